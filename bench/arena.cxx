@@ -0,0 +1,106 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/arena.hxx>
+
+#include "bench.hxx"
+#include <gdt/allocator.hxx>
+#include <gdt/dynarr.hxx>
+#include <cstdlib>
+
+using gdt::arena;
+using gdt::arena_allocator;
+using gdt::dynarr;
+
+namespace
+{
+    // Allocate `n` small objects, then free them all.
+    void bench_alloc_allocator(const char* name, int n)
+    {
+        dynarr<double*> ptrs(n);
+        auto ns = bench::measure(5, [&]
+        {
+            gdt::allocator<double> a;
+            for (int i = 0; i < n; ++i)
+            {
+                ptrs[i] = a.allocate(std::size_t(1 + i % 8));
+            }
+
+            bench::escape(ptrs.data());
+            for (int i = 0; i < n; ++i)
+            {
+                a.deallocate(ptrs[i], std::size_t(1 + i % 8));
+            }
+        });
+        bench::report(name, ns, n);
+    }
+
+    // Allocate `n` small objects, then reset the arena.
+    void bench_alloc_arena(const char* name, int n)
+    {
+        dynarr<double*> ptrs(n);
+        arena ar;
+        auto ns = bench::measure(5, [&]
+        {
+            arena_allocator<double> a(ar);
+            for (int i = 0; i < n; ++i)
+            {
+                ptrs[i] = a.allocate(std::size_t(1 + i % 8));
+            }
+
+            bench::escape(ptrs.data());
+            ar.reset();
+        });
+        bench::report(name, ns, n);
+    }
+
+    // Build `lists` short-lived dynarrs of `len` elements per frame.
+    template<typename Allocator, typename MakeAllocator, typename EndFrame>
+    void bench_frame(
+        const char* name,
+        int lists,
+        int len,
+        MakeAllocator make_allocator,
+        EndFrame end_frame)
+    {
+        auto ns = bench::measure(5, [&]
+        {
+            for (int i = 0; i < lists; ++i)
+            {
+                dynarr<int, Allocator> a(make_allocator());
+                for (int j = 0; j < len; ++j)
+                {
+                    a.push_back(j);
+                }
+
+                bench::escape(a.data());
+            }
+
+            end_frame();
+        });
+        bench::report(name, ns, double(lists) * len);
+    }
+}
+
+int bench_arena(int argc, char** const argv)
+{
+    int n = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+
+    bench_alloc_allocator("allocate/free (gdt::allocator)", n);
+    bench_alloc_arena("allocate/reset (arena_allocator)", n);
+
+    bench_frame<gdt::allocator<int>>(
+        "frame temporaries (gdt::allocator)", n / 100, 100,
+        [] { return gdt::allocator<int>(); },
+        [] {});
+
+    arena ar;
+    bench_frame<arena_allocator<int>>(
+        "frame temporaries (arena_allocator)", n / 100, 100,
+        [&] { return arena_allocator<int>(ar); },
+        [&] { ar.reset(); });
+
+    return 0;
+}
@@ -0,0 +1,75 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/batch_math.hxx>
+
+#include "bench.hxx"
+#include <gdt/dynarr.hxx>
+#include <gdt/vec.hxx>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+using gdt::batch::accuracy;
+using gdt::dynarr;
+using gdt::vec4;
+
+namespace
+{
+    constexpr int reps = 20;
+
+    // Per-vector gdt::func, batch precise, and batch fast.
+    #define gdt_bench(func, lo, hi)\
+    {\
+        dynarr<vec4<float>> in(n);\
+        dynarr<vec4<float>> out(n);\
+        for (std::size_t i = 0; i < n; ++i)\
+        {\
+            for (std::size_t k = 0; k < 4; ++k)\
+            {\
+                auto t = float((i * 4 + k) % 1000) / 999.0f;\
+                in[i][k] = lo + (hi - lo) * t;\
+            }\
+        }\
+        \
+        auto ns = bench::measure(reps, [&]\
+        {\
+            for (std::size_t i = 0; i < n; ++i)\
+            {\
+                out[i] = gdt::func(in[i]);\
+            }\
+            bench::escape(out.data());\
+        });\
+        bench::report(#func " (vec4 loop)", ns, double(n));\
+        \
+        ns = bench::measure(reps, [&]\
+        {\
+            gdt::batch::func(in, out, accuracy::precise);\
+            bench::escape(out.data());\
+        });\
+        bench::report(#func " (batch, precise)", ns, double(n));\
+        \
+        ns = bench::measure(reps, [&]\
+        {\
+            gdt::batch::func(in, out);\
+            bench::escape(out.data());\
+        });\
+        bench::report(#func " (batch, fast)", ns, double(n));\
+    }
+}
+
+int bench_batch_math(int argc, char** const argv)
+{
+    auto n = std::size_t(argc > 1 ? std::atoi(argv[1]) : 100'000);
+
+    gdt_bench(sin, -10.0f, 10.0f)
+    gdt_bench(cos, -10.0f, 10.0f)
+    gdt_bench(exp, -10.0f, 10.0f)
+    gdt_bench(log, 0.001f, 1000.0f)
+    gdt_bench(sqrt, 0.0f, 1000.0f)
+    #undef gdt_bench
+
+    return 0;
+}
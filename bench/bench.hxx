@@ -0,0 +1,62 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+
+namespace bench
+{
+    // Sink the optimizer can't see through.
+    inline const void* volatile sink;
+
+    // Make `p` (and whatever it points to) observable.
+    inline void escape(const void* p)
+    {
+        sink = p;
+    }
+
+    // Sink for integer results.
+    inline thread_local volatile std::uint64_t kept;
+
+    // Make an integer result observable.
+    template<typename T>
+    void keep(T value)
+    {
+        kept = std::uint64_t(value);
+    }
+
+    // Best wall-clock time of `reps` calls to `f` in nanoseconds.
+    template<typename F>
+    double measure(int reps, F&& f)
+    {
+        using clock = std::chrono::steady_clock;
+
+        auto best = (std::numeric_limits<double>::max)();
+        for (int i = 0; i < reps; ++i)
+        {
+            auto start = clock::now();
+            f();
+            auto stop = clock::now();
+
+            std::chrono::duration<double, std::nano> ns = stop - start;
+            best = (std::min)(best, ns.count());
+        }
+
+        return best;
+    }
+
+    // Print a result line.
+    inline void report(const char* name, double ns, double items)
+    {
+        std::printf(
+            "%-48s %12.3f ms %10.3f ns/item\n",
+            name, ns / 1e6, ns / items);
+    }
+}
@@ -0,0 +1,184 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/bitset_dynarr.hxx>
+
+#include "bench.hxx"
+#include <gdt/dynarr.hxx>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+
+using gdt::bitset_dynarr;
+using gdt::dynarr;
+
+namespace
+{
+    // Flags for `n` objects, like we used to do it, and packed.
+    // About 1 in `sparsity` is set.
+    struct flags
+    {
+        dynarr<bool> bools;
+        bitset_dynarr<> bits;
+
+        flags(std::size_t n, std::uint64_t seed, std::uint64_t sparsity) :
+            bools(n, false),
+            bits(n)
+        {
+            auto x = seed;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                x = x * 6364136223846793005 + 1442695040888963407;
+                if ((x >> 32) % sparsity == 0)
+                {
+                    bools[i] = true;
+                    bits.set(i);
+                }
+            }
+        }
+    };
+
+    void bench_size(std::size_t n)
+    {
+        int reps = n <= 10'000'000 ? 10 : 3;
+        flags visible(n, 1, 2);
+        flags dirty(n, 2, 1000);
+        auto items = double(n);
+
+        std::printf(
+            "%zu bits: %zu KiB as bools, %zu KiB packed\n",
+            n,
+            n / 1024,
+            visible.bits.words().size() * 8 / 1024);
+
+        // visible &= !dirty.
+        auto ns = bench::measure(reps, [&]
+        {
+            auto a = visible.bools.data();
+            auto b = dirty.bools.data();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                a[i] = a[i] & !b[i];
+            }
+            bench::escape(a);
+        });
+        bench::report("and not (dynarr<bool>)", ns, items);
+
+        ns = bench::measure(reps, [&]
+        {
+            visible.bits.and_not(dirty.bits);
+            bench::escape(visible.bits.data());
+        });
+        bench::report("and not (bitset_dynarr)", ns, items);
+
+        // visible |= dirty.
+        ns = bench::measure(reps, [&]
+        {
+            auto a = visible.bools.data();
+            auto b = dirty.bools.data();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                a[i] = a[i] | b[i];
+            }
+            bench::escape(a);
+        });
+        bench::report("or (dynarr<bool>)", ns, items);
+
+        ns = bench::measure(reps, [&]
+        {
+            visible.bits |= dirty.bits;
+            bench::escape(visible.bits.data());
+        });
+        bench::report("or (bitset_dynarr)", ns, items);
+
+        // Count.
+        ns = bench::measure(reps, [&]
+        {
+            std::size_t count = 0;
+            for (auto b : visible.bools)
+            {
+                count += b;
+            }
+            bench::keep(count);
+        });
+        bench::report("count (dynarr<bool>)", ns, items);
+
+        ns = bench::measure(reps, [&]
+        {
+            bench::keep(visible.bits.count());
+        });
+        bench::report("count (bitset_dynarr)", ns, items);
+
+        // Any, with nothing set until the very end.
+        flags clean(n, 3, n * 4);
+        clean.bools.back() = true;
+        clean.bits.set(n - 1);
+
+        ns = bench::measure(reps, [&]
+        {
+            bool any = false;
+            for (auto b : clean.bools)
+            {
+                any |= b;
+            }
+            bench::keep(any);
+        });
+        bench::report("any (dynarr<bool>)", ns, items);
+
+        ns = bench::measure(reps, [&]
+        {
+            bench::keep(clean.bits.any());
+        });
+        bench::report("any (bitset_dynarr)", ns, items);
+
+        // Visit the dirty objects.
+        ns = bench::measure(reps, [&]
+        {
+            std::size_t sum = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (dirty.bools[i])
+                {
+                    sum += i;
+                }
+            }
+            bench::keep(sum);
+        });
+        bench::report("visit 0.1% set (dynarr<bool>)", ns, items);
+
+        ns = bench::measure(reps, [&]
+        {
+            std::size_t sum = 0;
+            auto& bits = dirty.bits;
+            for (auto i = bits.find_first(); i != bits.npos; i = bits.find_next(i))
+            {
+                sum += i;
+            }
+            bench::keep(sum);
+        });
+        bench::report("visit 0.1% set (bitset_dynarr)", ns, items);
+    }
+}
+
+int bench_bitset_dynarr(int argc, char** const argv)
+{
+    // 1M to 100M bits, or just `argv[1]`.
+    std::size_t sizes[] = {1'000'000, 10'000'000, 100'000'000};
+    std::size_t last = std::size(sizes);
+    if (argc > 1)
+    {
+        sizes[0] = std::size_t(std::atoll(argv[1]));
+        last = 1;
+    }
+
+    for (std::size_t i = 0; i < last; ++i)
+    {
+        bench_size(sizes[i]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,233 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/bvh.hxx>
+
+#include "bench.hxx"
+#include <gdt/aabb.hxx>
+#include <gdt/dynarr.hxx>
+#include <gdt/frustum.hxx>
+#include <gdt/mat.hxx>
+#include <gdt/ray.hxx>
+#include <gdt/vec.hxx>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+using gdt::aabb;
+using gdt::bvh;
+using gdt::bvh_build_options;
+using gdt::dynarr;
+using gdt::frustum;
+using gdt::mat4;
+using gdt::ray;
+using gdt::vec;
+using gdt::vec3;
+
+namespace
+{
+    constexpr int reps = 5;
+
+    using box3 = aabb<float, 3>;
+
+    // Triangle.
+    struct triangle
+    {
+        vec3<float> a;
+        vec3<float> b;
+        vec3<float> c;
+    };
+
+    // Bounds of a triangle.
+    box3 bounds(const triangle& tri)
+    {
+        return merge(merge(box3(tri.a), tri.b), tri.c);
+    }
+
+    // Möller-Trumbore ray-triangle intersection.
+    float intersect(const ray<float, 3>& r, const triangle& tri)
+    {
+        auto inf = std::numeric_limits<float>::infinity();
+        auto e1 = tri.b - tri.a;
+        auto e2 = tri.c - tri.a;
+        auto p = cross(r.direction(), e2);
+        auto det = dot(e1, p);
+        if (std::abs(det) < 1e-12f)
+        {
+            return inf;
+        }
+        auto inv_det = 1.0f / det;
+        auto s = r.origin() - tri.a;
+        auto u = dot(s, p) * inv_det;
+        if (u < 0.0f || u > 1.0f)
+        {
+            return inf;
+        }
+        auto q = cross(s, e1);
+        auto v = dot(r.direction(), q) * inv_det;
+        if (v < 0.0f || u + v > 1.0f)
+        {
+            return inf;
+        }
+        auto t = dot(e2, q) * inv_det;
+        return t >= 0.0f ? t : inf;
+    }
+
+    // Height of a bumpy terrain.
+    float height(float x, float z)
+    {
+        return std::sin(x * 0.05f) * std::cos(z * 0.07f) * 20.0f +
+            std::sin(x * 0.9f + z * 0.4f) * 0.5f;
+    }
+
+    // Terrain of about `n` triangles over [0, 1000] in x and z, with a
+    // scattering of floating debris.
+    dynarr<triangle> make_scene(std::size_t n)
+    {
+        auto grid = std::size_t(std::sqrt(double(n) * 0.45));
+        auto step = 1000.0f / float(grid);
+        dynarr<triangle> ret;
+        for (std::size_t i = 0; i < grid; ++i)
+        {
+            for (std::size_t j = 0; j < grid; ++j)
+            {
+                auto x0 = float(i) * step;
+                auto z0 = float(j) * step;
+                auto x1 = x0 + step;
+                auto z1 = z0 + step;
+                vec3<float> p00(x0, height(x0, z0), z0);
+                vec3<float> p10(x1, height(x1, z0), z1 - step);
+                vec3<float> p01(x0, height(x0, z1), z1);
+                vec3<float> p11(x1, height(x1, z1), z1);
+                ret.push_back({p00, p10, p11});
+                ret.push_back({p00, p11, p01});
+            }
+        }
+
+        std::uint32_t seed = 1;
+        auto next = [&]
+        {
+            seed = seed * 1664525 + 1013904223;
+            return float(seed >> 8) / float(1 << 24);
+        };
+        while (ret.size() < n)
+        {
+            auto c = vec(next() * 1000.0f, next() * 60.0f, next() * 1000.0f);
+            auto d = vec(next(), next(), next()) - 0.5f;
+            auto e = vec(next(), next(), next()) - 0.5f;
+            ret.push_back({c, c + d, c + e});
+        }
+        return ret;
+    }
+
+    // Rays looking down on the terrain from random points.
+    dynarr<ray<float, 3>> make_rays(std::size_t n)
+    {
+        std::uint32_t seed = 2;
+        auto next = [&]
+        {
+            seed = seed * 1664525 + 1013904223;
+            return float(seed >> 8) / float(1 << 24);
+        };
+        dynarr<ray<float, 3>> ret;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto o = vec(next() * 1000.0f, 80.0f, next() * 1000.0f);
+            auto d = vec(next() - 0.5f, -0.5f - next(), next() - 0.5f);
+            ret.push_back(ray<float, 3>(o, d));
+        }
+        return ret;
+    }
+}
+
+int bench_bvh(int argc, char** const argv)
+{
+    auto n = std::size_t(argc > 1 ? std::atoi(argv[1]) : 1'000'000);
+
+    auto tris = make_scene(n);
+    dynarr<box3> boxes;
+    for (auto& tri : tris)
+    {
+        boxes.push_back(bounds(tri));
+    }
+
+    // Build.
+    bvh<float> tree;
+    auto ns = bench::measure(reps, [&]
+    {
+        tree.build(boxes);
+        bench::escape(tree.nodes().data());
+    });
+    bench::report("build", ns, double(n));
+
+    bvh_build_options options;
+    options.parallel = true;
+    ns = bench::measure(reps, [&]
+    {
+        tree.build(boxes, options);
+        bench::escape(tree.nodes().data());
+    });
+    bench::report("build (parallel)", ns, double(n));
+
+    ns = bench::measure(reps, [&]
+    {
+        tree.refit(boxes);
+        bench::escape(tree.nodes().data());
+    });
+    bench::report("refit", ns, double(n));
+
+    // Rays, nearest hit.
+    auto rays = make_rays(100'000);
+    std::size_t hits = 0;
+    ns = bench::measure(reps, [&]
+    {
+        hits = 0;
+        for (auto& r : rays)
+        {
+            auto hit = tree.intersect(r, [&](std::uint32_t i)
+            {
+                return intersect(r, tris[i]);
+            });
+            hits += hit.index != gdt::bvh_node<float>::none;
+        }
+        bench::escape(&hits);
+    });
+    bench::report("ray nearest hit (per ray)", ns, double(rays.size()));
+
+    // Boxes.
+    std::size_t found = 0;
+    ns = bench::measure(reps, [&]
+    {
+        found = 0;
+        for (std::size_t i = 0; i < 10'000; ++i)
+        {
+            auto x = float(i % 100) * 10.0f;
+            auto z = float(i / 100) * 10.0f;
+            box3 query(vec(x, -30.0f, z), vec(x + 5.0f, 30.0f, z + 5.0f));
+            tree.query(query, [&](std::uint32_t) { ++found; });
+        }
+        bench::escape(&found);
+    });
+    bench::report("box query (per query)", ns, 10'000.0);
+
+    // Frustum looking down on a 100 by 100 patch.
+    mat4<float> view_proj(
+        vec(0.02f, 0.0f, 0.0f, 0.0f),
+        vec(0.0f, 0.0f, 0.01f, 0.0f),
+        vec(0.0f, 0.02f, 0.0f, 0.0f),
+        vec(-10.0f, -10.0f, 0.5f, 1.0f));
+    frustum<float> f(view_proj);
+    ns = bench::measure(reps, [&]
+    {
+        found = 0;
+        tree.query(f, [&](std::uint32_t) { ++found; });
+        bench::escape(&found);
+    });
+    bench::report("frustum query (per primitive found)", ns, double(found));
+
+    return 0;
+}
@@ -0,0 +1,275 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/dynarr.hxx>
+
+#include "bench.hxx"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+using gdt::dynarr;
+
+namespace
+{
+    // Component with a user-provided move constructor, which hides its
+    // trivial relocatability from the compiler unless told otherwise.
+    template<bool Relocatable>
+    struct component
+    {
+        float data[8];
+
+        explicit component(float f) : data{f} {}
+        component(const component& other) = default;
+        component(component&& other) noexcept
+        {
+            for (int i = 0; i < 8; ++i)
+            {
+                data[i] = other.data[i];
+            }
+        }
+        component& operator=(const component& other) = default;
+        component& operator=(component&& other) = default;
+        ~component() {}
+    };
+
+    using before = component<false>;
+    using after = component<true>;
+
+    // Allocator that hides trivial relocatability from its containers.
+    template<typename T>
+    struct opaque_allocator : gdt::allocator<T>
+    {
+        opaque_allocator() = default;
+        opaque_allocator(const opaque_allocator&) = default;
+        ~opaque_allocator() {}
+    };
+
+    using inner_before = dynarr<int, opaque_allocator<int>>;
+    using inner_after = dynarr<int>;
+
+    // Allocator that hides `reallocate` from its containers.
+    template<typename T>
+    struct no_realloc_allocator : gdt::allocator<T>
+    {
+        void reallocate() = delete;
+    };
+
+    template<typename T>
+    void bench_growth(const char* name, int n)
+    {
+        auto ns = bench::measure(5, [&]
+        {
+            dynarr<T> a;
+            for (int i = 0; i < n; ++i)
+            {
+                a.emplace_back(float(i));
+            }
+            bench::escape(a.data());
+        });
+        bench::report(name, ns, n);
+    }
+
+    // Growth of a large array, counting how often the buffer moved.
+    template<typename Allocator>
+    void bench_large_growth(const char* name, int n)
+    {
+        int moves = 0;
+        auto ns = bench::measure(5, [&]
+        {
+            dynarr<std::int64_t, Allocator> a;
+            moves = 0;
+            auto data = a.data();
+            for (int i = 0; i < n; ++i)
+            {
+                a.push_back(i);
+                if (a.data() != data)
+                {
+                    ++moves;
+                    data = a.data();
+                }
+            }
+            bench::escape(a.data());
+        });
+        bench::report(name, ns, n);
+        std::printf("%-48s %12d buffer moves\n", "", moves);
+    }
+
+    template<typename T>
+    void bench_nested_growth(const char* name, int n)
+    {
+        auto ns = bench::measure(5, [&]
+        {
+            dynarr<T> a;
+            for (int i = 0; i < n; ++i)
+            {
+                a.emplace_back(1, i);
+            }
+            bench::escape(a.data());
+        });
+        bench::report(name, ns, n);
+    }
+
+    template<typename T>
+    void bench_insert_erase(const char* name, int n, int ops)
+    {
+        dynarr<T> a;
+        for (int i = 0; i < n; ++i)
+        {
+            a.emplace_back(float(i));
+        }
+
+        auto ns = bench::measure(5, [&]
+        {
+            for (int i = 0; i < ops; ++i)
+            {
+                a.insert(a.begin() + (i % 64), T(float(i)));
+                a.erase(a.begin() + (i % 32));
+            }
+            bench::escape(a.data());
+        });
+        bench::report(name, ns, ops);
+    }
+
+    // Per-frame resize of a particle buffer, the way
+    // dynarr used to do it one element at a time.
+    void bench_resize_per_element(const char* name, int n)
+    {
+        dynarr<float> a;
+        a.reserve(dynarr<float>::size_type(n));
+        auto ns = bench::measure(5, [&]
+        {
+            while (a.size() > 0)
+            {
+                a.pop_back();
+            }
+            while (a.size() < dynarr<float>::size_type(n))
+            {
+                a.emplace_back();
+            }
+            bench::escape(a.data());
+        });
+        bench::report(name, ns, n);
+    }
+
+    // Per-frame resize of a particle buffer.
+    void bench_resize_bulk(const char* name, int n)
+    {
+        dynarr<float> a;
+        a.reserve(dynarr<float>::size_type(n));
+        auto ns = bench::measure(5, [&]
+        {
+            a.resize(0);
+            a.resize(dynarr<float>::size_type(n));
+            bench::escape(a.data());
+        });
+        bench::report(name, ns, n);
+    }
+
+    // Per-frame fill of a particle buffer.
+    void bench_fill_bulk(const char* name, int n)
+    {
+        dynarr<float> a;
+        a.reserve(dynarr<float>::size_type(n));
+        auto ns = bench::measure(5, [&]
+        {
+            a.resize(0);
+            a.resize(dynarr<float>::size_type(n), 1.0f);
+            bench::escape(a.data());
+        });
+        bench::report(name, ns, n);
+    }
+
+    // Per-frame streaming buffer refill with a double write.
+    void bench_stream_resize(const char* name, int n)
+    {
+        dynarr<float> a;
+        a.reserve(dynarr<float>::size_type(n));
+        auto ns = bench::measure(5, [&]
+        {
+            a.clear();
+            a.resize(dynarr<float>::size_type(n));
+            float* p = a.data();
+            for (int i = 0; i < n; ++i)
+            {
+                p[i] = float(i);
+            }
+            bench::escape(p);
+        });
+        bench::report(name, ns, n);
+    }
+
+    // Per-frame streaming buffer refill without the double write.
+    void bench_stream_append_uninitialized(const char* name, int n)
+    {
+        dynarr<float> a;
+        a.reserve(dynarr<float>::size_type(n));
+        auto ns = bench::measure(5, [&]
+        {
+            a.clear();
+            float* p = a.append_uninitialized(dynarr<float>::size_type(n));
+            for (int i = 0; i < n; ++i)
+            {
+                p[i] = float(i);
+            }
+            bench::escape(p);
+        });
+        bench::report(name, ns, n);
+    }
+
+    template<typename T>
+    void bench_swap_remove(const char* name, int n)
+    {
+        auto ns = bench::measure(5, [&]
+        {
+            dynarr<T> a;
+            a.reserve(typename dynarr<T>::size_type(n));
+            for (int i = 0; i < n; ++i)
+            {
+                a.emplace_back(float(i));
+            }
+            while (!a.empty())
+            {
+                a.swap_remove(a.begin());
+            }
+            bench::escape(a.data());
+        });
+        bench::report(name, ns, n);
+    }
+}
+
+template<>
+struct gdt::is_trivially_relocatable<after> : std::true_type {};
+
+int bench_dynarr(int argc, char** const argv)
+{
+    int n = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+
+    bench_growth<before>("growth (move and destroy)", n);
+    bench_growth<after>("growth (trivially relocatable)", n);
+
+    bench_large_growth<no_realloc_allocator<std::int64_t>>(
+        "large growth (allocate, memcpy, free)", n * 20);
+    bench_large_growth<gdt::allocator<std::int64_t>>(
+        "large growth (realloc)", n * 20);
+
+    bench_nested_growth<inner_before>("nested dynarr growth (move and destroy)", n / 10);
+    bench_nested_growth<inner_after>("nested dynarr growth (trivially relocatable)", n / 10);
+
+    bench_insert_erase<before>("insert/erase (move)", n / 10, 1'000);
+    bench_insert_erase<after>("insert/erase (trivially relocatable)", n / 10, 1'000);
+
+    bench_resize_per_element("resize (per element)", n * 10);
+    bench_resize_bulk("resize (bulk)", n * 10);
+    bench_fill_bulk("resize with fill value (bulk)", n * 10);
+
+    bench_stream_resize("stream refill (resize)", n * 10);
+    bench_stream_append_uninitialized("stream refill (append_uninitialized)", n * 10);
+
+    bench_swap_remove<before>("swap remove (move)", n);
+    bench_swap_remove<after>("swap remove (trivially relocatable)", n);
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/flat_map.hxx>
+
+#include "bench.hxx"
+#include <gdt/dynarr.hxx>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <utility>
+
+using gdt::dynarr;
+using gdt::flat_map;
+
+namespace
+{
+    using key = std::uint32_t;
+    using pair = std::pair<key, key>;
+
+    // Pseudo-random keys below 2^31 (with some duplicates).
+    dynarr<pair> make_pairs(std::size_t n, key seed)
+    {
+        dynarr<pair> pairs;
+        pairs.reserve(n);
+        auto x = std::uint64_t(seed) * 0x9e3779b97f4a7c15 + 1;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            pairs.push_back({key(x >> 33), key(i)});
+        }
+        return pairs;
+    }
+
+    // Build and look up maps of `n` pairs.
+    void bench_size(std::size_t n)
+    {
+        // Enough lookups per rep to time small maps.
+        constexpr std::size_t lookups = 1'000'000;
+        int reps = n <= 100'000 ? 10 : 3;
+
+        auto pairs = make_pairs(n, 1);
+        dynarr<key> queries;
+        queries.reserve(lookups);
+        for (std::size_t i = 0; i < lookups; ++i)
+        {
+            // Half hits, half (mostly) misses.
+            queries.push_back(i % 2 == 0 ?
+                pairs[(i * 7919) % n].first :
+                key(i * 2654435761u));
+        }
+
+        // Build.
+        auto ns = bench::measure(reps, [&]
+        {
+            std::map<key, key> m;
+            for (auto& p : pairs)
+            {
+                m.insert(p);
+            }
+            bench::escape(&m);
+        });
+        bench::report("build (std::map)", ns, double(n));
+
+        if (n <= 100'000)
+        {
+            ns = bench::measure(reps, [&]
+            {
+                flat_map<key, key> m;
+                for (auto& p : pairs)
+                {
+                    m.insert(p);
+                }
+                bench::escape(m.keys().data());
+            });
+            bench::report("build (flat_map, insert)", ns, double(n));
+        }
+
+        ns = bench::measure(reps, [&]
+        {
+            flat_map<key, key> m;
+            m.insert_range(pairs);
+            bench::escape(m.keys().data());
+        });
+        bench::report("build (flat_map, insert_range)", ns, double(n));
+
+        // Lookup.
+        std::map<key, key> sm(pairs.begin(), pairs.end());
+        ns = bench::measure(reps, [&]
+        {
+            key sum = 0;
+            for (auto q : queries)
+            {
+                auto it = sm.find(q);
+                sum += it != sm.end() ? it->second : 0;
+            }
+            bench::keep(sum);
+        });
+        bench::report("find (std::map)", ns, double(lookups));
+
+        flat_map<key, key> fm;
+        fm.insert_range(pairs);
+        auto keys = fm.keys();
+        ns = bench::measure(reps, [&]
+        {
+            key sum = 0;
+            for (auto q : queries)
+            {
+                auto it = std::lower_bound(keys.begin(), keys.end(), q);
+                sum += it != keys.end() && *it == q ?
+                    fm.values()[std::size_t(it - keys.begin())] : 0;
+            }
+            bench::keep(sum);
+        });
+        bench::report("find (flat_map keys, std::lower_bound)", ns, double(lookups));
+
+        ns = bench::measure(reps, [&]
+        {
+            key sum = 0;
+            for (auto q : queries)
+            {
+                auto it = fm.find(q);
+                sum += it != fm.end() ? it->second : 0;
+            }
+            bench::keep(sum);
+        });
+        bench::report("find (flat_map)", ns, double(lookups));
+    }
+}
+
+int bench_flat_map(int argc, char** const argv)
+{
+    // 16 to 1M pairs, or just `argv[1]`.
+    std::size_t sizes[] = {16, 256, 4'096, 65'536, 1'048'576};
+    std::size_t last = std::size(sizes);
+    if (argc > 1)
+    {
+        sizes[0] = std::size_t(std::atoi(argv[1]));
+        last = 1;
+    }
+
+    for (std::size_t i = 0; i < last; ++i)
+    {
+        std::printf("%zu pairs\n", sizes[i]);
+        bench_size(sizes[i]);
+    }
+
+    return 0;
+}
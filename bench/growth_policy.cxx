@@ -0,0 +1,109 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/growth_policy.hxx>
+
+#include "bench.hxx"
+#include <gdt/allocator.hxx>
+#include <gdt/dynarr.hxx>
+#include <gdt/tracking_allocator.hxx>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+using gdt::capped_growth;
+using gdt::default_growth;
+using gdt::dynarr;
+using gdt::geometric_growth;
+using gdt::rounded_growth;
+
+namespace
+{
+    // Print what the allocator saw, per array.
+    void report_stats(const gdt::allocation_stats& stats, double arrays)
+    {
+        std::printf(
+            "  %.1f allocations + %.1f reallocations per array, "
+            "%.1f MiB peak\n",
+            double(stats.allocations()) / arrays,
+            double(stats.reallocations()) / arrays,
+            double(stats.peak_bytes()) / (1024.0 * 1024.0));
+    }
+
+    // Grow one big array to `n` elements.
+    template<typename Growth>
+    void bench_large(const char* name, int n)
+    {
+        using allocator_type = gdt::tracking_allocator<
+            gdt::allocator<std::int64_t>, Growth>;
+        auto& stats = allocator_type::stats();
+
+        double waste = 0;
+        auto ns = bench::measure(3, [&]
+        {
+            stats.reset();
+            dynarr<std::int64_t, allocator_type, Growth> a;
+            for (int i = 0; i < n; ++i)
+            {
+                a.push_back(i);
+            }
+
+            waste = double(a.capacity() - a.size()) / double(a.size());
+            bench::escape(a.data());
+        });
+
+        bench::report(name, ns, n);
+        std::printf("  %.0f%% unused capacity at the end\n", waste * 100);
+        report_stats(stats, 1);
+    }
+
+    // Build lots of tiny arrays of `len` elements.
+    template<typename Growth>
+    void bench_tiny(const char* name, int arrays, int len)
+    {
+        using allocator_type = gdt::tracking_allocator<
+            gdt::allocator<int>, Growth>;
+        auto& stats = allocator_type::stats();
+
+        auto ns = bench::measure(3, [&]
+        {
+            stats.reset();
+            for (int i = 0; i < arrays; ++i)
+            {
+                dynarr<int, allocator_type, Growth> a;
+                for (int j = 0; j < len; ++j)
+                {
+                    a.push_back(j);
+                }
+
+                bench::escape(a.data());
+            }
+        });
+
+        bench::report(name, ns, arrays);
+        report_stats(stats, arrays);
+    }
+
+    // Doubling, but linear above 64 MiB.
+    using capped = capped_growth<default_growth, 64 << 20, 32 << 20>;
+
+    // 1.5x, rounded to 4 KiB pages.
+    using paged = rounded_growth<geometric_growth<3, 2>, 4096>;
+}
+
+int bench_growth_policy(int argc, char** const argv)
+{
+    int n = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+
+    bench_large<default_growth>("large (2x)", n * 20);
+    bench_large<geometric_growth<3, 2>>("large (1.5x)", n * 20);
+    bench_large<capped>("large (2x, +32 MiB above 64 MiB)", n * 20);
+    bench_large<paged>("large (1.5x, page rounded)", n * 20);
+
+    bench_tiny<default_growth>("tiny arrays (2x)", n, 5);
+    bench_tiny<geometric_growth<2, 1, 8>>("tiny arrays (2x, min 8)", n, 5);
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/hash_map.hxx>
+
+#include "bench.hxx"
+#include <gdt/allocator.hxx>
+#include <gdt/dynarr.hxx>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+using gdt::dynarr;
+
+namespace
+{
+    using key = std::uint64_t;
+
+    // 32-bit sizes and differences.
+    using compact_allocator = gdt::allocator<
+        std::pair<const key, key>, std::uint32_t, std::int32_t>;
+
+    using std_map = std::unordered_map<key, key>;
+    using gdt_map = gdt::hash_map<key, key>;
+    using compact_map = gdt::hash_map<
+        key, key, std::hash<key>, std::equal_to<key>, compact_allocator>;
+
+    // Distinct pseudo-random keys (splitmix64 is a bijection).
+    dynarr<key> make_keys(std::size_t n, key seed)
+    {
+        dynarr<key> keys;
+        keys.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto z = (seed + i) * 0x9e3779b97f4a7c15;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            keys.push_back(z ^ (z >> 31));
+        }
+        return keys;
+    }
+
+    // Insert, look up present and absent keys, then erase, at size `n`.
+    template<typename Map>
+    void bench_map(const char* name, std::size_t n, int reps)
+    {
+        char label[64];
+        auto keys = make_keys(n, 0);
+        auto misses = make_keys(n, key(1) << 40);
+
+        auto ns = bench::measure(reps, [&]
+        {
+            Map m;
+            for (auto k : keys)
+            {
+                m[k] = k;
+            }
+            bench::escape(&m);
+        });
+        std::snprintf(label, sizeof(label), "insert (%s)", name);
+        bench::report(label, ns, double(n));
+
+        Map m;
+        for (auto k : keys)
+        {
+            m[k] = k;
+        }
+
+        ns = bench::measure(reps, [&]
+        {
+            key sum = 0;
+            for (auto k : keys)
+            {
+                sum += m.find(k)->second;
+            }
+            bench::escape(&sum);
+        });
+        std::snprintf(label, sizeof(label), "find hit (%s)", name);
+        bench::report(label, ns, double(n));
+
+        ns = bench::measure(reps, [&]
+        {
+            std::size_t found = 0;
+            for (auto k : misses)
+            {
+                found += m.find(k) != m.end();
+            }
+            bench::escape(&found);
+        });
+        std::snprintf(label, sizeof(label), "find miss (%s)", name);
+        bench::report(label, ns, double(n));
+
+        ns = bench::measure(reps, [&]
+        {
+            auto copy = m;
+            for (auto k : keys)
+            {
+                copy.erase(k);
+            }
+            bench::escape(&copy);
+        });
+        std::snprintf(label, sizeof(label), "copy + erase (%s)", name);
+        bench::report(label, ns, double(n));
+    }
+}
+
+int bench_hash_map(int argc, char** const argv)
+{
+    // 1K to 10M entries, or just `argv[1]`.
+    std::size_t sizes[] = {1'000, 10'000, 100'000, 1'000'000, 10'000'000};
+    std::size_t first = 0;
+    std::size_t last = std::size(sizes);
+    if (argc > 1)
+    {
+        sizes[0] = std::size_t(std::atoi(argv[1]));
+        last = 1;
+    }
+
+    for (auto i = first; i < last; ++i)
+    {
+        auto n = sizes[i];
+        auto reps = n <= 100'000 ? 20 : 3;
+        std::printf("%zu entries\n", n);
+
+        bench_map<std_map>("std::unordered_map", n, reps);
+        bench_map<gdt_map>("hash_map", n, reps);
+        bench_map<compact_map>("hash_map, 32-bit sizes", n, reps);
+    }
+
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/mat.hxx>
+
+#include "bench.hxx"
+#include <gdt/dynarr.hxx>
+#include <gdt/vec.hxx>
+#include <cstddef>
+#include <cstdlib>
+
+using gdt::dynarr;
+using gdt::mat4;
+using gdt::vec;
+using gdt::vec3;
+using gdt::vec4;
+
+namespace
+{
+    constexpr int reps = 20;
+
+    // A transform with rotation, scale, and translation.
+    mat4<float> make_mat4(float f)
+    {
+        return {
+            vec(0.8f, 0.6f * f, 0.0f, 0.0f),
+            vec(-0.6f, 0.8f, 0.0f, 0.0f),
+            vec(0.0f, 0.0f, 2.0f, 0.0f),
+            vec(1.0f, 2.0f, 3.0f, 1.0f),
+        };
+    }
+
+    // out[i] = a[i] * b[i].
+    void bench_mul(std::size_t n)
+    {
+        dynarr<mat4<float>> a;
+        dynarr<mat4<float>> b;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            a.push_back(make_mat4(float(i % 7)));
+            b.push_back(make_mat4(float(i % 5)));
+        }
+
+        dynarr<mat4<float>> out(n);
+        auto ns = bench::measure(reps, [&]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = a[i] * b[i];
+            }
+            bench::escape(out.data());
+        });
+        bench::report("mat4 * mat4", ns, double(n));
+    }
+
+    // Transform vec4s.
+    void bench_transform4(std::size_t n)
+    {
+        auto m = make_mat4(1.0f);
+        dynarr<vec4<float>> in;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto f = float(i % 1000);
+            in.push_back(vec(f, f + 1.0f, f + 2.0f, 1.0f));
+        }
+
+        dynarr<vec4<float>> out(n);
+        auto ns = bench::measure(reps, [&]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = m * in[i];
+            }
+            bench::escape(out.data());
+        });
+        bench::report("mat4 * vec4 (loop)", ns, double(n));
+
+        ns = bench::measure(reps, [&]
+        {
+            gdt::batch::transform(m, in, out);
+            bench::escape(out.data());
+        });
+        bench::report("mat4 * vec4 (batch::transform)", ns, double(n));
+    }
+
+    // Transform vec3 points.
+    void bench_transform3(std::size_t n)
+    {
+        auto m = make_mat4(1.0f);
+        dynarr<vec3<float>> in;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto f = float(i % 1000);
+            in.push_back(vec(f, f + 1.0f, f + 2.0f));
+        }
+
+        dynarr<vec3<float>> out(n);
+        auto ns = bench::measure(reps, [&]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = (m * vec4<float>(in[i], 1.0f)).xyz();
+            }
+            bench::escape(out.data());
+        });
+        bench::report("mat4 * point (loop)", ns, double(n));
+
+        ns = bench::measure(reps, [&]
+        {
+            gdt::batch::transform_points(m, in, out);
+            bench::escape(out.data());
+        });
+        bench::report("mat4 * point (batch::transform_points)", ns, double(n));
+    }
+}
+
+int bench_mat(int argc, char** const argv)
+{
+    auto n = std::size_t(argc > 1 ? std::atoi(argv[1]) : 1'000'000);
+
+    bench_mul(n / 4);
+    bench_transform4(n);
+    bench_transform3(n);
+
+    return 0;
+}
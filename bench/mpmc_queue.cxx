@@ -0,0 +1,208 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/mpmc_queue.hxx>
+
+#include "bench.hxx"
+#include <gdt/dynarr.hxx>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <span>
+#include <thread>
+
+using gdt::dynarr;
+using gdt::mpmc_queue;
+
+namespace
+{
+    constexpr int reps = 3;
+    constexpr std::size_t capacity = 4096;
+    constexpr std::size_t batch = 32;
+
+    // Mutex-guarded dynarr, like we used to do it.
+    // Consumers swap out everything queued so far.
+    class locked_dynarr
+    {
+    public:
+        void push(std::uint64_t v)
+        {
+            std::lock_guard lock(_mutex);
+            _items.push_back(v);
+        }
+
+        std::size_t pop_all(dynarr<std::uint64_t>& out)
+        {
+            std::lock_guard lock(_mutex);
+            out.swap(_items);
+            return out.size();
+        }
+
+    private:
+        std::mutex _mutex;
+        dynarr<std::uint64_t> _items;
+    };
+
+    // Run `producers` threads that each call `produce(count)` once and
+    // `consumers` threads that call `consume(sum)` until all `n` values
+    // have been received. `consume` returns how many it got.
+    template<typename Produce, typename Consume>
+    double run(
+        int producers,
+        int consumers,
+        std::uint64_t n,
+        Produce&& produce,
+        Consume&& consume)
+    {
+        return bench::measure(reps, [&]
+        {
+            std::atomic<std::uint64_t> received{0};
+            dynarr<std::thread> pool;
+
+            for (int p = 0; p < producers; ++p)
+            {
+                auto count = n / std::uint64_t(producers) +
+                    (std::uint64_t(p) < n % std::uint64_t(producers));
+                pool.emplace_back([&, count] { produce(count); });
+            }
+
+            for (int c = 0; c < consumers; ++c)
+            {
+                pool.emplace_back([&]
+                {
+                    std::uint64_t sum = 0;
+                    while (received.load(std::memory_order_relaxed) < n)
+                    {
+                        auto got = consume(sum);
+                        if (got == 0)
+                        {
+                            std::this_thread::yield();
+                        }
+                        received.fetch_add(got, std::memory_order_relaxed);
+                    }
+                    bench::keep(sum);
+                });
+            }
+
+            for (auto& t : pool)
+            {
+                t.join();
+            }
+        });
+    }
+
+    void bench_threads(int producers, int consumers, std::uint64_t n)
+    {
+        char label[96];
+
+        locked_dynarr locked;
+        auto ns = run(producers, consumers, n,
+            [&](std::uint64_t count)
+            {
+                for (std::uint64_t i = 0; i < count; ++i)
+                {
+                    locked.push(i);
+                }
+            },
+            [&](std::uint64_t& sum)
+            {
+                dynarr<std::uint64_t> local;
+                auto got = locked.pop_all(local);
+                for (auto v : local)
+                {
+                    sum += v;
+                }
+                return got;
+            });
+        std::snprintf(label, sizeof(label),
+            "mutex + dynarr, %dP/%dC", producers, consumers);
+        bench::report(label, ns, double(n));
+
+        mpmc_queue<std::uint64_t> q(capacity);
+        ns = run(producers, consumers, n,
+            [&](std::uint64_t count)
+            {
+                for (std::uint64_t i = 0; i < count;)
+                {
+                    if (q.try_push(i))
+                    {
+                        ++i;
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            },
+            [&](std::uint64_t& sum)
+            {
+                std::uint64_t v;
+                if (!q.try_pop(v))
+                {
+                    return std::size_t(0);
+                }
+                sum += v;
+                return std::size_t(1);
+            });
+        std::snprintf(label, sizeof(label),
+            "mpmc_queue, %dP/%dC", producers, consumers);
+        bench::report(label, ns, double(n));
+
+        ns = run(producers, consumers, n,
+            [&](std::uint64_t count)
+            {
+                std::uint64_t values[batch];
+                for (std::uint64_t i = 0; i < count;)
+                {
+                    auto k = std::size_t((std::min)(
+                        std::uint64_t(batch), count - i));
+                    for (std::size_t j = 0; j < k; ++j)
+                    {
+                        values[j] = i + j;
+                    }
+
+                    auto pushed = q.try_push_batch(std::span(values, k));
+                    if (pushed == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                    i += pushed;
+                }
+            },
+            [&](std::uint64_t& sum)
+            {
+                std::uint64_t values[batch];
+                auto got = q.try_pop_batch(values);
+                for (std::size_t j = 0; j < got; ++j)
+                {
+                    sum += values[j];
+                }
+                return std::size_t(got);
+            });
+        std::snprintf(label, sizeof(label),
+            "mpmc_queue batches, %dP/%dC", producers, consumers);
+        bench::report(label, ns, double(n));
+    }
+}
+
+int bench_mpmc_queue(int argc, char** const argv)
+{
+    auto n = std::uint64_t(argc > 1 ? std::atoi(argv[1]) : 4'000'000);
+    int max_threads = int(std::max(2u, std::thread::hardware_concurrency()));
+
+    // 1 to N producers and consumers, half the cores each.
+    for (int threads = 1; threads * 2 <= max_threads; threads *= 2)
+    {
+        bench_threads(threads, threads, n);
+    }
+    bench_threads(1, std::max(1, max_threads - 1), n);
+    bench_threads(std::max(1, max_threads - 1), 1, n);
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/packed.hxx>
+
+#include "bench.hxx"
+#include <gdt/dynarr.hxx>
+#include <gdt/half.hxx>
+#include <gdt/vec.hxx>
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+using gdt::dynarr;
+using gdt::half;
+using gdt::snorm16x2;
+using gdt::unorm10_10_10_2;
+using gdt::unorm8x4;
+using gdt::vec;
+using gdt::vec2;
+using gdt::vec4;
+
+namespace
+{
+    constexpr int reps = 20;
+
+    // Convert `in` to `P` and back, one vector at a time and in bulk.
+    template<typename P, typename V>
+    void bench_format(const char* name, const dynarr<V>& in)
+    {
+        auto n = in.size();
+        dynarr<P> packed(n);
+        dynarr<V> out(n);
+        char label[64];
+
+        auto ns = bench::measure(reps, [&]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                packed[i] = P(in[i]);
+            }
+            bench::escape(packed.data());
+        });
+        std::snprintf(label, sizeof(label), "pack %s (loop)", name);
+        bench::report(label, ns, double(n));
+
+        ns = bench::measure(reps, [&]
+        {
+            gdt::batch::convert(in, packed);
+            bench::escape(packed.data());
+        });
+        std::snprintf(label, sizeof(label), "pack %s (batch::convert)", name);
+        bench::report(label, ns, double(n));
+
+        ns = bench::measure(reps, [&]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = V(packed[i]);
+            }
+            bench::escape(out.data());
+        });
+        std::snprintf(label, sizeof(label), "unpack %s (loop)", name);
+        bench::report(label, ns, double(n));
+
+        ns = bench::measure(reps, [&]
+        {
+            gdt::batch::convert(packed, out);
+            bench::escape(out.data());
+        });
+        std::snprintf(label, sizeof(label), "unpack %s (batch::convert)", name);
+        bench::report(label, ns, double(n));
+    }
+}
+
+int bench_packed(int argc, char** const argv)
+{
+    auto n = std::size_t(argc > 1 ? std::atoi(argv[1]) : 1'000'000);
+
+    dynarr<vec4<float>> v4;
+    dynarr<vec2<float>> v2;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        auto f = float(i % 1000) / 1000.0f;
+        v4.push_back(vec(f, 1.0f - f, f * 0.5f, 1.0f));
+        v2.push_back(vec(f, -f));
+    }
+
+    // Copying floats, for scale.
+    dynarr<vec4<float>> copy(n);
+    auto ns = bench::measure(reps, [&]
+    {
+        std::copy(v4.begin(), v4.end(), copy.begin());
+        bench::escape(copy.data());
+    });
+    bench::report("copy vec4<float>", ns, double(n));
+
+    bench_format<vec4<half>>("vec4<half>", v4);
+    bench_format<unorm8x4>("unorm8x4", v4);
+    bench_format<unorm10_10_10_2>("unorm10_10_10_2", v4);
+    bench_format<snorm16x2>("snorm16x2", v2);
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/pool_allocator.hxx>
+
+#include "bench.hxx"
+#include <gdt/allocator.hxx>
+#include <gdt/dynarr.hxx>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+using gdt::dynarr;
+using gdt::pool_allocator;
+
+namespace
+{
+    struct node
+    {
+        node* next;
+        int value[6];
+    };
+
+    // Each thread repeatedly allocates a batch of nodes and frees them.
+    template<typename Allocator>
+    void bench_batches(const char* name, int threads, int n)
+    {
+        constexpr int batch = 1'000;
+        auto per_thread = n / threads;
+
+        auto ns = bench::measure(3, [&]
+        {
+            auto work = [&]
+            {
+                Allocator a;
+                node* nodes[batch];
+                for (int i = 0; i < per_thread; i += batch)
+                {
+                    for (auto& p : nodes)
+                    {
+                        p = a.allocate(1);
+                    }
+
+                    bench::escape(nodes);
+                    for (auto p : nodes)
+                    {
+                        a.deallocate(p, 1);
+                    }
+                }
+            };
+
+            dynarr<std::thread> pool;
+            for (int t = 0; t < threads; ++t)
+            {
+                pool.emplace_back(work);
+            }
+
+            for (auto& t : pool)
+            {
+                t.join();
+            }
+        });
+
+        char label[96];
+        std::snprintf(label, sizeof(label), "%s, %d thread(s)", name, threads);
+        bench::report(label, ns, n);
+    }
+
+    // One thread allocates, another frees.
+    template<typename Allocator>
+    void bench_cross_thread(const char* name, int n)
+    {
+        dynarr<node*> nodes(n);
+        auto ns = bench::measure(3, [&]
+        {
+            Allocator a;
+            for (auto& p : nodes)
+            {
+                p = a.allocate(1);
+            }
+
+            std::thread t([&]
+            {
+                Allocator b;
+                for (auto p : nodes)
+                {
+                    b.deallocate(p, 1);
+                }
+            });
+            t.join();
+        });
+        bench::report(name, ns, n);
+    }
+
+    // Another thread frees `n` nodes, then this one
+    // allocates and frees one node at a time.
+    template<typename Allocator>
+    void bench_drain_then_churn(const char* name, int n)
+    {
+        constexpr int churn = 100'000;
+        dynarr<node*> nodes(n);
+
+        auto ns = bench::measure(3, [&]
+        {
+            Allocator a;
+            for (auto& p : nodes)
+            {
+                p = a.allocate(1);
+            }
+
+            std::thread t([&]
+            {
+                Allocator b;
+                for (auto p : nodes)
+                {
+                    b.deallocate(p, 1);
+                }
+            });
+            t.join();
+
+            for (int i = 0; i < churn; ++i)
+            {
+                auto p = a.allocate(1);
+                bench::escape(p);
+                a.deallocate(p, 1);
+            }
+        });
+        bench::report(name, ns, n + churn);
+    }
+}
+
+int bench_pool_allocator(int argc, char** const argv)
+{
+    int n = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+    int max_threads = int(std::max(1u, std::thread::hardware_concurrency()));
+
+    for (int threads = 1; threads <= max_threads; threads *= 2)
+    {
+        bench_batches<gdt::allocator<node>>(
+            "alloc/free (gdt::allocator)", threads, n * 4);
+        bench_batches<pool_allocator<node>>(
+            "alloc/free (pool_allocator)", threads, n * 4);
+    }
+
+    bench_cross_thread<gdt::allocator<node>>(
+        "cross-thread free (gdt::allocator)", n);
+    bench_cross_thread<pool_allocator<node>>(
+        "cross-thread free (pool_allocator)", n);
+
+    bench_drain_then_churn<gdt::allocator<node>>(
+        "drain then churn (gdt::allocator)", n);
+    bench_drain_then_churn<pool_allocator<node>>(
+        "drain then churn (pool_allocator)", n);
+
+    return 0;
+}
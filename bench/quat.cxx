@@ -0,0 +1,127 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/quat.hxx>
+
+#include "bench.hxx"
+#include <gdt/dynarr.hxx>
+#include <gdt/vec.hxx>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+
+using gdt::dynarr;
+using gdt::quat;
+using gdt::vec;
+using gdt::vec3;
+
+namespace
+{
+    constexpr int reps = 20;
+
+    // A rotation that varies with `f`.
+    quat<float> make_quat(float f)
+    {
+        auto axis = normalize(vec(1.0f, f, 2.0f - f));
+        return quat<float>::from_axis_angle(axis, f * 0.7f + 0.1f);
+    }
+
+    // Rotate vec3s.
+    void bench_rotate(std::size_t n)
+    {
+        auto q = make_quat(0.5f);
+        dynarr<vec3<float>> in;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto f = float(i % 1000);
+            in.push_back(vec(f, f + 1.0f, f + 2.0f));
+        }
+
+        dynarr<vec3<float>> out(n);
+        auto ns = bench::measure(reps, [&]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = rotate(q, in[i]);
+            }
+            bench::escape(out.data());
+        });
+        bench::report("rotate (loop)", ns, double(n));
+
+        ns = bench::measure(reps, [&]
+        {
+            gdt::batch::rotate(q, in, out);
+            bench::escape(out.data());
+        });
+        bench::report("rotate (batch::rotate)", ns, double(n));
+    }
+
+    // Interpolate between pairs of rotations with `f`.
+    template<typename F>
+    void bench_interp(const char* name, std::size_t n, F f)
+    {
+        dynarr<quat<float>> a;
+        dynarr<quat<float>> b;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            a.push_back(make_quat(float(i % 7) * 0.25f));
+            b.push_back(make_quat(float(i % 11) * 0.25f));
+        }
+
+        dynarr<quat<float>> out(n);
+        auto ns = bench::measure(reps, [&]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = f(a[i], b[i], float(i % 16) / 15.0f);
+            }
+            bench::escape(out.data());
+        });
+        bench::report(name, ns, double(n));
+
+        // Largest angle between `f` and slerp in double precision.
+        double worst = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto t = float(i % 16) / 15.0f;
+            quat<double> qa(vec<double, 4>(a[i].xyzw()));
+            quat<double> qb(vec<double, 4>(b[i].xyzw()));
+            quat<double> qo(vec<double, 4>(out[i].xyzw()));
+            auto exact = slerp(qa, qb, double(t));
+            qo = normalize(dot(exact, qo) < 0.0 ? -qo : qo);
+
+            // Twice the chord length is the angle, for small angles.
+            auto e = 2.0 * length((exact - qo).xyzw());
+            worst = (std::max)(worst, e);
+        }
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s error", name);
+        std::printf("%-48s %12.6f rad (max)\n", label, worst);
+    }
+}
+
+int bench_quat(int argc, char** const argv)
+{
+    auto n = std::size_t(argc > 1 ? std::atoi(argv[1]) : 1'000'000);
+
+    bench_rotate(n);
+    bench_interp("nlerp", n / 4, [](auto& a, auto& b, float t)
+    {
+        return nlerp(a, b, t);
+    });
+    bench_interp("fast_slerp", n / 4, [](auto& a, auto& b, float t)
+    {
+        return fast_slerp(a, b, t);
+    });
+    bench_interp("slerp", n / 4, [](auto& a, auto& b, float t)
+    {
+        return slerp(a, b, t);
+    });
+
+    return 0;
+}
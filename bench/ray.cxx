@@ -0,0 +1,120 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/ray.hxx>
+
+#include "bench.hxx"
+#include <gdt/aabb.hxx>
+#include <gdt/dynarr.hxx>
+#include <gdt/vec.hxx>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+using gdt::aabb;
+using gdt::aabb_soa;
+using gdt::dynarr;
+using gdt::ray;
+using gdt::vec;
+
+namespace
+{
+    constexpr int reps = 20;
+
+    using box3 = aabb<float, 3>;
+
+    // Box `i` of a grid of small boxes, roughly half of which the ray hits.
+    box3 make_box(std::size_t i)
+    {
+        auto x = float(i % 101) * 0.1f - 5.0f;
+        auto y = float(i % 13) * 0.1f - 0.6f;
+        auto z = float(i % 17) * 0.1f - 0.8f;
+        return {vec(x, y, z), vec(x + 0.3f, y + 0.6f, z + 0.8f)};
+    }
+
+    // Test a ray and a box against `n` boxes, `W` at a time.
+    template<std::size_t W>
+    void bench_batch(const ray<float, 3>& r, const box3& query, std::size_t n)
+    {
+        auto inf = std::numeric_limits<float>::infinity();
+        dynarr<aabb_soa<float, 3, W>> groups((n + W - 1) / W);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            groups[i / W].set(i % W, make_box(i));
+        }
+        char label[64];
+
+        std::size_t hits = 0;
+        auto ns = bench::measure(reps, [&]
+        {
+            hits = 0;
+            for (auto& g : groups)
+            {
+                hits += std::popcount(gdt::batch::intersect(r, g, inf));
+            }
+            bench::escape(&hits);
+        });
+        std::snprintf(label, sizeof(label), "ray vs box (batch, W = %zu)", W);
+        bench::report(label, ns, double(n));
+
+        ns = bench::measure(reps, [&]
+        {
+            hits = 0;
+            for (auto& g : groups)
+            {
+                hits += std::popcount(gdt::batch::overlaps(query, g));
+            }
+            bench::escape(&hits);
+        });
+        std::snprintf(label, sizeof(label), "box vs box (batch, W = %zu)", W);
+        bench::report(label, ns, double(n));
+    }
+}
+
+int bench_ray(int argc, char** const argv)
+{
+    auto n = std::size_t(argc > 1 ? std::atoi(argv[1]) : 1'000'000);
+    n -= n % 8;
+
+    ray<float, 3> r(vec(-6.0f, 0.1f, 0.05f), vec(1.0f, 0.01f, -0.02f));
+    box3 query{vec(-1.0f, -0.2f, -0.3f), vec(1.0f, 0.2f, 0.3f)};
+    dynarr<box3> boxes;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        boxes.push_back(make_box(i));
+    }
+
+    // One box at a time.
+    std::size_t hits = 0;
+    auto ns = bench::measure(reps, [&]
+    {
+        hits = 0;
+        for (auto& b : boxes)
+        {
+            hits += intersect(r, b) != std::numeric_limits<float>::infinity();
+        }
+        bench::escape(&hits);
+    });
+    bench::report("ray vs box (loop)", ns, double(n));
+
+    ns = bench::measure(reps, [&]
+    {
+        hits = 0;
+        for (auto& b : boxes)
+        {
+            hits += overlaps(query, b);
+        }
+        bench::escape(&hits);
+    });
+    bench::report("box vs box (loop)", ns, double(n));
+
+    bench_batch<4>(r, query, n);
+    bench_batch<8>(r, query, n);
+
+    return 0;
+}
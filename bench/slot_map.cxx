@@ -0,0 +1,199 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/slot_map.hxx>
+
+#include "bench.hxx"
+#include <gdt/dynarr.hxx>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+using gdt::dynarr;
+using gdt::slot_map;
+
+namespace
+{
+    constexpr int reps = 5;
+
+    // Entity payload.
+    struct entity
+    {
+        float pos[3];
+        float vel[3];
+    };
+
+    // Handle.
+    using handle = gdt::slot_map_handle<>;
+
+    // Dynarr with tombstones and a free list, like we used to do it.
+    class tombstone_map
+    {
+    public:
+        handle insert(const entity& e)
+        {
+            std::uint32_t i;
+            if (!_free.empty())
+            {
+                i = _free.back();
+                _free.pop_back();
+                _slots[i].value = e;
+                _slots[i].alive = true;
+            }
+            else
+            {
+                i = std::uint32_t(_slots.size());
+                _slots.push_back({e, 0, true});
+            }
+            return {i, _slots[i].generation};
+        }
+
+        void erase(handle h)
+        {
+            auto& s = _slots[h.index()];
+            if (s.alive && s.generation == h.generation())
+            {
+                s.alive = false;
+                s.generation += 1;
+                _free.push_back(h.index());
+            }
+        }
+
+        entity& operator[](handle h)
+        {
+            return _slots[h.index()].value;
+        }
+
+        template<typename F>
+        void for_each(F&& f)
+        {
+            for (auto& s : _slots)
+            {
+                if (s.alive)
+                {
+                    f(s.value);
+                }
+            }
+        }
+
+    private:
+        struct slot
+        {
+            entity value;
+            std::uint32_t generation;
+            bool alive;
+        };
+
+        dynarr<slot> _slots;
+        dynarr<std::uint32_t> _free;
+    };
+
+    // Erase and insert `churn` entities per frame, then integrate them all.
+    template<typename Map, typename ForEach>
+    double run_frames(
+        std::size_t n,
+        std::size_t churn,
+        int frames,
+        ForEach&& for_each)
+    {
+        return bench::measure(reps, [&]
+        {
+            Map m;
+            dynarr<handle> handles;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                handles.push_back(m.insert(entity{{float(i)}, {1.0f}}));
+            }
+
+            std::uint64_t rng = 1;
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                for (std::size_t c = 0; c < churn; ++c)
+                {
+                    rng = rng * 6364136223846793005 + 1442695040888963407;
+                    auto j = std::size_t(rng >> 33) % n;
+                    m.erase(handles[j]);
+                    handles[j] = m.insert(entity{{float(c)}, {1.0f}});
+                }
+
+                for_each(m, [](entity& e)
+                {
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        e.pos[k] += e.vel[k] * (1.0f / 60.0f);
+                    }
+                });
+            }
+
+            bench::escape(&m[handles[0]]);
+        });
+    }
+
+    void bench_churn(std::size_t n, std::size_t churn, int frames)
+    {
+        auto items = double(n) * frames;
+
+        auto ns = run_frames<tombstone_map>(n, churn, frames,
+            [](tombstone_map& m, auto&& f) { m.for_each(f); });
+        bench::report("churn + iterate (dynarr, tombstones)", ns, items);
+
+        ns = run_frames<slot_map<entity>>(n, churn, frames,
+            [](slot_map<entity>& m, auto&& f)
+            {
+                for (auto& e : m)
+                {
+                    f(e);
+                }
+            });
+        bench::report("churn + iterate (slot_map)", ns, items);
+    }
+
+    // Fragment the tombstone map, then time iteration alone.
+    void bench_iterate_fragmented(std::size_t n)
+    {
+        tombstone_map t;
+        slot_map<entity> s;
+        dynarr<handle> th;
+        dynarr<handle> sh;
+        for (std::size_t i = 0; i < n * 2; ++i)
+        {
+            th.push_back(t.insert(entity{{float(i)}, {1.0f}}));
+            sh.push_back(s.insert(entity{{float(i)}, {1.0f}}));
+        }
+        for (std::size_t i = 0; i < n * 2; i += 2)
+        {
+            t.erase(th[i]);
+            s.erase(sh[i]);
+        }
+
+        auto ns = bench::measure(20, [&]
+        {
+            t.for_each([](entity& e) { e.pos[0] += e.vel[0]; });
+            bench::escape(&t[th[1]]);
+        });
+        bench::report("iterate half-erased (dynarr, tombstones)", ns, double(n));
+
+        ns = bench::measure(20, [&]
+        {
+            for (auto& e : s)
+            {
+                e.pos[0] += e.vel[0];
+            }
+            bench::escape(s.data());
+        });
+        bench::report("iterate half-erased (slot_map)", ns, double(n));
+    }
+}
+
+int bench_slot_map(int argc, char** const argv)
+{
+    auto n = std::size_t(argc > 1 ? std::atoi(argv[1]) : 100'000);
+
+    bench_churn(n, n / 100, 100);
+    bench_churn(n, n / 10, 100);
+    bench_iterate_fragmented(n);
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/small_dynarr.hxx>
+
+#include "bench.hxx"
+#include <gdt/dynarr.hxx>
+#include <cstdlib>
+
+using gdt::dynarr;
+using gdt::small_dynarr;
+
+namespace
+{
+    // Build `n` short per-entity lists and sum them back up.
+    template<typename List>
+    void bench_lists(const char* name, int n, int len)
+    {
+        auto ns = bench::measure(5, [&]
+        {
+            dynarr<List> lists(n);
+            for (int i = 0; i < n; ++i)
+            {
+                for (int j = 0; j < len; ++j)
+                {
+                    lists[i].push_back(i + j);
+                }
+            }
+
+            long long sum = 0;
+            for (auto& list : lists)
+            {
+                for (int x : list)
+                {
+                    sum += x;
+                }
+            }
+
+            bench::escape(&sum);
+            bench::escape(lists.data());
+        });
+        bench::report(name, ns, double(n) * len);
+    }
+}
+
+int bench_small_dynarr(int argc, char** const argv)
+{
+    int n = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+
+    bench_lists<dynarr<int>>("4-element lists (dynarr)", n / 4, 4);
+    bench_lists<small_dynarr<int, 8>>("4-element lists (small_dynarr<8>)", n / 4, 4);
+
+    bench_lists<dynarr<int>>("16-element lists (dynarr)", n / 16, 16);
+    bench_lists<small_dynarr<int, 8>>("16-element lists (small_dynarr<8>)", n / 16, 16);
+
+    return 0;
+}
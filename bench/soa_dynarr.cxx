@@ -0,0 +1,159 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/soa_dynarr.hxx>
+
+#include "bench.hxx"
+#include <gdt/dynarr.hxx>
+#include <gdt/vec.hxx>
+#include <cstddef>
+#include <cstdlib>
+
+using gdt::dynarr;
+using gdt::soa_dynarr;
+using gdt::vec3;
+
+namespace
+{
+    constexpr int reps = 20;
+    constexpr float dt = 1.0f / 60.0f;
+
+    // Particles as an array of structures.
+    struct aos_particles
+    {
+        dynarr<vec3<float>> pos;
+        dynarr<vec3<float>> vel;
+    };
+
+    // Particles as a structure of arrays.
+    struct soa_particles
+    {
+        soa_dynarr<vec3<float>> pos;
+        soa_dynarr<vec3<float>> vel;
+    };
+
+    template<typename Particles>
+    Particles make_particles(std::size_t n)
+    {
+        Particles p;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto f = float(i % 1000);
+            p.pos.push_back(vec3<float>(f, f + 1.0f, f + 2.0f));
+            p.vel.push_back(vec3<float>(1.0f, -f, 0.5f));
+        }
+        return p;
+    }
+
+    // pos += vel * dt.
+    void bench_integrate(std::size_t n)
+    {
+        auto aos = make_particles<aos_particles>(n);
+        auto ns = bench::measure(reps, [&]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                aos.pos[i] = aos.pos[i] + aos.vel[i] * dt;
+            }
+            bench::escape(aos.pos.data());
+        });
+        bench::report("integrate (AoS dynarr)", ns, double(n));
+
+        auto soa = make_particles<soa_particles>(n);
+        ns = bench::measure(reps, [&]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                soa.pos[i] += soa.vel[i] * dt;
+            }
+            bench::escape(soa.pos.lane(0).data());
+        });
+        bench::report("integrate (soa_dynarr, references)", ns, double(n));
+
+        ns = bench::measure(reps, [&]
+        {
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                auto p = soa.pos.lane(k);
+                auto v = soa.vel.lane(k);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    p[i] += v[i] * dt;
+                }
+            }
+            bench::escape(soa.pos.lane(0).data());
+        });
+        bench::report("integrate (soa_dynarr, lanes)", ns, double(n));
+    }
+
+    // out = length_squared(vel).
+    void bench_length_squared(std::size_t n)
+    {
+        dynarr<float> out(n);
+
+        auto aos = make_particles<aos_particles>(n);
+        auto ns = bench::measure(reps, [&]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                auto v = aos.vel[i];
+                out[i] = v.x() * v.x() + v.y() * v.y() + v.z() * v.z();
+            }
+            bench::escape(out.data());
+        });
+        bench::report("length squared (AoS dynarr)", ns, double(n));
+
+        auto soa = make_particles<soa_particles>(n);
+        ns = bench::measure(reps, [&]
+        {
+            auto x = soa.vel.lane(0);
+            auto y = soa.vel.lane(1);
+            auto z = soa.vel.lane(2);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+            }
+            bench::escape(out.data());
+        });
+        bench::report("length squared (soa_dynarr, lanes)", ns, double(n));
+    }
+
+    // Build by pushing back.
+    void bench_push_back(std::size_t n)
+    {
+        auto ns = bench::measure(reps, [&]
+        {
+            dynarr<vec3<float>> a;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                a.push_back(vec3<float>(float(i)));
+            }
+            bench::escape(a.data());
+        });
+        bench::report("push_back (AoS dynarr)", ns, double(n));
+
+        ns = bench::measure(reps, [&]
+        {
+            soa_dynarr<vec3<float>> a;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                a.push_back(vec3<float>(float(i)));
+            }
+            bench::escape(a.lane(0).data());
+        });
+        bench::report("push_back (soa_dynarr)", ns, double(n));
+    }
+}
+
+int bench_soa_dynarr(int argc, char** const argv)
+{
+    auto n = std::size_t(argc > 1 ? std::atoi(argv[1]) : 1'000'000);
+
+    bench_integrate(n);
+    bench_length_squared(n);
+    bench_push_back(n);
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/spsc_queue.hxx>
+
+#include "bench.hxx"
+#include <gdt/dynarr.hxx>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+
+using gdt::dynarr;
+using gdt::spsc_queue;
+
+namespace
+{
+    constexpr int reps = 5;
+    constexpr std::size_t capacity = 4096;
+    constexpr std::size_t batch = 64;
+
+    // Mutex-guarded dynarr, like we used to do it.
+    // The consumer swaps out everything queued so far.
+    struct locked_dynarr
+    {
+        std::mutex mutex;
+        dynarr<std::uint64_t> items;
+    };
+
+    // Stream `n` values from one thread to another through a locked dynarr.
+    double stream_locked(std::uint64_t n)
+    {
+        return bench::measure(reps, [&]
+        {
+            locked_dynarr q;
+            std::thread producer([&]
+            {
+                for (std::uint64_t i = 0; i < n; ++i)
+                {
+                    std::lock_guard lock(q.mutex);
+                    q.items.push_back(i);
+                }
+            });
+
+            dynarr<std::uint64_t> local;
+            std::uint64_t received = 0;
+            std::uint64_t sum = 0;
+            while (received < n)
+            {
+                {
+                    std::lock_guard lock(q.mutex);
+                    local.swap(q.items);
+                }
+
+                if (local.empty())
+                {
+                    std::this_thread::yield();
+                }
+
+                for (auto v : local)
+                {
+                    sum += v;
+                }
+                received += local.size();
+                local.clear();
+            }
+
+            producer.join();
+            bench::keep(sum);
+        });
+    }
+
+    // Stream `n` values one at a time.
+    double stream_single(std::uint64_t n)
+    {
+        return bench::measure(reps, [&]
+        {
+            spsc_queue<std::uint64_t> q(capacity);
+            std::thread producer([&]
+            {
+                for (std::uint64_t i = 0; i < n;)
+                {
+                    if (q.try_push(i))
+                    {
+                        ++i;
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+
+            std::uint64_t sum = 0;
+            std::uint64_t v;
+            for (std::uint64_t received = 0; received < n;)
+            {
+                if (q.try_pop(v))
+                {
+                    sum += v;
+                    ++received;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            producer.join();
+            bench::keep(sum);
+        });
+    }
+
+    // Stream `n` values in batches.
+    double stream_batched(std::uint64_t n)
+    {
+        return bench::measure(reps, [&]
+        {
+            spsc_queue<std::uint64_t> q(capacity);
+            std::thread producer([&]
+            {
+                std::uint64_t values[batch];
+                for (std::uint64_t i = 0; i < n;)
+                {
+                    std::size_t count = 0;
+                    for (; count < batch && i + count < n; ++count)
+                    {
+                        values[count] = i + count;
+                    }
+
+                    auto pushed = q.try_push_batch(std::span(values, count));
+                    if (pushed == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                    i += pushed;
+                }
+            });
+
+            std::uint64_t sum = 0;
+            std::uint64_t values[batch];
+            for (std::uint64_t received = 0; received < n;)
+            {
+                auto popped = q.try_pop_batch(values);
+                if (popped == 0)
+                {
+                    std::this_thread::yield();
+                }
+
+                for (std::size_t i = 0; i < popped; ++i)
+                {
+                    sum += values[i];
+                }
+                received += popped;
+            }
+
+            producer.join();
+            bench::keep(sum);
+        });
+    }
+
+    // Bounce a value between two threads `n` times.
+    double ping_pong(std::uint64_t n)
+    {
+        return bench::measure(reps, [&]
+        {
+            spsc_queue<std::uint64_t> ping(16);
+            spsc_queue<std::uint64_t> pong(16);
+
+            std::thread echo([&]
+            {
+                std::uint64_t v;
+                for (std::uint64_t i = 0; i < n; ++i)
+                {
+                    while (!ping.try_pop(v))
+                    {
+                        std::this_thread::yield();
+                    }
+                    pong.try_push(v + 1);
+                }
+            });
+
+            std::uint64_t v = 0;
+            for (std::uint64_t i = 0; i < n; ++i)
+            {
+                ping.try_push(v);
+                while (!pong.try_pop(v))
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            echo.join();
+            bench::keep(v);
+        });
+    }
+}
+
+int bench_spsc_queue(int argc, char** const argv)
+{
+    auto n = std::uint64_t(argc > 1 ? std::atoi(argv[1]) : 10'000'000);
+
+    bench::report("throughput (mutex + dynarr)", stream_locked(n), double(n));
+    bench::report("throughput (spsc_queue)", stream_single(n), double(n));
+    bench::report("throughput (spsc_queue, batches)", stream_batched(n), double(n));
+
+    auto trips = n / 100;
+    bench::report("round trip latency (spsc_queue)", ping_pong(trips), double(trips));
+
+    return 0;
+}
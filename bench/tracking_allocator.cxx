@@ -0,0 +1,54 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/tracking_allocator.hxx>
+
+#include "bench.hxx"
+#include <gdt/allocator.hxx>
+#include <gdt/dynarr.hxx>
+#include <cstdio>
+#include <cstdlib>
+
+using gdt::dynarr;
+using gdt::tracking_allocator;
+
+namespace
+{
+    // Build and destroy `lists` short dynarrs.
+    template<typename Allocator>
+    void bench_lists(const char* name, int lists, int len)
+    {
+        auto ns = bench::measure(5, [&]
+        {
+            for (int i = 0; i < lists; ++i)
+            {
+                dynarr<int, Allocator> a;
+                for (int j = 0; j < len; ++j)
+                {
+                    a.push_back(j);
+                }
+
+                bench::escape(a.data());
+            }
+        });
+        bench::report(name, ns, lists);
+    }
+}
+
+int bench_tracking_allocator(int argc, char** const argv)
+{
+    int n = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+
+    using tracked = tracking_allocator<gdt::allocator<int>>;
+    bench_lists<gdt::allocator<int>>("dynarr lists (gdt::allocator)", n / 10, 40);
+    bench_lists<tracked>("dynarr lists (tracking_allocator)", n / 10, 40);
+
+    auto& stats = tracked::stats();
+    std::printf(
+        "  %zu allocations, %zu reallocations, %zu bytes peak\n",
+        stats.allocations(), stats.reallocations(), stats.peak_bytes());
+
+    return 0;
+}
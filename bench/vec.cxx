@@ -0,0 +1,359 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/vec.hxx>
+
+#include "bench.hxx"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using gdt::vec;
+
+namespace
+{
+    // Component-wise loops, as vec was before SIMD.
+    template<typename T, std::size_t N>
+    struct scalar_vec
+    {
+        T data[N];
+
+        explicit scalar_vec(const vec<T, N>& v)
+        {
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                data[i] = v[i];
+            }
+        }
+
+        scalar_vec() = default;
+
+        #define gdt(op)\
+        friend auto operator op(const scalar_vec& lhs, const scalar_vec& rhs)\
+        {\
+            scalar_vec<decltype(lhs.data[0] op rhs.data[0]), N> ret;\
+            for (std::size_t i = 0; i < N; ++i)\
+            {\
+                ret.data[i] = lhs.data[i] op rhs.data[i];\
+            }\
+            return ret;\
+        }\
+        friend auto operator op(const scalar_vec& lhs, const T& rhs)\
+        {\
+            scalar_vec<decltype(lhs.data[0] op rhs), N> ret;\
+            for (std::size_t i = 0; i < N; ++i)\
+            {\
+                ret.data[i] = lhs.data[i] op rhs;\
+            }\
+            return ret;\
+        }
+        gdt(+)
+        gdt(-)
+        gdt(*)
+        gdt(/)
+        gdt(&)
+        gdt(<<)
+        gdt(<)
+        gdt(==)
+        #undef gdt
+
+        friend scalar_vec operator-(const scalar_vec& v)
+        {
+            scalar_vec ret;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                ret.data[i] = -v.data[i];
+            }
+            return ret;
+        }
+    };
+
+    // Apply `f` to `n` pairs of vectors `reps` times.
+    template<typename V, typename F>
+    void bench_op(
+        const char* type,
+        const char* name,
+        const std::vector<V>& a,
+        const std::vector<V>& b,
+        F f)
+    {
+        using R = decltype(f(a[0], b[0]));
+        std::vector<R> out(a.size());
+        constexpr int reps = 100;
+        auto ns = bench::measure(5, [&]
+        {
+            for (int r = 0; r < reps; ++r)
+            {
+                for (std::size_t i = 0; i < a.size(); ++i)
+                {
+                    out[i] = f(a[i], b[i]);
+                }
+
+                bench::escape(out.data());
+            }
+        });
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s %s", type, name);
+        bench::report(label, ns, double(a.size()) * reps);
+    }
+
+    // Fold `n` vectors into a dependent chain `reps` times.
+    template<typename V>
+    void bench_chain(const char* type, const char* name, const std::vector<V>& a)
+    {
+        constexpr int reps = 100;
+        auto out = a[0];
+        auto ns = bench::measure(5, [&]
+        {
+            for (int r = 0; r < reps; ++r)
+            {
+                auto acc = a[0];
+                for (std::size_t i = 1; i < a.size(); ++i)
+                {
+                    acc = acc * a[i] - -acc;
+                }
+
+                out = acc;
+                bench::escape(&out);
+            }
+        });
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s %s", type, name);
+        bench::report(label, ns, double(a.size()) * reps);
+    }
+
+    // Benchmark one operator for gdt::vec and the scalar loop.
+    #define gdt_bench(type, name, expr)\
+    bench_op(type, name, va, vb,\
+        [](const auto& a, [[maybe_unused]] const auto& b) { return expr; });\
+    bench_op(type, name " (scalar)", sa, sb,\
+        [](const auto& a, [[maybe_unused]] const auto& b) { return expr; });
+
+    // Benchmark float operators for `N` components.
+    template<std::size_t N>
+    void bench_float(const char* type, std::size_t n)
+    {
+        std::vector<vec<float, N>> va(n);
+        std::vector<vec<float, N>> vb(n);
+        std::vector<scalar_vec<float, N>> sa(n);
+        std::vector<scalar_vec<float, N>> sb(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            va[i] = vec<float, N>(float(i % 100) + 1.0f);
+            vb[i] = vec<float, N>(float(i % 7) + 0.5f);
+            sa[i] = scalar_vec<float, N>(va[i]);
+            sb[i] = scalar_vec<float, N>(vb[i]);
+        }
+
+        gdt_bench(type, "a + b", a + b)
+        gdt_bench(type, "a - b", a - b)
+        gdt_bench(type, "a * b", a * b)
+        gdt_bench(type, "a / b", a / b)
+        gdt_bench(type, "a * 2", a * 2.0f)
+        gdt_bench(type, "-a", -a)
+        gdt_bench(type, "a < b", a < b)
+        gdt_bench(type, "a == b", a == b)
+        bench_chain(type, "chain", va);
+        bench_chain(type, "chain (scalar)", sa);
+    }
+
+    // Benchmark int32 operators.
+    void bench_int(const char* type, std::size_t n)
+    {
+        std::vector<vec<std::int32_t, 4>> va(n);
+        std::vector<vec<std::int32_t, 4>> vb(n);
+        std::vector<scalar_vec<std::int32_t, 4>> sa(n);
+        std::vector<scalar_vec<std::int32_t, 4>> sb(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            va[i] = vec<std::int32_t, 4>(std::int32_t(i % 1000));
+            vb[i] = vec<std::int32_t, 4>(std::int32_t(i % 7));
+            sa[i] = scalar_vec<std::int32_t, 4>(va[i]);
+            sb[i] = scalar_vec<std::int32_t, 4>(vb[i]);
+        }
+
+        gdt_bench(type, "a + b", a + b)
+        gdt_bench(type, "a * b", a * b)
+        gdt_bench(type, "a & b", a & b)
+        gdt_bench(type, "a << b", a << b)
+        gdt_bench(type, "-a", -a)
+        gdt_bench(type, "a < b", a < b)
+    }
+
+    #undef gdt_bench
+
+    // Components `I...` of `v` one at a time, as the named swizzles were
+    // before `vec::swizzle`.
+    template<std::size_t... I, typename T, std::size_t N>
+    vec<T, sizeof...(I)> componentwise(const vec<T, N>& v)
+    {
+        return {v[I]...};
+    }
+
+    // Benchmark swizzles of 4 components of `T`.
+    template<typename T>
+    void bench_swizzle(const char* type, std::size_t n)
+    {
+        std::vector<vec<T, 4>> va(n);
+        std::vector<vec<T, 4>> vb(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            va[i] = vec<T, 4>(T(i % 100 + 1), T(i % 7), T(i % 13), T(3));
+            vb[i] = vec<T, 4>(T(i % 5 + 2), T(i % 11), T(1), T(i % 3));
+        }
+
+        bench_op(type, "a.wzyx()", va, vb,
+            [](const auto& a, const auto&) { return a.wzyx(); });
+        bench_op(type, "a.wzyx() (componentwise)", va, vb,
+            [](const auto& a, const auto&)
+            {
+                return componentwise<3, 2, 1, 0>(a);
+            });
+        bench_op(type, "a.xxxx() * b", va, vb,
+            [](const auto& a, const auto& b) { return a.xxxx() * b; });
+        bench_op(type, "a.xxxx() * b (componentwise)", va, vb,
+            [](const auto& a, const auto& b)
+            {
+                return componentwise<0, 0, 0, 0>(a) * b;
+            });
+        bench_op(type, "cross", va, vb,
+            [](const auto& a, const auto& b)
+            {
+                return a.yzxw() * b.zxyw() - a.zxyw() * b.yzxw();
+            });
+        bench_op(type, "cross (componentwise)", va, vb,
+            [](const auto& a, const auto& b)
+            {
+                return
+                    componentwise<1, 2, 0, 3>(a) *
+                    componentwise<2, 0, 1, 3>(b) -
+                    componentwise<2, 0, 1, 3>(a) *
+                    componentwise<1, 2, 0, 3>(b);
+            });
+        bench_op(type, "a.set_yzwx(b)", va, vb,
+            [](auto a, const auto& b)
+            {
+                a.set_yzwx(b);
+                return a;
+            });
+        bench_op(type, "a.set_yzwx(b) (componentwise)", va, vb,
+            [](auto a, const auto& b)
+            {
+                a.y() = b[0];
+                a.z() = b[1];
+                a.w() = b[2];
+                a.x() = b[3];
+                return a;
+            });
+    }
+
+    // Sequential dot product, as hand-rolled before `gdt::dot`.
+    template<std::size_t N>
+    float naive_dot(const vec<float, N>& a, const vec<float, N>& b)
+    {
+        float ret = 0.0f;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            ret += a[i] * b[i];
+        }
+        return ret;
+    }
+
+    // Largest error of `f(v)` in units of the last place of a unit vector,
+    // measured against a double-precision reference.
+    template<std::size_t N, typename F>
+    void report_accuracy(
+        const char* type,
+        const char* name,
+        const std::vector<vec<float, N>>& v,
+        F f)
+    {
+        double worst = 0.0;
+        for (const auto& x : v)
+        {
+            double len = 0.0;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                len += double(x[i]) * double(x[i]);
+            }
+            len = std::sqrt(len);
+
+            auto y = f(x);
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                worst = (std::max)(worst, std::fabs(y[i] - x[i] / len));
+            }
+        }
+
+        // One ulp of values in [0.5, 1) is 2^-24.
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s %s error", type, name);
+        std::printf("%-48s %12.2f ulp (max)\n", label, worst * 16777216.0);
+    }
+
+    // Benchmark geometric functions for `N` components.
+    template<std::size_t N>
+    void bench_geometric(const char* type, std::size_t n)
+    {
+        std::vector<vec<float, N>> va(n);
+        std::vector<vec<float, N>> vb(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                va[i][k] = float((i * 7 + k * 13) % 97) - 48.5f;
+                vb[i][k] = float((i * 11 + k * 5) % 89) * 0.25f + 0.5f;
+            }
+        }
+
+        auto naive_normalize = [](const auto& a, const auto&)
+        {
+            return a / std::sqrt(naive_dot(a, a));
+        };
+
+        bench_op(type, "dot", va, vb,
+            [](const auto& a, const auto& b) { return dot(a, b); });
+        bench_op(type, "dot (hand-rolled)", va, vb,
+            [](const auto& a, const auto& b) { return naive_dot(a, b); });
+        bench_op(type, "length", va, vb,
+            [](const auto& a, const auto&) { return length(a); });
+        bench_op(type, "normalize", va, vb,
+            [](const auto& a, const auto&) { return normalize(a); });
+        bench_op(type, "normalize (hand-rolled)", va, vb, naive_normalize);
+        bench_op(type, "fast_normalize", va, vb,
+            [](const auto& a, const auto&) { return fast_normalize(a); });
+        bench_op(type, "reflect", va, vb,
+            [](const auto& a, const auto& b) { return reflect(a, b); });
+        if constexpr (N == 3)
+        {
+            bench_op(type, "cross", va, vb,
+                [](const auto& a, const auto& b) { return cross(a, b); });
+        }
+
+        report_accuracy(type, "normalize", va,
+            [](const auto& a) { return normalize(a); });
+        report_accuracy(type, "fast_normalize", va,
+            [](const auto& a) { return fast_normalize(a); });
+    }
+}
+
+int bench_vec(int argc, char** const argv)
+{
+    auto n = std::size_t(argc > 1 ? std::atoi(argv[1]) : 4096);
+
+    bench_float<4>("vec4<float>", n);
+    bench_float<3>("vec3<float>", n);
+    bench_int("vec4<int32_t>", n);
+    bench_swizzle<float>("vec4<float>", n);
+    bench_swizzle<std::int32_t>("vec4<int32_t>", n);
+    bench_geometric<4>("vec4<float>", n);
+    bench_geometric<3>("vec3<float>", n);
+
+    return 0;
+}
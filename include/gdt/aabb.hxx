@@ -0,0 +1,288 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/aabb_simd.hxx"
+#include "assume.hxx"
+#include "vec.hxx"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace gdt_detail
+{
+    using namespace gdt;
+
+    // Component-wise minimum.
+    // Unrolled so boxes merged in a loop can stay in registers.
+    template<typename T, std::size_t N>
+    constexpr vec<T, N> component_min(const vec<T, N>& a, const vec<T, N>& b)
+    {
+        vec<T, N> ret;
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            ((ret[I] = b[I] < a[I] ? b[I] : a[I]), ...);
+        }(std::make_index_sequence<N>());
+        return ret;
+    }
+
+    // Component-wise maximum.
+    // Unrolled so boxes merged in a loop can stay in registers.
+    template<typename T, std::size_t N>
+    constexpr vec<T, N> component_max(const vec<T, N>& a, const vec<T, N>& b)
+    {
+        vec<T, N> ret;
+        [&]<std::size_t... I>(std::index_sequence<I...>)
+        {
+            ((ret[I] = a[I] < b[I] ? b[I] : a[I]), ...);
+        }(std::make_index_sequence<N>());
+        return ret;
+    }
+}
+
+namespace gdt
+{
+    // Axis-aligned bounding box.
+    // Closed, so it contains points on its boundary. Empty when any lower
+    // component is greater than the matching upper one.
+    template<typename T, std::size_t N>
+    struct aabb
+    {
+    public:
+        // Constructor.
+        constexpr aabb() = default;
+
+        // Constructor.
+        constexpr aabb(const vec<T, N>& lower, const vec<T, N>& upper)
+        :
+            _lower{lower},
+            _upper{upper}
+        {}
+
+        // Constructor.
+        // Just one point.
+        explicit constexpr aabb(const vec<T, N>& point)
+        :
+            _lower{point},
+            _upper{point}
+        {}
+
+        // Empty box.
+        // Merging it with anything gives the other thing.
+        static constexpr aabb empty()
+        {
+            return {
+                vec<T, N>(std::numeric_limits<T>::max()),
+                vec<T, N>(std::numeric_limits<T>::lowest())};
+        }
+
+        // Lower corner.
+        constexpr vec<T, N>& lower()
+        {
+            return _lower;
+        }
+
+        // Lower corner.
+        constexpr const vec<T, N>& lower() const
+        {
+            return _lower;
+        }
+
+        // Upper corner.
+        constexpr vec<T, N>& upper()
+        {
+            return _upper;
+        }
+
+        // Upper corner.
+        constexpr const vec<T, N>& upper() const
+        {
+            return _upper;
+        }
+
+        // Is empty.
+        constexpr bool is_empty() const
+        {
+            return any(_upper < _lower);
+        }
+
+        // Center.
+        constexpr vec<T, N> center() const
+        {
+            return (_lower + _upper) / T(2);
+        }
+
+        // Size along each axis.
+        constexpr vec<T, N> size() const
+        {
+            return _upper - _lower;
+        }
+
+        // Equality.
+        friend constexpr bool operator==(const aabb& lhs, const aabb& rhs)
+        {
+            return
+                all(lhs._lower == rhs._lower) &&
+                all(lhs._upper == rhs._upper);
+        }
+
+    private:
+        // Member variables.
+        vec<T, N> _lower;
+        vec<T, N> _upper;
+    };
+
+    // Smallest box containing both `a` and `b`.
+    template<typename T, std::size_t N>
+    constexpr aabb<T, N> merge(const aabb<T, N>& a, const aabb<T, N>& b)
+    {
+        return {
+            gdt_detail::component_min(a.lower(), b.lower()),
+            gdt_detail::component_max(a.upper(), b.upper())};
+    }
+
+    // Smallest box containing both `a` and `point`.
+    template<typename T, std::size_t N>
+    constexpr aabb<T, N> merge(const aabb<T, N>& a, const vec<T, N>& point)
+    {
+        return {
+            gdt_detail::component_min(a.lower(), point),
+            gdt_detail::component_max(a.upper(), point)};
+    }
+
+    // Box contained by both `a` and `b`, which is empty if they don't
+    // overlap.
+    template<typename T, std::size_t N>
+    constexpr aabb<T, N> intersect(const aabb<T, N>& a, const aabb<T, N>& b)
+    {
+        return {
+            gdt_detail::component_max(a.lower(), b.lower()),
+            gdt_detail::component_min(a.upper(), b.upper())};
+    }
+
+    // `a` and `b` share at least one point.
+    template<typename T, std::size_t N>
+    constexpr bool overlaps(const aabb<T, N>& a, const aabb<T, N>& b)
+    {
+        return all(a.lower() <= b.upper()) && all(b.lower() <= a.upper());
+    }
+
+    // `a` contains `point`.
+    template<typename T, std::size_t N>
+    constexpr bool contains(const aabb<T, N>& a, const vec<T, N>& point)
+    {
+        return all(a.lower() <= point) && all(point <= a.upper());
+    }
+
+    // `a` contains every point in `b`.
+    template<typename T, std::size_t N>
+    constexpr bool contains(const aabb<T, N>& a, const aabb<T, N>& b)
+    {
+        return all(a.lower() <= b.lower()) && all(b.upper() <= a.upper());
+    }
+
+    // `W` boxes in structure-of-arrays form, for testing against several at
+    // once.
+    template<typename T, std::size_t N, std::size_t W>
+    struct aabb_soa
+    {
+    public:
+        // Constructor.
+        constexpr aabb_soa() = default;
+
+        // All empty boxes.
+        static constexpr aabb_soa empty()
+        {
+            aabb_soa ret;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                ret._lower[i] = vec<T, W>(std::numeric_limits<T>::max());
+                ret._upper[i] = vec<T, W>(std::numeric_limits<T>::lowest());
+            }
+            return ret;
+        }
+
+        // Box `i`.
+        constexpr aabb<T, N> get(std::size_t i) const
+        {
+            gdt_assume(i < W);
+            aabb<T, N> ret;
+            for (std::size_t axis = 0; axis < N; ++axis)
+            {
+                ret.lower()[axis] = _lower[axis][i];
+                ret.upper()[axis] = _upper[axis][i];
+            }
+            return ret;
+        }
+
+        // Set box `i`.
+        constexpr void set(std::size_t i, const aabb<T, N>& box)
+        {
+            gdt_assume(i < W);
+            for (std::size_t axis = 0; axis < N; ++axis)
+            {
+                _lower[axis][i] = box.lower()[axis];
+                _upper[axis][i] = box.upper()[axis];
+            }
+        }
+
+        // Lower bounds of every box along `axis`.
+        constexpr const vec<T, W>& lower(std::size_t axis) const
+        {
+            gdt_assume(axis < N);
+            return _lower[axis];
+        }
+
+        // Upper bounds of every box along `axis`.
+        constexpr const vec<T, W>& upper(std::size_t axis) const
+        {
+            gdt_assume(axis < N);
+            return _upper[axis];
+        }
+
+    private:
+        // Member variables.
+        vec<T, W> _lower[N];
+        vec<T, W> _upper[N];
+    };
+}
+
+namespace gdt::batch
+{
+    // Overlaps.
+    // Bit `i` is set if `box` overlaps `boxes.get(i)`.
+    template<typename T, std::size_t N, std::size_t W>
+    constexpr std::uint32_t overlaps(
+        const aabb<T, N>& box,
+        const aabb_soa<T, N, W>& boxes)
+    {
+        static_assert(W <= 32);
+        if constexpr (gdt_detail::simd_aabb<T, W>::enabled)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                return gdt_detail::simd_aabb<T, W>::template overlaps<N>(
+                    std::addressof(boxes.lower(0)[0]),
+                    std::addressof(boxes.upper(0)[0]),
+                    std::addressof(box.lower()[0]),
+                    std::addressof(box.upper()[0]));
+            }
+        }
+
+        std::uint32_t ret = 0;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            if (overlaps(box, boxes.get(i)))
+            {
+                ret |= std::uint32_t(1) << i;
+            }
+        }
+        return ret;
+    }
+}
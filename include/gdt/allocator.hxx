@@ -6,14 +6,73 @@
 #pragma once
 
 #include "assert.hxx"
+#include "trivially_relocatable.hxx"
 #include <algorithm>
 #include <climits>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <limits>
 #include <memory>
 #include <new>
 #include <type_traits>
 
+namespace gdt
+{
+    // Allocation result.
+    // Like C++23's `std::allocation_result`.
+    template<typename Pointer, typename SizeT = std::size_t>
+    struct allocation_result
+    {
+        Pointer ptr;
+        SizeT count;
+    };
+}
+
+namespace gdt_detail
+{
+    // Allocator can allocate more than requested
+    // and report how much it actually allocated.
+    template<typename Allocator>
+    concept has_allocate_at_least = requires (
+        Allocator& a,
+        typename std::allocator_traits<Allocator>::size_type n)
+    {
+        {
+            a.allocate_at_least(n).ptr
+        } -> std::convertible_to<
+            typename std::allocator_traits<Allocator>::pointer>;
+        {
+            a.allocate_at_least(n).count
+        } -> std::convertible_to<
+            typename std::allocator_traits<Allocator>::size_type>;
+    };
+
+    // Allocator can resize a buffer in place.
+    template<typename Allocator>
+    concept has_try_expand = requires (
+        Allocator& a,
+        typename std::allocator_traits<Allocator>::pointer p,
+        typename std::allocator_traits<Allocator>::size_type n)
+    {
+        { a.try_expand(p, n, n) } -> std::same_as<bool>;
+    };
+
+    // Allocator can move a buffer of trivially
+    // relocatable elements to one with a new size.
+    template<typename Allocator>
+    concept has_reallocate = requires (
+        Allocator& a,
+        typename std::allocator_traits<Allocator>::pointer p,
+        typename std::allocator_traits<Allocator>::size_type n)
+    {
+        {
+            a.reallocate(p, n, n)
+        } -> std::same_as<typename std::allocator_traits<Allocator>::pointer>;
+    };
+}
+
 namespace gdt
 {
     // Allocator.
@@ -40,8 +99,8 @@ namespace gdt
         constexpr allocator(const allocator&) noexcept {}
 
         // Constructor.
-        template<typename U>
-        constexpr allocator(const allocator<U>&) noexcept {}
+        template<typename U, typename USizeT, typename UDiffT>
+        constexpr allocator(const allocator<U, USizeT, UDiffT>&) noexcept {}
 
         // Destructor.
         constexpr ~allocator() {}
@@ -77,7 +136,13 @@ namespace gdt
             }
 
             void* p;
-            if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            if constexpr (_uses_malloc)
+            {
+                // Objects can't be larger than PTRDIFF_MAX.
+                gdt_assert(size <= std::size_t(PTRDIFF_MAX));
+                p = std::malloc(size);
+            }
+            else if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
             {
                 auto align = std::align_val_t(alignof(T));
                 p = ::operator new(size, align, std::nothrow_t());
@@ -98,6 +163,10 @@ namespace gdt
             {
                 std::allocator<T>().deallocate(p, std::size_t(n));
             }
+            else if constexpr (_uses_malloc)
+            {
+                std::free(static_cast<void*>(p));
+            }
             else if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
             {
                 auto align = std::align_val_t(alignof(T));
@@ -109,6 +178,24 @@ namespace gdt
             }
         }
 
+        // Reallocate.
+        // Moves `old_n` trivially relocatable elements to a buffer with
+        // room for `new_n`, in place if possible. Not constexpr.
+        [[nodiscard]] T* reallocate(T* p, size_type old_n, size_type new_n)
+        requires _uses_malloc
+        {
+            gdt_assert(new_n <= max_size());
+            static_cast<void>(old_n);
+
+            // Objects can't be larger than PTRDIFF_MAX.
+            auto size = std::size_t(sizeof(T) * new_n);
+            gdt_assert(size <= std::size_t(PTRDIFF_MAX));
+            auto new_p = std::realloc(static_cast<void*>(p), size);
+
+            gdt_assert(new_p != nullptr);
+            return static_cast<T*>(new_p);
+        }
+
         // Equality.
         template<typename U>
         friend constexpr bool operator==(const allocator&, const allocator<U>&)
@@ -116,5 +203,17 @@ namespace gdt
         {
             return true;
         }
+
+    private:
+        // Use malloc/realloc/free instead of `::operator new/delete` so
+        // trivially relocatable elements can be moved with realloc.
+        static constexpr bool _uses_malloc =
+            is_trivially_relocatable_v<T> &&
+            alignof(T) <= alignof(std::max_align_t);
     };
+
+    // Allocator is trivially relocatable.
+    template<typename T, typename SizeT, typename DiffT>
+    struct is_trivially_relocatable<allocator<T, SizeT, DiffT>> :
+        std::true_type {};
 }
@@ -0,0 +1,333 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "assert.hxx"
+#include "assume.hxx"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+
+namespace gdt
+{
+    // Arena.
+    // Bump allocator over a list of blocks. Individual allocations
+    // aren't freed (unless they're the most recent one); everything
+    // is freed at once by `reset` or by rewinding to a marker.
+    class arena
+    {
+        // Block header.
+        struct _block
+        {
+            _block* next;
+            std::uintptr_t begin;
+            std::uintptr_t end;
+        };
+
+    public:
+        // Marker.
+        // Position to rewind back to.
+        class marker
+        {
+        public:
+            // Constructor.
+            marker() = default;
+
+        private:
+            // Friends.
+            friend arena;
+
+            // Member variables.
+            _block* _blk;
+            std::uintptr_t _top;
+
+            // Constructor.
+            constexpr marker(_block* blk, std::uintptr_t top) noexcept
+            :
+                _blk{blk},
+                _top{top}
+            {}
+        };
+
+        // Default block size.
+        static constexpr std::size_t default_block_size = 64 * 1024;
+
+        // Constructor.
+        // Owns all its blocks.
+        explicit arena(std::size_t block_size = default_block_size) noexcept
+        :
+            arena(nullptr, 0, block_size)
+        {}
+
+        // Constructor.
+        // Uses `buffer` first, then falls back to blocks it owns.
+        arena(
+            void* buffer,
+            std::size_t buffer_size,
+            std::size_t block_size = default_block_size)
+        noexcept
+        :
+            _first{nullptr, 0, 0},
+            _blk{&_first},
+            _top{0},
+            _block_size{block_size}
+        {
+            gdt_assert(block_size > 0);
+
+            if (buffer != nullptr)
+            {
+                _first.begin = reinterpret_cast<std::uintptr_t>(buffer);
+                _first.end = _first.begin + buffer_size;
+                _top = _first.begin;
+            }
+        }
+
+        // Constructor.
+        arena(const arena&) = delete;
+
+        // Destructor.
+        ~arena()
+        {
+            auto blk = _first.next;
+            while (blk != nullptr)
+            {
+                auto next = blk->next;
+                std::free(static_cast<void*>(blk));
+                blk = next;
+            }
+        }
+
+        // Assignment.
+        arena& operator=(const arena&) = delete;
+
+        // Allocate.
+        // `align` must be a power of two.
+        [[nodiscard]] void* allocate(std::size_t size, std::size_t align)
+        {
+            gdt_assume(align != 0 && (align & (align - 1)) == 0);
+
+            auto p = _align_up(_top, align);
+            if (p < _top || p > _blk->end || size > _blk->end - p)
+            {
+                _next_block(size, align);
+                p = _align_up(_top, align);
+            }
+
+            _top = p + size;
+            return reinterpret_cast<void*>(p);
+        }
+
+        // Deallocate.
+        // Only gives the memory back if it was the most recent allocation.
+        void deallocate(void* p, std::size_t size) noexcept
+        {
+            auto addr = reinterpret_cast<std::uintptr_t>(p);
+            if (addr + size == _top && addr >= _blk->begin)
+            {
+                _top = addr;
+            }
+        }
+
+        // Try expand.
+        // Resizes the most recent allocation in place if there's room.
+        bool try_expand(void* p, std::size_t old_size, std::size_t new_size)
+        noexcept
+        {
+            auto addr = reinterpret_cast<std::uintptr_t>(p);
+            if (addr + old_size != _top || addr < _blk->begin)
+            {
+                return false;
+            }
+
+            if (new_size > _blk->end - addr)
+            {
+                return false;
+            }
+
+            _top = addr + new_size;
+            return true;
+        }
+
+        // Mark.
+        marker mark() const noexcept
+        {
+            return marker(_blk, _top);
+        }
+
+        // Rewind.
+        // Frees everything allocated since `m` was made. O(1).
+        void rewind(marker m) noexcept
+        {
+            _blk = m._blk;
+            _top = m._top;
+        }
+
+        // Reset.
+        // Frees everything, keeping owned blocks around for reuse. O(1).
+        void reset() noexcept
+        {
+            _blk = &_first;
+            _top = _first.begin;
+        }
+
+        // Bytes left in the current block.
+        std::size_t available() const noexcept
+        {
+            return std::size_t(_blk->end - _top);
+        }
+
+    private:
+        // Member variables.
+        _block _first;
+        _block* _blk;
+        std::uintptr_t _top;
+        std::size_t _block_size;
+
+        // Round `p` up to a multiple of `align`.
+        static std::uintptr_t _align_up(
+            std::uintptr_t p,
+            std::size_t align)
+        noexcept
+        {
+            return (p + (align - 1)) & ~std::uintptr_t(align - 1);
+        }
+
+        // Move on to a block with room for `size` bytes aligned to `align`,
+        // reusing the next block if it's big enough.
+        void _next_block(std::size_t size, std::size_t align)
+        {
+            // Leave room to align anywhere in the block.
+            auto header = _align_up(sizeof(_block), alignof(std::max_align_t));
+            gdt_assert(size <= SIZE_MAX - header - align);
+            auto min_size = size + align;
+
+            auto next = _blk->next;
+            if (next == nullptr || next->end - next->begin < min_size)
+            {
+                auto alloc_size = header + (std::max)(min_size, _block_size);
+                auto mem = std::malloc(alloc_size);
+                gdt_assert(mem != nullptr);
+
+                auto blk = static_cast<_block*>(mem);
+                auto addr = reinterpret_cast<std::uintptr_t>(mem);
+                blk->next = next;
+                blk->begin = addr + header;
+                blk->end = addr + alloc_size;
+
+                _blk->next = blk;
+                next = blk;
+            }
+
+            _blk = next;
+            _top = next->begin;
+        }
+    };
+
+    // Arena allocator.
+    // Plugs an arena into dynarr and other allocator-aware containers.
+    template<
+        typename T,
+        typename SizeT = std::size_t,
+        typename DiffT = std::ptrdiff_t>
+    requires
+        std::is_integral_v<SizeT> && std::is_unsigned_v<SizeT> &&
+        std::is_integral_v<DiffT> && std::is_signed_v<DiffT>
+    class arena_allocator
+    {
+    public:
+        // Member types.
+        using value_type = T;
+        using size_type = SizeT;
+        using difference_type = DiffT;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        // Constructor.
+        arena_allocator(arena& a) noexcept
+        :
+            _arena{&a}
+        {}
+
+        // Constructor.
+        template<typename U>
+        arena_allocator(const arena_allocator<U, SizeT, DiffT>& other)
+        noexcept
+        :
+            _arena{&other.get_arena()}
+        {}
+
+        // Get arena.
+        arena& get_arena() const noexcept
+        {
+            return *_arena;
+        }
+
+        // Max size.
+        size_type max_size() const noexcept
+        {
+            using common_type = std::common_type_t<
+                std::size_t, SizeT, std::make_unsigned_t<DiffT>>;
+
+            auto size_max = (std::numeric_limits<SizeT>::max)();
+            auto diff_max = (std::numeric_limits<DiffT>::max)();
+
+            return size_type((std::min)({
+                common_type(PTRDIFF_MAX / sizeof(value_type)),
+                common_type(size_max / sizeof(value_type)),
+                common_type(diff_max),
+            }));
+        }
+
+        // Allocate.
+        [[nodiscard]] T* allocate(size_type n)
+        {
+            gdt_assert(n <= max_size());
+            auto p = _arena->allocate(sizeof(T) * std::size_t(n), alignof(T));
+            return static_cast<T*>(p);
+        }
+
+        // Deallocate.
+        void deallocate(T* p, size_type n) noexcept
+        {
+            _arena->deallocate(
+                static_cast<void*>(p),
+                sizeof(T) * std::size_t(n));
+        }
+
+        // Try expand.
+        bool try_expand(T* p, size_type old_n, size_type new_n) noexcept
+        {
+            if (new_n > max_size())
+            {
+                return false;
+            }
+
+            return _arena->try_expand(
+                static_cast<void*>(p),
+                sizeof(T) * std::size_t(old_n),
+                sizeof(T) * std::size_t(new_n));
+        }
+
+        // Equality.
+        template<typename U>
+        friend bool operator==(
+            const arena_allocator& lhs,
+            const arena_allocator<U, SizeT, DiffT>& rhs)
+        noexcept
+        {
+            return &lhs.get_arena() == &rhs.get_arena();
+        }
+
+    private:
+        // Member variables.
+        arena* _arena;
+    };
+}
@@ -0,0 +1,357 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/batch_math_simd.hxx"
+#include "assert.hxx"
+#include "vec.hxx"
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+
+namespace gdt::batch
+{
+    // Accuracy of batch math functions.
+    enum class accuracy
+    {
+        // Polynomial approximations, 4 components at a time where there's
+        // SIMD. See each function for error bounds.
+        fast,
+
+        // The <cmath> functions, one component at a time.
+        precise,
+    };
+}
+
+namespace gdt_detail
+{
+    using namespace gdt;
+
+    // Truncate to int32 like SSE2: out of range and NaN give INT32_MIN.
+    constexpr std::uint32_t batch_cvtt(float x)
+    {
+        if (x >= -2147483648.0f && x < 2147483648.0f)
+        {
+            return std::uint32_t(std::int32_t(x));
+        }
+        return std::uint32_t(1) << 31;
+    }
+
+    // Float from int32 bits.
+    constexpr float batch_cvt(std::uint32_t i)
+    {
+        return float(std::int32_t(i));
+    }
+
+    // Scalar kernels.
+    // Each performs the same float operations, in the same order, as the
+    // SIMD kernel for its operation.
+    template<typename Op>
+    struct batch_math;
+
+    // sin(x) or cos(x) after reducing |x| by the even octant `y`.
+    // `j` is `y` as an integer.
+    constexpr float batch_sincos(float x, float y, std::uint32_t j)
+    {
+        x = x - y * cephes::dp1;
+        x = x - y * cephes::dp2;
+        x = x - y * cephes::dp3;
+        auto z = x * x;
+
+        if ((j & 2) == 0)
+        {
+            auto s = cephes::sin_p0 * z;
+            s = (s + cephes::sin_p1) * z;
+            s = (s + cephes::sin_p2) * z;
+            return s * x + x;
+        }
+
+        auto c = cephes::cos_p0 * z;
+        c = (c + cephes::cos_p1) * z;
+        c = (c + cephes::cos_p2) * z * z;
+        c = c - z * 0.5f;
+        return c + 1.0f;
+    }
+
+    template<>
+    struct batch_math<batch_sin>
+    {
+        static float fast(float x)
+        {
+            auto bits = std::bit_cast<std::uint32_t>(x);
+            auto sign = bits & 0x80000000;
+            x = std::bit_cast<float>(bits & 0x7fffffff);
+
+            auto j = batch_cvtt(x * cephes::fopi);
+            j = (j + 1) & ~std::uint32_t(1);
+            auto y = batch_cvt(j);
+
+            sign ^= (j & 4) << 29;
+            auto ret = std::bit_cast<std::uint32_t>(batch_sincos(x, y, j));
+            return std::bit_cast<float>(ret ^ sign);
+        }
+
+        static float precise(float x)
+        {
+            return std::sin(x);
+        }
+    };
+
+    template<>
+    struct batch_math<batch_cos>
+    {
+        static float fast(float x)
+        {
+            auto bits = std::bit_cast<std::uint32_t>(x);
+            x = std::bit_cast<float>(bits & 0x7fffffff);
+
+            auto j = batch_cvtt(x * cephes::fopi);
+            j = (j + 1) & ~std::uint32_t(1);
+            auto y = batch_cvt(j);
+            j = j - 2;
+
+            auto sign = (~j & 4) << 29;
+            auto ret = std::bit_cast<std::uint32_t>(batch_sincos(x, y, j));
+            return std::bit_cast<float>(ret ^ sign);
+        }
+
+        static float precise(float x)
+        {
+            return std::cos(x);
+        }
+    };
+
+    template<>
+    struct batch_math<batch_exp>
+    {
+        static float fast(float x)
+        {
+            if (x != x)
+            {
+                return x;
+            }
+            if (x > cephes::exp_hi)
+            {
+                return std::numeric_limits<float>::infinity();
+            }
+
+            auto v = x < cephes::exp_hi ? x : cephes::exp_hi;
+            v = v > cephes::exp_lo ? v : cephes::exp_lo;
+
+            // fx = floor(v * log2(e) + 0.5).
+            auto fx = v * cephes::log2e + 0.5f;
+            auto t = batch_cvt(batch_cvtt(fx));
+            fx = t - (t > fx ? 1.0f : 0.0f);
+
+            v = v - fx * cephes::exp_c1;
+            v = v - fx * cephes::exp_c2;
+            auto z = v * v;
+
+            auto y = cephes::exp_p0 * v;
+            y = (y + cephes::exp_p1) * v;
+            y = (y + cephes::exp_p2) * v;
+            y = (y + cephes::exp_p3) * v;
+            y = (y + cephes::exp_p4) * v;
+            y = (y + cephes::exp_p5) * z;
+            y = y + v + 1.0f;
+
+            // Scale by 2^fx.
+            auto n = batch_cvtt(fx) + 127;
+            return y * std::bit_cast<float>(n << 23);
+        }
+
+        static float precise(float x)
+        {
+            return std::exp(x);
+        }
+    };
+
+    template<>
+    struct batch_math<batch_log>
+    {
+        static float fast(float x)
+        {
+            // log(0) = -inf, log(inf) = inf, and log(x < 0) = NaN.
+            if (!(x >= 0.0f))
+            {
+                return std::bit_cast<float>(std::uint32_t(0x7fc00000));
+            }
+            if (x == 0.0f)
+            {
+                return -std::numeric_limits<float>::infinity();
+            }
+            if (x == std::numeric_limits<float>::infinity())
+            {
+                return x;
+            }
+
+            auto min_normal = std::numeric_limits<float>::min();
+            auto v = x > min_normal ? x : min_normal;
+            auto bits = std::bit_cast<std::uint32_t>(v);
+
+            // v = m * 2^e with m in [0.5, 1).
+            auto e = batch_cvt((bits >> 23) - 127) + 1.0f;
+            bits = (bits & ~std::uint32_t(0x7f800000)) | 0x3f000000;
+            v = std::bit_cast<float>(bits);
+
+            // Shift m into [sqrt(1/2), sqrt(2)) and subtract 1.
+            auto small = v < cephes::sqrthf;
+            auto tmp = small ? v : 0.0f;
+            v = v - 1.0f;
+            e = e - (small ? 1.0f : 0.0f);
+            v = v + tmp;
+            auto z = v * v;
+
+            auto y = cephes::log_p0 * v;
+            y = (y + cephes::log_p1) * v;
+            y = (y + cephes::log_p2) * v;
+            y = (y + cephes::log_p3) * v;
+            y = (y + cephes::log_p4) * v;
+            y = (y + cephes::log_p5) * v;
+            y = (y + cephes::log_p6) * v;
+            y = (y + cephes::log_p7) * v;
+            y = (y + cephes::log_p8) * v * z;
+
+            y = y + e * cephes::log_q1;
+            y = y - z * 0.5f;
+            v = v + y;
+            return v + e * cephes::log_q2;
+        }
+
+        static float precise(float x)
+        {
+            return std::log(x);
+        }
+    };
+
+    template<>
+    struct batch_math<batch_sqrt>
+    {
+        static float fast(float x)
+        {
+            return std::sqrt(x);
+        }
+
+        static float precise(float x)
+        {
+            return std::sqrt(x);
+        }
+    };
+
+    // Apply a batch math operation to `n` floats.
+    // `in` and `out` must be the same or not overlap.
+    template<typename Op>
+    void batch_apply(
+        float* out,
+        const float* in,
+        std::size_t n,
+        batch::accuracy a)
+    {
+        if (a == batch::accuracy::precise)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = batch_math<Op>::precise(in[i]);
+            }
+            return;
+        }
+
+        std::size_t i = 0;
+        if constexpr (simd_batch<Op>)
+        {
+            i = simd_batch_apply<Op>(out, in, n);
+        }
+        for (; i < n; ++i)
+        {
+            out[i] = batch_math<Op>::fast(in[i]);
+        }
+    }
+
+    // Apply a batch math operation to spans of vectors.
+    template<typename Op, std::size_t N>
+    void batch_apply(
+        std::span<const vec<float, N>> in,
+        std::span<vec<float, N>> out,
+        batch::accuracy a)
+    {
+        static_assert(sizeof(vec<float, N>) == N * sizeof(float));
+        gdt_assert(in.size() == out.size());
+        if (!in.empty())
+        {
+            batch_apply<Op>(
+                std::addressof(out[0][0]),
+                std::addressof(in[0][0]),
+                in.size() * N,
+                a);
+        }
+    }
+}
+
+namespace gdt::batch
+{
+    // Batch math functions.
+    // out[i] = func(in[i]) for each component. `in` and `out` must be the
+    // same or not overlap.
+    #define gdt(func, Op)\
+    inline void func(\
+        std::span<const float> in,\
+        std::span<float> out,\
+        accuracy a = accuracy::fast)\
+    {\
+        gdt_assert(in.size() == out.size());\
+        gdt_detail::batch_apply<gdt_detail::Op>(\
+            out.data(), in.data(), in.size(), a);\
+    }\
+    inline void func(\
+        std::span<const vec2<float>> in,\
+        std::span<vec2<float>> out,\
+        accuracy a = accuracy::fast)\
+    {\
+        gdt_detail::batch_apply<gdt_detail::Op, 2>(in, out, a);\
+    }\
+    inline void func(\
+        std::span<const vec3<float>> in,\
+        std::span<vec3<float>> out,\
+        accuracy a = accuracy::fast)\
+    {\
+        gdt_detail::batch_apply<gdt_detail::Op, 3>(in, out, a);\
+    }\
+    inline void func(\
+        std::span<const vec4<float>> in,\
+        std::span<vec4<float>> out,\
+        accuracy a = accuracy::fast)\
+    {\
+        gdt_detail::batch_apply<gdt_detail::Op, 4>(in, out, a);\
+    }
+
+    // Sine.
+    // Fast: within 2 ulp for |x| <= pi, and 1e-7 absolute error for
+    // |x| <= 8192. Larger |x| loses accuracy.
+    gdt(sin, batch_sin)
+
+    // Cosine.
+    // Fast: within 2 ulp for |x| <= pi, and 1e-7 absolute error for
+    // |x| <= 8192. Larger |x| loses accuracy.
+    gdt(cos, batch_cos)
+
+    // Exponential.
+    // Fast: within 2 ulp where the result is a normal float. Results
+    // below that flush to zero, and x > 88.37 gives infinity.
+    gdt(exp, batch_exp)
+
+    // Natural logarithm.
+    // Fast: within 2 ulp. Subnormal x is treated as the smallest normal.
+    gdt(log, batch_log)
+
+    // Square root.
+    // Correctly rounded in both modes.
+    gdt(sqrt, batch_sqrt)
+    #undef gdt
+}
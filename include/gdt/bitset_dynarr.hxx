@@ -0,0 +1,504 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/bitset_simd.hxx"
+#include "allocator.hxx"
+#include "assert.hxx"
+#include "assume.hxx"
+#include "dynarr.hxx"
+#include "growth_policy.hxx"
+#include "trivially_relocatable.hxx"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace gdt
+{
+    // Dynamic array of bits.
+    // Packs 64 bits to a word in a dynarr, so it takes an eighth of the
+    // memory of a `dynarr<bool>` and whole-array operations work a word
+    // (or a SIMD register) at a time. Bits past `size()` in the last word
+    // are always zero.
+    template<
+        typename Allocator = allocator<std::uint64_t>,
+        typename Growth = default_growth>
+    class bitset_dynarr
+    {
+        // Member types.
+        using _word_allocator = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<std::uint64_t>;
+
+    public:
+        // Member types.
+        using value_type = bool;
+        using word_type = std::uint64_t;
+        using allocator_type = Allocator;
+        using growth_policy = Growth;
+        using words_type = dynarr<word_type, _word_allocator, Growth>;
+        using size_type = typename words_type::size_type;
+        using difference_type = typename words_type::difference_type;
+
+        // Bits per word.
+        static constexpr size_type bits_per_word = 64;
+
+        // No bit.
+        static constexpr size_type npos =
+            (std::numeric_limits<size_type>::max)();
+
+    private:
+        // Member variables.
+        words_type _words;
+        size_type _size;
+
+    public:
+        // Constructor.
+        constexpr bitset_dynarr() noexcept(noexcept(Allocator()))
+        :
+            bitset_dynarr(Allocator())
+        {}
+
+        // Constructor.
+        explicit constexpr bitset_dynarr(const Allocator& allocator) noexcept
+        :
+            _words(_word_allocator(allocator)),
+            _size{0}
+        {}
+
+        // Constructor.
+        explicit constexpr bitset_dynarr(
+            size_type len,
+            bool value = false,
+            const Allocator& allocator = Allocator())
+        :
+            bitset_dynarr(allocator)
+        {
+            resize(len, value);
+        }
+
+        // Get allocator.
+        constexpr allocator_type get_allocator() const noexcept
+        {
+            return allocator_type(_words.get_allocator());
+        }
+
+        // Empty.
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        // Size.
+        constexpr size_type size() const noexcept
+        {
+            return _size;
+        }
+
+        // Max size.
+        constexpr size_type max_size() const noexcept
+        {
+            auto words = _words.max_size();
+            return words >= npos / bits_per_word ?
+                npos - 1 : size_type(words * bits_per_word);
+        }
+
+        // Capacity.
+        constexpr size_type capacity() const noexcept
+        {
+            auto words = _words.capacity();
+            return words >= npos / bits_per_word ?
+                npos - 1 : size_type(words * bits_per_word);
+        }
+
+        // Reserve.
+        constexpr void reserve(size_type req_capacity)
+        {
+            _words.reserve(_word_count(req_capacity));
+        }
+
+        // Shrink to fit.
+        constexpr void shrink_to_fit()
+        {
+            _words.shrink_to_fit();
+        }
+
+        // Resize.
+        // New bits are `value`.
+        constexpr void resize(size_type tgt_len, bool value = false)
+        {
+            gdt_assert(tgt_len <= max_size());
+
+            if (value && tgt_len > _size && _size % bits_per_word != 0)
+            {
+                _words.back() |= ~word_type(0) << (_size % bits_per_word);
+            }
+
+            _words.resize(_word_count(tgt_len), value ? ~word_type(0) : 0);
+            _size = tgt_len;
+            _clear_tail();
+        }
+
+        // Clear.
+        constexpr void clear() noexcept
+        {
+            _words.clear();
+            _size = 0;
+        }
+
+        // Words.
+        // Every bit, packed little-endian, 64 to a word.
+        constexpr std::span<const word_type> words() const noexcept
+        {
+            return {_words.data(), std::size_t(_words.size())};
+        }
+
+        // Data.
+        constexpr const word_type* data() const noexcept
+        {
+            return _words.data();
+        }
+
+        // Subscript.
+        constexpr bool operator[](size_type i) const
+        {
+            gdt_assume(i < _size);
+            return (_words[_word_index(i)] >> (i % bits_per_word)) & 1;
+        }
+
+        // Test.
+        constexpr bool test(size_type i) const
+        {
+            gdt_assert(i < _size);
+            return (*this)[i];
+        }
+
+        // Set.
+        constexpr bitset_dynarr& set(size_type i, bool value = true)
+        {
+            gdt_assume(i < _size);
+            auto& word = _words[_word_index(i)];
+            auto bit = word_type(1) << (i % bits_per_word);
+            word = value ? word | bit : word & ~bit;
+            return *this;
+        }
+
+        // Set every bit.
+        constexpr bitset_dynarr& set() noexcept
+        {
+            std::fill(_words.begin(), _words.end(), ~word_type(0));
+            _clear_tail();
+            return *this;
+        }
+
+        // Reset.
+        constexpr bitset_dynarr& reset(size_type i)
+        {
+            return set(i, false);
+        }
+
+        // Reset every bit.
+        constexpr bitset_dynarr& reset() noexcept
+        {
+            std::fill(_words.begin(), _words.end(), word_type(0));
+            return *this;
+        }
+
+        // Flip.
+        constexpr bitset_dynarr& flip(size_type i)
+        {
+            gdt_assume(i < _size);
+            _words[_word_index(i)] ^= word_type(1) << (i % bits_per_word);
+            return *this;
+        }
+
+        // Flip every bit.
+        constexpr bitset_dynarr& flip() noexcept
+        {
+            for (auto& word : _words)
+            {
+                word = ~word;
+            }
+            _clear_tail();
+            return *this;
+        }
+
+        // Push back.
+        constexpr void push_back(bool value)
+        {
+            gdt_assert(_size < max_size());
+
+            if (_size % bits_per_word == 0)
+            {
+                _words.push_back(0);
+            }
+            _words.back() |= word_type(value) << (_size % bits_per_word);
+            _size += 1;
+        }
+
+        // Pop back.
+        constexpr void pop_back()
+        {
+            gdt_assume(_size > 0);
+
+            _size -= 1;
+            if (_size % bits_per_word == 0)
+            {
+                _words.pop_back();
+            }
+            else
+            {
+                _clear_tail();
+            }
+        }
+
+        // Count.
+        // Number of set bits.
+        constexpr size_type count() const noexcept
+        {
+            auto p = _words.data();
+            auto n = std::size_t(_words.size());
+
+            std::uint64_t total = 0;
+            std::size_t i = 0;
+            if (!std::is_constant_evaluated())
+            {
+                i = gdt_detail::simd_popcount_some(p, n, total);
+            }
+            for (; i < n; ++i)
+            {
+                total += std::uint64_t(std::popcount(p[i]));
+            }
+
+            return size_type(total);
+        }
+
+        // Any.
+        // Some bit is set?
+        constexpr bool any() const noexcept
+        {
+            auto n = std::size_t(_words.size());
+            return _skip(0, n, 0) < n;
+        }
+
+        // None.
+        // No bit is set?
+        constexpr bool none() const noexcept
+        {
+            return !any();
+        }
+
+        // All.
+        // Every bit is set? True if empty.
+        constexpr bool all() const noexcept
+        {
+            auto full = std::size_t(_size / bits_per_word);
+            if (_skip(0, full, ~word_type(0)) < full)
+            {
+                return false;
+            }
+
+            auto tail = _size % bits_per_word;
+            return
+                tail == 0 ||
+                _words[size_type(full)] == (word_type(1) << tail) - 1;
+        }
+
+        // Find first.
+        // Index of the first set bit, or `npos`.
+        constexpr size_type find_first() const noexcept
+        {
+            return _find_from(0);
+        }
+
+        // Find next.
+        // Index of the first set bit after `i`, or `npos`.
+        constexpr size_type find_next(size_type i) const noexcept
+        {
+            return i + 1 < _size ? _find_from(i + 1) : npos;
+        }
+
+        // Bitwise and assignment.
+        constexpr bitset_dynarr& operator&=(const bitset_dynarr& other)
+        {
+            return _apply<gdt_detail::bit_and>(other);
+        }
+
+        // Bitwise or assignment.
+        constexpr bitset_dynarr& operator|=(const bitset_dynarr& other)
+        {
+            return _apply<gdt_detail::bit_or>(other);
+        }
+
+        // Bitwise xor assignment.
+        constexpr bitset_dynarr& operator^=(const bitset_dynarr& other)
+        {
+            return _apply<gdt_detail::bit_xor>(other);
+        }
+
+        // And not.
+        // Clears every bit that's set in `other`.
+        constexpr bitset_dynarr& and_not(const bitset_dynarr& other)
+        {
+            return _apply<gdt_detail::bit_and_not>(other);
+        }
+
+        // Bitwise and.
+        friend constexpr bitset_dynarr operator&(
+            bitset_dynarr lhs,
+            const bitset_dynarr& rhs)
+        {
+            lhs &= rhs;
+            return lhs;
+        }
+
+        // Bitwise or.
+        friend constexpr bitset_dynarr operator|(
+            bitset_dynarr lhs,
+            const bitset_dynarr& rhs)
+        {
+            lhs |= rhs;
+            return lhs;
+        }
+
+        // Bitwise xor.
+        friend constexpr bitset_dynarr operator^(
+            bitset_dynarr lhs,
+            const bitset_dynarr& rhs)
+        {
+            lhs ^= rhs;
+            return lhs;
+        }
+
+        // Swap.
+        constexpr void swap(bitset_dynarr& other)
+        noexcept(noexcept(std::declval<words_type&>().swap(
+            std::declval<words_type&>())))
+        {
+            _words.swap(other._words);
+            std::swap(_size, other._size);
+        }
+
+        // Swap.
+        friend constexpr void swap(bitset_dynarr& lhs, bitset_dynarr& rhs)
+        noexcept(noexcept(lhs.swap(rhs)))
+        {
+            lhs.swap(rhs);
+        }
+
+        // Equality.
+        friend constexpr bool operator==(
+            const bitset_dynarr& lhs,
+            const bitset_dynarr& rhs)
+        {
+            return lhs._size == rhs._size && lhs._words == rhs._words;
+        }
+
+    private:
+        // Words needed for `len` bits.
+        static constexpr size_type _word_count(size_type len) noexcept
+        {
+            return size_type(
+                len / bits_per_word + (len % bits_per_word != 0));
+        }
+
+        // Word holding bit `i`.
+        static constexpr size_type _word_index(size_type i) noexcept
+        {
+            return size_type(i / bits_per_word);
+        }
+
+        // Zero the bits past `_size` in the last word.
+        constexpr void _clear_tail() noexcept
+        {
+            if (_size % bits_per_word != 0)
+            {
+                _words.back() &=
+                    (word_type(1) << (_size % bits_per_word)) - 1;
+            }
+        }
+
+        // Index of the first word from `first` to `last` that isn't
+        // `value`, or `last`.
+        constexpr std::size_t _skip(
+            std::size_t first,
+            std::size_t last,
+            word_type value) const noexcept
+        {
+            auto p = _words.data();
+            auto i = first;
+            if (!std::is_constant_evaluated())
+            {
+                i += gdt_detail::simd_skip_some(p + first, last - first, value);
+            }
+            while (i < last && p[i] == value)
+            {
+                ++i;
+            }
+            return i;
+        }
+
+        // Index of the first set bit from `i` on, or `npos`.
+        constexpr size_type _find_from(size_type i) const noexcept
+        {
+            if (i >= _size)
+            {
+                return npos;
+            }
+
+            auto w = std::size_t(_word_index(i));
+            auto word = _words[size_type(w)] &
+                (~word_type(0) << (i % bits_per_word));
+            if (word == 0)
+            {
+                auto n = std::size_t(_words.size());
+                w = _skip(w + 1, n, 0);
+                if (w == n)
+                {
+                    return npos;
+                }
+                word = _words[size_type(w)];
+            }
+
+            return size_type(w * bits_per_word + std::size_t(
+                std::countr_zero(word)));
+        }
+
+        // Apply `Op` to every word of this and `other`.
+        template<typename Op>
+        constexpr bitset_dynarr& _apply(const bitset_dynarr& other)
+        {
+            gdt_assert(_size == other._size);
+
+            auto dst = _words.data();
+            auto src = other._words.data();
+            auto n = std::size_t(_words.size());
+
+            std::size_t i = 0;
+            if (!std::is_constant_evaluated())
+            {
+                i = gdt_detail::simd_bitwise_some<Op>(dst, src, n);
+            }
+            for (; i < n; ++i)
+            {
+                dst[i] = Op::apply(dst[i], src[i]);
+            }
+
+            return *this;
+        }
+    };
+
+    // Bitset dynarr is trivially relocatable if its dynarr is.
+    template<typename Allocator, typename Growth>
+    struct is_trivially_relocatable<bitset_dynarr<Allocator, Growth>> :
+        is_trivially_relocatable<
+            typename bitset_dynarr<Allocator, Growth>::words_type> {};
+}
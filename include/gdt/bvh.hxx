@@ -0,0 +1,757 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "aabb.hxx"
+#include "assert.hxx"
+#include "assume.hxx"
+#include "dynarr.hxx"
+#include "frustum.hxx"
+#include "ray.hxx"
+#include "small_dynarr.hxx"
+#include "vec.hxx"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <thread>
+#include <utility>
+
+namespace gdt
+{
+    // BVH node.
+    // Four children in structure-of-arrays form. Lane `i` is empty if
+    // `first[i]` is `none`, a leaf of `count[i]` primitives starting at
+    // `indices()[first[i]]` if `count[i]` isn't 0, and otherwise child node
+    // `first[i]`.
+    template<typename T>
+    struct bvh_node
+    {
+        // No child.
+        static constexpr std::uint32_t none = UINT32_MAX;
+
+        // Member variables.
+        aabb_soa<T, 3, 4> bounds;
+        std::uint32_t first[4];
+        std::uint32_t count[4];
+
+        // Node with four empty lanes.
+        static constexpr bvh_node empty()
+        {
+            return {aabb_soa<T, 3, 4>::empty(), {none, none, none, none}, {}};
+        }
+    };
+
+    // BVH build options.
+    struct bvh_build_options
+    {
+        // Most primitives in a leaf.
+        std::uint32_t max_leaf_size = 4;
+
+        // Buckets per axis when evaluating the surface area heuristic.
+        std::uint32_t bins = 16;
+
+        // Build large subtrees on their own threads.
+        bool parallel = false;
+
+        // Fewest primitives in a subtree that gets its own thread.
+        std::uint32_t parallel_size = 32768;
+
+        // Most threads building at once, counting the calling thread.
+        // 0 means `std::thread::hardware_concurrency()`. Subtrees that
+        // would go over build on their parent's thread instead.
+        std::uint32_t max_threads = 0;
+    };
+
+    // Nearest hit from `bvh::intersect`.
+    template<typename T>
+    struct bvh_hit
+    {
+        // Primitive index, or `bvh_node<T>::none` for no hit.
+        std::uint32_t index;
+
+        // Distance along the ray, or infinity for no hit.
+        T t;
+    };
+}
+
+namespace gdt_detail
+{
+    using namespace gdt;
+
+    // Half the surface area of a non-empty box.
+    template<typename T>
+    constexpr T half_area(const aabb<T, 3>& box)
+    {
+        auto s = box.size();
+        return s[0] * s[1] + s[1] * s[2] + s[2] * s[0];
+    }
+
+    // Primitive being sorted into the tree.
+    template<typename T>
+    struct bvh_primitive
+    {
+        aabb<T, 3> bounds;
+        vec3<T> centroid;
+        std::uint32_t index;
+    };
+
+    // Primitives `begin` up to `end`.
+    template<typename T>
+    struct bvh_range
+    {
+        std::uint32_t begin;
+        std::uint32_t end;
+
+        // Bounds of the primitives.
+        aabb<T, 3> bounds;
+
+        // Bounds of their centroids.
+        aabb<T, 3> centroid_bounds;
+
+        // Already as split as it should be.
+        bool final;
+
+        // Number of primitives.
+        constexpr std::uint32_t size() const
+        {
+            return end - begin;
+        }
+    };
+
+    // Primitives binned by centroid.
+    template<typename T>
+    struct bvh_bin
+    {
+        aabb<T, 3> bounds;
+        aabb<T, 3> centroid_bounds;
+        std::uint32_t count;
+
+        // No primitives.
+        static constexpr bvh_bin empty()
+        {
+            return {aabb<T, 3>::empty(), aabb<T, 3>::empty(), 0};
+        }
+
+        // Surface area heuristic cost.
+        constexpr T cost() const
+        {
+            return count == 0 ? T(0) : half_area(bounds) * T(count);
+        }
+
+        // Both bins' primitives.
+        friend constexpr bvh_bin merge(const bvh_bin& a, const bvh_bin& b)
+        {
+            return {
+                gdt::merge(a.bounds, b.bounds),
+                gdt::merge(a.centroid_bounds, b.centroid_bounds),
+                a.count + b.count};
+        }
+    };
+
+    // Node on a ray traversal stack, with where the ray enters it.
+    template<typename T>
+    struct bvh_entry
+    {
+        std::uint32_t node;
+        T t;
+    };
+
+    // Top-down BVH builder.
+    // Splits ranges in two with the binned surface area heuristic, then
+    // collapses pairs of splits into 4-wide nodes. Partitions copies of the
+    // primitives' bounds rather than indices so each pass reads memory in
+    // order.
+    template<typename T>
+    class bvh_builder
+    {
+    public:
+        // Constructor.
+        constexpr bvh_builder(
+            std::span<bvh_primitive<T>> primitives,
+            const bvh_build_options& options)
+        :
+            _primitives{primitives},
+            _options{options},
+            _spare_threads{0}
+        {
+            if (!std::is_constant_evaluated() && options.parallel)
+            {
+                auto max_threads = options.max_threads != 0 ?
+                    options.max_threads :
+                    std::uint32_t(std::thread::hardware_concurrency());
+                _spare_threads.store(
+                    std::max(max_threads, std::uint32_t(1)) - 1,
+                    std::memory_order_relaxed);
+            }
+        }
+
+        // Range covering primitives `begin` up to `end`.
+        constexpr bvh_range<T> make_range(
+            std::uint32_t begin,
+            std::uint32_t end) const
+        {
+            bvh_range<T> ret{
+                begin,
+                end,
+                aabb<T, 3>::empty(),
+                aabb<T, 3>::empty(),
+                false};
+            for (auto i = begin; i < end; ++i)
+            {
+                auto& p = _primitives[i];
+                ret.bounds = merge(ret.bounds, p.bounds);
+                ret.centroid_bounds = merge(ret.centroid_bounds, p.centroid);
+            }
+            return ret;
+        }
+
+        // Build the subtree for `range` into `nodes[node]` and after.
+        template<typename Allocator>
+        constexpr void build(
+            dynarr<bvh_node<T>, Allocator>& nodes,
+            std::uint32_t node,
+            const bvh_range<T>& range)
+        {
+            // Split the largest splittable range until there are four.
+            bvh_range<T> lanes[4] = {range};
+            std::size_t lane_count = 1;
+            while (lane_count < 4)
+            {
+                std::size_t best = 4;
+                for (std::size_t i = 0; i < lane_count; ++i)
+                {
+                    if (!lanes[i].final && (best == 4 ||
+                        half_area(lanes[i].bounds) >
+                        half_area(lanes[best].bounds)))
+                    {
+                        best = i;
+                    }
+                }
+                if (best == 4)
+                {
+                    break;
+                }
+
+                bvh_range<T> right;
+                if (split(lanes[best], lanes[best], right))
+                {
+                    lanes[lane_count++] = right;
+                }
+                else
+                {
+                    lanes[best].final = true;
+                }
+            }
+
+            // Fill in leaves and find where child nodes go.
+            std::uint32_t children[4] = {};
+            for (std::size_t i = 0; i < lane_count; ++i)
+            {
+                nodes[node].bounds.set(i, lanes[i].bounds);
+                if (lanes[i].size() <= _options.max_leaf_size)
+                {
+                    nodes[node].first[i] = lanes[i].begin;
+                    nodes[node].count[i] = lanes[i].size();
+                }
+                else
+                {
+                    children[i] = std::uint32_t(nodes.size());
+                    nodes[node].first[i] = children[i];
+                    nodes[node].count[i] = 0;
+                    nodes.push_back(bvh_node<T>::empty());
+                }
+            }
+
+            // Build children, large ones on their own threads at first.
+            if (!std::is_constant_evaluated() &&
+                _options.parallel &&
+                range.size() / 2 >= _options.parallel_size)
+            {
+                build_parallel(nodes, lanes, children);
+                return;
+            }
+            for (std::size_t i = 0; i < lane_count; ++i)
+            {
+                if (children[i] != 0)
+                {
+                    build(nodes, children[i], lanes[i]);
+                }
+            }
+        }
+
+    private:
+        // Member variables.
+        std::span<bvh_primitive<T>> _primitives;
+        bvh_build_options _options;
+        std::atomic<std::uint32_t> _spare_threads;
+
+        // Take one of the spare threads, if there are any left.
+        bool _take_thread() noexcept
+        {
+            auto spare = _spare_threads.load(std::memory_order_relaxed);
+            while (spare != 0 && !_spare_threads.compare_exchange_weak(
+                spare, spare - 1, std::memory_order_relaxed))
+            {}
+
+            return spare != 0;
+        }
+
+        // Build child nodes `children` for `lanes`, with each large one in
+        // a separate array on its own thread (while there are spare
+        // threads), spliced in afterward.
+        template<typename Allocator>
+        void build_parallel(
+            dynarr<bvh_node<T>, Allocator>& nodes,
+            const bvh_range<T> (&lanes)[4],
+            const std::uint32_t (&children)[4])
+        {
+            dynarr<bvh_node<T>, Allocator> subtrees[4];
+            std::thread threads[4];
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                if (children[i] != 0 &&
+                    lanes[i].size() >= _options.parallel_size &&
+                    _take_thread())
+                {
+                    threads[i] = std::thread([&, i]
+                    {
+                        subtrees[i].push_back(bvh_node<T>::empty());
+                        build(subtrees[i], 0, lanes[i]);
+                        _spare_threads.fetch_add(1, std::memory_order_relaxed);
+                    });
+                }
+            }
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                if (children[i] != 0 && !threads[i].joinable())
+                {
+                    build(nodes, children[i], lanes[i]);
+                }
+            }
+
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                if (!threads[i].joinable())
+                {
+                    continue;
+                }
+                threads[i].join();
+
+                // The subtree root replaces its placeholder and the rest go
+                // on the end, so children still come after their parents.
+                auto offset = std::uint32_t(nodes.size()) - 1;
+                for (std::size_t n = 0; n < subtrees[i].size(); ++n)
+                {
+                    auto& sub = subtrees[i][n];
+                    for (std::size_t lane = 0; lane < 4; ++lane)
+                    {
+                        if (sub.count[lane] == 0 &&
+                            sub.first[lane] != bvh_node<T>::none)
+                        {
+                            sub.first[lane] += offset;
+                        }
+                    }
+                    if (n == 0)
+                    {
+                        nodes[children[i]] = sub;
+                    }
+                    else
+                    {
+                        nodes.push_back(sub);
+                    }
+                }
+            }
+        }
+
+        // Split `range` in two with the surface area heuristic.
+        // False if it's better as a leaf.
+        constexpr bool split(
+            const bvh_range<T>& range,
+            bvh_range<T>& left,
+            bvh_range<T>& right) const
+        {
+            auto n = range.size();
+            if (n <= 1)
+            {
+                return false;
+            }
+
+            // Bin centroids along the axis they're most spread out on.
+            constexpr std::size_t max_bins = 64;
+            auto bins = std::clamp<std::size_t>(
+                std::min<std::size_t>(_options.bins, n), 2, max_bins);
+            auto extent = range.centroid_bounds.size();
+            std::size_t axis = 0;
+            for (std::size_t a = 1; a < 3; ++a)
+            {
+                axis = extent[a] > extent[axis] ? a : axis;
+            }
+            auto lo = range.centroid_bounds.lower()[axis];
+            auto scale = extent[axis] > T(0) ? T(bins) / extent[axis] : T(0);
+
+            bvh_bin<T> grid[max_bins];
+            for (std::size_t b = 0; b < bins; ++b)
+            {
+                grid[b] = bvh_bin<T>::empty();
+            }
+            if (scale > T(0))
+            {
+                for (auto i = range.begin; i < range.end; ++i)
+                {
+                    auto& p = _primitives[i];
+                    auto& b = grid[bin(p.centroid[axis], lo, scale, bins)];
+                    b.bounds = merge(b.bounds, p.bounds);
+                    b.centroid_bounds = merge(b.centroid_bounds, p.centroid);
+                    ++b.count;
+                }
+            }
+
+            // Sweep for the cheapest split, counting each side's area times
+            // its primitives.
+            auto best_cost = std::numeric_limits<T>::infinity();
+            std::size_t best_bin = 0;
+            T right_cost[max_bins];
+            auto acc = bvh_bin<T>::empty();
+            for (auto b = bins - 1; b > 0; --b)
+            {
+                acc = merge(acc, grid[b]);
+                right_cost[b] = acc.cost();
+            }
+            acc = bvh_bin<T>::empty();
+            for (std::size_t b = 0; b + 1 < bins; ++b)
+            {
+                acc = merge(acc, grid[b]);
+                if (acc.count == 0 || acc.count == n)
+                {
+                    continue;
+                }
+                auto cost = acc.cost() + right_cost[b + 1];
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    best_bin = b;
+                }
+            }
+
+            // Leaves cost one intersection per primitive and nodes cost
+            // about one more for the traversal step.
+            auto area = half_area(range.bounds);
+            if (n <= _options.max_leaf_size &&
+                !(best_cost + area < area * T(n)))
+            {
+                return false;
+            }
+
+            auto begin = range.begin;
+            auto end = range.end;
+            if (best_cost == std::numeric_limits<T>::infinity())
+            {
+                // Every centroid is in the same place, so any split is as
+                // good as any other.
+                auto mid = begin + n / 2;
+                left = make_range(begin, mid);
+                right = make_range(mid, end);
+                return true;
+            }
+
+            // Partition, taking both sides' bounds from the bins.
+            auto first = _primitives.begin() + begin;
+            auto last = _primitives.begin() + end;
+            auto it = std::partition(first, last, [&](const auto& p)
+            {
+                return bin(p.centroid[axis], lo, scale, bins) <= best_bin;
+            });
+            auto mid = begin + std::uint32_t(it - first);
+
+            auto l = bvh_bin<T>::empty();
+            auto r = bvh_bin<T>::empty();
+            for (std::size_t b = 0; b < bins; ++b)
+            {
+                auto& side = b <= best_bin ? l : r;
+                side = merge(side, grid[b]);
+            }
+            left = {begin, mid, l.bounds, l.centroid_bounds, false};
+            right = {mid, end, r.bounds, r.centroid_bounds, false};
+            return true;
+        }
+
+        // Bin for centroid component `c`.
+        static constexpr std::size_t bin(
+            T c,
+            T lo,
+            T scale,
+            std::size_t bins)
+        {
+            auto b = std::size_t((c - lo) * scale);
+            return b < bins ? b : bins - 1;
+        }
+    };
+}
+
+namespace gdt
+{
+    // Bounding volume hierarchy.
+    // Built over the bounding boxes of some primitives and stored as a flat
+    // array of 4-wide nodes, with the root first and children after their
+    // parents. Queries call back with primitive indices.
+    template<typename T = float>
+    class bvh
+    {
+    public:
+        // Constructor.
+        constexpr bvh() = default;
+
+        // Constructor.
+        explicit constexpr bvh(
+            std::span<const aabb<T, 3>> boxes,
+            const bvh_build_options& options = {})
+        {
+            build(boxes, options);
+        }
+
+        // Build over primitives with bounds `boxes`.
+        constexpr void build(
+            std::span<const aabb<T, 3>> boxes,
+            const bvh_build_options& options = {})
+        {
+            gdt_assert(boxes.size() < bvh_node<T>::none);
+            gdt_assert(options.max_leaf_size > 0);
+            _nodes.clear();
+            _indices.clear();
+            if (boxes.empty())
+            {
+                return;
+            }
+
+            dynarr<gdt_detail::bvh_primitive<T>> primitives;
+            primitives.reserve(boxes.size());
+            for (std::size_t i = 0; i < boxes.size(); ++i)
+            {
+                primitives.push_back(
+                    {boxes[i], boxes[i].center(), std::uint32_t(i)});
+            }
+
+            gdt_detail::bvh_builder<T> builder(primitives, options);
+            _nodes.push_back(bvh_node<T>::empty());
+            builder.build(
+                _nodes,
+                0,
+                builder.make_range(0, std::uint32_t(boxes.size())));
+
+            _indices.reserve(boxes.size());
+            for (auto& p : primitives)
+            {
+                _indices.push_back(p.index);
+            }
+        }
+
+        // Update bounds after primitives move, keeping the tree as is.
+        // `boxes` must have the same size as when built.
+        constexpr void refit(std::span<const aabb<T, 3>> boxes)
+        {
+            gdt_assert(boxes.size() == _indices.size());
+
+            // Children come after their parents, so go backward.
+            for (auto n = _nodes.size(); n-- > 0;)
+            {
+                auto& node = _nodes[n];
+                for (std::size_t i = 0; i < 4; ++i)
+                {
+                    auto first = node.first[i];
+                    if (first == bvh_node<T>::none)
+                    {
+                        continue;
+                    }
+
+                    auto box = aabb<T, 3>::empty();
+                    if (node.count[i] != 0)
+                    {
+                        for (auto j = first; j < first + node.count[i]; ++j)
+                        {
+                            box = merge(box, boxes[_indices[j]]);
+                        }
+                    }
+                    else
+                    {
+                        box = node_bounds(first);
+                    }
+                    node.bounds.set(i, box);
+                }
+            }
+        }
+
+        // Is empty.
+        constexpr bool empty() const
+        {
+            return _nodes.empty();
+        }
+
+        // Bounds of every primitive.
+        constexpr aabb<T, 3> bounds() const
+        {
+            return empty() ? aabb<T, 3>::empty() : node_bounds(0);
+        }
+
+        // Nodes.
+        constexpr std::span<const bvh_node<T>> nodes() const
+        {
+            return _nodes;
+        }
+
+        // Primitive indices that leaves refer to.
+        constexpr std::span<const std::uint32_t> indices() const
+        {
+            return _indices;
+        }
+
+        // Nearest primitive that `r` hits within [0, t_max).
+        // `f(i)` returns the distance along `r` to primitive `i`, or infinity
+        // if it misses. Nodes are visited nearest first and skipped once
+        // they're further away than the nearest hit so far.
+        template<typename F>
+        constexpr bvh_hit<T> intersect(
+            const ray<T, 3>& r,
+            F&& f,
+            T t_max = std::numeric_limits<T>::infinity()) const
+        {
+            bvh_hit<T> ret{bvh_node<T>::none, t_max};
+            if (empty())
+            {
+                ret.t = std::numeric_limits<T>::infinity();
+                return ret;
+            }
+
+            small_dynarr<gdt_detail::bvh_entry<T>, 64> stack;
+            stack.push_back({0, T(0)});
+            while (!stack.empty())
+            {
+                auto entry = stack.back();
+                stack.pop_back();
+                if (entry.t > ret.t)
+                {
+                    continue;
+                }
+
+                auto& node = _nodes[entry.node];
+                vec4<T> t;
+                auto mask = batch::intersect(r, node.bounds, ret.t, &t);
+
+                // Push children furthest first so the nearest pops first.
+                gdt_detail::bvh_entry<T> children[4];
+                std::size_t child_count = 0;
+                for (; mask != 0; mask &= mask - 1)
+                {
+                    auto i = std::size_t(std::countr_zero(mask));
+                    auto first = node.first[i];
+                    if (node.count[i] == 0)
+                    {
+                        auto j = child_count++;
+                        for (; j > 0 && children[j - 1].t < t[i]; --j)
+                        {
+                            children[j] = children[j - 1];
+                        }
+                        children[j] = {first, t[i]};
+                        continue;
+                    }
+
+                    for (auto j = first; j < first + node.count[i]; ++j)
+                    {
+                        T tj = f(_indices[j]);
+                        if (tj < ret.t && tj >= T(0))
+                        {
+                            ret = {_indices[j], tj};
+                        }
+                    }
+                }
+                for (std::size_t i = 0; i < child_count; ++i)
+                {
+                    stack.push_back(children[i]);
+                }
+            }
+
+            if (ret.index == bvh_node<T>::none)
+            {
+                ret.t = std::numeric_limits<T>::infinity();
+            }
+            return ret;
+        }
+
+        // Calls `f(i)` for every primitive `i` in a leaf that overlaps
+        // `box`. The primitive itself may not overlap `box`.
+        template<typename F>
+        constexpr void query(const aabb<T, 3>& box, F&& f) const
+        {
+            visit([&](const aabb_soa<T, 3, 4>& bounds)
+            {
+                return batch::overlaps(box, bounds);
+            }, f);
+        }
+
+        // Calls `f(i)` for every primitive `i` in a leaf that overlaps
+        // `fr`. The primitive itself may not overlap `fr`.
+        template<typename F>
+        constexpr void query(const frustum<T>& fr, F&& f) const
+        {
+            visit([&](const aabb_soa<T, 3, 4>& bounds)
+            {
+                return batch::overlaps(fr, bounds);
+            }, f);
+        }
+
+    private:
+        // Member variables.
+        dynarr<bvh_node<T>> _nodes;
+        dynarr<std::uint32_t> _indices;
+
+        // Bounds of node `n`.
+        constexpr aabb<T, 3> node_bounds(std::size_t n) const
+        {
+            auto ret = aabb<T, 3>::empty();
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                ret = merge(ret, _nodes[n].bounds.get(i));
+            }
+            return ret;
+        }
+
+        // Depth-first traversal into lanes in `test(bounds)`'s mask.
+        template<typename Test, typename F>
+        constexpr void visit(const Test& test, F& f) const
+        {
+            if (empty())
+            {
+                return;
+            }
+
+            small_dynarr<std::uint32_t, 64> stack;
+            stack.push_back(0);
+            while (!stack.empty())
+            {
+                auto& node = _nodes[stack.back()];
+                stack.pop_back();
+                auto mask = test(node.bounds);
+                for (; mask != 0; mask &= mask - 1)
+                {
+                    auto i = std::size_t(std::countr_zero(mask));
+                    auto first = node.first[i];
+                    if (node.count[i] == 0)
+                    {
+                        stack.push_back(first);
+                        continue;
+                    }
+                    for (auto j = first; j < first + node.count[i]; ++j)
+                    {
+                        f(_indices[j]);
+                    }
+                }
+            }
+        }
+    };
+}
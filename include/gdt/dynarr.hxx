@@ -9,8 +9,11 @@
 #include "allocator.hxx"
 #include "assert.hxx"
 #include "assume.hxx"
+#include "growth_policy.hxx"
+#include "trivially_relocatable.hxx"
 #include <algorithm>
 #include <compare>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
@@ -27,18 +30,63 @@ namespace gdt_detail
     // Dynarr const iterator.
     template<typename T, typename Allocator>
     class dynarr_const_iterator;
+
+    // Allocator has a custom `construct` or `destroy`.
+    template<typename Allocator, typename T>
+    concept has_custom_construct_or_destroy =
+        requires (Allocator& a, T* p, T&& v)
+        {
+            a.construct(p, std::move(v));
+        } ||
+        requires (Allocator& a, T* p)
+        {
+            a.destroy(p);
+        };
+
+    // Elements can be relocated with memcpy/memmove.
+    template<typename Allocator, typename T>
+    concept is_memcpy_relocatable =
+        gdt::is_trivially_relocatable_v<T> &&
+        !has_custom_construct_or_destroy<Allocator, T>;
+
+    // Elements can be value-initialized with memset.
+    // Only scalars whose zero value is all zero bits qualify. Null member
+    // pointers aren't (they're -1 on Itanium ABIs), and classes could hold
+    // one, so those get real value-initialization, which compilers turn
+    // into a memset themselves when they can.
+    template<typename Allocator, typename T>
+    concept is_memset_value_initializable =
+        std::is_scalar_v<T> &&
+        !std::is_member_pointer_v<T> &&
+        !has_custom_construct_or_destroy<Allocator, T>;
+
+    // Elements can be destroyed without doing anything.
+    template<typename Allocator, typename T>
+    concept is_trivially_destroyable =
+        std::is_trivially_destructible_v<T> &&
+        !has_custom_construct_or_destroy<Allocator, T>;
+
+    // Elements can be constructed from `Args` without throwing.
+    template<typename Allocator, typename T, typename... Args>
+    concept is_nothrow_constructible_with =
+        std::is_nothrow_constructible_v<T, Args...> &&
+        !has_custom_construct_or_destroy<Allocator, T>;
 }
 
 namespace gdt
 {
     // Dynamic array.
-    template<typename T, typename Allocator = allocator<T>>
+    template<
+        typename T,
+        typename Allocator = allocator<T>,
+        typename Growth = default_growth>
     class dynarr
     {
     public:
         // Member types.
         using value_type = T;
         using allocator_type = Allocator;
+        using growth_policy = Growth;
         using pointer = typename std::allocator_traits<Allocator>::pointer;
         using const_pointer = typename std::allocator_traits<Allocator>::const_pointer;
         using reference = value_type&;
@@ -437,9 +485,9 @@ namespace gdt
         constexpr void resize(size_type tgt_len)
         {
             _reserve_or_shrink(tgt_len);
-            while (_size < tgt_len)
+            if (_size < tgt_len)
             {
-                emplace_back();
+                _value_init_back(size_type(tgt_len - _size));
             }
         }
 
@@ -450,6 +498,32 @@ namespace gdt
             _fill_to(tgt_len, fill_value);
         }
 
+        // Resize for overwrite.
+        // Like resize, but default-initializes new elements
+        // instead, so trivial ones are left uninitialized.
+        constexpr void resize_for_overwrite(size_type tgt_len)
+        {
+            _reserve_or_shrink(tgt_len);
+            if (_size < tgt_len)
+            {
+                _default_init_back(size_type(tgt_len - _size));
+            }
+        }
+
+        // Append uninitialized.
+        // Default-initializes `n` new elements at the end and returns a
+        // pointer to the first one, so trivial ones are left uninitialized.
+        constexpr T* append_uninitialized(size_type n)
+        {
+            gdt_assert(n <= max_size() - _size);
+
+            auto old_size = _size;
+            reserve(size_type(old_size + n));
+            _default_init_back(n);
+
+            return data() + old_size;
+        }
+
         // Reserve.
         constexpr void reserve(size_type req_capacity)
         {
@@ -462,7 +536,11 @@ namespace gdt
         // Shrink to fit.
         constexpr void shrink_to_fit()
         {
-            if (_capacity > _size)
+            if (_size == 0)
+            {
+                _reset();
+            }
+            else if (_capacity > _size)
             {
                 _reallocate(_size);
             }
@@ -652,10 +730,20 @@ namespace gdt
             auto last_idx = last - beg;
             auto first_idx = first - beg;
 
-            // Shift forward elements after the erase range.
+            // Destroy the erase range and relocate
+            // elements after it if possible.
             auto src_begin = beg + last_idx;
             auto src_end = end();
             auto dst_begin = beg + first_idx;
+            if (_can_memcpy())
+            {
+                _destroy(dst_begin, src_begin);
+                _memmove(dst_begin, src_begin, size_type(src_end - src_begin));
+                _size -= size_type(src_begin - dst_begin);
+                return dst_begin;
+            }
+
+            // Shift forward elements after the erase range otherwise.
             auto dst_end = std::move(src_begin, src_end, dst_begin);
 
             // Truncate after the shift.
@@ -665,6 +753,39 @@ namespace gdt
             return dst_begin;
         }
 
+        // Swap remove.
+        // Like erase, but moves the last element into the gap
+        // instead of shifting. Doesn't preserve element order.
+        constexpr iterator swap_remove(const_iterator position)
+        {
+            gdt_assume(position >= begin());
+            gdt_assume(position < end());
+
+            auto beg = begin();
+            auto pos = position - beg + beg;
+            auto last = end() - 1;
+
+            if (_can_memcpy())
+            {
+                _destroy(std::addressof(*pos));
+                if (pos != last)
+                {
+                    _memmove(pos, last, 1);
+                }
+                --_size;
+            }
+            else
+            {
+                if (pos != last)
+                {
+                    *pos = std::move(*last);
+                }
+                pop_back();
+            }
+
+            return pos;
+        }
+
         // Swap.
         constexpr void swap(
             dynarr& other)
@@ -712,8 +833,9 @@ namespace gdt
         }
 
         // Comparison.
+        template<typename U = T>
         friend constexpr auto operator<=>(const dynarr& lhs, const dynarr& rhs)
-        -> decltype(lhs[0] <=> rhs[0])
+        -> decltype(std::declval<const U&>() <=> std::declval<const U&>())
         {
             // TODO: Use lexicographical_compare_three_way.
 
@@ -771,23 +893,28 @@ namespace gdt
         // Choose a new capacity >= `req_capacity`.
         constexpr size_type _choose_new_capacity(size_type req_capacity)
         {
-            auto max_capacity = max_size();
-            auto capacity_x2 = size_type(_capacity * 2);
-            if (capacity_x2 < _capacity || capacity_x2 > max_capacity)
-            {
-                capacity_x2 = max_capacity;
-            }
+            auto new_capacity = Growth::next_capacity(
+                _capacity, req_capacity, max_size(), sizeof(T));
 
-            return std::max(req_capacity, capacity_x2);
+            gdt_assume(new_capacity >= req_capacity);
+            return new_capacity;
         }
 
-        // Allocate a buffer with capacity `n`.
-        constexpr pointer _allocate(size_type n)
+        // Allocate a buffer with capacity of at least `n`.
+        // Updates `n` to the actual capacity.
+        constexpr pointer _allocate(size_type& n)
         {
             if (n == 0)
             {
                 return nullptr;
             }
+            else if constexpr (gdt_detail::has_allocate_at_least<Allocator>)
+            {
+                auto [ptr, count] = _allocator.allocate_at_least(n);
+                gdt_assume(count >= n);
+                n = size_type(count);
+                return ptr;
+            }
             else
             {
                 return std::allocator_traits<Allocator>::allocate(
@@ -812,9 +939,12 @@ namespace gdt
         // Destroy range using allocator.
         constexpr void _destroy(iterator first, iterator last) noexcept
         {
-            for (; first < last; ++first)
+            if constexpr (!gdt_detail::is_trivially_destroyable<Allocator, T>)
             {
-                _destroy(std::addressof(*first));
+                for (; first < last; ++first)
+                {
+                    _destroy(std::addressof(*first));
+                }
             }
         }
 
@@ -826,10 +956,44 @@ namespace gdt
             _construct(p, std::forward<Args>(args)...);
         }
 
+        // Can relocate elements with memcpy/memmove right now?
+        static constexpr bool _can_memcpy() noexcept
+        {
+            if constexpr (
+                gdt_detail::is_memcpy_relocatable<Allocator, T>)
+            {
+                return !std::is_constant_evaluated();
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        // Relocate `n` elements from `src` to `dst` with memmove.
+        // The ranges may overlap.
+        static void _memmove(iterator dst, iterator src, size_type n)
+        noexcept
+        {
+            if (n > 0)
+            {
+                std::memmove(
+                    static_cast<void*>(std::to_address(dst._ptr)),
+                    static_cast<const void*>(std::to_address(src._ptr)),
+                    sizeof(T) * std::size_t(n));
+            }
+        }
+
         // Move and destroy `n` elements from `src` to `dst`.
         constexpr void _migrate(iterator dst, iterator src, size_type n)
         noexcept
         {
+            if (_can_memcpy())
+            {
+                _memmove(dst, src, n);
+                return;
+            }
+
             for (; n > 0; ++dst, ++src, --n)
             {
                 _construct(std::addressof(*dst), std::move(*src));
@@ -847,11 +1011,48 @@ namespace gdt
             }
         }
 
+        // Grow the current buffer in place if the allocator supports it.
+        constexpr bool _try_expand(size_type new_capacity)
+        {
+            if constexpr (gdt_detail::has_try_expand<Allocator>)
+            {
+                if (!std::is_constant_evaluated() &&
+                    _ptr != nullptr &&
+                    new_capacity > _capacity &&
+                    _allocator.try_expand(_ptr, _capacity, new_capacity))
+                {
+                    _capacity = new_capacity;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
         // Move to a new buffer with the given capacity.
         constexpr void _reallocate(size_type new_capacity)
         {
             gdt_assume(new_capacity >= _size);
 
+            // Resize in place if possible.
+            if (_try_expand(new_capacity))
+            {
+                return;
+            }
+
+            // Let the allocator move the buffer if it
+            // supports it and we'd just memcpy otherwise.
+            if constexpr (gdt_detail::has_reallocate<Allocator>)
+            {
+                if (_can_memcpy() && _ptr != nullptr && new_capacity != 0)
+                {
+                    _ptr = _allocator.reallocate(
+                        _ptr, _capacity, new_capacity);
+                    _capacity = new_capacity;
+                    return;
+                }
+            }
+
             auto new_ptr = _allocate(new_capacity);
             _migrate(iterator(new_ptr), begin(), _size);
             _deallocate();
@@ -901,9 +1102,9 @@ namespace gdt
         constexpr void _reserve_or_shrink(size_type tgt_len)
         {
             reserve(tgt_len);
-            while (_size > tgt_len)
+            if (_size > tgt_len)
             {
-                pop_back();
+                _truncate(begin() + difference_type(tgt_len));
             }
         }
 
@@ -917,12 +1118,103 @@ namespace gdt
         }
 
         // Grow to at least `tgt_len` using `fill_value` for new elements.
+        // Capacity must already be reserved.
         constexpr void _fill_to(size_type tgt_len, const T& fill_value)
         {
-            while (_size < tgt_len)
+            if (_size < tgt_len)
+            {
+                _construct_back(size_type(tgt_len - _size), fill_value);
+            }
+        }
+
+        // Construct `n` elements after the end from `args`.
+        // Capacity must already be reserved.
+        template<typename... Args>
+        constexpr void _construct_back(size_type n, const Args&... args)
+        {
+            gdt_assume(n <= _capacity - _size);
+
+            auto dst = end();
+            auto dst_end = dst + difference_type(n);
+            if constexpr (gdt_detail::is_nothrow_constructible_with<
+                Allocator, T, const Args&...>)
+            {
+                // Nothing can throw, so only update the size once.
+                for (; dst < dst_end; ++dst)
+                {
+                    _construct(std::addressof(*dst), args...);
+                }
+                _size += n;
+            }
+            else
+            {
+                // Keep the size in sync for basic exception safety.
+                for (; dst < dst_end; ++dst)
+                {
+                    _construct(std::addressof(*dst), args...);
+                    ++_size;
+                }
+            }
+        }
+
+        // Default-initialize `n` elements after the end.
+        // Capacity must already be reserved.
+        constexpr void _default_init_back(size_type n)
+        {
+            gdt_assume(n <= _capacity - _size);
+
+            // Placement new is the only way to default-initialize, and
+            // it isn't allowed in constant evaluation or if the allocator
+            // has a custom `construct`, so value-initialize in those cases.
+            if constexpr (
+                !gdt_detail::has_custom_construct_or_destroy<Allocator, T>)
+            {
+                if (std::is_constant_evaluated())
+                {
+                    // Fall through.
+                }
+                else if constexpr (
+                    std::is_trivially_default_constructible_v<T>)
+                {
+                    _size += n;
+                    return;
+                }
+                else
+                {
+                    auto dst = end();
+                    auto dst_end = dst + difference_type(n);
+                    for (; dst < dst_end; ++dst)
+                    {
+                        ::new(static_cast<void*>(std::addressof(*dst))) T;
+                        ++_size;
+                    }
+                    return;
+                }
+            }
+
+            _construct_back(n);
+        }
+
+        // Value-initialize `n` elements after the end.
+        // Capacity must already be reserved.
+        constexpr void _value_init_back(size_type n)
+        {
+            gdt_assume(n <= _capacity - _size);
+
+            if constexpr (
+                gdt_detail::is_memset_value_initializable<Allocator, T>)
             {
-                push_back(fill_value);
+                if (!std::is_constant_evaluated())
+                {
+                    std::memset(
+                        static_cast<void*>(std::to_address(end()._ptr)),
+                        0, sizeof(T) * std::size_t(n));
+                    _size += n;
+                    return;
+                }
             }
+
+            _construct_back(n);
         }
 
         // Emplace or insert.
@@ -939,7 +1231,7 @@ namespace gdt
             gdt_assume(position <= end());
 
             // Emplace in the middle of migration if reallocation is necessary.
-            if (_capacity == _size)
+            if (_capacity == _size && !_try_expand(_choose_next_capacity()))
             {
                 auto new_capacity = _choose_next_capacity();
                 auto new_ptr = _allocate(new_capacity);
@@ -958,6 +1250,16 @@ namespace gdt
                 return old_end;
             }
 
+            // Relocate all elements from position onward
+            // back and emplace in the gap if possible.
+            if (_can_memcpy())
+            {
+                auto beg = begin();
+                auto pos = position - beg + beg;
+                _emplace_relocate(pos, std::forward<Args>(args)...);
+                return pos;
+            }
+
             // Shift all elements from position onward back otherwise.
             auto old_end_m1 = old_end - 1;
             _construct(std::addressof(*old_end), std::move(*old_end_m1));
@@ -982,6 +1284,19 @@ namespace gdt
             return pos;
         }
 
+        // Relocate elements from `pos` onward back by one
+        // and emplace in the gap. Only valid if `_can_memcpy()`.
+        template<
+            typename... Args>
+        void _emplace_relocate(iterator pos, Args&&... args) noexcept
+        {
+            gdt_assume(_capacity > _size);
+
+            _memmove(pos + 1, pos, size_type(end() - pos));
+            _construct(std::addressof(*pos), std::forward<Args>(args)...);
+            ++_size;
+        }
+
         // Insert multiple.
         template<
             typename InputIterator>
@@ -1007,7 +1322,8 @@ namespace gdt
 
                 // Insert in the middle of migration
                 // if reallocation is necessary.
-                if (_capacity < new_size)
+                if (_capacity < new_size &&
+                    !_try_expand(_choose_new_capacity(new_size)))
                 {
                     auto new_capacity = _choose_new_capacity(new_size);
                     auto new_ptr = _allocate(new_capacity);
@@ -1145,11 +1461,26 @@ namespace gdt
             gdt_assume(position >= begin());
             gdt_assume(position <= end());
 
-            // Shift all elements from position onward back.
+            // Relocate all elements from position onward back
+            // and construct in the gap if possible.
             auto beg = begin();
+            auto pos = position - beg + beg;
+            if (_can_memcpy())
+            {
+                auto gap_end = pos + difference_type(new_size - _size);
+                _memmove(gap_end, pos, size_type(end() - pos));
+                for (auto dst = pos; dst < gap_end; ++dst, ++first)
+                {
+                    _construct(std::addressof(*dst), *first);
+                }
+
+                _size = new_size;
+                return pos;
+            }
+
+            // Shift all elements from position onward back otherwise.
             auto dst = beg + new_size;
             auto src = beg + _size;
-            auto pos = position - beg + beg;
 
             auto old_end = end();
             while (dst > old_end && src > pos)
@@ -1192,7 +1523,7 @@ namespace gdt
 
                 while (dst < dst_end)
                 {
-                    _construct(std::addressof(*dst++, *first++));
+                    _construct(std::addressof(*dst++), *first++);
                 }
             }
 
@@ -1210,28 +1541,36 @@ namespace gdt
     dynarr(InputIterator, InputIterator, Allocator = Allocator()) ->
     dynarr<typename std::iterator_traits<InputIterator>::value_type, Allocator>;
 
+    // Dynarr is trivially relocatable if its allocator and pointer are.
+    template<typename T, typename Allocator, typename Growth>
+    struct is_trivially_relocatable<dynarr<T, Allocator, Growth>> :
+        std::bool_constant<
+            is_trivially_relocatable_v<Allocator> &&
+            is_trivially_relocatable_v<
+                typename std::allocator_traits<Allocator>::pointer>> {};
+
     // Erase.
-    template<typename T, typename Allocator, typename U>
-    constexpr typename dynarr<T, Allocator>::size_type
-    erase(dynarr<T, Allocator>& a, const U& value)
+    template<typename T, typename Allocator, typename Growth, typename U>
+    constexpr typename dynarr<T, Allocator, Growth>::size_type
+    erase(dynarr<T, Allocator, Growth>& a, const U& value)
     {
         auto old_end = a.end();
         auto new_end = std::remove(a.begin(), old_end, value);
-        using size_type = typename dynarr<T, Allocator>::size_type;
+        using size_type = typename dynarr<T, Allocator, Growth>::size_type;
         auto count = size_type(old_end - new_end);
         a.erase(new_end, old_end);
         return count;
     }
 
     // Erase if.
-    template<typename T, typename Allocator, typename Pred>
-    constexpr typename dynarr<T, Allocator>::size_type
-    erase_if(dynarr<T, Allocator>& a, Pred&& pred)
+    template<typename T, typename Allocator, typename Growth, typename Pred>
+    constexpr typename dynarr<T, Allocator, Growth>::size_type
+    erase_if(dynarr<T, Allocator, Growth>& a, Pred&& pred)
     {
         auto beg = a.begin();
         auto old_end = a.end();
         auto new_end = std::remove_if(beg, old_end, std::forward<Pred>(pred));
-        using size_type = typename dynarr<T, Allocator>::size_type;
+        using size_type = typename dynarr<T, Allocator, Growth>::size_type;
         auto count = size_type(old_end - new_end);
         a.erase(new_end, old_end);
         return count;
@@ -1364,7 +1703,7 @@ namespace gdt_detail
 
     private:
         // Friends.
-        friend dynarr<T, Allocator>;
+        template<typename, typename, typename> friend class gdt::dynarr;
         friend dynarr_const_iterator<T, Allocator>;
 
         // Member types.
@@ -1529,7 +1868,7 @@ namespace gdt_detail
 
     private:
         // Friends.
-        friend dynarr<T, Allocator>;
+        template<typename, typename, typename> friend class gdt::dynarr;
 
         // Member types.
         using _pointer = typename dynarr<T, Allocator>::const_pointer;
@@ -0,0 +1,806 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/flat_search.hxx"
+#include "allocator.hxx"
+#include "assert.hxx"
+#include "dynarr.hxx"
+#include "growth_policy.hxx"
+#include "trivially_relocatable.hxx"
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace gdt_detail
+{
+    // Flat map iterator.
+    // Walks the key and value arrays in step. Dereferencing gives a
+    // pair of references rather than a reference to a pair, since no
+    // pair is ever stored.
+    template<typename K, typename V, typename DiffT>
+    class flat_map_iterator
+    {
+    public:
+        // Member types.
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+        using value_type = std::pair<K, std::remove_const_t<V>>;
+        using difference_type = DiffT;
+        using reference = std::pair<const K&, V&>;
+
+        // Pointer.
+        // Keeps the pair of references alive for `operator->`.
+        class pointer
+        {
+        public:
+            // Constructor.
+            constexpr pointer(reference ref) noexcept
+            :
+                _ref{ref}
+            {}
+
+            // Member access.
+            constexpr const reference* operator->() const noexcept
+            {
+                return std::addressof(_ref);
+            }
+
+        private:
+            // Member variables.
+            reference _ref;
+        };
+
+        // Constructor.
+        constexpr flat_map_iterator() = default;
+
+        // Constructor.
+        constexpr flat_map_iterator(const K* key, V* value) noexcept
+        :
+            _key{key},
+            _value{value}
+        {}
+
+        // Constructor.
+        // Converts iterator to const iterator.
+        template<typename U>
+        requires std::is_same_v<const U, V> && (!std::is_same_v<U, V>)
+        constexpr flat_map_iterator(
+            const flat_map_iterator<K, U, DiffT>& other) noexcept
+        :
+            _key{other._key},
+            _value{other._value}
+        {}
+
+        // Dereference.
+        constexpr reference operator*() const
+        {
+            return {*_key, *_value};
+        }
+
+        // Member access.
+        constexpr pointer operator->() const
+        {
+            return **this;
+        }
+
+        // Subscript.
+        constexpr reference operator[](DiffT i) const
+        {
+            return *(*this + i);
+        }
+
+        // Pre-increment.
+        constexpr flat_map_iterator& operator++()
+        {
+            ++_key;
+            ++_value;
+            return *this;
+        }
+
+        // Pre-decrement.
+        constexpr flat_map_iterator& operator--()
+        {
+            --_key;
+            --_value;
+            return *this;
+        }
+
+        // Post-increment.
+        constexpr flat_map_iterator operator++(int)
+        {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        // Post-decrement.
+        constexpr flat_map_iterator operator--(int)
+        {
+            auto old = *this;
+            --*this;
+            return old;
+        }
+
+        // Addition assignment.
+        constexpr flat_map_iterator& operator+=(DiffT n)
+        {
+            _key += n;
+            _value += n;
+            return *this;
+        }
+
+        // Subtraction assignment.
+        constexpr flat_map_iterator& operator-=(DiffT n)
+        {
+            _key -= n;
+            _value -= n;
+            return *this;
+        }
+
+        // Addition.
+        friend constexpr flat_map_iterator operator+(
+            flat_map_iterator lhs,
+            DiffT rhs)
+        {
+            return lhs += rhs;
+        }
+
+        // Addition.
+        friend constexpr flat_map_iterator operator+(
+            DiffT lhs,
+            flat_map_iterator rhs)
+        {
+            return rhs += lhs;
+        }
+
+        // Subtraction.
+        friend constexpr flat_map_iterator operator-(
+            flat_map_iterator lhs,
+            DiffT rhs)
+        {
+            return lhs -= rhs;
+        }
+
+        // Difference.
+        friend constexpr DiffT operator-(
+            const flat_map_iterator& lhs,
+            const flat_map_iterator& rhs)
+        {
+            return DiffT(lhs._key - rhs._key);
+        }
+
+        // Equality.
+        friend constexpr bool operator==(
+            const flat_map_iterator& lhs,
+            const flat_map_iterator& rhs)
+        {
+            return lhs._key == rhs._key;
+        }
+
+        // Comparison.
+        friend constexpr std::strong_ordering operator<=>(
+            const flat_map_iterator& lhs,
+            const flat_map_iterator& rhs)
+        {
+            return lhs._key <=> rhs._key;
+        }
+
+    private:
+        template<typename, typename, typename>
+        friend class flat_map_iterator;
+
+        // Member variables.
+        const K* _key = nullptr;
+        V* _value = nullptr;
+    };
+}
+
+namespace gdt
+{
+    // Flat map.
+    // Keys stay sorted in one dynarr and values sit at the same index in
+    // another, so a lookup's binary search only touches dense keys and
+    // reads a single value at the end. Updates cost what they do in
+    // `flat_set`, plus the same shift in the value array.
+    template<
+        typename K,
+        typename V,
+        typename Compare = std::less<K>,
+        typename Allocator = allocator<std::pair<K, V>>,
+        typename Growth = default_growth>
+    class flat_map
+    {
+        // Member types.
+        using _key_allocator = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<K>;
+        using _value_allocator = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<V>;
+        using _pair_allocator = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<std::pair<K, V>>;
+
+    public:
+        // Member types.
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+        using key_compare = Compare;
+        using allocator_type = Allocator;
+        using growth_policy = Growth;
+        using keys_type = dynarr<K, _key_allocator, Growth>;
+        using values_type = dynarr<V, _value_allocator, Growth>;
+        using size_type = typename keys_type::size_type;
+        using difference_type = typename keys_type::difference_type;
+        using iterator = gdt_detail::flat_map_iterator<
+            K, V, difference_type>;
+        using const_iterator = gdt_detail::flat_map_iterator<
+            K, const V, difference_type>;
+        using reference = typename iterator::reference;
+        using const_reference = typename const_iterator::reference;
+
+    private:
+        // Member variables.
+        [[no_unique_address]] Compare _compare;
+        keys_type _keys;
+        values_type _values;
+
+    public:
+        // Constructor.
+        constexpr flat_map()
+        noexcept(noexcept(Compare()) && noexcept(Allocator()))
+        :
+            flat_map(Compare())
+        {}
+
+        // Constructor.
+        explicit constexpr flat_map(
+            const Compare& compare,
+            const Allocator& allocator = Allocator()) noexcept
+        :
+            _compare{compare},
+            _keys(_key_allocator(allocator)),
+            _values(_value_allocator(allocator))
+        {}
+
+        // Constructor.
+        explicit constexpr flat_map(const Allocator& allocator) noexcept
+        :
+            flat_map(Compare(), allocator)
+        {}
+
+        // Constructor.
+        template<
+            typename InputIterator>
+        requires std::is_base_of_v<
+            std::input_iterator_tag,
+            typename std::iterator_traits<InputIterator>::iterator_category>
+        constexpr flat_map(
+            InputIterator first,
+            InputIterator last,
+            const Compare& compare = Compare(),
+            const Allocator& allocator = Allocator())
+        :
+            flat_map(compare, allocator)
+        {
+            insert(first, last);
+        }
+
+        // Constructor.
+        constexpr flat_map(
+            std::initializer_list<value_type> il,
+            const Compare& compare = Compare(),
+            const Allocator& allocator = Allocator())
+        :
+            flat_map(il.begin(), il.end(), compare, allocator)
+        {}
+
+        // Get allocator.
+        constexpr allocator_type get_allocator() const noexcept
+        {
+            return allocator_type(_keys.get_allocator());
+        }
+
+        // Key compare.
+        constexpr key_compare key_comp() const
+        {
+            return _compare;
+        }
+
+        // Begin.
+        constexpr iterator begin() noexcept
+        {
+            return _iterator_at(0);
+        }
+
+        // Begin.
+        constexpr const_iterator begin() const noexcept
+        {
+            return _iterator_at(0);
+        }
+
+        // End.
+        constexpr iterator end() noexcept
+        {
+            return _iterator_at(std::size_t(size()));
+        }
+
+        // End.
+        constexpr const_iterator end() const noexcept
+        {
+            return _iterator_at(std::size_t(size()));
+        }
+
+        // Const begin.
+        constexpr const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        // Const end.
+        constexpr const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        // Empty.
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return _keys.empty();
+        }
+
+        // Size.
+        constexpr size_type size() const noexcept
+        {
+            return _keys.size();
+        }
+
+        // Max size.
+        constexpr size_type max_size() const noexcept
+        {
+            return (std::min)(_keys.max_size(), _values.max_size());
+        }
+
+        // Capacity.
+        constexpr size_type capacity() const noexcept
+        {
+            return (std::min)(_keys.capacity(), _values.capacity());
+        }
+
+        // Reserve.
+        constexpr void reserve(size_type req_capacity)
+        {
+            _keys.reserve(req_capacity);
+            _values.reserve(req_capacity);
+        }
+
+        // Shrink to fit.
+        constexpr void shrink_to_fit()
+        {
+            _keys.shrink_to_fit();
+            _values.shrink_to_fit();
+        }
+
+        // Keys.
+        // Every key, sorted and contiguous.
+        constexpr std::span<const K> keys() const noexcept
+        {
+            return {_keys.data(), std::size_t(size())};
+        }
+
+        // Values.
+        // Every mapped value, contiguous, in key order.
+        constexpr std::span<V> values() noexcept
+        {
+            return {_values.data(), std::size_t(size())};
+        }
+
+        // Values.
+        constexpr std::span<const V> values() const noexcept
+        {
+            return {_values.data(), std::size_t(size())};
+        }
+
+        // Insert.
+        constexpr std::pair<iterator, bool> insert(const value_type& value)
+        {
+            return _try_emplace(value.first, value.second);
+        }
+
+        // Insert.
+        constexpr std::pair<iterator, bool> insert(value_type&& value)
+        {
+            return _try_emplace(
+                std::move(value.first),
+                std::move(value.second));
+        }
+
+        // Insert.
+        // Appends every pair, sorts them and merges them in, rather than
+        // shifting the tail once per pair. Keys already in the map, and
+        // all but the first of equivalent new keys, are dropped.
+        template<
+            typename InputIterator>
+        requires std::is_base_of_v<
+            std::input_iterator_tag,
+            typename std::iterator_traits<InputIterator>::iterator_category>
+        constexpr void insert(InputIterator first, InputIterator last)
+        {
+            _insert_range(first, last);
+        }
+
+        // Insert.
+        constexpr void insert(std::initializer_list<value_type> il)
+        {
+            _insert_range(il.begin(), il.end());
+        }
+
+        // Insert range.
+        template<std::ranges::input_range R>
+        constexpr void insert_range(R&& range)
+        {
+            _insert_range(std::ranges::begin(range), std::ranges::end(range));
+        }
+
+        // Emplace.
+        template<typename... Args>
+        constexpr std::pair<iterator, bool> emplace(Args&&... args)
+        {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        // Try emplace.
+        // Constructs the mapped value from `args` only if `key` isn't there.
+        template<typename... Args>
+        constexpr std::pair<iterator, bool> try_emplace(
+            const K& key,
+            Args&&... args)
+        {
+            return _try_emplace(key, std::forward<Args>(args)...);
+        }
+
+        // Try emplace.
+        template<typename... Args>
+        constexpr std::pair<iterator, bool> try_emplace(
+            K&& key,
+            Args&&... args)
+        {
+            return _try_emplace(std::move(key), std::forward<Args>(args)...);
+        }
+
+        // Insert or assign.
+        template<typename M>
+        constexpr std::pair<iterator, bool> insert_or_assign(
+            const K& key,
+            M&& obj)
+        {
+            return _insert_or_assign(key, std::forward<M>(obj));
+        }
+
+        // Insert or assign.
+        template<typename M>
+        constexpr std::pair<iterator, bool> insert_or_assign(
+            K&& key,
+            M&& obj)
+        {
+            return _insert_or_assign(std::move(key), std::forward<M>(obj));
+        }
+
+        // Subscript.
+        // Value-initializes the mapped value if `key` isn't there.
+        constexpr V& operator[](const K& key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        // Subscript.
+        constexpr V& operator[](K&& key)
+        {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        // At.
+        constexpr V& at(const K& key)
+        {
+            auto i = _lower_bound(key);
+            gdt_assert(_found(i, key));
+            return _values[size_type(i)];
+        }
+
+        // At.
+        constexpr const V& at(const K& key) const
+        {
+            auto i = _lower_bound(key);
+            gdt_assert(_found(i, key));
+            return _values[size_type(i)];
+        }
+
+        // Erase.
+        constexpr iterator erase(const_iterator position)
+        {
+            return erase(position, std::next(position));
+        }
+
+        // Erase.
+        constexpr iterator erase(const_iterator first, const_iterator last)
+        {
+            auto i = first - cbegin();
+            auto j = last - cbegin();
+            _keys.erase(_keys.begin() + i, _keys.begin() + j);
+            _values.erase(_values.begin() + i, _values.begin() + j);
+            return begin() + i;
+        }
+
+        // Erase.
+        // Returns the number of pairs erased.
+        constexpr size_type erase(const K& key)
+        {
+            auto it = find(key);
+            if (it == end())
+            {
+                return 0;
+            }
+
+            erase(it);
+            return 1;
+        }
+
+        // Clear.
+        constexpr void clear() noexcept
+        {
+            _keys.clear();
+            _values.clear();
+        }
+
+        // Swap.
+        constexpr void swap(flat_map& other)
+        noexcept(
+            noexcept(std::declval<keys_type&>().swap(
+                std::declval<keys_type&>())) &&
+            noexcept(std::declval<values_type&>().swap(
+                std::declval<values_type&>())))
+        {
+            using std::swap;
+            swap(_compare, other._compare);
+            _keys.swap(other._keys);
+            _values.swap(other._values);
+        }
+
+        // Swap.
+        friend constexpr void swap(flat_map& lhs, flat_map& rhs)
+        noexcept(noexcept(lhs.swap(rhs)))
+        {
+            lhs.swap(rhs);
+        }
+
+        // Count.
+        constexpr size_type count(const K& key) const
+        {
+            return size_type(contains(key));
+        }
+
+        // Find.
+        constexpr iterator find(const K& key)
+        {
+            auto i = _lower_bound(key);
+            return _found(i, key) ? _iterator_at(i) : end();
+        }
+
+        // Find.
+        constexpr const_iterator find(const K& key) const
+        {
+            auto i = _lower_bound(key);
+            return _found(i, key) ? _iterator_at(i) : end();
+        }
+
+        // Contains.
+        constexpr bool contains(const K& key) const
+        {
+            return _found(_lower_bound(key), key);
+        }
+
+        // Lower bound.
+        constexpr iterator lower_bound(const K& key)
+        {
+            return _iterator_at(_lower_bound(key));
+        }
+
+        // Lower bound.
+        constexpr const_iterator lower_bound(const K& key) const
+        {
+            return _iterator_at(_lower_bound(key));
+        }
+
+        // Upper bound.
+        constexpr iterator upper_bound(const K& key)
+        {
+            return _iterator_at(_upper_bound(key));
+        }
+
+        // Upper bound.
+        constexpr const_iterator upper_bound(const K& key) const
+        {
+            return _iterator_at(_upper_bound(key));
+        }
+
+        // Equality.
+        friend constexpr bool operator==(
+            const flat_map& lhs,
+            const flat_map& rhs)
+        {
+            return lhs._keys == rhs._keys && lhs._values == rhs._values;
+        }
+
+    private:
+        // Iterator at index `i`.
+        constexpr iterator _iterator_at(std::size_t i) noexcept
+        {
+            return {_keys.data() + i, _values.data() + i};
+        }
+
+        // Iterator at index `i`.
+        constexpr const_iterator _iterator_at(std::size_t i) const noexcept
+        {
+            return {_keys.data() + i, _values.data() + i};
+        }
+
+        // Index of the first key not less than `key`.
+        constexpr std::size_t _lower_bound(const K& key) const
+        {
+            return gdt_detail::flat_lower_bound(
+                _keys.data(), std::size_t(size()), key, _compare);
+        }
+
+        // Index of the first key greater than `key`.
+        constexpr std::size_t _upper_bound(const K& key) const
+        {
+            return gdt_detail::flat_upper_bound(
+                _keys.data(), std::size_t(size()), key, _compare);
+        }
+
+        // Key at index `i` from `_lower_bound` is equivalent to `key`?
+        constexpr bool _found(std::size_t i, const K& key) const
+        {
+            return i < size() && !_compare(key, _keys[size_type(i)]);
+        }
+
+        // Try emplace.
+        template<typename Key, typename... Args>
+        constexpr std::pair<iterator, bool> _try_emplace(
+            Key&& key,
+            Args&&... args)
+        {
+            auto i = _lower_bound(key);
+            if (_found(i, key))
+            {
+                return {_iterator_at(i), false};
+            }
+
+            auto offset = difference_type(i);
+            _values.emplace(
+                _values.begin() + offset,
+                std::forward<Args>(args)...);
+            _keys.insert(_keys.begin() + offset, std::forward<Key>(key));
+            return {_iterator_at(i), true};
+        }
+
+        // Insert or assign.
+        template<typename Key, typename M>
+        constexpr std::pair<iterator, bool> _insert_or_assign(
+            Key&& key,
+            M&& obj)
+        {
+            auto ret = _try_emplace(std::forward<Key>(key), std::forward<M>(obj));
+            if (!ret.second)
+            {
+                ret.first->second = std::forward<M>(obj);
+            }
+            return ret;
+        }
+
+        // Insert range.
+        // Gathers the new pairs into their own run first, since sorting
+        // the tails of two arrays in step would need a permutation.
+        template<typename InputIterator, typename Sentinel>
+        constexpr void _insert_range(InputIterator first, Sentinel last)
+        {
+            dynarr<value_type, _pair_allocator, Growth> run(
+                _pair_allocator(_keys.get_allocator()));
+            if constexpr (std::forward_iterator<InputIterator>)
+            {
+                run.reserve(size_type(std::ranges::distance(first, last)));
+            }
+            for (; first != last; ++first)
+            {
+                run.emplace_back(*first);
+            }
+
+            auto compare = [this](const value_type& a, const value_type& b)
+            {
+                return _compare(a.first, b.first);
+            };
+            run.erase(
+                gdt_detail::flat_sort_unique(run.begin(), run.end(), compare),
+                run.end());
+            if (run.empty())
+            {
+                return;
+            }
+
+            // Everything new goes after everything old.
+            if (empty() || _compare(_keys.back(), run.front().first))
+            {
+                reserve(size_type(size() + run.size()));
+                for (auto& pair : run)
+                {
+                    _keys.push_back(std::move(pair.first));
+                    _values.push_back(std::move(pair.second));
+                }
+                return;
+            }
+
+            keys_type keys(_keys.get_allocator());
+            values_type values(_values.get_allocator());
+            keys.reserve(size_type(size() + run.size()));
+            values.reserve(size_type(size() + run.size()));
+
+            size_type i = 0;
+            auto j = run.begin();
+            while (i < size() && j != run.end())
+            {
+                if (_compare(j->first, _keys[i]))
+                {
+                    keys.push_back(std::move(j->first));
+                    values.push_back(std::move(j->second));
+                    ++j;
+                }
+                else
+                {
+                    j += difference_type(!_compare(_keys[i], j->first));
+                    keys.push_back(std::move(_keys[i]));
+                    values.push_back(std::move(_values[i]));
+                    ++i;
+                }
+            }
+            for (; i < size(); ++i)
+            {
+                keys.push_back(std::move(_keys[i]));
+                values.push_back(std::move(_values[i]));
+            }
+            for (; j != run.end(); ++j)
+            {
+                keys.push_back(std::move(j->first));
+                values.push_back(std::move(j->second));
+            }
+
+            _keys.swap(keys);
+            _values.swap(values);
+        }
+    };
+
+    // Flat map is trivially relocatable if its comparison and dynarrs are.
+    template<
+        typename K,
+        typename V,
+        typename Compare,
+        typename Allocator,
+        typename Growth>
+    struct is_trivially_relocatable<
+        flat_map<K, V, Compare, Allocator, Growth>> :
+        std::bool_constant<
+            is_trivially_relocatable_v<Compare> &&
+            is_trivially_relocatable_v<typename flat_map<
+                K, V, Compare, Allocator, Growth>::keys_type> &&
+            is_trivially_relocatable_v<typename flat_map<
+                K, V, Compare, Allocator, Growth>::values_type>> {};
+}
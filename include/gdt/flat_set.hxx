@@ -0,0 +1,430 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/flat_search.hxx"
+#include "allocator.hxx"
+#include "dynarr.hxx"
+#include "growth_policy.hxx"
+#include "trivially_relocatable.hxx"
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace gdt
+{
+    // Flat set.
+    // Keys stay sorted in one contiguous dynarr, so lookups are a
+    // binary search over dense memory. Inserting and erasing shift
+    // everything after the key, which suits tables that are built
+    // once (preferably with a single bulk insert) and read often.
+    template<
+        typename K,
+        typename Compare = std::less<K>,
+        typename Allocator = allocator<K>,
+        typename Growth = default_growth>
+    class flat_set
+    {
+    public:
+        // Member types.
+        using key_type = K;
+        using value_type = K;
+        using key_compare = Compare;
+        using value_compare = Compare;
+        using allocator_type = Allocator;
+        using growth_policy = Growth;
+        using keys_type = dynarr<K, Allocator, Growth>;
+        using size_type = typename keys_type::size_type;
+        using difference_type = typename keys_type::difference_type;
+        using reference = const K&;
+        using const_reference = const K&;
+        using iterator = typename keys_type::const_iterator;
+        using const_iterator = typename keys_type::const_iterator;
+
+    private:
+        // Member variables.
+        [[no_unique_address]] Compare _compare;
+        keys_type _keys;
+
+    public:
+        // Constructor.
+        constexpr flat_set()
+        noexcept(noexcept(Compare()) && noexcept(Allocator()))
+        :
+            flat_set(Compare())
+        {}
+
+        // Constructor.
+        explicit constexpr flat_set(
+            const Compare& compare,
+            const Allocator& allocator = Allocator()) noexcept
+        :
+            _compare{compare},
+            _keys(allocator)
+        {}
+
+        // Constructor.
+        explicit constexpr flat_set(const Allocator& allocator) noexcept
+        :
+            flat_set(Compare(), allocator)
+        {}
+
+        // Constructor.
+        template<
+            typename InputIterator>
+        requires std::is_base_of_v<
+            std::input_iterator_tag,
+            typename std::iterator_traits<InputIterator>::iterator_category>
+        constexpr flat_set(
+            InputIterator first,
+            InputIterator last,
+            const Compare& compare = Compare(),
+            const Allocator& allocator = Allocator())
+        :
+            flat_set(compare, allocator)
+        {
+            insert(first, last);
+        }
+
+        // Constructor.
+        constexpr flat_set(
+            std::initializer_list<K> il,
+            const Compare& compare = Compare(),
+            const Allocator& allocator = Allocator())
+        :
+            flat_set(il.begin(), il.end(), compare, allocator)
+        {}
+
+        // Get allocator.
+        constexpr allocator_type get_allocator() const noexcept
+        {
+            return _keys.get_allocator();
+        }
+
+        // Key compare.
+        constexpr key_compare key_comp() const
+        {
+            return _compare;
+        }
+
+        // Value compare.
+        constexpr value_compare value_comp() const
+        {
+            return _compare;
+        }
+
+        // Begin.
+        constexpr const_iterator begin() const noexcept
+        {
+            return _keys.begin();
+        }
+
+        // End.
+        constexpr const_iterator end() const noexcept
+        {
+            return _keys.end();
+        }
+
+        // Const begin.
+        constexpr const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        // Const end.
+        constexpr const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        // Empty.
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return _keys.empty();
+        }
+
+        // Size.
+        constexpr size_type size() const noexcept
+        {
+            return _keys.size();
+        }
+
+        // Max size.
+        constexpr size_type max_size() const noexcept
+        {
+            return _keys.max_size();
+        }
+
+        // Capacity.
+        constexpr size_type capacity() const noexcept
+        {
+            return _keys.capacity();
+        }
+
+        // Reserve.
+        constexpr void reserve(size_type req_capacity)
+        {
+            _keys.reserve(req_capacity);
+        }
+
+        // Shrink to fit.
+        constexpr void shrink_to_fit()
+        {
+            _keys.shrink_to_fit();
+        }
+
+        // Data.
+        constexpr const K* data() const noexcept
+        {
+            return _keys.data();
+        }
+
+        // Keys.
+        // Every key, sorted and contiguous.
+        constexpr std::span<const K> keys() const noexcept
+        {
+            return {_keys.data(), std::size_t(size())};
+        }
+
+        // Insert.
+        constexpr std::pair<iterator, bool> insert(const K& key)
+        {
+            return _insert(key);
+        }
+
+        // Insert.
+        constexpr std::pair<iterator, bool> insert(K&& key)
+        {
+            return _insert(std::move(key));
+        }
+
+        // Insert.
+        // Appends every key, sorts them and merges them in, rather than
+        // shifting the tail once per key. Keys already in the set, and
+        // all but the first of equivalent new keys, are dropped.
+        template<
+            typename InputIterator>
+        requires std::is_base_of_v<
+            std::input_iterator_tag,
+            typename std::iterator_traits<InputIterator>::iterator_category>
+        constexpr void insert(InputIterator first, InputIterator last)
+        {
+            _insert_range(first, last);
+        }
+
+        // Insert.
+        constexpr void insert(std::initializer_list<K> il)
+        {
+            _insert_range(il.begin(), il.end());
+        }
+
+        // Insert range.
+        template<std::ranges::input_range R>
+        constexpr void insert_range(R&& range)
+        {
+            _insert_range(std::ranges::begin(range), std::ranges::end(range));
+        }
+
+        // Emplace.
+        template<typename... Args>
+        constexpr std::pair<iterator, bool> emplace(Args&&... args)
+        {
+            return _insert(K(std::forward<Args>(args)...));
+        }
+
+        // Erase.
+        constexpr iterator erase(const_iterator position)
+        {
+            return _keys.erase(position);
+        }
+
+        // Erase.
+        constexpr iterator erase(const_iterator first, const_iterator last)
+        {
+            return _keys.erase(first, last);
+        }
+
+        // Erase.
+        // Returns the number of keys erased.
+        constexpr size_type erase(const K& key)
+        {
+            auto it = find(key);
+            if (it == end())
+            {
+                return 0;
+            }
+
+            _keys.erase(it);
+            return 1;
+        }
+
+        // Clear.
+        constexpr void clear() noexcept
+        {
+            _keys.clear();
+        }
+
+        // Swap.
+        constexpr void swap(flat_set& other)
+        noexcept(noexcept(std::declval<keys_type&>().swap(
+            std::declval<keys_type&>())))
+        {
+            using std::swap;
+            swap(_compare, other._compare);
+            _keys.swap(other._keys);
+        }
+
+        // Swap.
+        friend constexpr void swap(flat_set& lhs, flat_set& rhs)
+        noexcept(noexcept(lhs.swap(rhs)))
+        {
+            lhs.swap(rhs);
+        }
+
+        // Count.
+        constexpr size_type count(const K& key) const
+        {
+            return size_type(contains(key));
+        }
+
+        // Find.
+        constexpr const_iterator find(const K& key) const
+        {
+            auto i = _lower_bound(key);
+            return _found(i, key) ? begin() + difference_type(i) : end();
+        }
+
+        // Contains.
+        constexpr bool contains(const K& key) const
+        {
+            return _found(_lower_bound(key), key);
+        }
+
+        // Lower bound.
+        constexpr const_iterator lower_bound(const K& key) const
+        {
+            return begin() + difference_type(_lower_bound(key));
+        }
+
+        // Upper bound.
+        constexpr const_iterator upper_bound(const K& key) const
+        {
+            auto i = gdt_detail::flat_upper_bound(
+                _keys.data(), std::size_t(size()), key, _compare);
+            return begin() + difference_type(i);
+        }
+
+        // Equality.
+        friend constexpr bool operator==(
+            const flat_set& lhs,
+            const flat_set& rhs)
+        {
+            return lhs._keys == rhs._keys;
+        }
+
+    private:
+        // Index of the first key not less than `key`.
+        constexpr std::size_t _lower_bound(const K& key) const
+        {
+            return gdt_detail::flat_lower_bound(
+                _keys.data(), std::size_t(size()), key, _compare);
+        }
+
+        // Key at index `i` from `_lower_bound` is equivalent to `key`?
+        constexpr bool _found(std::size_t i, const K& key) const
+        {
+            return i < size() && !_compare(key, _keys[size_type(i)]);
+        }
+
+        // Insert.
+        template<typename Key>
+        constexpr std::pair<iterator, bool> _insert(Key&& key)
+        {
+            auto i = _lower_bound(key);
+            auto position = begin() + difference_type(i);
+            if (_found(i, key))
+            {
+                return {position, false};
+            }
+
+            return {_keys.insert(position, std::forward<Key>(key)), true};
+        }
+
+        // Insert range.
+        template<typename InputIterator, typename Sentinel>
+        constexpr void _insert_range(InputIterator first, Sentinel last)
+        {
+            keys_type run(_keys.get_allocator());
+            if constexpr (std::forward_iterator<InputIterator>)
+            {
+                run.reserve(size_type(std::ranges::distance(first, last)));
+            }
+            for (; first != last; ++first)
+            {
+                run.emplace_back(*first);
+            }
+
+            run.erase(
+                gdt_detail::flat_sort_unique(run.begin(), run.end(), _compare),
+                run.end());
+            if (run.empty())
+            {
+                return;
+            }
+
+            // Everything new goes after everything old.
+            if (empty() || _compare(_keys.back(), run.front()))
+            {
+                _keys.reserve(size_type(size() + run.size()));
+                for (auto& key : run)
+                {
+                    _keys.push_back(std::move(key));
+                }
+                return;
+            }
+
+            keys_type merged(_keys.get_allocator());
+            merged.reserve(size_type(size() + run.size()));
+
+            auto i = _keys.begin();
+            auto j = run.begin();
+            while (i != _keys.end() && j != run.end())
+            {
+                if (_compare(*j, *i))
+                {
+                    merged.push_back(std::move(*j++));
+                }
+                else
+                {
+                    j += difference_type(!_compare(*i, *j));
+                    merged.push_back(std::move(*i++));
+                }
+            }
+            for (; i != _keys.end(); ++i)
+            {
+                merged.push_back(std::move(*i));
+            }
+            for (; j != run.end(); ++j)
+            {
+                merged.push_back(std::move(*j));
+            }
+
+            _keys.swap(merged);
+        }
+    };
+
+    // Flat set is trivially relocatable if its comparison and dynarr are.
+    template<typename K, typename Compare, typename Allocator, typename Growth>
+    struct is_trivially_relocatable<flat_set<K, Compare, Allocator, Growth>> :
+        std::bool_constant<
+            is_trivially_relocatable_v<Compare> &&
+            is_trivially_relocatable_v<dynarr<K, Allocator, Growth>>> {};
+}
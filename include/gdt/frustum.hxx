@@ -0,0 +1,119 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "aabb.hxx"
+#include "assume.hxx"
+#include "mat.hxx"
+#include "vec.hxx"
+#include <cstddef>
+#include <cstdint>
+
+namespace gdt
+{
+    // View frustum.
+    // Six planes facing inward, each `vec4(normal, d)` with the points `p`
+    // where `dot(normal, p) + d >= 0` on the inside.
+    template<typename T>
+    struct frustum
+    {
+    public:
+        // Constructor.
+        constexpr frustum() = default;
+
+        // Constructor.
+        // Left, right, bottom, top, near, and far planes.
+        constexpr frustum(
+            const vec4<T>& left,
+            const vec4<T>& right,
+            const vec4<T>& bottom,
+            const vec4<T>& top,
+            const vec4<T>& near,
+            const vec4<T>& far)
+        :
+            _planes{left, right, bottom, top, near, far}
+        {}
+
+        // Constructor.
+        // Planes of the clip volume of `view_proj`, which maps points inside
+        // to -w <= x, y <= w and 0 <= z <= w. The planes aren't normalized.
+        explicit constexpr frustum(const mat4<T>& view_proj)
+        {
+            auto x = view_proj.row(0);
+            auto y = view_proj.row(1);
+            auto z = view_proj.row(2);
+            auto w = view_proj.row(3);
+            _planes[0] = w + x;
+            _planes[1] = w - x;
+            _planes[2] = w + y;
+            _planes[3] = w - y;
+            _planes[4] = z;
+            _planes[5] = w - z;
+        }
+
+        // Plane `i`.
+        constexpr const vec4<T>& plane(std::size_t i) const
+        {
+            gdt_assume(i < 6);
+            return _planes[i];
+        }
+
+    private:
+        // Member variables.
+        vec4<T> _planes[6];
+    };
+
+    // `box` is at least partly inside `f`.
+    // Conservative: may be true for boxes just outside a corner of `f`.
+    template<typename T>
+    constexpr bool overlaps(const frustum<T>& f, const aabb<T, 3>& box)
+    {
+        for (std::size_t i = 0; i < 6; ++i)
+        {
+            // The corner furthest along the plane normal.
+            auto& p = f.plane(i);
+            auto x = !(p[0] < T(0)) ? box.upper()[0] : box.lower()[0];
+            auto y = !(p[1] < T(0)) ? box.upper()[1] : box.lower()[1];
+            auto z = !(p[2] < T(0)) ? box.upper()[2] : box.lower()[2];
+            if (!(x * p[0] + y * p[1] + z * p[2] + p[3] >= T(0)))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+namespace gdt::batch
+{
+    // Overlaps.
+    // Bit `i` is set if `overlaps(f, boxes.get(i))`.
+    template<typename T, std::size_t W>
+    constexpr std::uint32_t overlaps(
+        const frustum<T>& f,
+        const aabb_soa<T, 3, W>& boxes)
+    {
+        static_assert(W <= 32);
+        auto ret = std::uint32_t((std::uint64_t(1) << W) - 1);
+        for (std::size_t i = 0; i < 6; ++i)
+        {
+            auto& p = f.plane(i);
+            auto x = !(p[0] < T(0)) ? boxes.upper(0) : boxes.lower(0);
+            auto y = !(p[1] < T(0)) ? boxes.upper(1) : boxes.lower(1);
+            auto z = !(p[2] < T(0)) ? boxes.upper(2) : boxes.lower(2);
+            auto inside = x * p[0] + y * p[1] + z * p[2] + p[3] >=
+                vec<T, W>(T(0));
+            for (std::size_t lane = 0; lane < W; ++lane)
+            {
+                if (!inside[lane])
+                {
+                    ret &= ~(std::uint32_t(1) << lane);
+                }
+            }
+        }
+        return ret;
+    }
+}
@@ -0,0 +1,134 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace gdt
+{
+    // Geometric growth.
+    // Grows capacity by a factor of `Num / Den`, to at least `MinCapacity`.
+    template<
+        std::size_t Num = 2,
+        std::size_t Den = 1,
+        std::size_t MinCapacity = 0>
+    requires (Den > 0 && Num > Den)
+    struct geometric_growth
+    {
+        // Next capacity.
+        // Chooses a capacity >= `req_capacity` to grow from `capacity`.
+        template<typename SizeT>
+        static constexpr SizeT next_capacity(
+            SizeT capacity,
+            SizeT req_capacity,
+            SizeT max_capacity,
+            std::size_t)
+        noexcept
+        {
+            // capacity * Num / Den without overflowing.
+            auto q = SizeT(capacity / Den);
+            auto r = SizeT(capacity % Den);
+            SizeT grown;
+            if (q > max_capacity / Num)
+            {
+                grown = max_capacity;
+            }
+            else
+            {
+                grown = SizeT(q * Num);
+                auto extra = SizeT(r * Num / Den);
+                grown = extra > max_capacity - grown ?
+                    max_capacity : SizeT(grown + extra);
+            }
+
+            if (MinCapacity > grown)
+            {
+                grown = MinCapacity < max_capacity ?
+                    SizeT(MinCapacity) : max_capacity;
+            }
+
+            return (std::max)(req_capacity, grown);
+        }
+    };
+
+    // Rounded growth.
+    // Rounds buffers of at least `Granularity` bytes
+    // up to a multiple of `Granularity` (e.g. a page).
+    template<typename Inner, std::size_t Granularity>
+    requires (Granularity > 0)
+    struct rounded_growth
+    {
+        // Next capacity.
+        template<typename SizeT>
+        static constexpr SizeT next_capacity(
+            SizeT capacity,
+            SizeT req_capacity,
+            SizeT max_capacity,
+            std::size_t elem_size)
+        noexcept
+        {
+            auto new_capacity = Inner::next_capacity(
+                capacity, req_capacity, max_capacity, elem_size);
+
+            if (new_capacity > SIZE_MAX / elem_size)
+            {
+                return new_capacity;
+            }
+
+            auto bytes = std::size_t(new_capacity) * elem_size;
+            if (bytes < Granularity || bytes > SIZE_MAX - Granularity)
+            {
+                return new_capacity;
+            }
+
+            auto rounded = (bytes + (Granularity - 1)) / Granularity;
+            auto n = rounded * Granularity / elem_size;
+            return n <= max_capacity ? SizeT(n) : new_capacity;
+        }
+    };
+
+    // Capped growth.
+    // Once a buffer reaches `Threshold` bytes, grows
+    // it by at most `Step` bytes at a time.
+    template<typename Inner, std::size_t Threshold, std::size_t Step>
+    requires (Step > 0)
+    struct capped_growth
+    {
+        // Next capacity.
+        template<typename SizeT>
+        static constexpr SizeT next_capacity(
+            SizeT capacity,
+            SizeT req_capacity,
+            SizeT max_capacity,
+            std::size_t elem_size)
+        noexcept
+        {
+            auto new_capacity = Inner::next_capacity(
+                capacity, req_capacity, max_capacity, elem_size);
+
+            if (capacity < Threshold / elem_size)
+            {
+                return new_capacity;
+            }
+
+            auto step = (std::max)(Step / elem_size, std::size_t(1));
+            if (step < std::size_t(max_capacity - capacity))
+            {
+                auto limit = SizeT(capacity + step);
+                new_capacity = (std::min)(new_capacity, limit);
+            }
+
+            return (std::max)(req_capacity, new_capacity);
+        }
+    };
+
+    // Default growth.
+    // Doubles capacity.
+    using default_growth = geometric_growth<>;
+}
@@ -0,0 +1,183 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/packed_simd.hxx"
+#include "assert.hxx"
+#include "vec.hxx"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace gdt_detail
+{
+    // Float to binary16 bits, rounding to nearest even.
+    // Overflow gives infinity and NaN gives a quiet NaN.
+    constexpr std::uint16_t float_to_half(float f)
+    {
+        auto u = std::bit_cast<std::uint32_t>(f);
+        auto sign = (u >> 16) & 0x8000;
+        u &= 0x7fffffff;
+
+        std::uint32_t h;
+        if (u >= 0x47800000)
+        {
+            h = u > 0x7f800000 ? 0x7e00 : 0x7c00;
+        }
+        else if (u < 0x38800000)
+        {
+            // Below the smallest normal half, adding 0.5 rounds the mantissa
+            // into place.
+            auto sub = std::bit_cast<float>(u) + 0.5f;
+            h = std::bit_cast<std::uint32_t>(sub) - 0x3f000000;
+        }
+        else
+        {
+            // Rebias the exponent and round the mantissa to nearest even.
+            auto odd = (u >> 13) & 1;
+            h = (u + 0xc8000fff + odd) >> 13;
+        }
+        return std::uint16_t(h | sign);
+    }
+
+    // Binary16 bits to float. Exact.
+    constexpr float half_to_float(std::uint16_t h)
+    {
+        // Multiplying by 2^112 rebiases the exponent, subnormals included.
+        auto u = std::uint32_t(h & 0x7fff) << 13;
+        auto f = std::bit_cast<float>(u) * 0x1p112f;
+
+        // Infinity and NaN.
+        u = std::bit_cast<std::uint32_t>(f);
+        if (f >= 65536.0f)
+        {
+            u |= 0x7f800000;
+        }
+        return std::bit_cast<float>(u | std::uint32_t(h & 0x8000) << 16);
+    }
+}
+
+namespace gdt
+{
+    // Half-precision float.
+    // IEEE 754 binary16, for storage. Converts to float for arithmetic.
+    struct half
+    {
+    public:
+        // Constructor.
+        constexpr half() = default;
+
+        // Constructor.
+        // Rounds to nearest even.
+        explicit constexpr half(float f)
+        :
+            _bits{gdt_detail::float_to_half(f)}
+        {}
+
+        // From binary16 bits.
+        static constexpr half from_bits(std::uint16_t bits)
+        {
+            half ret;
+            ret._bits = bits;
+            return ret;
+        }
+
+        // Binary16 bits.
+        constexpr std::uint16_t bits() const
+        {
+            return _bits;
+        }
+
+        // To float. Exact.
+        constexpr operator float() const
+        {
+            return gdt_detail::half_to_float(_bits);
+        }
+
+    private:
+        // Member variables.
+        std::uint16_t _bits;
+    };
+}
+
+namespace gdt_detail
+{
+    using namespace gdt;
+
+    // Floats to halves.
+    inline void batch_to_half(half* out, const float* in, std::size_t n)
+    {
+        auto i = simd_pack_some<packed_half>(out, in, n);
+        for (; i < n; ++i)
+        {
+            out[i] = half(in[i]);
+        }
+    }
+
+    // Halves to floats.
+    inline void batch_from_half(float* out, const half* in, std::size_t n)
+    {
+        auto i = simd_unpack_some<packed_half>(out, in, n);
+        for (; i < n; ++i)
+        {
+            out[i] = float(in[i]);
+        }
+    }
+}
+
+namespace gdt::batch
+{
+    // Convert.
+    // out[i] = U(in[i]) between floats and halves. `in` and `out` must not
+    // overlap.
+    inline void convert(std::span<const float> in, std::span<half> out)
+    {
+        gdt_assert(in.size() == out.size());
+        gdt_detail::batch_to_half(out.data(), in.data(), in.size());
+    }
+
+    inline void convert(std::span<const half> in, std::span<float> out)
+    {
+        gdt_assert(in.size() == out.size());
+        gdt_detail::batch_from_half(out.data(), in.data(), in.size());
+    }
+
+    #define gdt(N)\
+    inline void convert(\
+        std::span<const vec<float, N>> in,\
+        std::span<vec<half, N>> out)\
+    {\
+        static_assert(sizeof(vec<half, N>) == N * sizeof(half));\
+        gdt_assert(in.size() == out.size());\
+        if (!in.empty())\
+        {\
+            gdt_detail::batch_to_half(\
+                std::addressof(out[0][0]),\
+                std::addressof(in[0][0]),\
+                in.size() * N);\
+        }\
+    }\
+    inline void convert(\
+        std::span<const vec<half, N>> in,\
+        std::span<vec<float, N>> out)\
+    {\
+        static_assert(sizeof(vec<half, N>) == N * sizeof(half));\
+        gdt_assert(in.size() == out.size());\
+        if (!in.empty())\
+        {\
+            gdt_detail::batch_from_half(\
+                std::addressof(out[0][0]),\
+                std::addressof(in[0][0]),\
+                in.size() * N);\
+        }\
+    }
+    gdt(2)
+    gdt(3)
+    gdt(4)
+    #undef gdt
+}
@@ -0,0 +1,182 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/hash_table.hxx"
+#include "allocator.hxx"
+#include "assert.hxx"
+#include "trivially_relocatable.hxx"
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace gdt_detail
+{
+    // Hash map policy.
+    template<typename K, typename V>
+    struct hash_map_policy
+    {
+        using key_type = K;
+        using value_type = std::pair<const K, V>;
+        static constexpr bool constant_iterators = false;
+
+        static constexpr const K& key(const value_type& value) noexcept
+        {
+            return value.first;
+        }
+    };
+}
+
+namespace gdt
+{
+    // Hash map.
+    // Flat open-addressing table that probes a group of control bytes
+    // at a time. Elements move when the table grows, so iterators and
+    // references don't survive inserts.
+    template<
+        typename K,
+        typename V,
+        typename Hash = std::hash<K>,
+        typename KeyEqual = std::equal_to<K>,
+        typename Allocator = allocator<std::pair<const K, V>>>
+    class hash_map :
+        public gdt_detail::hash_table<
+            gdt_detail::hash_map_policy<K, V>, Hash, KeyEqual, Allocator>
+    {
+        using _base = gdt_detail::hash_table<
+            gdt_detail::hash_map_policy<K, V>, Hash, KeyEqual, Allocator>;
+
+    public:
+        // Member types.
+        using mapped_type = V;
+        using typename _base::key_type;
+        using typename _base::value_type;
+        using typename _base::size_type;
+        using typename _base::iterator;
+        using typename _base::const_iterator;
+
+        // Constructors.
+        using _base::_base;
+
+        // Assignment.
+        using _base::operator=;
+
+        // Try emplace.
+        // Constructs the mapped value from `args` only if `key` isn't there.
+        template<typename... Args>
+        constexpr std::pair<iterator, bool> try_emplace(
+            const K& key,
+            Args&&... args)
+        {
+            return _try_emplace(key, std::forward<Args>(args)...);
+        }
+
+        // Try emplace.
+        template<typename... Args>
+        constexpr std::pair<iterator, bool> try_emplace(
+            K&& key,
+            Args&&... args)
+        {
+            return _try_emplace(std::move(key), std::forward<Args>(args)...);
+        }
+
+        // Insert or assign.
+        template<typename M>
+        constexpr std::pair<iterator, bool> insert_or_assign(
+            const K& key,
+            M&& obj)
+        {
+            return _insert_or_assign(key, std::forward<M>(obj));
+        }
+
+        // Insert or assign.
+        template<typename M>
+        constexpr std::pair<iterator, bool> insert_or_assign(
+            K&& key,
+            M&& obj)
+        {
+            return _insert_or_assign(std::move(key), std::forward<M>(obj));
+        }
+
+        // Subscript.
+        // Value-initializes the mapped value if `key` isn't there.
+        constexpr V& operator[](const K& key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        // Subscript.
+        constexpr V& operator[](K&& key)
+        {
+            return try_emplace(std::move(key)).first->second;
+        }
+
+        // At.
+        constexpr V& at(const K& key)
+        {
+            auto it = this->find(key);
+            gdt_assert(it != this->end());
+            return it->second;
+        }
+
+        // At.
+        constexpr const V& at(const K& key) const
+        {
+            auto it = this->find(key);
+            gdt_assert(it != this->end());
+            return it->second;
+        }
+
+    private:
+        // Try emplace.
+        template<typename Key, typename... Args>
+        constexpr std::pair<iterator, bool> _try_emplace(
+            Key&& key,
+            Args&&... args)
+        {
+            auto slot = this->_find_or_prepare_insert(key);
+            if (slot.found)
+            {
+                return {this->_iterator_at(slot.index), false};
+            }
+
+            auto it = this->_construct_at(
+                slot,
+                std::piecewise_construct,
+                std::forward_as_tuple(std::forward<Key>(key)),
+                std::forward_as_tuple(std::forward<Args>(args)...));
+            return {it, true};
+        }
+
+        // Insert or assign.
+        template<typename Key, typename M>
+        constexpr std::pair<iterator, bool> _insert_or_assign(
+            Key&& key,
+            M&& obj)
+        {
+            auto ret = _try_emplace(std::forward<Key>(key), std::forward<M>(obj));
+            if (!ret.second)
+            {
+                ret.first->second = std::forward<M>(obj);
+            }
+            return ret;
+        }
+    };
+
+    // Hash map is trivially relocatable if its functors and allocator are.
+    template<
+        typename K,
+        typename V,
+        typename Hash,
+        typename KeyEqual,
+        typename Allocator>
+    struct is_trivially_relocatable<hash_map<K, V, Hash, KeyEqual, Allocator>> :
+        std::bool_constant<
+            is_trivially_relocatable_v<Hash> &&
+            is_trivially_relocatable_v<KeyEqual> &&
+            is_trivially_relocatable_v<Allocator>> {};
+}
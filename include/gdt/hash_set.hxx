@@ -0,0 +1,62 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/hash_table.hxx"
+#include "allocator.hxx"
+#include "trivially_relocatable.hxx"
+#include <functional>
+#include <type_traits>
+
+namespace gdt_detail
+{
+    // Hash set policy.
+    template<typename K>
+    struct hash_set_policy
+    {
+        using key_type = K;
+        using value_type = K;
+        static constexpr bool constant_iterators = true;
+
+        static constexpr const K& key(const value_type& value) noexcept
+        {
+            return value;
+        }
+    };
+}
+
+namespace gdt
+{
+    // Hash set.
+    // Same table as `hash_map`, storing keys alone.
+    template<
+        typename K,
+        typename Hash = std::hash<K>,
+        typename KeyEqual = std::equal_to<K>,
+        typename Allocator = allocator<K>>
+    class hash_set :
+        public gdt_detail::hash_table<
+            gdt_detail::hash_set_policy<K>, Hash, KeyEqual, Allocator>
+    {
+        using _base = gdt_detail::hash_table<
+            gdt_detail::hash_set_policy<K>, Hash, KeyEqual, Allocator>;
+
+    public:
+        // Constructors.
+        using _base::_base;
+
+        // Assignment.
+        using _base::operator=;
+    };
+
+    // Hash set is trivially relocatable if its functors and allocator are.
+    template<typename K, typename Hash, typename KeyEqual, typename Allocator>
+    struct is_trivially_relocatable<hash_set<K, Hash, KeyEqual, Allocator>> :
+        std::bool_constant<
+            is_trivially_relocatable_v<Hash> &&
+            is_trivially_relocatable_v<KeyEqual> &&
+            is_trivially_relocatable_v<Allocator>> {};
+}
@@ -0,0 +1,518 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/mat_simd.hxx"
+#include "assert.hxx"
+#include "assume.hxx"
+#include "vec.hxx"
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+namespace gdt
+{
+    // Matrix.
+    // `R` rows by `C` columns, stored as `C` column vectors.
+    template<typename T, std::size_t R, std::size_t C> struct mat;
+    template<typename T> using mat2 = mat<T, 2, 2>;
+    template<typename T> using mat3 = mat<T, 3, 3>;
+    template<typename T> using mat4 = mat<T, 4, 4>;
+}
+
+namespace gdt_detail
+{
+    using namespace gdt;
+
+    // Is matrix.
+    template<typename T>
+    struct is_mat : std::false_type {};
+
+    template<typename T, std::size_t R, std::size_t C>
+    struct is_mat<mat<T, R, C>> : std::true_type {};
+
+    template<typename T>
+    constexpr bool is_mat_v = is_mat<T>::value;
+
+    // Matrix can use the 4x4 float SIMD kernels.
+    template<typename T, std::size_t R, std::size_t C>
+    constexpr bool uses_simd_mat4 =
+        std::is_same_v<T, float> && R == 4 && C == 4 && has_simd_mat4;
+
+    // Pointer to the first of a matrix's contiguous components.
+    template<typename T, std::size_t R, std::size_t C>
+    constexpr T* mat_data(mat<T, R, C>& m)
+    {
+        static_assert(sizeof(mat<T, R, C>) == sizeof(T) * R * C);
+        return std::addressof(m[0][0]);
+    }
+
+    template<typename T, std::size_t R, std::size_t C>
+    constexpr const T* mat_data(const mat<T, R, C>& m)
+    {
+        static_assert(sizeof(mat<T, R, C>) == sizeof(T) * R * C);
+        return std::addressof(m[0][0]);
+    }
+
+    // 2x2 minors of a 4x4 matrix.
+    // `s` from rows 0 and 1, `c` from rows 2 and 3.
+    template<typename T>
+    struct mat4_minors_result
+    {
+        T s[6];
+        T c[6];
+    };
+
+    template<typename T>
+    constexpr mat4_minors_result<T> mat4_minors(const mat<T, 4, 4>& m)
+    {
+        auto minor = [&](std::size_t r0, std::size_t c0, std::size_t c1)
+        {
+            return m[c0][r0] * m[c1][r0 + 1] - m[c0][r0 + 1] * m[c1][r0];
+        };
+
+        // Column pairs (0,1) (0,2) (0,3) (1,2) (1,3) (2,3).
+        return {
+            {
+                minor(0, 0, 1), minor(0, 0, 2), minor(0, 0, 3),
+                minor(0, 1, 2), minor(0, 1, 3), minor(0, 2, 3),
+            },
+            {
+                minor(2, 0, 1), minor(2, 0, 2), minor(2, 0, 3),
+                minor(2, 1, 2), minor(2, 1, 3), minor(2, 2, 3),
+            },
+        };
+    }
+}
+
+namespace gdt
+{
+    // Matrix.
+    template<typename T, std::size_t R, std::size_t C>
+    struct mat
+    {
+        // Disallow matrices of vectors or matrices.
+        static_assert(!gdt_detail::is_vec_v<T>);
+        static_assert(!gdt_detail::is_mat_v<T>);
+
+    public:
+        // Member types.
+        using column_type = vec<T, R>;
+        using row_type = vec<T, C>;
+
+        // Constructor.
+        constexpr mat() = default;
+
+        // Constructor.
+        // `s` along the diagonal and zero elsewhere.
+        explicit constexpr mat(const T& s)
+        {
+            for (std::size_t c = 0; c < C; ++c)
+            {
+                for (std::size_t r = 0; r < R; ++r)
+                {
+                    _cols[c][r] = r == c ? s : T(0);
+                }
+            }
+        }
+
+        // Constructor.
+        // One vector per column.
+        template<typename... Cols>
+        requires (
+            sizeof...(Cols) == C &&
+            (std::is_convertible_v<const Cols&, vec<T, R>> && ...))
+        constexpr mat(const Cols&... cols)
+        :
+            _cols{vec<T, R>(cols)...}
+        {}
+
+        // Constructor.
+        // Converts and/or truncates another matrix.
+        template<typename OtherT, std::size_t OtherR, std::size_t OtherC>
+        requires (OtherR >= R && OtherC >= C)
+        explicit constexpr mat(const mat<OtherT, OtherR, OtherC>& other)
+        {
+            for (std::size_t c = 0; c < C; ++c)
+            {
+                _cols[c] = vec<T, R>(other[c]);
+            }
+        }
+
+        // Identity.
+        static constexpr mat identity() requires (R == C)
+        {
+            return mat(T(1));
+        }
+
+        // Column.
+        constexpr vec<T, R>& operator[](std::size_t c)
+        {
+            gdt_assume(c < C);
+            return _cols[c];
+        }
+
+        // Column.
+        constexpr const vec<T, R>& operator[](std::size_t c) const
+        {
+            gdt_assume(c < C);
+            return _cols[c];
+        }
+
+        // Row.
+        constexpr vec<T, C> row(std::size_t r) const
+        {
+            gdt_assume(r < R);
+            vec<T, C> ret;
+            for (std::size_t c = 0; c < C; ++c)
+            {
+                ret[c] = _cols[c][r];
+            }
+            return ret;
+        }
+
+        // Unary minus.
+        friend constexpr mat operator-(const mat& m)
+        {
+            mat ret;
+            for (std::size_t c = 0; c < C; ++c)
+            {
+                ret._cols[c] = -m._cols[c];
+            }
+            return ret;
+        }
+
+        // Component-wise binary operators.
+        #define gdt(op)\
+        friend constexpr mat operator op(const mat& lhs, const mat& rhs)\
+        {\
+            mat ret;\
+            for (std::size_t c = 0; c < C; ++c)\
+            {\
+                ret._cols[c] = lhs._cols[c] op rhs._cols[c];\
+            }\
+            return ret;\
+        }
+        gdt(+)
+        gdt(-)
+        #undef gdt
+
+        // Matrix-scalar and scalar-matrix operators.
+        #define gdt(op)\
+        friend constexpr mat operator op(const mat& lhs, const T& rhs)\
+        {\
+            mat ret;\
+            for (std::size_t c = 0; c < C; ++c)\
+            {\
+                ret._cols[c] = lhs._cols[c] op rhs;\
+            }\
+            return ret;\
+        }
+        gdt(*)
+        gdt(/)
+        #undef gdt
+
+        friend constexpr mat operator*(const T& lhs, const mat& rhs)
+        {
+            return rhs * lhs;
+        }
+
+        // Matrix-vector multiplication.
+        friend constexpr vec<T, R> operator*(
+            const mat& lhs,
+            const vec<T, C>& rhs)
+        {
+            vec<T, R> ret;
+            if constexpr (gdt_detail::uses_simd_mat4<T, R, C>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    gdt_detail::simd_mat4_mul_vec(
+                        std::addressof(ret[0]),
+                        gdt_detail::mat_data(lhs),
+                        std::addressof(rhs[0]));
+                    return ret;
+                }
+            }
+
+            ret = vec<T, R>(lhs._cols[0] * rhs[0]);
+            for (std::size_t c = 1; c < C; ++c)
+            {
+                ret = vec<T, R>(ret + lhs._cols[c] * rhs[c]);
+            }
+            return ret;
+        }
+
+        // Vector-matrix multiplication.
+        // Treats `lhs` as a row vector.
+        friend constexpr vec<T, C> operator*(
+            const vec<T, R>& lhs,
+            const mat& rhs)
+        {
+            vec<T, C> ret;
+            for (std::size_t c = 0; c < C; ++c)
+            {
+                auto col = lhs * rhs._cols[c];
+                ret[c] = col[0];
+                for (std::size_t r = 1; r < R; ++r)
+                {
+                    ret[c] += col[r];
+                }
+            }
+            return ret;
+        }
+
+        // Matrix-matrix multiplication.
+        template<std::size_t K>
+        friend constexpr mat<T, R, K> operator*(
+            const mat& lhs,
+            const mat<T, C, K>& rhs)
+        {
+            mat<T, R, K> ret;
+            if constexpr (
+                K == 4 &&
+                gdt_detail::uses_simd_mat4<T, R, C>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    gdt_detail::simd_mat4_mul(
+                        gdt_detail::mat_data(ret),
+                        gdt_detail::mat_data(lhs),
+                        gdt_detail::mat_data(rhs));
+                    return ret;
+                }
+            }
+
+            for (std::size_t k = 0; k < K; ++k)
+            {
+                ret[k] = lhs * rhs[k];
+            }
+            return ret;
+        }
+
+        // Equality.
+        friend constexpr bool operator==(const mat& lhs, const mat& rhs)
+        {
+            for (std::size_t c = 0; c < C; ++c)
+            {
+                if (!all(lhs._cols[c] == rhs._cols[c]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+        // Member variables.
+        vec<T, R> _cols[C];
+    };
+
+    // Transpose.
+    template<typename T, std::size_t R, std::size_t C>
+    constexpr mat<T, C, R> transpose(const mat<T, R, C>& m)
+    {
+        mat<T, C, R> ret;
+        for (std::size_t r = 0; r < R; ++r)
+        {
+            ret[r] = m.row(r);
+        }
+        return ret;
+    }
+
+    // Determinant.
+    template<typename T, std::size_t N>
+    requires (N >= 2 && N <= 4)
+    constexpr T determinant(const mat<T, N, N>& m)
+    {
+        if constexpr (N == 2)
+        {
+            return m[0][0] * m[1][1] - m[1][0] * m[0][1];
+        }
+        else if constexpr (N == 3)
+        {
+            return
+                m[0][0] * (m[1][1] * m[2][2] - m[2][1] * m[1][2]) -
+                m[1][0] * (m[0][1] * m[2][2] - m[2][1] * m[0][2]) +
+                m[2][0] * (m[0][1] * m[1][2] - m[1][1] * m[0][2]);
+        }
+        else
+        {
+            auto [s, c] = gdt_detail::mat4_minors(m);
+            return
+                s[0] * c[5] - s[1] * c[4] + s[2] * c[3] +
+                s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+        }
+    }
+
+    // Inverse.
+    // The result isn't finite if `m` is singular.
+    template<typename T, std::size_t N>
+    requires (N >= 2 && N <= 4 && std::is_floating_point_v<T>)
+    constexpr mat<T, N, N> inverse(const mat<T, N, N>& m)
+    {
+        mat<T, N, N> ret;
+        if constexpr (N == 2)
+        {
+            auto inv_det = T(1) / determinant(m);
+            ret[0][0] = m[1][1] * inv_det;
+            ret[0][1] = -m[0][1] * inv_det;
+            ret[1][0] = -m[1][0] * inv_det;
+            ret[1][1] = m[0][0] * inv_det;
+        }
+        else if constexpr (N == 3)
+        {
+            // Rows of the inverse are cross products of the columns.
+            auto inv_det = T(1) / determinant(m);
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                auto& a = m[(i + 1) % 3];
+                auto& b = m[(i + 2) % 3];
+                ret[0][i] = (a[1] * b[2] - a[2] * b[1]) * inv_det;
+                ret[1][i] = (a[2] * b[0] - a[0] * b[2]) * inv_det;
+                ret[2][i] = (a[0] * b[1] - a[1] * b[0]) * inv_det;
+            }
+        }
+        else
+        {
+            // Cofactors from 2x2 minors of the top and bottom row pairs.
+            auto [s, c] = gdt_detail::mat4_minors(m);
+            auto det =
+                s[0] * c[5] - s[1] * c[4] + s[2] * c[3] +
+                s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+            auto inv_det = T(1) / det;
+
+            auto a = [&](std::size_t r, std::size_t col) { return m[col][r]; };
+            auto set = [&](std::size_t r, std::size_t col, T v)
+            {
+                ret[col][r] = v * inv_det;
+            };
+
+            set(0, 0, a(1, 1) * c[5] - a(1, 2) * c[4] + a(1, 3) * c[3]);
+            set(0, 1, -a(0, 1) * c[5] + a(0, 2) * c[4] - a(0, 3) * c[3]);
+            set(0, 2, a(3, 1) * s[5] - a(3, 2) * s[4] + a(3, 3) * s[3]);
+            set(0, 3, -a(2, 1) * s[5] + a(2, 2) * s[4] - a(2, 3) * s[3]);
+            set(1, 0, -a(1, 0) * c[5] + a(1, 2) * c[2] - a(1, 3) * c[1]);
+            set(1, 1, a(0, 0) * c[5] - a(0, 2) * c[2] + a(0, 3) * c[1]);
+            set(1, 2, -a(3, 0) * s[5] + a(3, 2) * s[2] - a(3, 3) * s[1]);
+            set(1, 3, a(2, 0) * s[5] - a(2, 2) * s[2] + a(2, 3) * s[1]);
+            set(2, 0, a(1, 0) * c[4] - a(1, 1) * c[2] + a(1, 3) * c[0]);
+            set(2, 1, -a(0, 0) * c[4] + a(0, 1) * c[2] - a(0, 3) * c[0]);
+            set(2, 2, a(3, 0) * s[4] - a(3, 1) * s[2] + a(3, 3) * s[0]);
+            set(2, 3, -a(2, 0) * s[4] + a(2, 1) * s[2] - a(2, 3) * s[0]);
+            set(3, 0, -a(1, 0) * c[3] + a(1, 1) * c[1] - a(1, 2) * c[0]);
+            set(3, 1, a(0, 0) * c[3] - a(0, 1) * c[1] + a(0, 2) * c[0]);
+            set(3, 2, -a(3, 0) * s[3] + a(3, 1) * s[1] - a(3, 2) * s[0]);
+            set(3, 3, a(2, 0) * s[3] - a(2, 1) * s[1] + a(2, 2) * s[0]);
+        }
+        return ret;
+    }
+}
+
+namespace gdt::batch
+{
+    // Transform.
+    // out[i] = m * in[i]. `in` and `out` must be the same or not overlap.
+    template<typename T>
+    constexpr void transform(
+        const mat<T, 4, 4>& m,
+        std::type_identity_t<std::span<const vec<T, 4>>> in,
+        std::type_identity_t<std::span<vec<T, 4>>> out)
+    {
+        gdt_assert(in.size() == out.size());
+
+        if constexpr (gdt_detail::uses_simd_mat4<T, 4, 4>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                if (!in.empty())
+                {
+                    gdt_detail::simd_mat4_transform4(
+                        std::addressof(out[0][0]),
+                        gdt_detail::mat_data(m),
+                        std::addressof(in[0][0]),
+                        in.size());
+                }
+                return;
+            }
+        }
+
+        for (std::size_t i = 0; i < in.size(); ++i)
+        {
+            out[i] = m * in[i];
+        }
+    }
+}
+
+namespace gdt_detail
+{
+    // out[i] = (m * vec4(in[i], W)).xyz.
+    template<bool W, typename T>
+    constexpr void mat4_transform3(
+        const mat<T, 4, 4>& m,
+        std::span<const vec<T, 3>> in,
+        std::span<vec<T, 3>> out)
+    {
+        gdt_assert(in.size() == out.size());
+
+        std::size_t i = 0;
+        if constexpr (uses_simd_mat4<T, 4, 4>)
+        {
+            if (!std::is_constant_evaluated() && !in.empty())
+            {
+                i = simd_mat4_transform3<W>(
+                    std::addressof(out[0][0]),
+                    mat_data(m),
+                    std::addressof(in[0][0]),
+                    in.size());
+            }
+        }
+
+        // Same operation order as the SIMD kernels.
+        auto c0 = m[0].xyz();
+        auto c1 = m[1].xyz();
+        auto c2 = m[2].xyz();
+        auto c3 = m[3].xyz();
+        for (; i < in.size(); ++i)
+        {
+            auto v = in[i];
+            auto ret = c0 * v[0] + c1 * v[1] + c2 * v[2];
+            if constexpr (W)
+            {
+                ret = ret + c3;
+            }
+            out[i] = ret;
+        }
+    }
+}
+
+namespace gdt::batch
+{
+    // Transform points.
+    // out[i] = (m * vec4(in[i], 1)).xyz, ignoring the bottom row of `m`.
+    // `in` and `out` must be the same or not overlap.
+    template<typename T>
+    constexpr void transform_points(
+        const mat<T, 4, 4>& m,
+        std::type_identity_t<std::span<const vec<T, 3>>> in,
+        std::type_identity_t<std::span<vec<T, 3>>> out)
+    {
+        gdt_detail::mat4_transform3<true>(m, in, out);
+    }
+
+    // Transform vectors.
+    // out[i] = (m * vec4(in[i], 0)).xyz, ignoring the bottom row of `m`.
+    // `in` and `out` must be the same or not overlap.
+    template<typename T>
+    constexpr void transform_vectors(
+        const mat<T, 4, 4>& m,
+        std::type_identity_t<std::span<const vec<T, 3>>> in,
+        std::type_identity_t<std::span<vec<T, 3>>> out)
+    {
+        gdt_detail::mat4_transform3<false>(m, in, out);
+    }
+}
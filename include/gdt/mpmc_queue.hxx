@@ -0,0 +1,318 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/cache_line.hxx"
+#include "allocator.hxx"
+#include "assert.hxx"
+#include "assume.hxx"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace gdt
+{
+    // Multi-producer multi-consumer queue.
+    // Bounded lock-free ring buffer in the style of Dmitry Vyukov's.
+    // Every cell has a sequence number that says whose turn it is:
+    // the producer of position `pos` waits for `pos`, and its consumer
+    // for `pos + 1`. Threads claim cells by advancing a shared index.
+    template<typename T, typename Allocator = allocator<T>>
+    class mpmc_queue
+    {
+        static_assert(std::is_same_v<
+            typename std::allocator_traits<Allocator>::pointer, T*>);
+
+    public:
+        // Member types.
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = typename std::allocator_traits<Allocator>::size_type;
+
+        // Constructor.
+        // Rounds `capacity` up to a power of 2, and at least 2.
+        explicit mpmc_queue(
+            size_type capacity,
+            const Allocator& allocator = Allocator())
+        :
+            _allocator{allocator},
+            _cells{nullptr},
+            _mask{0}
+        {
+            _cell_allocator cell_allocator(_allocator);
+            gdt_assert(capacity > 0);
+            gdt_assert(capacity <= (std::allocator_traits<_cell_allocator>::
+                max_size(cell_allocator) / 2));
+
+            auto n = size_type(std::bit_ceil((std::max)(capacity, size_type(2))));
+            _cells = _cell_traits::allocate(cell_allocator, n);
+            _mask = size_type(n - 1);
+
+            for (size_type i = 0; i < n; ++i)
+            {
+                _cell_traits::construct(cell_allocator, _cells + i, i);
+            }
+        }
+
+        // Constructor.
+        mpmc_queue(const mpmc_queue&) = delete;
+
+        // Destructor.
+        ~mpmc_queue()
+        {
+            auto head = _dequeue.pos.load(std::memory_order_relaxed);
+            auto tail = _enqueue.pos.load(std::memory_order_relaxed);
+            for (; head != tail; ++head)
+            {
+                _destroy(_cells[head & _mask].value());
+            }
+
+            _cell_allocator cell_allocator(_allocator);
+            for (size_type i = 0; i < capacity(); ++i)
+            {
+                _cell_traits::destroy(cell_allocator, _cells + i);
+            }
+            _cell_traits::deallocate(cell_allocator, _cells, capacity());
+        }
+
+        // Assignment.
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+        // Get allocator.
+        allocator_type get_allocator() const noexcept
+        {
+            return _allocator;
+        }
+
+        // Capacity.
+        size_type capacity() const noexcept
+        {
+            return size_type(_mask + 1);
+        }
+
+        // Size.
+        // Only a snapshot if other threads are active.
+        size_type size() const noexcept
+        {
+            auto head = _dequeue.pos.load(std::memory_order_acquire);
+            auto tail = _enqueue.pos.load(std::memory_order_acquire);
+            auto n = _signed(size_type(tail - head));
+            return n < 0 ? 0 : (std::min)(size_type(n), capacity());
+        }
+
+        // Empty.
+        // Only a snapshot if other threads are active.
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        // Try emplace.
+        // Returns false if the queue is full.
+        template<typename... Args>
+        bool try_emplace(Args&&... args)
+        {
+            auto pos = _enqueue.pos.load(std::memory_order_relaxed);
+            if (_claim(_enqueue.pos, pos, 1, 0) == 0)
+            {
+                return false;
+            }
+
+            auto& cell = _cells[pos & _mask];
+            _construct(cell.value(), std::forward<Args>(args)...);
+            cell.sequence.store(size_type(pos + 1), std::memory_order_release);
+            return true;
+        }
+
+        // Try push.
+        // Returns false if the queue is full.
+        bool try_push(const T& value)
+        {
+            return try_emplace(value);
+        }
+
+        // Try push.
+        bool try_push(T&& value)
+        {
+            return try_emplace(std::move(value));
+        }
+
+        // Try push batch.
+        // Claims as many consecutive free cells as it can, up to
+        // `values.size()`, with one atomic operation, then copies leading
+        // values into them. Returns how many were pushed.
+        size_type try_push_batch(std::span<const T> values)
+        {
+            auto pos = _enqueue.pos.load(std::memory_order_relaxed);
+            auto n = _claim(_enqueue.pos, pos, values.size(), 0);
+
+            for (size_type i = 0; i < n; ++i)
+            {
+                auto& cell = _cells[(pos + i) & _mask];
+                _construct(cell.value(), values[i]);
+                cell.sequence.store(
+                    size_type(pos + i + 1), std::memory_order_release);
+            }
+
+            return n;
+        }
+
+        // Try pop.
+        // Moves the front value into `out`.
+        // Returns false if the queue is empty.
+        bool try_pop(T& out)
+        {
+            auto pos = _dequeue.pos.load(std::memory_order_relaxed);
+            if (_claim(_dequeue.pos, pos, 1, 1) == 0)
+            {
+                return false;
+            }
+
+            _pop_cell(pos, out);
+            return true;
+        }
+
+        // Try pop batch.
+        // Claims up to `out.size()` consecutive full cells with one atomic
+        // operation and moves their values into `out`.
+        // Returns how many were popped.
+        size_type try_pop_batch(std::span<T> out)
+        {
+            auto pos = _dequeue.pos.load(std::memory_order_relaxed);
+            auto n = _claim(_dequeue.pos, pos, out.size(), 1);
+
+            for (size_type i = 0; i < n; ++i)
+            {
+                _pop_cell(size_type(pos + i), out[i]);
+            }
+
+            return n;
+        }
+
+    private:
+        // Cell.
+        struct _cell
+        {
+            std::atomic<size_type> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            // Constructor.
+            explicit _cell(size_type seq) noexcept
+            :
+                sequence{seq}
+            {}
+
+            // Value.
+            T* value() noexcept
+            {
+                return std::launder(reinterpret_cast<T*>(storage));
+            }
+        };
+
+        // Shared index, on its own cache line.
+        struct alignas(gdt_detail::cache_line_size) _index
+        {
+            std::atomic<size_type> pos{0};
+        };
+
+        // Member types.
+        using _cell_allocator = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<_cell>;
+        using _cell_traits = std::allocator_traits<_cell_allocator>;
+
+        // Member variables.
+        [[no_unique_address]] Allocator _allocator;
+        _cell* _cells;
+        size_type _mask;
+        _index _enqueue;
+        _index _dequeue;
+
+        // Signed distance.
+        static std::make_signed_t<size_type> _signed(size_type d) noexcept
+        {
+            return std::make_signed_t<size_type>(d);
+        }
+
+        // Claim up to `wanted` consecutive cells starting at `pos` by
+        // advancing `index`. A cell is ready once its sequence number is
+        // its position plus `lag`. Updates `pos` to the first claimed cell
+        // and returns how many were claimed, or 0 if the first isn't ready.
+        size_type _claim(
+            std::atomic<size_type>& index,
+            size_type& pos,
+            std::size_t wanted,
+            size_type lag) noexcept
+        {
+            while (true)
+            {
+                size_type n = 0;
+                for (; n < wanted; ++n)
+                {
+                    auto& cell = _cells[(pos + n) & _mask];
+                    auto seq = cell.sequence.load(std::memory_order_acquire);
+                    if (seq != size_type(pos + n + lag))
+                    {
+                        break;
+                    }
+                }
+
+                if (n == 0)
+                {
+                    // Full (or empty) if the first cell is a lap behind.
+                    auto& cell = _cells[pos & _mask];
+                    auto seq = cell.sequence.load(std::memory_order_acquire);
+                    if (_signed(size_type(seq - (pos + lag))) < 0)
+                    {
+                        return 0;
+                    }
+
+                    // Someone else claimed it. Catch up.
+                    pos = index.load(std::memory_order_relaxed);
+                    continue;
+                }
+
+                if (index.compare_exchange_weak(
+                    pos, size_type(pos + n),
+                    std::memory_order_relaxed,
+                    std::memory_order_relaxed))
+                {
+                    return n;
+                }
+            }
+        }
+
+        // Move the value at position `pos` into `out`
+        // and hand the cell to the next lap's producer.
+        void _pop_cell(size_type pos, T& out)
+        {
+            auto& cell = _cells[pos & _mask];
+            auto p = cell.value();
+            out = std::move(*p);
+            _destroy(p);
+            cell.sequence.store(
+                size_type(pos + _mask + 1), std::memory_order_release);
+        }
+
+        // Construct using allocator.
+        template<typename... Args>
+        void _construct(T* p, Args&&... args)
+        {
+            std::allocator_traits<Allocator>::construct(
+                _allocator, p, std::forward<Args>(args)...);
+        }
+
+        // Destroy using allocator.
+        void _destroy(T* p) noexcept
+        {
+            std::allocator_traits<Allocator>::destroy(_allocator, p);
+        }
+    };
+}
@@ -0,0 +1,348 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/packed_simd.hxx"
+#include "assert.hxx"
+#include "vec.hxx"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <type_traits>
+
+namespace gdt_detail
+{
+    // Round to the nearest integer, ties to even, like the SIMD conversions
+    // in the default rounding mode.
+    constexpr std::int32_t round_even(float x)
+    {
+        auto i = std::int32_t(x);
+        auto r = x - float(i);
+        if (r > 0.5f || (r == 0.5f && (i & 1) != 0))
+        {
+            ++i;
+        }
+        else if (r < -0.5f || (r == -0.5f && (i & 1) != 0))
+        {
+            --i;
+        }
+        return i;
+    }
+
+    // Float to a normalized integer.
+    // Clamps to [lo, 1], scales, and rounds to nearest even. NaN gives 0.
+    constexpr std::int32_t to_norm(float x, float lo, float scale)
+    {
+        x = x == x ? x : 0.0f;
+        x = x > lo ? x : lo;
+        x = x < 1.0f ? x : 1.0f;
+        return round_even(x * scale);
+    }
+
+    // Unsigned normalized integer to float.
+    constexpr float from_unorm(std::uint32_t i, float scale)
+    {
+        return float(i) / scale;
+    }
+
+    // Signed normalized integer to float.
+    // The most negative integer gives -1, like the one after it.
+    constexpr float from_snorm(std::int32_t i, float scale)
+    {
+        auto f = float(i) / scale;
+        return f > -1.0f ? f : -1.0f;
+    }
+}
+
+namespace gdt
+{
+    // Unsigned normalized integer.
+    // Stores a float in [0, 1] as an integer in [0, max], mostly as a `vec`
+    // component.
+    template<typename T>
+    struct unorm
+    {
+        // 8- and 16-bit integers; floats can't represent larger ones exactly.
+        static_assert(
+            std::is_same_v<T, std::uint8_t> ||
+            std::is_same_v<T, std::uint16_t>);
+
+    public:
+        // Constructor.
+        constexpr unorm() = default;
+
+        // Constructor.
+        // Clamps to [0, 1] and rounds to nearest even. NaN gives 0.
+        explicit constexpr unorm(float f)
+        :
+            _bits{T(gdt_detail::to_norm(f, 0.0f, _scale))}
+        {}
+
+        // From integer bits.
+        static constexpr unorm from_bits(T bits)
+        {
+            unorm ret;
+            ret._bits = bits;
+            return ret;
+        }
+
+        // Integer bits.
+        constexpr T bits() const
+        {
+            return _bits;
+        }
+
+        // To float.
+        constexpr operator float() const
+        {
+            return gdt_detail::from_unorm(_bits, _scale);
+        }
+
+    private:
+        // Largest integer, which represents 1.
+        static constexpr float _scale = float(std::numeric_limits<T>::max());
+
+        // Member variables.
+        T _bits;
+    };
+
+    // Signed normalized integer.
+    // Stores a float in [-1, 1] as an integer in [-max, max], mostly as a
+    // `vec` component.
+    template<typename T>
+    struct snorm
+    {
+        // 8- and 16-bit integers; floats can't represent larger ones exactly.
+        static_assert(
+            std::is_same_v<T, std::int8_t> ||
+            std::is_same_v<T, std::int16_t>);
+
+    public:
+        // Constructor.
+        constexpr snorm() = default;
+
+        // Constructor.
+        // Clamps to [-1, 1] and rounds to nearest even. NaN gives 0.
+        explicit constexpr snorm(float f)
+        :
+            _bits{T(gdt_detail::to_norm(f, -1.0f, _scale))}
+        {}
+
+        // From integer bits.
+        static constexpr snorm from_bits(T bits)
+        {
+            snorm ret;
+            ret._bits = bits;
+            return ret;
+        }
+
+        // Integer bits.
+        constexpr T bits() const
+        {
+            return _bits;
+        }
+
+        // To float.
+        constexpr operator float() const
+        {
+            return gdt_detail::from_snorm(_bits, _scale);
+        }
+
+    private:
+        // Largest integer, which represents 1.
+        static constexpr float _scale = float(std::numeric_limits<T>::max());
+
+        // Member variables.
+        T _bits;
+    };
+
+    // Normalized integer aliases.
+    using unorm8 = unorm<std::uint8_t>;
+    using unorm16 = unorm<std::uint16_t>;
+    using snorm8 = snorm<std::int8_t>;
+    using snorm16 = snorm<std::int16_t>;
+
+    // Packed vector aliases.
+    using unorm8x4 = vec4<unorm8>;
+    using snorm16x2 = vec2<snorm16>;
+
+    // Packed unsigned normalized 4-vector.
+    // x, y, and z get 10 bits each and w gets 2, from the least significant
+    // bit up.
+    struct unorm10_10_10_2
+    {
+    public:
+        // Constructor.
+        constexpr unorm10_10_10_2() = default;
+
+        // Constructor.
+        // Clamps to [0, 1] and rounds to nearest even. NaN gives 0.
+        explicit constexpr unorm10_10_10_2(const vec4<float>& v)
+        :
+            _bits{
+                std::uint32_t(gdt_detail::to_norm(v[0], 0.0f, 1023.0f)) |
+                std::uint32_t(gdt_detail::to_norm(v[1], 0.0f, 1023.0f)) << 10 |
+                std::uint32_t(gdt_detail::to_norm(v[2], 0.0f, 1023.0f)) << 20 |
+                std::uint32_t(gdt_detail::to_norm(v[3], 0.0f, 3.0f)) << 30}
+        {}
+
+        // From packed bits.
+        static constexpr unorm10_10_10_2 from_bits(std::uint32_t bits)
+        {
+            unorm10_10_10_2 ret;
+            ret._bits = bits;
+            return ret;
+        }
+
+        // Packed bits.
+        constexpr std::uint32_t bits() const
+        {
+            return _bits;
+        }
+
+        // To vec4<float>.
+        explicit constexpr operator vec4<float>() const
+        {
+            return {
+                gdt_detail::from_unorm(_bits & 0x3ff, 1023.0f),
+                gdt_detail::from_unorm((_bits >> 10) & 0x3ff, 1023.0f),
+                gdt_detail::from_unorm((_bits >> 20) & 0x3ff, 1023.0f),
+                gdt_detail::from_unorm(_bits >> 30, 3.0f)};
+        }
+
+    private:
+        // Member variables.
+        std::uint32_t _bits;
+    };
+}
+
+namespace gdt_detail
+{
+    using namespace gdt;
+
+    // Floats to normalized integers.
+    template<typename Format, typename P>
+    void batch_to_norm(P* out, const float* in, std::size_t n)
+    {
+        auto i = simd_pack_some<Format>(out, in, n);
+        for (; i < n; ++i)
+        {
+            out[i] = P(in[i]);
+        }
+    }
+
+    // Normalized integers to floats.
+    template<typename Format, typename P>
+    void batch_from_norm(float* out, const P* in, std::size_t n)
+    {
+        auto i = simd_unpack_some<Format>(out, in, n);
+        for (; i < n; ++i)
+        {
+            out[i] = float(in[i]);
+        }
+    }
+}
+
+namespace gdt::batch
+{
+    // Convert.
+    // out[i] = U(in[i]) between float vectors and packed formats. `in` and
+    // `out` must not overlap.
+    inline void convert(
+        std::span<const vec4<float>> in,
+        std::span<unorm8x4> out)
+    {
+        static_assert(sizeof(unorm8x4) == 4);
+        gdt_assert(in.size() == out.size());
+        if (!in.empty())
+        {
+            gdt_detail::batch_to_norm<gdt_detail::packed_unorm8>(
+                std::addressof(out[0][0]),
+                std::addressof(in[0][0]),
+                in.size() * 4);
+        }
+    }
+
+    inline void convert(
+        std::span<const unorm8x4> in,
+        std::span<vec4<float>> out)
+    {
+        gdt_assert(in.size() == out.size());
+        if (!in.empty())
+        {
+            gdt_detail::batch_from_norm<gdt_detail::packed_unorm8>(
+                std::addressof(out[0][0]),
+                std::addressof(in[0][0]),
+                in.size() * 4);
+        }
+    }
+
+    inline void convert(
+        std::span<const vec2<float>> in,
+        std::span<snorm16x2> out)
+    {
+        static_assert(sizeof(snorm16x2) == 4);
+        gdt_assert(in.size() == out.size());
+        if (!in.empty())
+        {
+            gdt_detail::batch_to_norm<gdt_detail::packed_snorm16>(
+                std::addressof(out[0][0]),
+                std::addressof(in[0][0]),
+                in.size() * 2);
+        }
+    }
+
+    inline void convert(
+        std::span<const snorm16x2> in,
+        std::span<vec2<float>> out)
+    {
+        gdt_assert(in.size() == out.size());
+        if (!in.empty())
+        {
+            gdt_detail::batch_from_norm<gdt_detail::packed_snorm16>(
+                std::addressof(out[0][0]),
+                std::addressof(in[0][0]),
+                in.size() * 2);
+        }
+    }
+
+    inline void convert(
+        std::span<const vec4<float>> in,
+        std::span<unorm10_10_10_2> out)
+    {
+        static_assert(sizeof(unorm10_10_10_2) == 4);
+        gdt_assert(in.size() == out.size());
+        if (!in.empty())
+        {
+            using gdt_detail::packed_unorm10_10_10_2;
+            auto i = gdt_detail::simd_pack_some<packed_unorm10_10_10_2>(
+                out.data(), std::addressof(in[0][0]), in.size() * 4) / 4;
+            for (; i < in.size(); ++i)
+            {
+                out[i] = unorm10_10_10_2(in[i]);
+            }
+        }
+    }
+
+    inline void convert(
+        std::span<const unorm10_10_10_2> in,
+        std::span<vec4<float>> out)
+    {
+        gdt_assert(in.size() == out.size());
+        if (!in.empty())
+        {
+            using gdt_detail::packed_unorm10_10_10_2;
+            auto i = gdt_detail::simd_unpack_some<packed_unorm10_10_10_2>(
+                std::addressof(out[0][0]), in.data(), in.size() * 4) / 4;
+            for (; i < in.size(); ++i)
+            {
+                out[i] = vec4<float>(in[i]);
+            }
+        }
+    }
+}
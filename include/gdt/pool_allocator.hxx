@@ -0,0 +1,342 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "allocator.hxx"
+#include "assert.hxx"
+#include "unreachable.hxx"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+namespace gdt_detail
+{
+    // Pool slot.
+    // Free slots hold the next free slot in their first bytes.
+    struct pool_slot
+    {
+        pool_slot* next;
+    };
+
+    // Pool batch.
+    // The first slot of a batch on the global free list also
+    // holds the next batch.
+    struct pool_batch : pool_slot
+    {
+        pool_batch* next_batch;
+    };
+
+    // Fixed-size pool.
+    // Slots are carved out of pages that are never given back to the
+    // system. Each thread keeps its own free list, and threads hand
+    // surplus slots back a batch at a time through a global stack.
+    template<std::size_t SlotSize>
+    class pool
+    {
+        static_assert(SlotSize >= sizeof(pool_batch));
+
+    public:
+        // Allocate.
+        static void* allocate()
+        {
+            auto& cache = _cache;
+            if (cache.head == nullptr)
+            {
+                _refill(cache);
+            }
+
+            auto slot = cache.head;
+            cache.head = slot->next;
+            cache.count -= 1;
+            return slot;
+        }
+
+        // Deallocate.
+        static void deallocate(void* p) noexcept
+        {
+            auto& cache = _cache;
+            auto slot = static_cast<pool_slot*>(p);
+
+            slot->next = cache.head;
+            cache.head = slot;
+            cache.count += 1;
+
+            // Give a batch of surplus slots back so threads that only
+            // free (e.g. consumers) don't hoard them. Keeps the most
+            // recently freed batch, which is most likely still cached.
+            if (cache.count >= _cache_limit)
+            {
+                auto keep = cache.head;
+                for (auto i = _batch_size; i-- > 1;)
+                {
+                    keep = keep->next;
+                }
+
+                _push_batch(keep->next);
+                keep->next = nullptr;
+                cache.count -= _batch_size;
+            }
+        }
+
+    private:
+        // Page size.
+        static constexpr std::size_t _page_size = 64 * 1024;
+
+        // Slots per page.
+        static constexpr std::size_t _slots_per_page = _page_size / SlotSize;
+
+        // Slots per batch on the global free list.
+        static constexpr std::size_t _batch_size = _slots_per_page;
+
+        // Free slots a thread can keep before giving a batch back.
+        static constexpr std::size_t _cache_limit = 2 * _batch_size;
+
+        // Thread cache.
+        struct _thread_cache
+        {
+            pool_slot* head = nullptr;
+            std::size_t count = 0;
+
+            // Destructor.
+            // Gives everything back when the thread exits.
+            ~_thread_cache()
+            {
+                if (head != nullptr)
+                {
+                    _push_batch(head);
+                    head = nullptr;
+                    count = 0;
+                }
+            }
+        };
+
+        // Member variables.
+        static inline thread_local _thread_cache _cache;
+        static inline constinit std::atomic<pool_batch*> _batches{nullptr};
+        static inline constinit std::mutex _pop_mutex;
+
+        // Push the null-terminated list at `head` onto the global
+        // stack as one batch. Lock-free.
+        static void _push_batch(pool_slot* head) noexcept
+        {
+            auto next = head->next;
+            auto batch = ::new (static_cast<void*>(head)) pool_batch{
+                {next}, _batches.load(std::memory_order_relaxed)};
+            while (!_batches.compare_exchange_weak(
+                batch->next_batch, batch,
+                std::memory_order_release,
+                std::memory_order_relaxed))
+            {}
+        }
+
+        // Pop one batch off the global stack, or null if it's empty.
+        // Pops are serialized, so a batch can't be popped and pushed
+        // back between loading the top and swapping it out (ABA).
+        // Pushes never wait on the lock, and it's only taken once
+        // per batch.
+        static pool_batch* _pop_batch()
+        {
+            std::lock_guard lock(_pop_mutex);
+            auto batch = _batches.load(std::memory_order_acquire);
+            while (batch != nullptr && !_batches.compare_exchange_weak(
+                batch, batch->next_batch,
+                std::memory_order_acquire,
+                std::memory_order_acquire))
+            {}
+
+            return batch;
+        }
+
+        // Refill an empty thread cache with one batch from the
+        // global free list, or from a new page if that's empty.
+        static void _refill(_thread_cache& cache)
+        {
+            if (auto batch = _pop_batch())
+            {
+                pool_slot* head = batch;
+                std::size_t count = 0;
+                for (auto slot = head; slot != nullptr; slot = slot->next)
+                {
+                    count += 1;
+                }
+
+                cache.head = head;
+                cache.count = count;
+                return;
+            }
+
+            auto page = static_cast<unsigned char*>(std::malloc(_page_size));
+            gdt_assert(page != nullptr);
+
+            pool_slot* next = nullptr;
+            for (auto i = _slots_per_page; i-- > 0;)
+            {
+                auto slot = ::new (static_cast<void*>(page + i * SlotSize))
+                    pool_slot{next};
+                next = slot;
+            }
+
+            cache.head = next;
+            cache.count = _slots_per_page;
+        }
+    };
+
+    // Smallest and largest pooled sizes.
+    inline constexpr std::size_t pool_min_size = 16;
+    inline constexpr std::size_t pool_max_size = 1024;
+
+    // Slot size for an allocation of `size` bytes.
+    constexpr std::size_t pool_slot_size(std::size_t size) noexcept
+    {
+        return std::max(pool_min_size, std::bit_ceil(size));
+    }
+
+    // Allocate a slot of `slot_size` bytes.
+    inline void* pool_allocate(std::size_t slot_size)
+    {
+        switch (slot_size)
+        {
+        case 16: return pool<16>::allocate();
+        case 32: return pool<32>::allocate();
+        case 64: return pool<64>::allocate();
+        case 128: return pool<128>::allocate();
+        case 256: return pool<256>::allocate();
+        case 512: return pool<512>::allocate();
+        case 1024: return pool<1024>::allocate();
+        default: gdt_unreachable();
+        }
+    }
+
+    // Deallocate a slot of `slot_size` bytes.
+    inline void pool_deallocate(void* p, std::size_t slot_size) noexcept
+    {
+        switch (slot_size)
+        {
+        case 16: return pool<16>::deallocate(p);
+        case 32: return pool<32>::deallocate(p);
+        case 64: return pool<64>::deallocate(p);
+        case 128: return pool<128>::deallocate(p);
+        case 256: return pool<256>::deallocate(p);
+        case 512: return pool<512>::deallocate(p);
+        case 1024: return pool<1024>::deallocate(p);
+        default: gdt_unreachable();
+        }
+    }
+}
+
+namespace gdt
+{
+    // Pool allocator.
+    // Serves allocations up to 1 KiB from per-size-class pools, and
+    // anything bigger (or over-aligned) from `gdt::allocator`.
+    template<
+        typename T,
+        typename SizeT = std::size_t,
+        typename DiffT = std::ptrdiff_t>
+    requires
+        std::is_integral_v<SizeT> && std::is_unsigned_v<SizeT> &&
+        std::is_integral_v<DiffT> && std::is_signed_v<DiffT>
+    struct pool_allocator
+    {
+        // Member types.
+        using value_type = T;
+        using size_type = SizeT;
+        using difference_type = DiffT;
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        // Constructor.
+        constexpr pool_allocator() noexcept {}
+
+        // Constructor.
+        constexpr pool_allocator(const pool_allocator&) noexcept {}
+
+        // Constructor.
+        template<typename U>
+        constexpr pool_allocator(const pool_allocator<U, SizeT, DiffT>&)
+        noexcept
+        {}
+
+        // Assignment.
+        constexpr pool_allocator& operator=(const pool_allocator&) = default;
+
+        // Max size.
+        constexpr size_type max_size() const noexcept
+        {
+            return _fallback().max_size();
+        }
+
+        // Allocate.
+        [[nodiscard]] constexpr T* allocate(size_type n)
+        {
+            return allocate_at_least(n).ptr;
+        }
+
+        // Allocate at least.
+        // Rounds up to fill the whole slot.
+        [[nodiscard]] constexpr allocation_result<T*, size_type>
+        allocate_at_least(size_type n)
+        {
+            if (std::is_constant_evaluated() || !_is_pooled(n))
+            {
+                return {_fallback().allocate(n), n};
+            }
+
+            auto slot_size = gdt_detail::pool_slot_size(sizeof(T) * n);
+            auto p = gdt_detail::pool_allocate(slot_size);
+            return {static_cast<T*>(p), size_type(slot_size / sizeof(T))};
+        }
+
+        // Deallocate.
+        constexpr void deallocate(T* p, size_type n)
+        {
+            if (std::is_constant_evaluated() || !_is_pooled(n))
+            {
+                _fallback().deallocate(p, n);
+            }
+            else
+            {
+                auto slot_size = gdt_detail::pool_slot_size(sizeof(T) * n);
+                gdt_detail::pool_deallocate(static_cast<void*>(p), slot_size);
+            }
+        }
+
+        // Equality.
+        template<typename U>
+        friend constexpr bool operator==(
+            const pool_allocator&,
+            const pool_allocator<U, SizeT, DiffT>&)
+        noexcept
+        {
+            return true;
+        }
+
+    private:
+        // Fallback allocator.
+        static constexpr allocator<T, SizeT, DiffT> _fallback() noexcept
+        {
+            return {};
+        }
+
+        // Are `n` elements served from a pool?
+        static constexpr bool _is_pooled(size_type n) noexcept
+        {
+            return
+                alignof(T) <= gdt_detail::pool_min_size &&
+                n <= gdt_detail::pool_max_size / sizeof(T);
+        }
+    };
+
+    // Pool allocators are stateless.
+    template<typename T, typename SizeT, typename DiffT>
+    struct is_trivially_relocatable<pool_allocator<T, SizeT, DiffT>> :
+        std::true_type {};
+}
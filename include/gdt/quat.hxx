@@ -0,0 +1,357 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "mat.hxx"
+#include "vec.hxx"
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace gdt
+{
+    // Quaternion.
+    // x, y, and z are the vector part and w is the scalar part. Rotations are
+    // unit quaternions.
+    template<typename T>
+    struct quat
+    {
+        // Only floating-point quaternions.
+        static_assert(std::is_floating_point_v<T>);
+
+    public:
+        // Constructor.
+        constexpr quat() = default;
+
+        // Constructor.
+        constexpr quat(const T& x, const T& y, const T& z, const T& w)
+        :
+            _xyzw{x, y, z, w}
+        {}
+
+        // Constructor.
+        constexpr quat(const vec<T, 3>& xyz, const T& w)
+        :
+            _xyzw{xyz, w}
+        {}
+
+        // Constructor.
+        explicit constexpr quat(const vec<T, 4>& xyzw)
+        :
+            _xyzw{xyzw}
+        {}
+
+        // Identity.
+        static constexpr quat identity()
+        {
+            return {T(0), T(0), T(0), T(1)};
+        }
+
+        // Rotation by `angle` radians about unit vector `axis`.
+        static quat from_axis_angle(const vec<T, 3>& axis, const T& angle)
+        {
+            auto half = angle / T(2);
+            return {axis * std::sin(half), std::cos(half)};
+        }
+
+        // Rotation matrix to quaternion.
+        static constexpr quat from_mat3(const mat<T, 3, 3>& m)
+        {
+            // Elements by row and column.
+            auto e = [&](std::size_t r, std::size_t c) { return m[c][r]; };
+
+            // Divide by the largest of 4w^2, 4x^2, 4y^2, and 4z^2.
+            auto trace = e(0, 0) + e(1, 1) + e(2, 2);
+            if (trace > T(0))
+            {
+                auto s = gdt_detail::constexpr_sqrt(trace + T(1)) * T(2);
+                return {
+                    (e(2, 1) - e(1, 2)) / s,
+                    (e(0, 2) - e(2, 0)) / s,
+                    (e(1, 0) - e(0, 1)) / s,
+                    s / T(4)};
+            }
+            else if (e(0, 0) > e(1, 1) && e(0, 0) > e(2, 2))
+            {
+                auto s = gdt_detail::constexpr_sqrt(
+                    T(1) + e(0, 0) - e(1, 1) - e(2, 2)) * T(2);
+                return {
+                    s / T(4),
+                    (e(0, 1) + e(1, 0)) / s,
+                    (e(0, 2) + e(2, 0)) / s,
+                    (e(2, 1) - e(1, 2)) / s};
+            }
+            else if (e(1, 1) > e(2, 2))
+            {
+                auto s = gdt_detail::constexpr_sqrt(
+                    T(1) + e(1, 1) - e(0, 0) - e(2, 2)) * T(2);
+                return {
+                    (e(0, 1) + e(1, 0)) / s,
+                    s / T(4),
+                    (e(1, 2) + e(2, 1)) / s,
+                    (e(0, 2) - e(2, 0)) / s};
+            }
+            else
+            {
+                auto s = gdt_detail::constexpr_sqrt(
+                    T(1) + e(2, 2) - e(0, 0) - e(1, 1)) * T(2);
+                return {
+                    (e(0, 2) + e(2, 0)) / s,
+                    (e(1, 2) + e(2, 1)) / s,
+                    s / T(4),
+                    (e(1, 0) - e(0, 1)) / s};
+            }
+        }
+
+        // Individual component accessors.
+        #define gdt(i, I)\
+        constexpr T& i()\
+        {\
+            return _xyzw[I];\
+        }\
+        constexpr const T& i() const\
+        {\
+            return _xyzw[I];\
+        }
+        gdt(x, 0)
+        gdt(y, 1)
+        gdt(z, 2)
+        gdt(w, 3)
+        #undef gdt
+
+        // Vector part.
+        constexpr vec<T, 3> xyz() const
+        {
+            return _xyzw.xyz();
+        }
+
+        // All components as a vector.
+        constexpr const vec<T, 4>& xyzw() const
+        {
+            return _xyzw;
+        }
+
+        // Unary minus.
+        // Negating a rotation gives the same rotation.
+        friend constexpr quat operator-(const quat& q)
+        {
+            return quat(-q._xyzw);
+        }
+
+        // Component-wise binary operators.
+        #define gdt(op)\
+        friend constexpr quat operator op(const quat& lhs, const quat& rhs)\
+        {\
+            return quat(lhs._xyzw op rhs._xyzw);\
+        }
+        gdt(+)
+        gdt(-)
+        #undef gdt
+
+        // Quaternion-scalar and scalar-quaternion operators.
+        #define gdt(op)\
+        friend constexpr quat operator op(const quat& lhs, const T& rhs)\
+        {\
+            return quat(lhs._xyzw op rhs);\
+        }
+        gdt(*)
+        gdt(/)
+        #undef gdt
+
+        friend constexpr quat operator*(const T& lhs, const quat& rhs)
+        {
+            return rhs * lhs;
+        }
+
+        // Quaternion multiplication.
+        // Rotates by `rhs`, then by `lhs`.
+        friend constexpr quat operator*(const quat& lhs, const quat& rhs)
+        {
+            auto& a = lhs._xyzw;
+            auto& b = rhs._xyzw;
+            return {
+                a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1],
+                a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0],
+                a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3],
+                a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2]};
+        }
+
+        // Equality.
+        friend constexpr bool operator==(const quat& lhs, const quat& rhs)
+        {
+            return all(lhs._xyzw == rhs._xyzw);
+        }
+
+    private:
+        // Member variables.
+        vec<T, 4> _xyzw;
+    };
+
+    // Dot product.
+    template<typename T>
+    constexpr T dot(const quat<T>& q1, const quat<T>& q2)
+    {
+        return dot(q1.xyzw(), q2.xyzw());
+    }
+
+    // Length.
+    template<typename T>
+    constexpr T length(const quat<T>& q)
+    {
+        return length(q.xyzw());
+    }
+
+    // Unit quaternion in the direction of `q`, which must not be zero.
+    template<typename T>
+    constexpr quat<T> normalize(const quat<T>& q)
+    {
+        return quat<T>(normalize(q.xyzw()));
+    }
+
+    // Conjugate.
+    // The inverse of a unit quaternion.
+    template<typename T>
+    constexpr quat<T> conjugate(const quat<T>& q)
+    {
+        return {-q.xyz(), q.w()};
+    }
+
+    // Inverse.
+    template<typename T>
+    constexpr quat<T> inverse(const quat<T>& q)
+    {
+        return conjugate(q) / dot(q, q);
+    }
+
+    // Rotate `v` by unit quaternion `q`.
+    template<typename T>
+    constexpr vec<T, 3> rotate(const quat<T>& q, const vec<T, 3>& v)
+    {
+        auto u = q.xyz();
+        auto t = T(2) * cross(u, v);
+        return v + q.w() * t + cross(u, t);
+    }
+
+    // Rotation matrix for unit quaternion `q`.
+    template<typename T>
+    constexpr mat<T, 3, 3> to_mat3(const quat<T>& q)
+    {
+        auto x = q.x();
+        auto y = q.y();
+        auto z = q.z();
+        auto w = q.w();
+        return {
+            vec<T, 3>(
+                T(1) - T(2) * (y * y + z * z),
+                T(2) * (x * y + w * z),
+                T(2) * (x * z - w * y)),
+            vec<T, 3>(
+                T(2) * (x * y - w * z),
+                T(1) - T(2) * (x * x + z * z),
+                T(2) * (y * z + w * x)),
+            vec<T, 3>(
+                T(2) * (x * z + w * y),
+                T(2) * (y * z - w * x),
+                T(1) - T(2) * (x * x + y * y))};
+    }
+
+    // Rotation angle of unit quaternion `q` in radians, in [0, 2pi].
+    template<typename T>
+    T angle(const quat<T>& q)
+    {
+        return T(2) * std::atan2(length(q.xyz()), q.w());
+    }
+
+    // Rotation axis of unit quaternion `q`.
+    // Any unit vector for the identity; this returns +x.
+    template<typename T>
+    vec<T, 3> axis(const quat<T>& q)
+    {
+        auto v = q.xyz();
+        auto l = length_squared(v);
+        if (l == T(0))
+        {
+            return {T(1), T(0), T(0)};
+        }
+        return v / gdt_detail::constexpr_sqrt(l);
+    }
+
+    // Normalized linear interpolation.
+    // Takes the shortest path, with uneven angular speed between unit
+    // quaternions `q1` and `q2`.
+    template<typename T>
+    constexpr quat<T> nlerp(const quat<T>& q1, const quat<T>& q2, const T& t)
+    {
+        auto b = dot(q1, q2) < T(0) ? -q2.xyzw() : q2.xyzw();
+        auto a = q1.xyzw();
+        return quat<T>(normalize(a + (b - a) * t));
+    }
+
+    // Spherical linear interpolation.
+    // Takes the shortest path, at constant angular speed between unit
+    // quaternions `q1` and `q2`.
+    template<typename T>
+    quat<T> slerp(const quat<T>& q1, const quat<T>& q2, const T& t)
+    {
+        auto d = dot(q1, q2);
+        auto b = d < T(0) ? -q2.xyzw() : q2.xyzw();
+        d = std::abs(d);
+
+        // Nearly parallel; sin(theta) is too small to divide by.
+        if (d > T(0.9995))
+        {
+            return nlerp(q1, q2, t);
+        }
+
+        auto theta = std::acos(d);
+        auto s = std::sin(theta);
+        auto a = q1.xyzw() * (std::sin((T(1) - t) * theta) / s);
+        return quat<T>(a + b * (std::sin(t * theta) / s));
+    }
+
+    // Approximately `slerp(q1, q2, t)`.
+    // nlerp with `t` adjusted by a polynomial fit in the angle between
+    // `q1` and `q2`, so no trigonometry. Within about 0.001 radians.
+    template<typename T>
+    constexpr quat<T> fast_slerp(
+        const quat<T>& q1,
+        const quat<T>& q2,
+        const T& t)
+    {
+        auto d = dot(q1, q2);
+        d = d < T(0) ? -d : d;
+
+        auto ca = T(1.0904) + d * (T(-3.2452) + d * (T(3.55645)
+            - d * T(1.43519)));
+        auto cb = T(0.848013) + d * (T(-1.06021) + d * T(0.215638));
+        auto k = ca * (t - T(0.5)) * (t - T(0.5)) + cb;
+        auto u = t + t * (t - T(0.5)) * (t - T(1)) * k;
+        return nlerp(q1, q2, u);
+    }
+}
+
+namespace gdt::batch
+{
+    // Rotate.
+    // out[i] = rotate(q, in[i]) for unit quaternion `q`, via its rotation
+    // matrix, so results can differ from `rotate` in the last place. `in`
+    // and `out` must be the same or not overlap.
+    template<typename T>
+    constexpr void rotate(
+        const quat<T>& q,
+        std::type_identity_t<std::span<const vec<T, 3>>> in,
+        std::type_identity_t<std::span<vec<T, 3>>> out)
+    {
+        auto m = to_mat3(q);
+        mat<T, 4, 4> m4(
+            vec<T, 4>(m[0], T(0)),
+            vec<T, 4>(m[1], T(0)),
+            vec<T, 4>(m[2], T(0)),
+            vec<T, 4>(T(0), T(0), T(0), T(1)));
+        transform_vectors(m4, in, out);
+    }
+}
@@ -0,0 +1,222 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/aabb_simd.hxx"
+#include "aabb.hxx"
+#include "vec.hxx"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+namespace gdt_detail
+{
+    using namespace gdt;
+
+    // 1 / x, component-wise.
+    // Gives signed infinity for signed zero in constant expressions too.
+    template<typename T, std::size_t N>
+    constexpr vec<T, N> ray_reciprocal(const vec<T, N>& x)
+    {
+        if (std::is_constant_evaluated())
+        {
+            vec<T, N> ret;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (x[i] != T(0))
+                {
+                    ret[i] = T(1) / x[i];
+                    continue;
+                }
+
+                auto negative = false;
+                if constexpr (sizeof(T) == sizeof(std::uint32_t))
+                {
+                    negative = std::bit_cast<std::uint32_t>(x[i]) >> 31;
+                }
+                else if constexpr (sizeof(T) == sizeof(std::uint64_t))
+                {
+                    negative = std::bit_cast<std::uint64_t>(x[i]) >> 63;
+                }
+                auto inf = std::numeric_limits<T>::infinity();
+                ret[i] = negative ? -inf : inf;
+            }
+            return ret;
+        }
+        return T(1) / x;
+    }
+}
+
+namespace gdt
+{
+    // Ray.
+    // Points at `origin() + direction() * t` for t >= 0. Keeps the inverse
+    // of its direction for box intersection tests.
+    template<typename T, std::size_t N>
+    struct ray
+    {
+        // Only floating-point rays.
+        static_assert(std::is_floating_point_v<T>);
+
+    public:
+        // Constructor.
+        constexpr ray() = default;
+
+        // Constructor.
+        // `direction` needn't be normalized; distances are in units of it.
+        constexpr ray(const vec<T, N>& origin, const vec<T, N>& direction)
+        :
+            _origin{origin},
+            _direction{direction},
+            _inv_direction{gdt_detail::ray_reciprocal(direction)}
+        {}
+
+        // Origin.
+        constexpr const vec<T, N>& origin() const
+        {
+            return _origin;
+        }
+
+        // Direction.
+        constexpr const vec<T, N>& direction() const
+        {
+            return _direction;
+        }
+
+        // 1 / direction, component-wise.
+        constexpr const vec<T, N>& inv_direction() const
+        {
+            return _inv_direction;
+        }
+
+        // Point at distance `t`.
+        constexpr vec<T, N> at(const T& t) const
+        {
+            return _origin + _direction * t;
+        }
+
+    private:
+        // Member variables.
+        vec<T, N> _origin;
+        vec<T, N> _direction;
+        vec<T, N> _inv_direction;
+    };
+}
+
+namespace gdt_detail
+{
+    using namespace gdt;
+
+    // Slab test against the box with bounds `lower(axis)` and
+    // `upper(axis)`. Sets `t` to the entry distance on a hit and infinity on
+    // a miss. The order of operations and NaN handling match the SIMD
+    // kernels.
+    template<typename T, std::size_t N, typename L, typename U>
+    constexpr bool ray_slabs(
+        const ray<T, N>& r,
+        const L& lower,
+        const U& upper,
+        const T& t_max,
+        T& t)
+    {
+        auto t_enter = T(0);
+        auto t_exit = t_max;
+        for (std::size_t axis = 0; axis < N; ++axis)
+        {
+            auto o = r.origin()[axis];
+            auto inv = r.inv_direction()[axis];
+            auto near = !(inv < T(0)) ? lower(axis) : upper(axis);
+            auto far = !(inv < T(0)) ? upper(axis) : lower(axis);
+
+            // A NaN from 0 * infinity, where the ray is parallel to and on
+            // a slab boundary, leaves the interval as is.
+            auto tn = (near - o) * inv;
+            auto tf = (far - o) * inv;
+            t_enter = tn > t_enter ? tn : t_enter;
+            t_exit = tf < t_exit ? tf : t_exit;
+        }
+
+        auto hit = t_enter <= t_exit;
+        t = hit ? t_enter : std::numeric_limits<T>::infinity();
+        return hit;
+    }
+}
+
+namespace gdt
+{
+    // Ray-box intersection.
+    // Distance along `r` to where it enters `box`, or 0 if it starts inside.
+    // Infinity if it doesn't reach `box` within [0, t_max]. A ray parallel
+    // to a face and exactly in its plane may or may not hit.
+    template<typename T, std::size_t N>
+    constexpr T intersect(
+        const ray<T, N>& r,
+        const aabb<T, N>& box,
+        const T& t_max = std::numeric_limits<T>::infinity())
+    {
+        T t;
+        gdt_detail::ray_slabs(
+            r,
+            [&](std::size_t axis) { return box.lower()[axis]; },
+            [&](std::size_t axis) { return box.upper()[axis]; },
+            t_max,
+            t);
+        return t;
+    }
+}
+
+namespace gdt::batch
+{
+    // Ray-box intersection.
+    // Bit `i` is set if `r` reaches `boxes.get(i)` within [0, t_max]. If `t`
+    // isn't null, lane `i` of `*t` is `intersect(r, boxes.get(i), t_max)`.
+    template<typename T, std::size_t N, std::size_t W>
+    constexpr std::uint32_t intersect(
+        const ray<T, N>& r,
+        const aabb_soa<T, N, W>& boxes,
+        const T& t_max = std::numeric_limits<T>::infinity(),
+        vec<T, W>* t = nullptr)
+    {
+        static_assert(W <= 32);
+        if constexpr (gdt_detail::simd_aabb<T, W>::enabled)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                return gdt_detail::simd_aabb<T, W>::template intersect<N>(
+                    std::addressof(boxes.lower(0)[0]),
+                    std::addressof(boxes.upper(0)[0]),
+                    std::addressof(r.origin()[0]),
+                    std::addressof(r.inv_direction()[0]),
+                    t_max,
+                    t != nullptr ? std::addressof((*t)[0]) : nullptr);
+            }
+        }
+
+        std::uint32_t ret = 0;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            T ti;
+            auto hit = gdt_detail::ray_slabs(
+                r,
+                [&](std::size_t axis) { return boxes.lower(axis)[i]; },
+                [&](std::size_t axis) { return boxes.upper(axis)[i]; },
+                t_max,
+                ti);
+            if (hit)
+            {
+                ret |= std::uint32_t(1) << i;
+            }
+            if (t != nullptr)
+            {
+                (*t)[i] = ti;
+            }
+        }
+        return ret;
+    }
+}
@@ -0,0 +1,482 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "allocator.hxx"
+#include "assert.hxx"
+#include "assume.hxx"
+#include "dynarr.hxx"
+#include "growth_policy.hxx"
+#include "trivially_relocatable.hxx"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace gdt
+{
+    // Slot map handle.
+    // Names a slot and the generation of the value that was put in it,
+    // packed into 32 bits with the index in the low `IndexBits`.
+    // Handles to erased values go stale instead of dangling.
+    template<std::uint32_t IndexBits = 20>
+    struct slot_map_handle
+    {
+        static_assert(IndexBits > 0 && IndexBits < 32);
+
+        // Largest slot index, plus one. Every index bit set means no slot.
+        static constexpr std::uint32_t max_slots = (1u << IndexBits) - 1;
+
+        // Largest generation.
+        static constexpr std::uint32_t max_generation =
+            UINT32_MAX >> IndexBits;
+
+        // Member variables.
+        std::uint32_t bits = UINT32_MAX;
+
+        // Constructor.
+        // No slot.
+        constexpr slot_map_handle() noexcept = default;
+
+        // Constructor.
+        constexpr slot_map_handle(
+            std::uint32_t index,
+            std::uint32_t generation) noexcept
+        :
+            bits{(generation << IndexBits) | index}
+        {
+            gdt_assume(index < max_slots);
+            gdt_assume(generation <= max_generation);
+        }
+
+        // Index.
+        constexpr std::uint32_t index() const noexcept
+        {
+            return bits & max_slots;
+        }
+
+        // Generation.
+        constexpr std::uint32_t generation() const noexcept
+        {
+            return bits >> IndexBits;
+        }
+
+        // Equality.
+        friend constexpr bool operator==(
+            const slot_map_handle&,
+            const slot_map_handle&) = default;
+    };
+
+    // Slot map.
+    // Values stay densely packed in insertion order, except that erasing
+    // moves the last value into the gap. Handles find them through a table
+    // of slots that tracks where each value went. A slot whose generation
+    // runs out is retired instead of wrapping around.
+    template<
+        typename T,
+        typename Allocator = allocator<T>,
+        typename Growth = default_growth,
+        std::uint32_t IndexBits = 20>
+    class slot_map
+    {
+    public:
+        // Member types.
+        using value_type = T;
+        using handle = slot_map_handle<IndexBits>;
+        using allocator_type = Allocator;
+        using growth_policy = Growth;
+        using values_type = dynarr<T, Allocator, Growth>;
+        using size_type = typename values_type::size_type;
+        using difference_type = typename values_type::difference_type;
+        using reference = T&;
+        using const_reference = const T&;
+        using iterator = typename values_type::iterator;
+        using const_iterator = typename values_type::const_iterator;
+
+    private:
+        // No free slot.
+        static constexpr std::uint32_t _no_slot = UINT32_MAX;
+
+        // Slot.
+        // Holds the dense index of its value, or the next free slot.
+        // Retired slots have a generation past `handle::max_generation`.
+        struct _slot
+        {
+            std::uint32_t index;
+            std::uint32_t generation;
+        };
+
+        // Member types.
+        using _slot_allocator = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<_slot>;
+        using _index_allocator = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<std::uint32_t>;
+
+        // Member variables.
+        values_type _values;
+        dynarr<std::uint32_t, _index_allocator, Growth> _owners;
+        dynarr<_slot, _slot_allocator, Growth> _slots;
+        std::uint32_t _free_head;
+
+    public:
+        // Constructor.
+        constexpr slot_map() noexcept(noexcept(Allocator()))
+        :
+            slot_map(Allocator())
+        {}
+
+        // Constructor.
+        explicit constexpr slot_map(const Allocator& allocator) noexcept
+        :
+            _values(allocator),
+            _owners(_index_allocator(allocator)),
+            _slots(_slot_allocator(allocator)),
+            _free_head{_no_slot}
+        {}
+
+        // Constructor.
+        constexpr slot_map(const slot_map& other) = default;
+
+        // Constructor.
+        // Leaves `other` empty, with no free slots.
+        constexpr slot_map(slot_map&& other) noexcept
+        :
+            _values(std::move(other._values)),
+            _owners(std::move(other._owners)),
+            _slots(std::move(other._slots)),
+            _free_head{std::exchange(other._free_head, _no_slot)}
+        {}
+
+        // Assignment.
+        constexpr slot_map& operator=(const slot_map& other) = default;
+
+        // Assignment.
+        // Leaves `other` empty, with no free slots.
+        constexpr slot_map& operator=(slot_map&& other)
+        noexcept(
+            std::is_nothrow_move_assignable_v<values_type> &&
+            std::is_nothrow_move_assignable_v<decltype(_owners)> &&
+            std::is_nothrow_move_assignable_v<decltype(_slots)>)
+        {
+            if (&other != this)
+            {
+                _values = std::move(other._values);
+                _owners = std::move(other._owners);
+                _slots = std::move(other._slots);
+                _free_head = std::exchange(other._free_head, _no_slot);
+
+                other._values.clear();
+                other._owners.clear();
+                other._slots.clear();
+            }
+            return *this;
+        }
+
+        // Get allocator.
+        constexpr allocator_type get_allocator() const noexcept
+        {
+            return _values.get_allocator();
+        }
+
+        // Begin.
+        // Iterates values in dense order.
+        constexpr iterator begin() noexcept
+        {
+            return _values.begin();
+        }
+
+        // Begin.
+        constexpr const_iterator begin() const noexcept
+        {
+            return _values.begin();
+        }
+
+        // End.
+        constexpr iterator end() noexcept
+        {
+            return _values.end();
+        }
+
+        // End.
+        constexpr const_iterator end() const noexcept
+        {
+            return _values.end();
+        }
+
+        // Const begin.
+        constexpr const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        // Const end.
+        constexpr const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        // Empty.
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return _values.empty();
+        }
+
+        // Size.
+        constexpr size_type size() const noexcept
+        {
+            return _values.size();
+        }
+
+        // Max size.
+        // Slot indices have to fit in a handle.
+        constexpr size_type max_size() const noexcept
+        {
+            return size_type((std::min)(
+                std::size_t(_values.max_size()),
+                std::size_t(handle::max_slots)));
+        }
+
+        // Capacity.
+        constexpr size_type capacity() const noexcept
+        {
+            return _values.capacity();
+        }
+
+        // Reserve.
+        constexpr void reserve(size_type req_capacity)
+        {
+            gdt_assert(req_capacity <= max_size());
+            _values.reserve(req_capacity);
+            _owners.reserve(req_capacity);
+            _slots.reserve(req_capacity);
+        }
+
+        // Data.
+        constexpr T* data() noexcept
+        {
+            return _values.data();
+        }
+
+        // Data.
+        constexpr const T* data() const noexcept
+        {
+            return _values.data();
+        }
+
+        // Values.
+        // Every value, contiguous.
+        constexpr std::span<T> values() noexcept
+        {
+            return {_values.data(), std::size_t(size())};
+        }
+
+        // Values.
+        constexpr std::span<const T> values() const noexcept
+        {
+            return {_values.data(), std::size_t(size())};
+        }
+
+        // Insert.
+        constexpr handle insert(const T& value)
+        {
+            return emplace(value);
+        }
+
+        // Insert.
+        constexpr handle insert(T&& value)
+        {
+            return emplace(std::move(value));
+        }
+
+        // Emplace.
+        template<typename... Args>
+        constexpr handle emplace(Args&&... args)
+        {
+            _values.emplace_back(std::forward<Args>(args)...);
+            auto index = std::uint32_t(_values.size() - 1);
+
+            std::uint32_t s;
+            if (_free_head != _no_slot)
+            {
+                s = _free_head;
+                _free_head = _slots[s].index;
+            }
+            else
+            {
+                gdt_assert(_slots.size() < handle::max_slots);
+                s = std::uint32_t(_slots.size());
+                _slots.push_back({0, 0});
+            }
+
+            _slots[s].index = index;
+            _owners.push_back(s);
+            return {s, _slots[s].generation};
+        }
+
+        // Erase.
+        // Moves the last value into the gap. Returns whether `h` was valid.
+        constexpr bool erase(handle h)
+        {
+            if (!contains(h))
+            {
+                return false;
+            }
+
+            _erase_slot(h.index());
+            return true;
+        }
+
+        // Erase.
+        // Returns an iterator to the value moved into the gap.
+        constexpr iterator erase(const_iterator position)
+        {
+            gdt_assume(position >= cbegin());
+            gdt_assume(position < cend());
+
+            auto i = position - cbegin();
+            _erase_slot(_owners[size_type(i)]);
+            return begin() + i;
+        }
+
+        // Clear.
+        // Invalidates every handle.
+        constexpr void clear() noexcept
+        {
+            for (auto s : _owners)
+            {
+                _free_slot(s);
+            }
+
+            _values.clear();
+            _owners.clear();
+        }
+
+        // Contains.
+        constexpr bool contains(handle h) const noexcept
+        {
+            return
+                h.index() < _slots.size() &&
+                _slots[h.index()].generation == h.generation();
+        }
+
+        // Find.
+        // Returns null for stale handles.
+        constexpr T* find(handle h) noexcept
+        {
+            return contains(h) ?
+                _values.data() + _slots[h.index()].index :
+                nullptr;
+        }
+
+        // Find.
+        constexpr const T* find(handle h) const noexcept
+        {
+            return contains(h) ?
+                _values.data() + _slots[h.index()].index :
+                nullptr;
+        }
+
+        // Subscript.
+        constexpr reference operator[](handle h)
+        {
+            gdt_assume(contains(h));
+            return _values[_slots[h.index()].index];
+        }
+
+        // Subscript.
+        constexpr const_reference operator[](handle h) const
+        {
+            gdt_assume(contains(h));
+            return _values[_slots[h.index()].index];
+        }
+
+        // At.
+        constexpr reference at(handle h)
+        {
+            gdt_assert(contains(h));
+            return (*this)[h];
+        }
+
+        // At.
+        constexpr const_reference at(handle h) const
+        {
+            gdt_assert(contains(h));
+            return (*this)[h];
+        }
+
+        // Handle of the value at `position`.
+        constexpr handle handle_of(const_iterator position) const
+        {
+            gdt_assume(position >= cbegin());
+            gdt_assume(position < cend());
+
+            auto s = _owners[size_type(position - cbegin())];
+            return {s, _slots[s].generation};
+        }
+
+        // Swap.
+        constexpr void swap(slot_map& other)
+        noexcept(noexcept(std::declval<values_type&>().swap(
+            std::declval<values_type&>())))
+        {
+            _values.swap(other._values);
+            _owners.swap(other._owners);
+            _slots.swap(other._slots);
+            std::swap(_free_head, other._free_head);
+        }
+
+        // Swap.
+        friend constexpr void swap(slot_map& lhs, slot_map& rhs)
+        noexcept(noexcept(lhs.swap(rhs)))
+        {
+            lhs.swap(rhs);
+        }
+
+    private:
+        // Erase the value in slot `s`.
+        constexpr void _erase_slot(std::uint32_t s)
+        {
+            auto i = _slots[s].index;
+            auto last = std::uint32_t(_values.size() - 1);
+
+            _values.swap_remove(_values.begin() + difference_type(i));
+            if (i != last)
+            {
+                auto moved = _owners[last];
+                _owners[i] = moved;
+                _slots[moved].index = i;
+            }
+            _owners.pop_back();
+
+            _free_slot(s);
+        }
+
+        // Retire slot `s`'s generation and put it on the free list, unless
+        // that was its last generation.
+        constexpr void _free_slot(std::uint32_t s) noexcept
+        {
+            _slots[s].generation += 1;
+            if (_slots[s].generation <= handle::max_generation)
+            {
+                _slots[s].index = _free_head;
+                _free_head = s;
+            }
+        }
+    };
+
+    // Slot map is trivially relocatable if its dynarrs are.
+    template<
+        typename T,
+        typename Allocator,
+        typename Growth,
+        std::uint32_t IndexBits>
+    struct is_trivially_relocatable<
+        slot_map<T, Allocator, Growth, IndexBits>> :
+        is_trivially_relocatable<dynarr<T, Allocator, Growth>> {};
+}
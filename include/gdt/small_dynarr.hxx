@@ -0,0 +1,491 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "allocator.hxx"
+#include "dynarr.hxx"
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace gdt_detail
+{
+    // Small dynarr allocator.
+    // Hands out its inline buffer when it's big enough and
+    // not already in use, and defers to `Allocator` otherwise.
+    template<typename T, std::size_t N, typename Allocator>
+    class small_dynarr_allocator
+    {
+        static_assert(N > 0);
+        static_assert(std::is_same_v<
+            typename std::allocator_traits<Allocator>::pointer, T*>);
+
+    public:
+        // Member types.
+        using value_type = T;
+        using size_type = typename std::allocator_traits<Allocator>::size_type;
+        using difference_type = typename std::allocator_traits<Allocator>::difference_type;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::false_type;
+        using propagate_on_container_swap = std::false_type;
+        using is_always_equal = std::false_type;
+
+        // Constructor.
+        explicit constexpr small_dynarr_allocator(const Allocator& allocator)
+        noexcept
+        :
+            _allocator{allocator},
+            _in_use{false}
+        {}
+
+        // Constructor.
+        // Copies get their own (unused) inline buffer.
+        constexpr small_dynarr_allocator(const small_dynarr_allocator& other)
+        noexcept
+        :
+            _allocator{other._allocator},
+            _in_use{false}
+        {}
+
+        // Assignment.
+        small_dynarr_allocator& operator=(
+            const small_dynarr_allocator&) = delete;
+
+        // Inner allocator.
+        constexpr const Allocator& inner() const noexcept
+        {
+            return _allocator;
+        }
+
+        // Max size.
+        constexpr size_type max_size() const noexcept
+        {
+            return std::allocator_traits<Allocator>::max_size(_allocator);
+        }
+
+        // Allocate.
+        [[nodiscard]] constexpr T* allocate(size_type n)
+        {
+            return allocate_at_least(n).ptr;
+        }
+
+        // Allocate at least.
+        [[nodiscard]] constexpr allocation_result<T*, size_type>
+        allocate_at_least(size_type n)
+        {
+            // Constant evaluation can't reinterpret the
+            // inline buffer, so always use `Allocator` then.
+            if (!std::is_constant_evaluated() && n <= N && !_in_use)
+            {
+                _in_use = true;
+                return {_buffer_ptr(), size_type(N)};
+            }
+
+            auto p = std::allocator_traits<Allocator>::allocate(_allocator, n);
+            return {p, n};
+        }
+
+        // Deallocate.
+        constexpr void deallocate(T* p, size_type n)
+        {
+            if (_is_inline(p))
+            {
+                _in_use = false;
+            }
+            else
+            {
+                std::allocator_traits<Allocator>::deallocate(_allocator, p, n);
+            }
+        }
+
+        // Try expand.
+        bool try_expand(T* p, size_type old_n, size_type new_n)
+        requires has_try_expand<Allocator>
+        {
+            if (_is_inline(p))
+            {
+                return new_n <= N;
+            }
+            else
+            {
+                return _allocator.try_expand(p, old_n, new_n);
+            }
+        }
+
+        // Reallocate.
+        // Requests that fit stay in (or move back to) the inline buffer.
+        [[nodiscard]] T* reallocate(T* p, size_type old_n, size_type new_n)
+        requires has_reallocate<Allocator>
+        {
+            auto inline_p = _is_inline(p);
+            if (inline_p && new_n <= N)
+            {
+                return p;
+            }
+
+            if (!inline_p && (new_n > N || _in_use))
+            {
+                return _allocator.reallocate(p, old_n, new_n);
+            }
+
+            auto new_p = inline_p ?
+                std::allocator_traits<Allocator>::allocate(_allocator, new_n) :
+                _buffer_ptr();
+            std::memcpy(
+                static_cast<void*>(new_p),
+                static_cast<const void*>(p),
+                sizeof(T) * std::size_t(std::min(old_n, new_n)));
+            deallocate(p, old_n);
+            _in_use = !inline_p;
+            return new_p;
+        }
+
+        // Equality.
+        // Inline buffers can't change hands, so allocators
+        // using theirs aren't equal to anything.
+        friend constexpr bool operator==(
+            const small_dynarr_allocator& lhs,
+            const small_dynarr_allocator& rhs)
+        noexcept
+        {
+            return
+                !lhs._in_use &&
+                !rhs._in_use &&
+                lhs._allocator == rhs._allocator;
+        }
+
+    private:
+        // Member variables.
+        [[no_unique_address]] Allocator _allocator;
+        bool _in_use;
+        alignas(T) unsigned char _buffer[sizeof(T) * N];
+
+        // Inline buffer pointer.
+        T* _buffer_ptr() noexcept
+        {
+            return static_cast<T*>(static_cast<void*>(_buffer));
+        }
+
+        // Is `p` the inline buffer?
+        constexpr bool _is_inline(T* p) noexcept
+        {
+            return !std::is_constant_evaluated() && p == _buffer_ptr();
+        }
+    };
+}
+
+namespace gdt
+{
+    // Small dynamic array.
+    // A dynarr with room for `N` elements inline.
+    template<typename T, std::size_t N, typename Allocator = allocator<T>>
+    class small_dynarr :
+        private dynarr<T, gdt_detail::small_dynarr_allocator<T, N, Allocator>>
+    {
+        // Member types.
+        using _allocator_type =
+            gdt_detail::small_dynarr_allocator<T, N, Allocator>;
+        using _base = dynarr<T, _allocator_type>;
+
+    public:
+        // Member types.
+        using value_type = typename _base::value_type;
+        using allocator_type = Allocator;
+        using pointer = typename _base::pointer;
+        using const_pointer = typename _base::const_pointer;
+        using reference = typename _base::reference;
+        using const_reference = typename _base::const_reference;
+        using size_type = typename _base::size_type;
+        using difference_type = typename _base::difference_type;
+        using iterator = typename _base::iterator;
+        using const_iterator = typename _base::const_iterator;
+        using reverse_iterator = typename _base::reverse_iterator;
+        using const_reverse_iterator = typename _base::const_reverse_iterator;
+
+        // Inline capacity.
+        static constexpr std::size_t inline_capacity = N;
+
+        // Constructor.
+        constexpr small_dynarr() noexcept(noexcept(Allocator()))
+        :
+            small_dynarr(Allocator())
+        {}
+
+        // Constructor.
+        explicit constexpr small_dynarr(const Allocator& allocator) noexcept
+        :
+            _base(_allocator_type(allocator))
+        {}
+
+        // Constructor.
+        explicit constexpr small_dynarr(
+            size_type len,
+            const Allocator& allocator = Allocator())
+        :
+            _base(len, _allocator_type(allocator))
+        {}
+
+        // Constructor.
+        constexpr small_dynarr(
+            size_type len,
+            const T& fill_value,
+            const Allocator& allocator = Allocator())
+        :
+            _base(len, fill_value, _allocator_type(allocator))
+        {}
+
+        // Constructor.
+        template<
+            typename InputIterator>
+        requires std::is_base_of_v<
+            std::input_iterator_tag,
+            typename std::iterator_traits<InputIterator>::iterator_category>
+        constexpr small_dynarr(
+            InputIterator first,
+            InputIterator last,
+            const Allocator& allocator = Allocator())
+        :
+            _base(first, last, _allocator_type(allocator))
+        {}
+
+        // Constructor.
+        constexpr small_dynarr(const small_dynarr& other)
+        :
+            small_dynarr(other, std::allocator_traits<Allocator>::
+                select_on_container_copy_construction(other.get_allocator()))
+        {}
+
+        // Constructor.
+        // Steals heap buffers, but moves inline elements one by one.
+        constexpr small_dynarr(small_dynarr&& other)
+        noexcept(std::is_nothrow_move_constructible_v<T>)
+        :
+            small_dynarr(std::move(other), other.get_allocator())
+        {}
+
+        // Constructor.
+        constexpr small_dynarr(
+            const small_dynarr& other,
+            const Allocator& allocator)
+        :
+            _base(other, _allocator_type(allocator))
+        {}
+
+        // Constructor.
+        constexpr small_dynarr(
+            small_dynarr&& other,
+            const Allocator& allocator)
+        :
+            _base(std::move(other), _allocator_type(allocator))
+        {}
+
+        // Constructor.
+        constexpr small_dynarr(
+            std::initializer_list<T> il,
+            const Allocator& allocator = Allocator())
+        :
+            _base(il, _allocator_type(allocator))
+        {}
+
+        // Destructor.
+        constexpr ~small_dynarr() = default;
+
+        // Assignment.
+        constexpr small_dynarr& operator=(const small_dynarr& other) = default;
+
+        // Assignment.
+        constexpr small_dynarr& operator=(small_dynarr&& other) = default;
+
+        // Assignment.
+        constexpr small_dynarr& operator=(std::initializer_list<T> il)
+        {
+            _base::operator=(il);
+            return *this;
+        }
+
+        // Get allocator.
+        constexpr allocator_type get_allocator() const noexcept
+        {
+            return _base::get_allocator().inner();
+        }
+
+        // Is using the inline buffer?
+        constexpr bool is_inline() const noexcept
+        {
+            if (std::is_constant_evaluated())
+            {
+                return false;
+            }
+
+            auto p = static_cast<const void*>(data());
+            auto less = std::less<const void*>();
+            return
+                !less(p, static_cast<const void*>(this)) &&
+                less(p, static_cast<const void*>(this + 1));
+        }
+
+        // Dynarr interface.
+        using _base::assign;
+        using _base::begin;
+        using _base::end;
+        using _base::rbegin;
+        using _base::rend;
+        using _base::cbegin;
+        using _base::cend;
+        using _base::crbegin;
+        using _base::crend;
+        using _base::empty;
+        using _base::size;
+        using _base::max_size;
+        using _base::capacity;
+        using _base::resize;
+        using _base::resize_for_overwrite;
+        using _base::append_uninitialized;
+        using _base::reserve;
+        using _base::operator[];
+        using _base::at;
+        using _base::front;
+        using _base::back;
+        using _base::data;
+        using _base::emplace_back;
+        using _base::push_back;
+        using _base::pop_back;
+        using _base::emplace;
+        using _base::insert;
+        using _base::erase;
+        using _base::swap_remove;
+        using _base::clear;
+
+        // Shrink to fit.
+        // Elements already in the inline buffer stay there.
+        constexpr void shrink_to_fit()
+        {
+            if (!is_inline())
+            {
+                _base::shrink_to_fit();
+            }
+        }
+
+        // Swap.
+        // Constant time when neither side is inline. Otherwise inline
+        // buffers can't change hands, so this swaps or moves elements
+        // one by one and is linear in the number of inline elements.
+        constexpr void swap(small_dynarr& other)
+        noexcept(
+            std::is_nothrow_move_constructible_v<T> &&
+            std::is_nothrow_swappable_v<T>)
+        {
+            if (!is_inline() && !other.is_inline())
+            {
+                _base::swap(other);
+            }
+            else if (is_inline() && other.is_inline())
+            {
+                _swap_inline(other);
+            }
+            else if (is_inline())
+            {
+                other._swap_inline_with_heap(*this);
+            }
+            else
+            {
+                _swap_inline_with_heap(other);
+            }
+        }
+
+        // Swap.
+        friend constexpr void swap(small_dynarr& lhs, small_dynarr& rhs)
+        {
+            lhs.swap(rhs);
+        }
+
+        // Equality.
+        friend constexpr bool operator==(
+            const small_dynarr& lhs,
+            const small_dynarr& rhs)
+        {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+        // Comparison.
+        template<typename U = T>
+        friend constexpr auto operator<=>(
+            const small_dynarr& lhs,
+            const small_dynarr& rhs)
+        -> decltype(std::declval<const U&>() <=> std::declval<const U&>())
+        {
+            return static_cast<const _base&>(lhs) <=>
+                static_cast<const _base&>(rhs);
+        }
+
+    private:
+        // Swap with another inline small dynarr.
+        constexpr void _swap_inline(small_dynarr& other)
+        {
+            auto& shorter = size() < other.size() ? *this : other;
+            auto& longer = size() < other.size() ? other : *this;
+            auto mid = longer.begin() + difference_type(shorter.size());
+
+            std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+            for (auto it = mid; it != longer.end(); ++it)
+            {
+                shorter.push_back(std::move(*it));
+            }
+            longer.erase(mid, longer.end());
+        }
+
+        // Swap with an inline small dynarr while this one's on the heap.
+        // Moves `other`'s elements into this one's inline buffer
+        // and hands it the heap buffer.
+        constexpr void _swap_inline_with_heap(small_dynarr& other)
+        {
+            small_dynarr heap(std::move(*this));
+            reserve(size_type(N));
+            for (auto& value : other)
+            {
+                push_back(std::move(value));
+            }
+
+            other.clear();
+            other._base::shrink_to_fit();
+            other._base::swap(heap);
+        }
+    };
+
+    // Erase.
+    template<typename T, std::size_t N, typename Allocator, typename U>
+    constexpr typename small_dynarr<T, N, Allocator>::size_type
+    erase(small_dynarr<T, N, Allocator>& a, const U& value)
+    {
+        auto old_end = a.end();
+        auto new_end = std::remove(a.begin(), old_end, value);
+        using size_type = typename small_dynarr<T, N, Allocator>::size_type;
+        auto count = size_type(old_end - new_end);
+        a.erase(new_end, old_end);
+        return count;
+    }
+
+    // Erase if.
+    template<typename T, std::size_t N, typename Allocator, typename Pred>
+    constexpr typename small_dynarr<T, N, Allocator>::size_type
+    erase_if(small_dynarr<T, N, Allocator>& a, Pred&& pred)
+    {
+        auto beg = a.begin();
+        auto old_end = a.end();
+        auto new_end = std::remove_if(beg, old_end, std::forward<Pred>(pred));
+        using size_type = typename small_dynarr<T, N, Allocator>::size_type;
+        auto count = size_type(old_end - new_end);
+        a.erase(new_end, old_end);
+        return count;
+    }
+}
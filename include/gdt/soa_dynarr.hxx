@@ -0,0 +1,800 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "allocator.hxx"
+#include "assert.hxx"
+#include "assume.hxx"
+#include "dynarr.hxx"
+#include "growth_policy.hxx"
+#include "trivially_relocatable.hxx"
+#include "vec.hxx"
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace gdt_detail
+{
+    using namespace gdt;
+
+    // Component type of a structure-of-arrays element.
+    template<typename V>
+    struct soa_component;
+
+    template<typename T, std::size_t N>
+    struct soa_component<vec<T, N>>
+    {
+        using type = T;
+    };
+
+    template<typename V>
+    using soa_component_t = typename soa_component<V>::type;
+
+    // Structure-of-arrays reference.
+    template<typename T, std::size_t N>
+    class soa_reference;
+
+    // Structure-of-arrays dynarr iterator.
+    template<typename Soa>
+    class soa_dynarr_iterator;
+
+    // Is structure-of-arrays reference.
+    template<typename T>
+    struct is_soa_reference : std::false_type {};
+
+    template<typename T, std::size_t N>
+    struct is_soa_reference<soa_reference<T, N>> : std::true_type {};
+
+    template<typename T>
+    constexpr bool is_soa_reference_v = is_soa_reference<T>::value;
+}
+
+namespace gdt
+{
+    // Structure-of-arrays dynamic array.
+    template<
+        typename V,
+        typename Allocator = allocator<gdt_detail::soa_component_t<V>>,
+        typename Growth = default_growth>
+    class soa_dynarr;
+
+    // Structure-of-arrays dynamic array of vectors.
+    // Stores each component in its own contiguous lane.
+    template<typename T, std::size_t N, typename Allocator, typename Growth>
+    class soa_dynarr<vec<T, N>, Allocator, Growth>
+    {
+    public:
+        // Member types.
+        using value_type = vec<T, N>;
+        using component_type = T;
+        using allocator_type = Allocator;
+        using growth_policy = Growth;
+        using lane_type = dynarr<T, Allocator, Growth>;
+        using size_type = typename lane_type::size_type;
+        using difference_type = typename lane_type::difference_type;
+        using reference = gdt_detail::soa_reference<T, N>;
+        using const_reference = gdt_detail::soa_reference<const T, N>;
+        using iterator = gdt_detail::soa_dynarr_iterator<soa_dynarr>;
+        using const_iterator = gdt_detail::soa_dynarr_iterator<const soa_dynarr>;
+
+        // Constructor.
+        constexpr soa_dynarr() noexcept(noexcept(Allocator())) = default;
+
+        // Constructor.
+        explicit constexpr soa_dynarr(const Allocator& allocator) noexcept
+        :
+            soa_dynarr(allocator, std::make_index_sequence<N>())
+        {}
+
+        // Constructor.
+        constexpr soa_dynarr(const soa_dynarr& other)
+        :
+            soa_dynarr(std::make_index_sequence<N>(), other)
+        {}
+
+        // Constructor.
+        constexpr soa_dynarr(soa_dynarr&& other) noexcept
+        :
+            soa_dynarr(std::make_index_sequence<N>(), std::move(other))
+        {}
+
+        // Constructor.
+        explicit constexpr soa_dynarr(
+            size_type count,
+            const Allocator& allocator = Allocator())
+        :
+            soa_dynarr(allocator)
+        {
+            resize(count);
+        }
+
+        // Constructor.
+        constexpr soa_dynarr(
+            size_type count,
+            const value_type& value,
+            const Allocator& allocator = Allocator())
+        :
+            soa_dynarr(allocator)
+        {
+            resize(count, value);
+        }
+
+        // Constructor.
+        constexpr soa_dynarr(
+            std::initializer_list<value_type> il,
+            const Allocator& allocator = Allocator())
+        :
+            soa_dynarr(allocator)
+        {
+            reserve(size_type(il.size()));
+            for (auto& v : il)
+            {
+                push_back(v);
+            }
+        }
+
+        // Assignment.
+        constexpr soa_dynarr& operator=(const soa_dynarr& other)
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                _lanes[k] = other._lanes[k];
+            }
+            return *this;
+        }
+
+        // Assignment.
+        constexpr soa_dynarr& operator=(
+            soa_dynarr&& other)
+        noexcept(std::is_nothrow_move_assignable_v<lane_type>)
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                _lanes[k] = std::move(other._lanes[k]);
+            }
+            return *this;
+        }
+
+        // Get allocator.
+        constexpr allocator_type get_allocator() const noexcept
+        {
+            return _lanes[0].get_allocator();
+        }
+
+        // Begin.
+        constexpr iterator begin() noexcept
+        {
+            return iterator(this, 0);
+        }
+
+        // Begin.
+        constexpr const_iterator begin() const noexcept
+        {
+            return const_iterator(this, 0);
+        }
+
+        // End.
+        constexpr iterator end() noexcept
+        {
+            return iterator(this, size());
+        }
+
+        // End.
+        constexpr const_iterator end() const noexcept
+        {
+            return const_iterator(this, size());
+        }
+
+        // Const begin.
+        constexpr const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        // Const end.
+        constexpr const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        // Empty.
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return _lanes[0].empty();
+        }
+
+        // Size.
+        constexpr size_type size() const noexcept
+        {
+            return _lanes[0].size();
+        }
+
+        // Max size.
+        constexpr size_type max_size() const noexcept
+        {
+            return _lanes[0].max_size();
+        }
+
+        // Capacity.
+        // Every lane has the same capacity.
+        constexpr size_type capacity() const noexcept
+        {
+            return _lanes[0].capacity();
+        }
+
+        // Resize.
+        constexpr void resize(size_type tgt_len)
+        {
+            for (auto& lane : _lanes)
+            {
+                lane.resize(tgt_len);
+            }
+        }
+
+        // Resize.
+        constexpr void resize(size_type tgt_len, const value_type& fill_value)
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                _lanes[k].resize(tgt_len, fill_value[k]);
+            }
+        }
+
+        // Reserve.
+        constexpr void reserve(size_type req_capacity)
+        {
+            for (auto& lane : _lanes)
+            {
+                lane.reserve(req_capacity);
+            }
+        }
+
+        // Shrink to fit.
+        constexpr void shrink_to_fit()
+        {
+            for (auto& lane : _lanes)
+            {
+                lane.shrink_to_fit();
+            }
+        }
+
+        // Subscript.
+        constexpr reference operator[](size_type i)
+        {
+            gdt_assume(i <= capacity());
+            return _reference<reference>(*this, i);
+        }
+
+        // Subscript.
+        constexpr const_reference operator[](size_type i) const
+        {
+            gdt_assume(i <= capacity());
+            return _reference<const_reference>(*this, i);
+        }
+
+        // At.
+        constexpr reference at(size_type i)
+        {
+            gdt_assert(i < size());
+            return (*this)[i];
+        }
+
+        // At.
+        constexpr const_reference at(size_type i) const
+        {
+            gdt_assert(i < size());
+            return (*this)[i];
+        }
+
+        // Front.
+        constexpr reference front()
+        {
+            gdt_assume(!empty());
+            return (*this)[0];
+        }
+
+        // Front.
+        constexpr const_reference front() const
+        {
+            gdt_assume(!empty());
+            return (*this)[0];
+        }
+
+        // Back.
+        constexpr reference back()
+        {
+            gdt_assume(!empty());
+            return (*this)[size() - 1];
+        }
+
+        // Back.
+        constexpr const_reference back() const
+        {
+            gdt_assume(!empty());
+            return (*this)[size() - 1];
+        }
+
+        // Lane.
+        // Component `k` of every element, contiguous.
+        constexpr std::span<T> lane(std::size_t k) noexcept
+        {
+            gdt_assume(k < N);
+            return {_lanes[k].data(), std::size_t(size())};
+        }
+
+        // Lane.
+        constexpr std::span<const T> lane(std::size_t k) const noexcept
+        {
+            gdt_assume(k < N);
+            return {_lanes[k].data(), std::size_t(size())};
+        }
+
+        // Push back.
+        constexpr void push_back(const value_type& value)
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                _lanes[k].push_back(value[k]);
+            }
+        }
+
+        // Pop back.
+        constexpr void pop_back()
+        {
+            for (auto& lane : _lanes)
+            {
+                lane.pop_back();
+            }
+        }
+
+        // Erase.
+        constexpr iterator erase(const_iterator position)
+        {
+            gdt_assume(position >= begin());
+            gdt_assume(position < end());
+
+            auto i = position - cbegin();
+            for (auto& lane : _lanes)
+            {
+                lane.erase(lane.begin() + i);
+            }
+
+            return begin() + i;
+        }
+
+        // Swap remove.
+        // Like erase, but moves the last element into the gap
+        // instead of shifting. Doesn't preserve element order.
+        constexpr iterator swap_remove(const_iterator position)
+        {
+            gdt_assume(position >= begin());
+            gdt_assume(position < end());
+
+            auto i = position - cbegin();
+            for (auto& lane : _lanes)
+            {
+                lane.swap_remove(lane.begin() + i);
+            }
+
+            return begin() + i;
+        }
+
+        // Swap.
+        constexpr void swap(soa_dynarr& other)
+        noexcept(noexcept(std::declval<lane_type&>().swap(
+            std::declval<lane_type&>())))
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                _lanes[k].swap(other._lanes[k]);
+            }
+        }
+
+        // Swap.
+        friend constexpr void swap(soa_dynarr& lhs, soa_dynarr& rhs)
+        noexcept(noexcept(lhs.swap(rhs)))
+        {
+            lhs.swap(rhs);
+        }
+
+        // Clear.
+        constexpr void clear() noexcept
+        {
+            for (auto& lane : _lanes)
+            {
+                lane.clear();
+            }
+        }
+
+        // Equality.
+        friend constexpr bool operator==(
+            const soa_dynarr& lhs,
+            const soa_dynarr& rhs)
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                if (lhs._lanes[k] != rhs._lanes[k])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+        // Member variables.
+        lane_type _lanes[N];
+
+        // Constructor.
+        template<std::size_t... I>
+        constexpr soa_dynarr(
+            const Allocator& allocator,
+            std::index_sequence<I...>)
+        noexcept
+        :
+            _lanes{((void)I, lane_type(allocator))...}
+        {}
+
+        // Constructor.
+        // Copies or moves each lane. GCC can't copy
+        // arrays of dynarrs in constant expressions.
+        template<std::size_t... I, typename Other>
+        constexpr soa_dynarr(std::index_sequence<I...>, Other&& other)
+        :
+            _lanes{lane_type(std::forward<Other>(other)._lanes[I])...}
+        {}
+
+        // Reference to element `i` of `self`.
+        template<typename Ref, typename Self>
+        static constexpr Ref _reference(Self& self, size_type i)
+        {
+            Ref ret;
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                ret._ptrs[k] = self._lanes[k].data() + i;
+            }
+            return ret;
+        }
+    };
+
+    // Structure-of-arrays dynarr is trivially relocatable if its lanes are.
+    template<typename T, std::size_t N, typename Allocator, typename Growth>
+    struct is_trivially_relocatable<soa_dynarr<vec<T, N>, Allocator, Growth>> :
+        is_trivially_relocatable<dynarr<T, Allocator, Growth>> {};
+}
+
+namespace gdt_detail
+{
+    // Structure-of-arrays reference.
+    // Refers to one element of a soa_dynarr and behaves like a `vec`.
+    // Assigning through it writes the element.
+    template<typename T, std::size_t N>
+    class soa_reference
+    {
+    public:
+        // Member types.
+        using value_type = vec<std::remove_const_t<T>, N>;
+
+        // Constructor.
+        template<typename U>
+        requires (std::is_const_v<T> && std::is_same_v<const U, T>)
+        constexpr soa_reference(const soa_reference<U, N>& other) noexcept
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                _ptrs[k] = other._ptrs[k];
+            }
+        }
+
+        // Constructor.
+        constexpr soa_reference(const soa_reference&) = default;
+
+        // Assignment.
+        // Writes the element rather than rebinding.
+        constexpr const soa_reference& operator=(
+            const soa_reference& other) const
+        requires (!std::is_const_v<T>)
+        {
+            return *this = other.get();
+        }
+
+        // Assignment.
+        constexpr const soa_reference& operator=(const value_type& v) const
+        requires (!std::is_const_v<T>)
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                *_ptrs[k] = v[k];
+            }
+            return *this;
+        }
+
+        // Get.
+        constexpr value_type get() const
+        {
+            value_type ret;
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                ret[k] = *_ptrs[k];
+            }
+            return ret;
+        }
+
+        // Conversion.
+        constexpr operator value_type() const
+        {
+            return get();
+        }
+
+        // Subscript.
+        constexpr T& operator[](std::size_t i) const
+        {
+            gdt_assume(i < N);
+            return *_ptrs[i];
+        }
+
+        // Individual component accessors.
+        #define gdt(i, I)\
+        constexpr T& i() const requires (N > I)\
+        {\
+            return *_ptrs[I];\
+        }
+        gdt(x, 0)
+        gdt(y, 1)
+        gdt(z, 2)
+        gdt(w, 3)
+        gdt(r, 0)
+        gdt(g, 1)
+        gdt(b, 2)
+        gdt(a, 3)
+        #undef gdt
+
+        // Unary operators.
+        friend constexpr auto operator-(const soa_reference& v)
+        {
+            return -v.get();
+        }
+
+        // Binary operators.
+        // Load the element, then defer to `vec`.
+        #define gdt(op)\
+        friend constexpr auto operator op(\
+            const soa_reference& lhs,\
+            const soa_reference& rhs)\
+        {\
+            return lhs.get() op rhs.get();\
+        }\
+        friend constexpr auto operator op(\
+            const soa_reference& lhs,\
+            const value_type& rhs)\
+        {\
+            return lhs.get() op rhs;\
+        }\
+        friend constexpr auto operator op(\
+            const value_type& lhs,\
+            const soa_reference& rhs)\
+        {\
+            return lhs op rhs.get();\
+        }\
+        template<typename U>\
+        requires (!is_vec_v<U> && !is_soa_reference_v<U>)\
+        friend constexpr auto operator op(\
+            const soa_reference& lhs,\
+            const U& rhs)\
+        {\
+            return lhs.get() op rhs;\
+        }\
+        template<typename U>\
+        requires (!is_vec_v<U> && !is_soa_reference_v<U>)\
+        friend constexpr auto operator op(\
+            const U& lhs,\
+            const soa_reference& rhs)\
+        {\
+            return lhs op rhs.get();\
+        }
+        gdt(+)
+        gdt(-)
+        gdt(*)
+        gdt(/)
+        gdt(==)
+        gdt(!=)
+        #undef gdt
+
+        // Compound assignment operators.
+        #define gdt(op)\
+        template<typename U>\
+        constexpr const soa_reference& operator op##=(const U& rhs) const\
+        requires (!std::is_const_v<T>)\
+        {\
+            return *this = value_type(*this op rhs);\
+        }
+        gdt(+)
+        gdt(-)
+        gdt(*)
+        gdt(/)
+        #undef gdt
+
+        // Swap.
+        // Swaps the referenced elements.
+        friend constexpr void swap(soa_reference lhs, soa_reference rhs)
+        requires (!std::is_const_v<T>)
+        {
+            auto tmp = lhs.get();
+            lhs = rhs.get();
+            rhs = tmp;
+        }
+
+    private:
+        // Friends.
+        template<typename, typename, typename> friend class gdt::soa_dynarr;
+        template<typename, std::size_t> friend class soa_reference;
+
+        // Member variables.
+        T* _ptrs[N];
+
+        // Constructor.
+        constexpr soa_reference() = default;
+    };
+
+    // Structure-of-arrays dynarr iterator.
+    // `Soa` is a possibly const soa_dynarr.
+    template<typename Soa>
+    class soa_dynarr_iterator
+    {
+    public:
+        // Member types.
+        using value_type = typename Soa::value_type;
+        using difference_type = typename Soa::difference_type;
+        using reference = decltype(std::declval<Soa&>()[0]);
+        using iterator_category = std::input_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+
+        // Constructor.
+        constexpr soa_dynarr_iterator() = default;
+
+        // Constructor.
+        template<typename Other>
+        requires (
+            std::is_const_v<Soa> &&
+            std::is_same_v<const Other, Soa>)
+        constexpr soa_dynarr_iterator(const soa_dynarr_iterator<Other>& other)
+        :
+            _soa{other._soa},
+            _i{other._i}
+        {}
+
+        // Dereference.
+        constexpr reference operator*() const
+        {
+            return (*_soa)[_i];
+        }
+
+        // Subscript.
+        constexpr reference operator[](difference_type i) const
+        {
+            return (*_soa)[_size_type(_i + i)];
+        }
+
+        // Pre-increment.
+        constexpr soa_dynarr_iterator& operator++()
+        {
+            ++_i;
+            return *this;
+        }
+
+        // Pre-decrement.
+        constexpr soa_dynarr_iterator& operator--()
+        {
+            --_i;
+            return *this;
+        }
+
+        // Post-increment.
+        constexpr soa_dynarr_iterator operator++(int)
+        {
+            auto ret = *this;
+            ++_i;
+            return ret;
+        }
+
+        // Post-decrement.
+        constexpr soa_dynarr_iterator operator--(int)
+        {
+            auto ret = *this;
+            --_i;
+            return ret;
+        }
+
+        // Addition.
+        friend constexpr soa_dynarr_iterator operator+(
+            const soa_dynarr_iterator& lhs,
+            difference_type rhs)
+        {
+            return soa_dynarr_iterator(lhs._soa, _size_type(lhs._i + rhs));
+        }
+
+        // Addition.
+        friend constexpr soa_dynarr_iterator operator+(
+            difference_type lhs,
+            const soa_dynarr_iterator& rhs)
+        {
+            return rhs + lhs;
+        }
+
+        // Subtraction.
+        friend constexpr soa_dynarr_iterator operator-(
+            const soa_dynarr_iterator& lhs,
+            difference_type rhs)
+        {
+            return soa_dynarr_iterator(lhs._soa, _size_type(lhs._i - rhs));
+        }
+
+        // Subtraction.
+        friend constexpr difference_type operator-(
+            const soa_dynarr_iterator& lhs,
+            const soa_dynarr_iterator& rhs)
+        {
+            return difference_type(lhs._i) - difference_type(rhs._i);
+        }
+
+        // Addition assignment.
+        friend constexpr soa_dynarr_iterator& operator+=(
+            soa_dynarr_iterator& lhs,
+            difference_type rhs)
+        {
+            lhs._i = _size_type(lhs._i + rhs);
+            return lhs;
+        }
+
+        // Subtraction assignment.
+        friend constexpr soa_dynarr_iterator& operator-=(
+            soa_dynarr_iterator& lhs,
+            difference_type rhs)
+        {
+            lhs._i = _size_type(lhs._i - rhs);
+            return lhs;
+        }
+
+        // Equality.
+        friend constexpr bool operator==(
+            const soa_dynarr_iterator& lhs,
+            const soa_dynarr_iterator& rhs)
+        {
+            return lhs._i == rhs._i;
+        }
+
+        // Comparison.
+        friend constexpr std::strong_ordering operator<=>(
+            const soa_dynarr_iterator& lhs,
+            const soa_dynarr_iterator& rhs)
+        {
+            return lhs._i <=> rhs._i;
+        }
+
+    private:
+        // Friends.
+        template<typename, typename, typename> friend class gdt::soa_dynarr;
+        template<typename> friend class soa_dynarr_iterator;
+
+        // Member types.
+        using _size_type = typename Soa::size_type;
+
+        // Member variables.
+        Soa* _soa = nullptr;
+        _size_type _i = 0;
+
+        // Constructor.
+        constexpr soa_dynarr_iterator(Soa* soa, _size_type i)
+        :
+            _soa{soa},
+            _i{i}
+        {}
+    };
+}
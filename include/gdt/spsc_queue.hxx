@@ -0,0 +1,255 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt_detail/cache_line.hxx"
+#include "allocator.hxx"
+#include "assert.hxx"
+#include "assume.hxx"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace gdt
+{
+    // Single-producer single-consumer queue.
+    // Bounded lock-free ring buffer. One thread may push while another
+    // pops. Each side caches the other's index and only reloads it when
+    // the queue looks full or empty.
+    template<typename T, typename Allocator = allocator<T>>
+    class spsc_queue
+    {
+        static_assert(std::is_same_v<
+            typename std::allocator_traits<Allocator>::pointer, T*>);
+
+    public:
+        // Member types.
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = typename std::allocator_traits<Allocator>::size_type;
+
+        // Constructor.
+        // Rounds `capacity` up to a power of 2.
+        explicit spsc_queue(
+            size_type capacity,
+            const Allocator& allocator = Allocator())
+        :
+            _allocator{allocator},
+            _buffer{nullptr},
+            _mask{0}
+        {
+            gdt_assert(capacity > 0);
+            gdt_assert(capacity <= (std::allocator_traits<Allocator>::
+                max_size(_allocator) / 2));
+
+            auto n = size_type(std::bit_ceil(capacity));
+            _buffer = std::allocator_traits<Allocator>::allocate(_allocator, n);
+            _mask = size_type(n - 1);
+        }
+
+        // Constructor.
+        spsc_queue(const spsc_queue&) = delete;
+
+        // Destructor.
+        ~spsc_queue()
+        {
+            auto head = _consumer.head.load(std::memory_order_relaxed);
+            auto tail = _producer.tail.load(std::memory_order_relaxed);
+            for (; head != tail; ++head)
+            {
+                _destroy(_buffer + (head & _mask));
+            }
+
+            std::allocator_traits<Allocator>::deallocate(
+                _allocator, _buffer, capacity());
+        }
+
+        // Assignment.
+        spsc_queue& operator=(const spsc_queue&) = delete;
+
+        // Get allocator.
+        allocator_type get_allocator() const noexcept
+        {
+            return _allocator;
+        }
+
+        // Capacity.
+        size_type capacity() const noexcept
+        {
+            return size_type(_mask + 1);
+        }
+
+        // Size.
+        // Only a snapshot if the other thread is active.
+        size_type size() const noexcept
+        {
+            auto head = _consumer.head.load(std::memory_order_acquire);
+            auto tail = _producer.tail.load(std::memory_order_acquire);
+            return size_type(tail - head);
+        }
+
+        // Empty.
+        // Only a snapshot if the other thread is active.
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        // Try emplace.
+        // Producer only. Returns false if the queue is full.
+        template<typename... Args>
+        bool try_emplace(Args&&... args)
+        {
+            auto tail = _producer.tail.load(std::memory_order_relaxed);
+            if (_free(tail, 1) == 0)
+            {
+                return false;
+            }
+
+            _construct(_buffer + (tail & _mask), std::forward<Args>(args)...);
+            _producer.tail.store(size_type(tail + 1), std::memory_order_release);
+            return true;
+        }
+
+        // Try push.
+        // Producer only. Returns false if the queue is full.
+        bool try_push(const T& value)
+        {
+            return try_emplace(value);
+        }
+
+        // Try push.
+        bool try_push(T&& value)
+        {
+            return try_emplace(std::move(value));
+        }
+
+        // Try push batch.
+        // Producer only. Copies as many leading values as fit and
+        // publishes them together. Returns how many were pushed.
+        size_type try_push_batch(std::span<const T> values)
+        {
+            auto tail = _producer.tail.load(std::memory_order_relaxed);
+            auto n = size_type((std::min)(
+                std::size_t(_free(tail, values.size())), values.size()));
+
+            for (size_type i = 0; i < n; ++i)
+            {
+                _construct(_buffer + ((tail + i) & _mask), values[i]);
+            }
+
+            _producer.tail.store(size_type(tail + n), std::memory_order_release);
+            return n;
+        }
+
+        // Try pop.
+        // Consumer only. Moves the front value into `out`.
+        // Returns false if the queue is empty.
+        bool try_pop(T& out)
+        {
+            auto head = _consumer.head.load(std::memory_order_relaxed);
+            if (_used(head, 1) == 0)
+            {
+                return false;
+            }
+
+            auto p = _buffer + (head & _mask);
+            out = std::move(*p);
+            _destroy(p);
+            _consumer.head.store(size_type(head + 1), std::memory_order_release);
+            return true;
+        }
+
+        // Try pop batch.
+        // Consumer only. Moves up to `out.size()` values into `out` and
+        // frees their slots together. Returns how many were popped.
+        size_type try_pop_batch(std::span<T> out)
+        {
+            auto head = _consumer.head.load(std::memory_order_relaxed);
+            auto n = size_type((std::min)(
+                std::size_t(_used(head, out.size())), out.size()));
+
+            for (size_type i = 0; i < n; ++i)
+            {
+                auto p = _buffer + ((head + i) & _mask);
+                out[i] = std::move(*p);
+                _destroy(p);
+            }
+
+            _consumer.head.store(size_type(head + n), std::memory_order_release);
+            return n;
+        }
+
+    private:
+        // Producer's side.
+        // `head` is the consumer's index as of the last time it was full.
+        struct alignas(gdt_detail::cache_line_size) _producer_state
+        {
+            std::atomic<size_type> tail{0};
+            size_type head = 0;
+        };
+
+        // Consumer's side.
+        // `tail` is the producer's index as of the last time it was empty.
+        struct alignas(gdt_detail::cache_line_size) _consumer_state
+        {
+            std::atomic<size_type> head{0};
+            size_type tail = 0;
+        };
+
+        // Member variables.
+        [[no_unique_address]] Allocator _allocator;
+        T* _buffer;
+        size_type _mask;
+        _producer_state _producer;
+        _consumer_state _consumer;
+
+        // Free slots from the producer's point of view.
+        // Reloads the consumer's index if there are fewer than `wanted`.
+        size_type _free(size_type tail, std::size_t wanted) noexcept
+        {
+            auto free = size_type(capacity() - (tail - _producer.head));
+            if (free < wanted)
+            {
+                _producer.head = _consumer.head.load(std::memory_order_acquire);
+                free = size_type(capacity() - (tail - _producer.head));
+            }
+            return free;
+        }
+
+        // Used slots from the consumer's point of view.
+        // Reloads the producer's index if there are fewer than `wanted`.
+        size_type _used(size_type head, std::size_t wanted) noexcept
+        {
+            auto used = size_type(_consumer.tail - head);
+            if (used < wanted)
+            {
+                _consumer.tail = _producer.tail.load(std::memory_order_acquire);
+                used = size_type(_consumer.tail - head);
+            }
+            return used;
+        }
+
+        // Construct using allocator.
+        template<typename... Args>
+        void _construct(T* p, Args&&... args)
+        {
+            std::allocator_traits<Allocator>::construct(
+                _allocator, p, std::forward<Args>(args)...);
+        }
+
+        // Destroy using allocator.
+        void _destroy(T* p) noexcept
+        {
+            std::allocator_traits<Allocator>::destroy(_allocator, p);
+        }
+    };
+}
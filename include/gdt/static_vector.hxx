@@ -0,0 +1,855 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "assert.hxx"
+#include "assume.hxx"
+#include "trivially_relocatable.hxx"
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace gdt_detail
+{
+    // Smallest unsigned integer type that can represent `N`.
+    template<std::size_t N>
+    using uint_least_for =
+        std::conditional_t<N <= UINT8_MAX, std::uint8_t,
+        std::conditional_t<N <= UINT16_MAX, std::uint16_t,
+        std::conditional_t<N <= UINT32_MAX, std::uint32_t,
+        std::size_t>>>;
+
+    // Static vector storage.
+    // A union so elements can stay unconstructed until they're needed.
+    template<
+        typename T,
+        std::size_t N,
+        bool = std::is_trivially_destructible_v<T>>
+    union static_vector_storage
+    {
+        constexpr static_vector_storage() noexcept {}
+
+        T data[N];
+    };
+
+    // Static vector storage.
+    // Elements are destroyed by the owning static_vector.
+    template<typename T, std::size_t N>
+    union static_vector_storage<T, N, false>
+    {
+        constexpr static_vector_storage() noexcept {}
+        constexpr ~static_vector_storage() {}
+
+        T data[N];
+    };
+}
+
+namespace gdt
+{
+    // Static vector.
+    // A dynarr-like array with a fixed capacity of `N` elements
+    // stored inside the object itself. Never allocates. Lengths, counts
+    // and indices are passed as `std::size_t` so they get checked
+    // before they're narrowed to `size_type`.
+    template<typename T, std::size_t N>
+    class static_vector
+    {
+        static_assert(N > 0);
+
+    public:
+        // Member types.
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using size_type = gdt_detail::uint_least_for<N>;
+        using difference_type = std::ptrdiff_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    private:
+        // Member variables.
+        gdt_detail::static_vector_storage<T, N> _storage;
+        size_type _size;
+
+    public:
+        // Constructor.
+        constexpr static_vector() noexcept
+        :
+            _size{0}
+        {
+            // Trivial copies read every element, so they'd
+            // better all be initialized during constant evaluation.
+            if constexpr (std::is_trivially_default_constructible_v<T>)
+            {
+                if (std::is_constant_evaluated())
+                {
+                    for (auto& elem : _storage.data)
+                    {
+                        std::construct_at(std::addressof(elem));
+                    }
+                }
+            }
+        }
+
+        // Constructor.
+        explicit constexpr static_vector(std::size_t len)
+        :
+            static_vector()
+        {
+            resize(len);
+        }
+
+        // Constructor.
+        constexpr static_vector(std::size_t len, const T& fill_value)
+        :
+            static_vector()
+        {
+            resize(len, fill_value);
+        }
+
+        // Constructor.
+        template<
+            typename InputIterator>
+        requires std::is_base_of_v<
+            std::input_iterator_tag,
+            typename std::iterator_traits<InputIterator>::iterator_category>
+        constexpr static_vector(InputIterator first, InputIterator last)
+        :
+            static_vector()
+        {
+            _append(first, last);
+        }
+
+        // Constructor.
+        constexpr static_vector(const static_vector& other)
+        requires std::is_trivially_copy_constructible_v<T> = default;
+
+        // Constructor.
+        constexpr static_vector(const static_vector& other)
+        :
+            static_vector()
+        {
+            _append(other.begin(), other.end());
+        }
+
+        // Constructor.
+        constexpr static_vector(static_vector&& other)
+        requires std::is_trivially_move_constructible_v<T> = default;
+
+        // Constructor.
+        constexpr static_vector(static_vector&& other)
+        noexcept(std::is_nothrow_move_constructible_v<T>)
+        :
+            static_vector()
+        {
+            _append(
+                std::make_move_iterator(other.begin()),
+                std::make_move_iterator(other.end()));
+        }
+
+        // Constructor.
+        constexpr static_vector(std::initializer_list<T> il)
+        :
+            static_vector(il.begin(), il.end())
+        {}
+
+        // Destructor.
+        constexpr ~static_vector()
+        requires std::is_trivially_destructible_v<T> = default;
+
+        // Destructor.
+        constexpr ~static_vector()
+        {
+            _truncate(begin());
+        }
+
+        // Assignment.
+        constexpr static_vector& operator=(const static_vector& other)
+        requires
+            std::is_trivially_copy_assignable_v<T> &&
+            std::is_trivially_copy_constructible_v<T> &&
+            std::is_trivially_destructible_v<T> = default;
+
+        // Assignment.
+        constexpr static_vector& operator=(const static_vector& other)
+        {
+            if (this != &other)
+            {
+                assign(other.begin(), other.end());
+            }
+
+            return *this;
+        }
+
+        // Assignment.
+        constexpr static_vector& operator=(static_vector&& other)
+        requires
+            std::is_trivially_move_assignable_v<T> &&
+            std::is_trivially_move_constructible_v<T> &&
+            std::is_trivially_destructible_v<T> = default;
+
+        // Assignment.
+        constexpr static_vector& operator=(static_vector&& other)
+        noexcept(
+            std::is_nothrow_move_assignable_v<T> &&
+            std::is_nothrow_move_constructible_v<T>)
+        {
+            if (this != &other)
+            {
+                assign(
+                    std::make_move_iterator(other.begin()),
+                    std::make_move_iterator(other.end()));
+            }
+
+            return *this;
+        }
+
+        // Assignment.
+        constexpr static_vector& operator=(std::initializer_list<T> il)
+        {
+            assign(il);
+            return *this;
+        }
+
+        // Assign.
+        template<
+            typename InputIterator>
+        requires std::is_base_of_v<
+            std::input_iterator_tag,
+            typename std::iterator_traits<InputIterator>::iterator_category>
+        constexpr void assign(InputIterator first, InputIterator last)
+        {
+            auto itr = begin();
+            for (; itr != end() && first != last; ++itr, ++first)
+            {
+                *itr = *first;
+            }
+
+            _truncate(itr);
+            _append(first, last);
+        }
+
+        // Assign.
+        constexpr void assign(std::size_t tgt_len, const T& fill_value)
+        {
+            gdt_assert(tgt_len <= N);
+
+            auto n = std::min(std::size_t(_size), tgt_len);
+            std::fill(begin(), begin() + n, fill_value);
+            _truncate(begin() + n);
+            resize(tgt_len, fill_value);
+        }
+
+        // Assign.
+        constexpr void assign(std::initializer_list<T> il)
+        {
+            assign(il.begin(), il.end());
+        }
+
+        // Begin.
+        constexpr iterator begin() noexcept
+        {
+            return data();
+        }
+
+        // Begin.
+        constexpr const_iterator begin() const noexcept
+        {
+            return data();
+        }
+
+        // End.
+        constexpr iterator end() noexcept
+        {
+            return data() + _size;
+        }
+
+        // End.
+        constexpr const_iterator end() const noexcept
+        {
+            return data() + _size;
+        }
+
+        // Reverse begin.
+        constexpr reverse_iterator rbegin() noexcept
+        {
+            return reverse_iterator(end());
+        }
+
+        // Reverse begin.
+        constexpr const_reverse_iterator rbegin() const noexcept
+        {
+            return const_reverse_iterator(end());
+        }
+
+        // Reverse end.
+        constexpr reverse_iterator rend() noexcept
+        {
+            return reverse_iterator(begin());
+        }
+
+        // Reverse end.
+        constexpr const_reverse_iterator rend() const noexcept
+        {
+            return const_reverse_iterator(begin());
+        }
+
+        // Const begin.
+        constexpr const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        // Const end.
+        constexpr const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        // Const reverse begin.
+        constexpr const_reverse_iterator crbegin() const noexcept
+        {
+            return rbegin();
+        }
+
+        // Const reverse end.
+        constexpr const_reverse_iterator crend() const noexcept
+        {
+            return rend();
+        }
+
+        // Empty.
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        // Full.
+        constexpr bool full() const noexcept
+        {
+            return _size == N;
+        }
+
+        // Size.
+        constexpr size_type size() const noexcept
+        {
+            return _size;
+        }
+
+        // Max size.
+        static constexpr size_type max_size() noexcept
+        {
+            return size_type(N);
+        }
+
+        // Capacity.
+        static constexpr size_type capacity() noexcept
+        {
+            return size_type(N);
+        }
+
+        // Resize.
+        constexpr void resize(std::size_t tgt_len)
+        {
+            if (tgt_len <= _size)
+            {
+                _truncate(begin() + tgt_len);
+            }
+            else
+            {
+                gdt_assert(tgt_len <= N);
+                for (; _size < tgt_len; ++_size)
+                {
+                    std::construct_at(end());
+                }
+            }
+        }
+
+        // Resize.
+        constexpr void resize(std::size_t tgt_len, const T& fill_value)
+        {
+            if (tgt_len <= _size)
+            {
+                _truncate(begin() + tgt_len);
+            }
+            else
+            {
+                gdt_assert(tgt_len <= N);
+                for (; _size < tgt_len; ++_size)
+                {
+                    std::construct_at(end(), fill_value);
+                }
+            }
+        }
+
+        // Resize for overwrite.
+        // New elements are default-initialized, which leaves
+        // trivial types like `float` uninitialized.
+        constexpr void resize_for_overwrite(std::size_t tgt_len)
+        {
+            if (tgt_len <= _size)
+            {
+                _truncate(begin() + tgt_len);
+            }
+            else
+            {
+                append_uninitialized(tgt_len - _size);
+            }
+        }
+
+        // Append uninitialized.
+        // Default-initializes `n` new elements at the
+        // end and returns a pointer to the first one.
+        constexpr T* append_uninitialized(std::size_t n)
+        {
+            gdt_assert(n <= N - _size);
+
+            auto first = end();
+            if (std::is_constant_evaluated() ||
+                !std::is_trivially_default_constructible_v<T>)
+            {
+                for (std::size_t i = 0; i < n; ++i, ++_size)
+                {
+                    _default_init(end());
+                }
+            }
+            else
+            {
+                _size = size_type(_size + n);
+            }
+
+            return first;
+        }
+
+        // Reserve.
+        // Only checks that `req_capacity` fits.
+        constexpr void reserve(std::size_t req_capacity)
+        {
+            gdt_assert(req_capacity <= N);
+        }
+
+        // Shrink to fit.
+        // Does nothing.
+        constexpr void shrink_to_fit() noexcept
+        {
+        }
+
+        // Subscript.
+        constexpr reference operator[](std::size_t i)
+        {
+            gdt_assume(i < _size);
+            return data()[i];
+        }
+
+        // Subscript.
+        constexpr const_reference operator[](std::size_t i) const
+        {
+            gdt_assume(i < _size);
+            return data()[i];
+        }
+
+        // At.
+        constexpr const_reference at(std::size_t i) const
+        {
+            gdt_assert(i < _size);
+            return data()[i];
+        }
+
+        // At.
+        constexpr reference at(std::size_t i)
+        {
+            gdt_assert(i < _size);
+            return data()[i];
+        }
+
+        // Front.
+        constexpr reference front()
+        {
+            gdt_assume(!empty());
+            return data()[0];
+        }
+
+        // Front.
+        constexpr const_reference front() const
+        {
+            gdt_assume(!empty());
+            return data()[0];
+        }
+
+        // Back.
+        constexpr reference back()
+        {
+            gdt_assume(!empty());
+            return data()[_size - 1];
+        }
+
+        // Back.
+        constexpr const_reference back() const
+        {
+            gdt_assume(!empty());
+            return data()[_size - 1];
+        }
+
+        // Data.
+        constexpr T* data() noexcept
+        {
+            return _storage.data;
+        }
+
+        // Data.
+        constexpr const T* data() const noexcept
+        {
+            return _storage.data;
+        }
+
+        // Emplace back.
+        template<typename... Args>
+        constexpr reference emplace_back(Args&&... args)
+        {
+            gdt_assert(_size < N);
+
+            auto p = std::construct_at(end(), std::forward<Args>(args)...);
+            ++_size;
+            return *p;
+        }
+
+        // Push back.
+        constexpr void push_back(const T& value)
+        {
+            emplace_back(value);
+        }
+
+        // Push back.
+        constexpr void push_back(T&& value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        // Pop back.
+        constexpr void pop_back()
+        {
+            gdt_assume(!empty());
+            std::destroy_at(end() - 1);
+            --_size;
+        }
+
+        // Emplace.
+        template<typename... Args>
+        constexpr iterator emplace(const_iterator position, Args&&... args)
+        {
+            gdt_assume(position >= begin());
+            gdt_assume(position <= end());
+
+            auto pos = begin() + (position - cbegin());
+            emplace_back(std::forward<Args>(args)...);
+            _rotate_back(pos, end() - 1);
+            return pos;
+        }
+
+        // Insert.
+        constexpr iterator insert(const_iterator position, const T& value)
+        {
+            return emplace(position, value);
+        }
+
+        // Insert.
+        constexpr iterator insert(const_iterator position, T&& value)
+        {
+            return emplace(position, std::move(value));
+        }
+
+        // Insert.
+        constexpr iterator insert(
+            const_iterator position,
+            std::size_t fill_len,
+            const T& fill_value)
+        {
+            gdt_assume(position >= begin());
+            gdt_assume(position <= end());
+            gdt_assert(fill_len <= N - _size);
+
+            auto pos = begin() + (position - cbegin());
+            auto old_end = end();
+            for (std::size_t i = 0; i < fill_len; ++i, ++_size)
+            {
+                std::construct_at(end(), fill_value);
+            }
+
+            _rotate_back(pos, old_end);
+            return pos;
+        }
+
+        // Insert.
+        template<
+            typename InputIterator>
+        requires std::is_base_of_v<
+            std::input_iterator_tag,
+            typename std::iterator_traits<InputIterator>::iterator_category>
+        constexpr iterator insert(
+            const_iterator position,
+            InputIterator first,
+            InputIterator last)
+        {
+            gdt_assume(position >= begin());
+            gdt_assume(position <= end());
+
+            auto pos = begin() + (position - cbegin());
+            auto old_end = end();
+            _append(first, last);
+            _rotate_back(pos, old_end);
+            return pos;
+        }
+
+        // Insert.
+        constexpr iterator insert(
+            const_iterator position,
+            std::initializer_list<T> il)
+        {
+            return insert(position, il.begin(), il.end());
+        }
+
+        // Erase.
+        constexpr iterator erase(const_iterator position)
+        {
+            gdt_assume(position >= begin());
+            gdt_assume(position < end());
+
+            return erase(position, position + 1);
+        }
+
+        // Erase.
+        constexpr iterator erase(const_iterator first, const_iterator last)
+        {
+            gdt_assume(first >= begin());
+            gdt_assume(first <= last);
+            gdt_assume(last <= end());
+
+            auto dst = begin() + (first - cbegin());
+            auto src = begin() + (last - cbegin());
+            if (dst != src)
+            {
+                if (_can_memcpy())
+                {
+                    auto n = std::size_t(last - first);
+                    auto tail = std::size_t(end() - src);
+                    _destroy(dst, src);
+                    std::memmove(
+                        static_cast<void*>(dst),
+                        static_cast<const void*>(src),
+                        sizeof(T) * tail);
+                    _size = size_type(_size - n);
+                }
+                else
+                {
+                    _truncate(std::move(src, end(), dst));
+                }
+            }
+
+            return dst;
+        }
+
+        // Swap remove.
+        // Erases the element at `position` by moving the last element
+        // into its place. Doesn't preserve order, but is O(1).
+        constexpr iterator swap_remove(const_iterator position)
+        {
+            gdt_assume(position >= begin());
+            gdt_assume(position < end());
+
+            auto pos = begin() + (position - cbegin());
+            auto last = end() - 1;
+            if (pos != last)
+            {
+                *pos = std::move(*last);
+            }
+
+            pop_back();
+            return pos;
+        }
+
+        // Swap.
+        constexpr void swap(static_vector& other)
+        {
+            if (_size > other._size)
+            {
+                other.swap(*this);
+                return;
+            }
+
+            std::swap_ranges(begin(), end(), other.begin());
+
+            auto old_size = _size;
+            _append(
+                std::make_move_iterator(other.begin() + old_size),
+                std::make_move_iterator(other.end()));
+            other._truncate(other.begin() + old_size);
+        }
+
+        // Swap.
+        friend constexpr void swap(static_vector& lhs, static_vector& rhs)
+        {
+            lhs.swap(rhs);
+        }
+
+        // Clear.
+        constexpr void clear() noexcept
+        {
+            _truncate(begin());
+        }
+
+        // Equality.
+        friend constexpr bool operator==(
+            const static_vector& lhs,
+            const static_vector& rhs)
+        {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+
+        // Comparison.
+        template<typename U = T>
+        friend constexpr auto operator<=>(
+            const static_vector& lhs,
+            const static_vector& rhs)
+        -> decltype(std::declval<const U&>() <=> std::declval<const U&>())
+        {
+            return std::lexicographical_compare_three_way(
+                lhs.begin(), lhs.end(),
+                rhs.begin(), rhs.end());
+        }
+
+    private:
+        // Elements can be moved around with memmove.
+        constexpr bool _can_memcpy() const noexcept
+        {
+            return
+                is_trivially_relocatable_v<T> &&
+                !std::is_constant_evaluated();
+        }
+
+        // Default-initialize `*p`.
+        // Value-initializes during constant evaluation instead,
+        // since constant expressions can't leave things uninitialized.
+        static constexpr void _default_init(T* p)
+        {
+            if (std::is_constant_evaluated())
+            {
+                std::construct_at(p);
+            }
+            else
+            {
+                ::new (static_cast<void*>(p)) T;
+            }
+        }
+
+        // Destroy [first, last) without changing the size.
+        constexpr void _destroy(iterator first, iterator last) noexcept
+        {
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                std::destroy(first, last);
+            }
+        }
+
+        // Destroy everything from `new_end` on.
+        constexpr void _truncate(iterator new_end) noexcept
+        {
+            gdt_assume(new_end >= begin());
+            gdt_assume(new_end <= end());
+
+            _destroy(new_end, end());
+            _size = size_type(new_end - begin());
+        }
+
+        // Append [first, last) to the end.
+        template<typename InputIterator>
+        constexpr void _append(InputIterator first, InputIterator last)
+        {
+            if constexpr (std::is_base_of_v<
+                std::forward_iterator_tag,
+                typename std::iterator_traits<InputIterator>::
+                    iterator_category>)
+            {
+                auto n = std::size_t(std::distance(first, last));
+                gdt_assert(n <= std::size_t(N - _size));
+            }
+
+            for (; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+        }
+
+        // Rotate [middle, end) in front of [pos, middle).
+        constexpr void _rotate_back(iterator pos, iterator middle)
+        {
+            if (pos == middle || middle == end())
+            {
+                return;
+            }
+
+            if (_can_memcpy() && middle + 1 == end())
+            {
+                // Relocate the single new element
+                // through a buffer instead of rotating.
+                alignas(T) unsigned char tmp[sizeof(T)];
+                std::memcpy(tmp, static_cast<const void*>(middle), sizeof(T));
+                std::memmove(
+                    static_cast<void*>(pos + 1),
+                    static_cast<const void*>(pos),
+                    sizeof(T) * std::size_t(middle - pos));
+                std::memcpy(static_cast<void*>(pos), tmp, sizeof(T));
+            }
+            else
+            {
+                std::rotate(pos, middle, end());
+            }
+        }
+    };
+
+    // Erase.
+    template<typename T, std::size_t N, typename U>
+    constexpr typename static_vector<T, N>::size_type
+    erase(static_vector<T, N>& a, const U& value)
+    {
+        auto old_end = a.end();
+        auto new_end = std::remove(a.begin(), old_end, value);
+        using size_type = typename static_vector<T, N>::size_type;
+        auto count = size_type(old_end - new_end);
+        a.erase(new_end, old_end);
+        return count;
+    }
+
+    // Erase if.
+    template<typename T, std::size_t N, typename Pred>
+    constexpr typename static_vector<T, N>::size_type
+    erase_if(static_vector<T, N>& a, Pred&& pred)
+    {
+        auto beg = a.begin();
+        auto old_end = a.end();
+        auto new_end = std::remove_if(beg, old_end, std::forward<Pred>(pred));
+        using size_type = typename static_vector<T, N>::size_type;
+        auto count = size_type(old_end - new_end);
+        a.erase(new_end, old_end);
+        return count;
+    }
+
+    // Static vectors are as relocatable as their elements.
+    template<typename T, std::size_t N>
+    struct is_trivially_relocatable<static_vector<T, N>> :
+        is_trivially_relocatable<T> {};
+}
@@ -0,0 +1,369 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "allocator.hxx"
+#include "trivially_relocatable.hxx"
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace gdt
+{
+    // Allocation statistics.
+    // Counters are updated with relaxed atomics, so they're cheap and
+    // safe to read from any thread, but only eventually consistent.
+    class allocation_stats
+    {
+    public:
+        // Number of size histogram buckets.
+        static constexpr std::size_t histogram_buckets =
+            std::numeric_limits<std::size_t>::digits + 1;
+
+        // Constructor.
+        constexpr allocation_stats() noexcept = default;
+
+        // Constructor.
+        allocation_stats(const allocation_stats&) = delete;
+
+        // Assignment.
+        allocation_stats& operator=(const allocation_stats&) = delete;
+
+        // Histogram bucket for an allocation of `size` bytes.
+        // Bucket `i` counts sizes in [2^(i-1), 2^i); bucket 0 counts 0.
+        static constexpr std::size_t bucket_for(std::size_t size) noexcept
+        {
+            return std::size_t(std::bit_width(size));
+        }
+
+        // Bytes currently allocated.
+        std::size_t live_bytes() const noexcept
+        {
+            return _live_bytes.load(std::memory_order_relaxed);
+        }
+
+        // Most bytes allocated at once.
+        std::size_t peak_bytes() const noexcept
+        {
+            return _peak_bytes.load(std::memory_order_relaxed);
+        }
+
+        // Number of allocations.
+        std::size_t allocations() const noexcept
+        {
+            return _allocations.load(std::memory_order_relaxed);
+        }
+
+        // Number of deallocations.
+        std::size_t deallocations() const noexcept
+        {
+            return _deallocations.load(std::memory_order_relaxed);
+        }
+
+        // Number of reallocations (via `reallocate`).
+        std::size_t reallocations() const noexcept
+        {
+            return _reallocations.load(std::memory_order_relaxed);
+        }
+
+        // Number of in-place resizes (via `try_expand`).
+        std::size_t expansions() const noexcept
+        {
+            return _expansions.load(std::memory_order_relaxed);
+        }
+
+        // Number of allocations in histogram bucket `i`.
+        std::size_t histogram(std::size_t i) const noexcept
+        {
+            return _histogram[i].load(std::memory_order_relaxed);
+        }
+
+        // Record an allocation.
+        void record_allocate(std::size_t size) noexcept
+        {
+            _allocations.fetch_add(1, std::memory_order_relaxed);
+            _histogram[bucket_for(size)].fetch_add(
+                1, std::memory_order_relaxed);
+            _grow(size);
+        }
+
+        // Record a deallocation.
+        void record_deallocate(std::size_t size) noexcept
+        {
+            _deallocations.fetch_add(1, std::memory_order_relaxed);
+            _live_bytes.fetch_sub(size, std::memory_order_relaxed);
+        }
+
+        // Record a reallocation.
+        void record_reallocate(std::size_t old_size, std::size_t new_size)
+        noexcept
+        {
+            _reallocations.fetch_add(1, std::memory_order_relaxed);
+            _histogram[bucket_for(new_size)].fetch_add(
+                1, std::memory_order_relaxed);
+            _resize(old_size, new_size);
+        }
+
+        // Record an in-place resize.
+        void record_expand(std::size_t old_size, std::size_t new_size)
+        noexcept
+        {
+            _expansions.fetch_add(1, std::memory_order_relaxed);
+            _resize(old_size, new_size);
+        }
+
+        // Reset everything but live bytes, and
+        // start the peak over from live bytes.
+        void reset() noexcept
+        {
+            _peak_bytes.store(live_bytes(), std::memory_order_relaxed);
+            _allocations.store(0, std::memory_order_relaxed);
+            _deallocations.store(0, std::memory_order_relaxed);
+            _reallocations.store(0, std::memory_order_relaxed);
+            _expansions.store(0, std::memory_order_relaxed);
+            for (auto& count : _histogram)
+            {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        // Member variables.
+        std::atomic<std::size_t> _live_bytes{0};
+        std::atomic<std::size_t> _peak_bytes{0};
+        std::atomic<std::size_t> _allocations{0};
+        std::atomic<std::size_t> _deallocations{0};
+        std::atomic<std::size_t> _reallocations{0};
+        std::atomic<std::size_t> _expansions{0};
+        std::atomic<std::size_t> _histogram[histogram_buckets]{};
+
+        // Add `size` live bytes and update the peak.
+        void _grow(std::size_t size) noexcept
+        {
+            auto live = _live_bytes.fetch_add(
+                size, std::memory_order_relaxed) + size;
+            auto peak = _peak_bytes.load(std::memory_order_relaxed);
+            while (live > peak && !_peak_bytes.compare_exchange_weak(
+                peak, live, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        // Change live bytes from `old_size` to `new_size`.
+        void _resize(std::size_t old_size, std::size_t new_size) noexcept
+        {
+            if (new_size >= old_size)
+            {
+                _grow(new_size - old_size);
+            }
+            else
+            {
+                _live_bytes.fetch_sub(
+                    old_size - new_size, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Allocation statistics for `Tag`.
+    template<typename Tag>
+    allocation_stats& allocation_stats_for() noexcept
+    {
+        static constinit allocation_stats stats;
+        return stats;
+    }
+
+    // Tracking allocator.
+    // Wraps `Inner`, recording what it does in `allocation_stats_for<Tag>`.
+    template<typename Inner, typename Tag = void>
+    class tracking_allocator
+    {
+        // Member types.
+        using _traits = std::allocator_traits<Inner>;
+
+    public:
+        // Member types.
+        using value_type = typename _traits::value_type;
+        using pointer = typename _traits::pointer;
+        using const_pointer = typename _traits::const_pointer;
+        using void_pointer = typename _traits::void_pointer;
+        using const_void_pointer = typename _traits::const_void_pointer;
+        using size_type = typename _traits::size_type;
+        using difference_type = typename _traits::difference_type;
+        using propagate_on_container_copy_assignment =
+            typename _traits::propagate_on_container_copy_assignment;
+        using propagate_on_container_move_assignment =
+            typename _traits::propagate_on_container_move_assignment;
+        using propagate_on_container_swap =
+            typename _traits::propagate_on_container_swap;
+        using is_always_equal = typename _traits::is_always_equal;
+
+        // Rebind.
+        template<typename U>
+        struct rebind
+        {
+            using other = tracking_allocator<
+                typename _traits::template rebind_alloc<U>, Tag>;
+        };
+
+        // Constructor.
+        constexpr tracking_allocator()
+        noexcept(std::is_nothrow_default_constructible_v<Inner>)
+        requires std::is_default_constructible_v<Inner> = default;
+
+        // Constructor.
+        constexpr tracking_allocator(const Inner& inner) noexcept
+        :
+            _inner(inner)
+        {}
+
+        // Constructor.
+        template<typename U>
+        constexpr tracking_allocator(const tracking_allocator<U, Tag>& other)
+        noexcept
+        :
+            _inner(other.inner())
+        {}
+
+        // Inner allocator.
+        constexpr const Inner& inner() const noexcept
+        {
+            return _inner;
+        }
+
+        // Statistics.
+        static allocation_stats& stats() noexcept
+        {
+            return allocation_stats_for<Tag>();
+        }
+
+        // Max size.
+        constexpr size_type max_size() const noexcept
+        {
+            return _traits::max_size(_inner);
+        }
+
+        // Allocate.
+        [[nodiscard]] constexpr pointer allocate(size_type n)
+        {
+            auto p = _traits::allocate(_inner, n);
+            if (!std::is_constant_evaluated())
+            {
+                stats().record_allocate(_bytes(n));
+            }
+
+            return p;
+        }
+
+        // Allocate at least.
+        [[nodiscard]] constexpr allocation_result<pointer, size_type>
+        allocate_at_least(size_type n)
+        requires gdt_detail::has_allocate_at_least<Inner>
+        {
+            auto r = _inner.allocate_at_least(n);
+            if (!std::is_constant_evaluated())
+            {
+                stats().record_allocate(_bytes(size_type(r.count)));
+            }
+
+            return {r.ptr, size_type(r.count)};
+        }
+
+        // Deallocate.
+        constexpr void deallocate(pointer p, size_type n)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                stats().record_deallocate(_bytes(n));
+            }
+
+            _traits::deallocate(_inner, p, n);
+        }
+
+        // Try expand.
+        bool try_expand(pointer p, size_type old_n, size_type new_n)
+        requires gdt_detail::has_try_expand<Inner>
+        {
+            if (!_inner.try_expand(p, old_n, new_n))
+            {
+                return false;
+            }
+
+            stats().record_expand(_bytes(old_n), _bytes(new_n));
+            return true;
+        }
+
+        // Reallocate.
+        [[nodiscard]] pointer reallocate(
+            pointer p,
+            size_type old_n,
+            size_type new_n)
+        requires gdt_detail::has_reallocate<Inner>
+        {
+            auto new_p = _inner.reallocate(p, old_n, new_n);
+            stats().record_reallocate(_bytes(old_n), _bytes(new_n));
+            return new_p;
+        }
+
+        // Construct.
+        template<typename U, typename... Args>
+        constexpr void construct(U* p, Args&&... args)
+        requires requires (Inner& a)
+        {
+            a.construct(p, std::forward<Args>(args)...);
+        }
+        {
+            _inner.construct(p, std::forward<Args>(args)...);
+        }
+
+        // Destroy.
+        template<typename U>
+        constexpr void destroy(U* p)
+        requires requires (Inner& a)
+        {
+            a.destroy(p);
+        }
+        {
+            _inner.destroy(p);
+        }
+
+        // Select on container copy construction.
+        constexpr tracking_allocator select_on_container_copy_construction()
+        const
+        {
+            return tracking_allocator(
+                _traits::select_on_container_copy_construction(_inner));
+        }
+
+        // Equality.
+        template<typename U>
+        friend constexpr bool operator==(
+            const tracking_allocator& lhs,
+            const tracking_allocator<U, Tag>& rhs)
+        noexcept
+        {
+            return lhs.inner() == rhs.inner();
+        }
+
+    private:
+        // Member variables.
+        [[no_unique_address]] Inner _inner;
+
+        // Size of `n` elements in bytes.
+        static constexpr std::size_t _bytes(size_type n) noexcept
+        {
+            return sizeof(value_type) * std::size_t(n);
+        }
+    };
+
+    // Tracking allocators are as relocatable as what they wrap.
+    template<typename Inner, typename Tag>
+    struct is_trivially_relocatable<tracking_allocator<Inner, Tag>> :
+        is_trivially_relocatable<Inner> {};
+}
@@ -0,0 +1,22 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include <type_traits>
+
+namespace gdt
+{
+    // Is trivially relocatable.
+    // Specialize for types that can be moved to a new address with memcpy
+    // without calling the move constructor or the old object's destructor.
+    template<typename T>
+    struct is_trivially_relocatable :
+        std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+    template<typename T>
+    constexpr bool is_trivially_relocatable_v =
+        is_trivially_relocatable<T>::value;
+}
@@ -6,10 +6,15 @@
 #pragma once
 
 #include "assume.hxx"
+#include "../gdt_detail/vec_simd.hxx"
+#include <bit>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 namespace gdt
 {
@@ -33,13 +38,323 @@ namespace gdt_detail
 
     template<typename T>
     constexpr bool is_vec_v = is_vec<T>::value;
+
+    // No index appears twice in `I...`.
+    template<std::size_t... I>
+    consteval bool are_distinct()
+    {
+        std::size_t indices[] = {I...};
+        for (std::size_t i = 0; i < sizeof...(I); ++i)
+        {
+            for (std::size_t j = 0; j < i; ++j)
+            {
+                if (indices[i] == indices[j])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Position of `J` in `I...`, or `sizeof...(I)` if it's missing.
+    template<std::size_t J, std::size_t... I>
+    consteval std::size_t index_of()
+    {
+        std::size_t indices[] = {I...};
+        std::size_t i = 0;
+        while (i < sizeof...(I) && indices[i] != J)
+        {
+            ++i;
+        }
+        return i;
+    }
+
+    // Named swizzles of `vec<T, N>`, like `zxy()` and `set_zx(v)`.
+    // Thin wrappers around `swizzle` and `set_swizzle`. Layer `C` declares
+    // the ones whose highest component index is `C - 1` and derives from
+    // layer `C - 1`, so each is declared once and vectors only get the
+    // names of components they have.
+    template<typename T, std::size_t N, std::size_t C = (N < 4 ? N : 4)>
+    struct vec_swizzles : vec_swizzles<T, N, C - 1> {};
+
+    template<typename T, std::size_t N>
+    struct vec_swizzles<T, N, 0> {};
+
+    // Larger of component indices `I` and `J`.
+    #define gdt_max_00 0
+    #define gdt_max_01 1
+    #define gdt_max_02 2
+    #define gdt_max_03 3
+    #define gdt_max_10 1
+    #define gdt_max_11 1
+    #define gdt_max_12 2
+    #define gdt_max_13 3
+    #define gdt_max_20 2
+    #define gdt_max_21 2
+    #define gdt_max_22 2
+    #define gdt_max_23 3
+    #define gdt_max_30 3
+    #define gdt_max_31 3
+    #define gdt_max_32 3
+    #define gdt_max_33 3
+    #define gdt_max_(I, J) gdt_max_##I##J
+    #define gdt_max(I, J) gdt_max_(I, J)
+
+    // Keep a declaration in layer `C + 1` if its highest index is `I`.
+    #define gdt_if_00(...) __VA_ARGS__
+    #define gdt_if_01(...)
+    #define gdt_if_02(...)
+    #define gdt_if_03(...)
+    #define gdt_if_10(...)
+    #define gdt_if_11(...) __VA_ARGS__
+    #define gdt_if_12(...)
+    #define gdt_if_13(...)
+    #define gdt_if_20(...)
+    #define gdt_if_21(...)
+    #define gdt_if_22(...) __VA_ARGS__
+    #define gdt_if_23(...)
+    #define gdt_if_30(...)
+    #define gdt_if_31(...)
+    #define gdt_if_32(...)
+    #define gdt_if_33(...) __VA_ARGS__
+    #define gdt_if_(C, I) gdt_if_##C##I
+    #define gdt_if(C, I) gdt_if_(C, I)
+
+    // 2-component getter.
+    #define gdt_get_2(C, i, I, j, J)\
+    gdt_if(C, gdt_max(I, J))(\
+    constexpr auto i##j() const\
+    {\
+        return static_cast<const vec<T, N>&>(*this).template\
+            swizzle<I, J>();\
+    })
+
+    // 3-component getter.
+    #define gdt_get_3(C, i, I, j, J, k, K)\
+    gdt_if(C, gdt_max(gdt_max(I, J), K))(\
+    constexpr auto i##j##k() const\
+    {\
+        return static_cast<const vec<T, N>&>(*this).template\
+            swizzle<I, J, K>();\
+    })
+
+    // 4-component getter.
+    #define gdt_get_4(C, i, I, j, J, k, K, l, L)\
+    gdt_if(C, gdt_max(gdt_max(gdt_max(I, J), K), L))(\
+    constexpr auto i##j##k##l() const\
+    {\
+        return static_cast<const vec<T, N>&>(*this).template\
+            swizzle<I, J, K, L>();\
+    })
+
+    // 2-component setter.
+    #define gdt_set_2(C, i, I, j, J)\
+    gdt_if(C, gdt_max(I, J))(\
+    constexpr void set_##i##j(const vec2<T>& v)\
+    {\
+        static_cast<vec<T, N>&>(*this).template\
+            set_swizzle<I, J>(v);\
+    })
+
+    // 3-component setter.
+    #define gdt_set_3(C, i, I, j, J, k, K)\
+    gdt_if(C, gdt_max(gdt_max(I, J), K))(\
+    constexpr void set_##i##j##k(const vec3<T>& v)\
+    {\
+        static_cast<vec<T, N>&>(*this).template\
+            set_swizzle<I, J, K>(v);\
+    })
+
+    // 4-component setter.
+    #define gdt_set_4(C, i, I, j, J, k, K, l, L)\
+    gdt_if(C, gdt_max(gdt_max(gdt_max(I, J), K), L))(\
+    constexpr void set_##i##j##k##l(const vec4<T>& v)\
+    {\
+        static_cast<vec<T, N>&>(*this).template\
+            set_swizzle<I, J, K, L>(v);\
+    })
+
+    // Getters of components named `x`, `y`, `z`, and `w`.
+    #define gdt_get_2_j(C, i, I, x, y, z, w)\
+    gdt_get_2(C, i, I, x, 0)\
+    gdt_get_2(C, i, I, y, 1)\
+    gdt_get_2(C, i, I, z, 2)\
+    gdt_get_2(C, i, I, w, 3)
+    #define gdt_get_3_k(C, i, I, j, J, x, y, z, w)\
+    gdt_get_3(C, i, I, j, J, x, 0)\
+    gdt_get_3(C, i, I, j, J, y, 1)\
+    gdt_get_3(C, i, I, j, J, z, 2)\
+    gdt_get_3(C, i, I, j, J, w, 3)
+    #define gdt_get_3_j(C, i, I, x, y, z, w)\
+    gdt_get_3_k(C, i, I, x, 0, x, y, z, w)\
+    gdt_get_3_k(C, i, I, y, 1, x, y, z, w)\
+    gdt_get_3_k(C, i, I, z, 2, x, y, z, w)\
+    gdt_get_3_k(C, i, I, w, 3, x, y, z, w)
+    #define gdt_get_4_l(C, i, I, j, J, k, K, x, y, z, w)\
+    gdt_get_4(C, i, I, j, J, k, K, x, 0)\
+    gdt_get_4(C, i, I, j, J, k, K, y, 1)\
+    gdt_get_4(C, i, I, j, J, k, K, z, 2)\
+    gdt_get_4(C, i, I, j, J, k, K, w, 3)
+    #define gdt_get_4_k(C, i, I, j, J, x, y, z, w)\
+    gdt_get_4_l(C, i, I, j, J, x, 0, x, y, z, w)\
+    gdt_get_4_l(C, i, I, j, J, y, 1, x, y, z, w)\
+    gdt_get_4_l(C, i, I, j, J, z, 2, x, y, z, w)\
+    gdt_get_4_l(C, i, I, j, J, w, 3, x, y, z, w)
+    #define gdt_get_4_j(C, i, I, x, y, z, w)\
+    gdt_get_4_k(C, i, I, x, 0, x, y, z, w)\
+    gdt_get_4_k(C, i, I, y, 1, x, y, z, w)\
+    gdt_get_4_k(C, i, I, z, 2, x, y, z, w)\
+    gdt_get_4_k(C, i, I, w, 3, x, y, z, w)
+    #define gdt_getters(C, x, y, z, w)\
+    gdt_get_2_j(C, x, 0, x, y, z, w)\
+    gdt_get_3_j(C, x, 0, x, y, z, w)\
+    gdt_get_4_j(C, x, 0, x, y, z, w)\
+    gdt_get_2_j(C, y, 1, x, y, z, w)\
+    gdt_get_3_j(C, y, 1, x, y, z, w)\
+    gdt_get_4_j(C, y, 1, x, y, z, w)\
+    gdt_get_2_j(C, z, 2, x, y, z, w)\
+    gdt_get_3_j(C, z, 2, x, y, z, w)\
+    gdt_get_4_j(C, z, 2, x, y, z, w)\
+    gdt_get_2_j(C, w, 3, x, y, z, w)\
+    gdt_get_3_j(C, w, 3, x, y, z, w)\
+    gdt_get_4_j(C, w, 3, x, y, z, w)
+
+    // Setters of distinct components named `x`, `y`, `z`, and `w`.
+    #define gdt_setters(C, x, y, z, w)\
+    gdt_set_2(C, x, 0, y, 1)\
+    gdt_set_2(C, x, 0, z, 2)\
+    gdt_set_2(C, x, 0, w, 3)\
+    gdt_set_2(C, y, 1, x, 0)\
+    gdt_set_2(C, y, 1, z, 2)\
+    gdt_set_2(C, y, 1, w, 3)\
+    gdt_set_2(C, z, 2, x, 0)\
+    gdt_set_2(C, z, 2, y, 1)\
+    gdt_set_2(C, z, 2, w, 3)\
+    gdt_set_2(C, w, 3, x, 0)\
+    gdt_set_2(C, w, 3, y, 1)\
+    gdt_set_2(C, w, 3, z, 2)\
+    gdt_set_3(C, x, 0, y, 1, z, 2)\
+    gdt_set_3(C, x, 0, y, 1, w, 3)\
+    gdt_set_3(C, x, 0, z, 2, y, 1)\
+    gdt_set_3(C, x, 0, z, 2, w, 3)\
+    gdt_set_3(C, x, 0, w, 3, y, 1)\
+    gdt_set_3(C, x, 0, w, 3, z, 2)\
+    gdt_set_3(C, y, 1, x, 0, z, 2)\
+    gdt_set_3(C, y, 1, x, 0, w, 3)\
+    gdt_set_3(C, y, 1, z, 2, x, 0)\
+    gdt_set_3(C, y, 1, z, 2, w, 3)\
+    gdt_set_3(C, y, 1, w, 3, x, 0)\
+    gdt_set_3(C, y, 1, w, 3, z, 2)\
+    gdt_set_3(C, z, 2, x, 0, y, 1)\
+    gdt_set_3(C, z, 2, x, 0, w, 3)\
+    gdt_set_3(C, z, 2, y, 1, x, 0)\
+    gdt_set_3(C, z, 2, y, 1, w, 3)\
+    gdt_set_3(C, z, 2, w, 3, x, 0)\
+    gdt_set_3(C, z, 2, w, 3, y, 1)\
+    gdt_set_3(C, w, 3, x, 0, y, 1)\
+    gdt_set_3(C, w, 3, x, 0, z, 2)\
+    gdt_set_3(C, w, 3, y, 1, x, 0)\
+    gdt_set_3(C, w, 3, y, 1, z, 2)\
+    gdt_set_3(C, w, 3, z, 2, x, 0)\
+    gdt_set_3(C, w, 3, z, 2, y, 1)\
+    gdt_set_4(C, x, 0, y, 1, z, 2, w, 3)\
+    gdt_set_4(C, x, 0, y, 1, w, 3, z, 2)\
+    gdt_set_4(C, x, 0, z, 2, y, 1, w, 3)\
+    gdt_set_4(C, x, 0, z, 2, w, 3, y, 1)\
+    gdt_set_4(C, x, 0, w, 3, y, 1, z, 2)\
+    gdt_set_4(C, x, 0, w, 3, z, 2, y, 1)\
+    gdt_set_4(C, y, 1, x, 0, z, 2, w, 3)\
+    gdt_set_4(C, y, 1, x, 0, w, 3, z, 2)\
+    gdt_set_4(C, y, 1, z, 2, x, 0, w, 3)\
+    gdt_set_4(C, y, 1, z, 2, w, 3, x, 0)\
+    gdt_set_4(C, y, 1, w, 3, x, 0, z, 2)\
+    gdt_set_4(C, y, 1, w, 3, z, 2, x, 0)\
+    gdt_set_4(C, z, 2, x, 0, y, 1, w, 3)\
+    gdt_set_4(C, z, 2, x, 0, w, 3, y, 1)\
+    gdt_set_4(C, z, 2, y, 1, x, 0, w, 3)\
+    gdt_set_4(C, z, 2, y, 1, w, 3, x, 0)\
+    gdt_set_4(C, z, 2, w, 3, x, 0, y, 1)\
+    gdt_set_4(C, z, 2, w, 3, y, 1, x, 0)\
+    gdt_set_4(C, w, 3, x, 0, y, 1, z, 2)\
+    gdt_set_4(C, w, 3, x, 0, z, 2, y, 1)\
+    gdt_set_4(C, w, 3, y, 1, x, 0, z, 2)\
+    gdt_set_4(C, w, 3, y, 1, z, 2, x, 0)\
+    gdt_set_4(C, w, 3, z, 2, x, 0, y, 1)\
+    gdt_set_4(C, w, 3, z, 2, y, 1, x, 0)
+
+    // Layer of names whose highest component index is `C`.
+    #define gdt(C)\
+    template<typename T, std::size_t N>\
+    struct vec_swizzles<T, N, C + 1> : vec_swizzles<T, N, C>\
+    {\
+        gdt_getters(C, x, y, z, w)\
+        gdt_getters(C, r, g, b, a)\
+        gdt_setters(C, x, y, z, w)\
+        gdt_setters(C, r, g, b, a)\
+    };
+    gdt(0)
+    gdt(1)
+    gdt(2)
+    gdt(3)
+    #undef gdt
+    #undef gdt_setters
+    #undef gdt_getters
+    #undef gdt_get_4_j
+    #undef gdt_get_4_k
+    #undef gdt_get_4_l
+    #undef gdt_get_3_j
+    #undef gdt_get_3_k
+    #undef gdt_get_2_j
+    #undef gdt_set_4
+    #undef gdt_set_3
+    #undef gdt_set_2
+    #undef gdt_get_4
+    #undef gdt_get_3
+    #undef gdt_get_2
+    #undef gdt_if
+    #undef gdt_if_
+    #undef gdt_if_00
+    #undef gdt_if_01
+    #undef gdt_if_02
+    #undef gdt_if_03
+    #undef gdt_if_10
+    #undef gdt_if_11
+    #undef gdt_if_12
+    #undef gdt_if_13
+    #undef gdt_if_20
+    #undef gdt_if_21
+    #undef gdt_if_22
+    #undef gdt_if_23
+    #undef gdt_if_30
+    #undef gdt_if_31
+    #undef gdt_if_32
+    #undef gdt_if_33
+    #undef gdt_max
+    #undef gdt_max_
+    #undef gdt_max_00
+    #undef gdt_max_01
+    #undef gdt_max_02
+    #undef gdt_max_03
+    #undef gdt_max_10
+    #undef gdt_max_11
+    #undef gdt_max_12
+    #undef gdt_max_13
+    #undef gdt_max_20
+    #undef gdt_max_21
+    #undef gdt_max_22
+    #undef gdt_max_23
+    #undef gdt_max_30
+    #undef gdt_max_31
+    #undef gdt_max_32
+    #undef gdt_max_33
 }
 
 namespace gdt
 {
     // Vector.
     template<typename T, std::size_t N>
-    struct vec
+    struct vec : gdt_detail::vec_swizzles<T, N>
     {
         // Disallow vectors of vectors.
         static_assert(!gdt_detail::is_vec_v<T>);
@@ -103,7 +418,7 @@ namespace gdt
         constexpr vec(const T& x, const vec2<T>& yz, const T& w)
         requires (N == 4)
         :
-            _data{x, yz[0]. yz[1], w}
+            _data{x, yz[0], yz[1], w}
         {}
 
         // Constructor.
@@ -179,299 +494,97 @@ namespace gdt
         gdt(a, 3)
         #undef gdt
 
-        // 2-component getters.
-        #define gdt_1(i, j)\
-        constexpr vec2<T> i##j() const\
-        {\
-            return {i(), j()};\
-        }
-        #define gdt_2(i)\
-        gdt_1(i, x)\
-        gdt_1(i, y)\
-        gdt_1(i, z)\
-        gdt_1(i, w)
-        gdt_2(x)
-        gdt_2(y)
-        gdt_2(z)
-        gdt_2(w)
-        #undef gdt_2
-        #define gdt_2(i)\
-        gdt_1(i, r)\
-        gdt_1(i, g)\
-        gdt_1(i, b)\
-        gdt_1(i, a)
-        gdt_2(r)
-        gdt_2(g)
-        gdt_2(b)
-        gdt_2(a)
-        #undef gdt_2
-        #undef gdt_1
-
-        // 3-component getters.
-        #define gdt_1(i, j, k)\
-        constexpr vec3<T> i##j##k() const\
-        {\
-            return {i(), j(), k()};\
-        }
-        #define gdt_2(i, j)\
-        gdt_1(i, j, x)\
-        gdt_1(i, j, y)\
-        gdt_1(i, j, z)\
-        gdt_1(i, j, w)
-        #define gdt_3(i)\
-        gdt_2(i, x)\
-        gdt_2(i, y)\
-        gdt_2(i, z)\
-        gdt_2(i, w)
-        gdt_3(x)
-        gdt_3(y)
-        gdt_3(z)
-        gdt_3(w)
-        #undef gdt_3
-        #undef gdt_2
-        #define gdt_2(i, j)\
-        gdt_1(i, j, r)\
-        gdt_1(i, j, g)\
-        gdt_1(i, j, b)\
-        gdt_1(i, j, a)
-        #define gdt_3(i)\
-        gdt_2(i, r)\
-        gdt_2(i, g)\
-        gdt_2(i, b)\
-        gdt_2(i, a)
-        gdt_3(r)
-        gdt_3(g)
-        gdt_3(b)
-        gdt_3(a)
-        #undef gdt_3
-        #undef gdt_2
-        #undef gdt_1
-
-        // 4-component getters.
-        #define gdt_1(i, j, k, l)\
-        constexpr vec4<T> i##j##k##l() const \
-        {\
-            return {i(), j(), k(), l()};\
-        }
-        #define gdt_2(i, j, k)\
-        gdt_1(i, j, k, x)\
-        gdt_1(i, j, k, y)\
-        gdt_1(i, j, k, z)\
-        gdt_1(i, j, k, w)
-        #define gdt_3(i, j)\
-        gdt_2(i, j, x)\
-        gdt_2(i, j, y)\
-        gdt_2(i, j, z)\
-        gdt_2(i, j, w)
-        #define gdt_4(i)\
-        gdt_3(i, x)\
-        gdt_3(i, y)\
-        gdt_3(i, z)\
-        gdt_3(i, w)
-        gdt_4(x)
-        gdt_4(y)
-        gdt_4(z)
-        gdt_4(w)
-        #undef gdt_4
-        #undef gdt_3
-        #undef gdt_2
-        #define gdt_2(i, j, k)\
-        gdt_1(i, j, k, r)\
-        gdt_1(i, j, k, g)\
-        gdt_1(i, j, k, b)\
-        gdt_1(i, j, k, a)
-        #define gdt_3(i, j)\
-        gdt_2(i, j, r)\
-        gdt_2(i, j, g)\
-        gdt_2(i, j, b)\
-        gdt_2(i, j, a)
-        #define gdt_4(i)\
-        gdt_3(i, r)\
-        gdt_3(i, g)\
-        gdt_3(i, b)\
-        gdt_3(i, a)
-        gdt_4(r)
-        gdt_4(g)
-        gdt_4(b)
-        gdt_4(a)
-        #undef gdt_4
-        #undef gdt_3
-        #undef gdt_2
-        #undef gdt_1
-
-        // 2-component setters.
-        #define gdt(i, j)\
-        constexpr void set_##i##j(const vec2<T>& v)\
-        {\
-            i() = v[0];\
-            j() = v[1];\
-        }
-        gdt(x, y)
-        gdt(x, z)
-        gdt(x, w)
-        gdt(y, x)
-        gdt(y, z)
-        gdt(y, w)
-        gdt(z, x)
-        gdt(z, y)
-        gdt(z, w)
-        gdt(w, x)
-        gdt(w, y)
-        gdt(w, z)
-        gdt(r, g)
-        gdt(r, b)
-        gdt(r, a)
-        gdt(g, r)
-        gdt(g, b)
-        gdt(g, a)
-        gdt(b, r)
-        gdt(b, g)
-        gdt(b, a)
-        gdt(a, r)
-        gdt(a, g)
-        gdt(a, b)
-        #undef gdt
+        // Swizzle.
+        // Components `I...` in order, so `swizzle<2, 0, 1>()` is `zxy()`.
+        // A full-width swizzle of a SIMD vector is one shuffle.
+        template<std::size_t... I>
+        requires (sizeof...(I) > 0 && ((I < N) && ...))
+        constexpr vec<T, sizeof...(I)> swizzle() const
+        {
+            vec<T, sizeof...(I)> ret;
+            if constexpr (gdt_detail::simd_swizzle<T, N, I...>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    gdt_detail::simd_apply_swizzle<I...>(
+                        std::addressof(ret[0]), std::addressof(_data[0]));
+                    return ret;
+                }
+            }
 
-        // 3-component setters.
-        #define gdt(i, j, k)\
-        constexpr void set_##i##j##k(const vec3<T>& v)\
-        {\
-            i() = v[0];\
-            j() = v[1];\
-            k() = v[2];\
+            std::size_t i = 0;
+            ((ret[i++] = _data[I]), ...);
+            return ret;
         }
-        gdt(x, y, z)
-        gdt(x, y, w)
-        gdt(x, z, y)
-        gdt(x, z, w)
-        gdt(x, w, y)
-        gdt(x, w, z)
-        gdt(y, x, z)
-        gdt(y, x, w)
-        gdt(y, z, x)
-        gdt(y, z, w)
-        gdt(y, w, x)
-        gdt(y, w, z)
-        gdt(z, x, y)
-        gdt(z, x, w)
-        gdt(z, y, x)
-        gdt(z, y, w)
-        gdt(z, w, x)
-        gdt(z, w, y)
-        gdt(w, x, y)
-        gdt(w, x, z)
-        gdt(w, y, x)
-        gdt(w, y, z)
-        gdt(w, z, x)
-        gdt(w, z, y)
-        gdt(r, g, b)
-        gdt(r, g, a)
-        gdt(r, b, g)
-        gdt(r, b, a)
-        gdt(r, a, g)
-        gdt(r, a, b)
-        gdt(g, r, b)
-        gdt(g, r, a)
-        gdt(g, b, r)
-        gdt(g, b, a)
-        gdt(g, a, r)
-        gdt(g, a, b)
-        gdt(b, r, g)
-        gdt(b, r, a)
-        gdt(b, g, r)
-        gdt(b, g, a)
-        gdt(b, a, r)
-        gdt(b, a, g)
-        gdt(a, r, g)
-        gdt(a, r, b)
-        gdt(a, g, r)
-        gdt(a, g, b)
-        gdt(a, b, r)
-        gdt(a, b, g)
-        #undef gdt
 
-        // 4-component setters.
-        #define gdt(i, j, k, l)\
-        constexpr void set_##i##j##k##l(const vec4<T>& v)\
-        {\
-            i() = v[0];\
-            j() = v[1];\
-            k() = v[2];\
-            l() = v[3];\
+        // Set swizzle.
+        // Sets components `I...`, which must be distinct, to those of `v`, so
+        // `set_swizzle<2, 0>(v)` is `set_zx(v)`.
+        template<std::size_t... I>
+        requires (
+            sizeof...(I) > 0 && ((I < N) && ...) &&
+            gdt_detail::are_distinct<I...>())
+        constexpr void set_swizzle(const vec<T, sizeof...(I)>& v)
+        {
+            if constexpr (sizeof...(I) == N)
+            {
+                // A permutation. Apply its inverse to `v` instead.
+                *this = [&]<std::size_t... J>(std::index_sequence<J...>)
+                {
+                    return v.template swizzle<
+                        gdt_detail::index_of<J, I...>()...>();
+                }(std::make_index_sequence<N>());
+            }
+            else
+            {
+                std::size_t i = 0;
+                ((_data[I] = v[i++]), ...);
+            }
         }
-        gdt(x, y, z, w)
-        gdt(x, y, w, z)
-        gdt(x, z, y, w)
-        gdt(x, z, w, y)
-        gdt(x, w, y, z)
-        gdt(x, w, z, y)
-        gdt(y, x, z, w)
-        gdt(y, x, w, z)
-        gdt(y, z, x, w)
-        gdt(y, z, w, x)
-        gdt(y, w, x, z)
-        gdt(y, w, z, x)
-        gdt(z, x, y, w)
-        gdt(z, x, w, y)
-        gdt(z, y, x, w)
-        gdt(z, y, w, x)
-        gdt(z, w, x, y)
-        gdt(z, w, y, x)
-        gdt(w, x, y, z)
-        gdt(w, x, z, y)
-        gdt(w, y, x, z)
-        gdt(w, y, z, x)
-        gdt(w, z, x, y)
-        gdt(w, z, y, x)
-        gdt(r, g, b, a)
-        gdt(r, g, a, b)
-        gdt(r, b, g, a)
-        gdt(r, b, a, g)
-        gdt(r, a, g, b)
-        gdt(r, a, b, g)
-        gdt(g, r, b, a)
-        gdt(g, r, a, b)
-        gdt(g, b, r, a)
-        gdt(g, b, a, r)
-        gdt(g, a, r, b)
-        gdt(g, a, b, r)
-        gdt(b, r, g, a)
-        gdt(b, r, a, g)
-        gdt(b, g, r, a)
-        gdt(b, g, a, r)
-        gdt(b, a, r, g)
-        gdt(b, a, g, r)
-        gdt(a, r, g, b)
-        gdt(a, r, b, g)
-        gdt(a, g, r, b)
-        gdt(a, g, b, r)
-        gdt(a, b, r, g)
-        gdt(a, b, g, r)
-        #undef gdt
 
         // Unary operators.
-        #define gdt(op)\
+        #define gdt(op, Op)\
         friend constexpr auto operator op(const vec& v)\
         {\
-            vec<decltype(op v[0]), N> ret;\
+            using R = decltype(op v[0]);\
+            vec<R, N> ret;\
+            if constexpr (gdt_detail::simd_unary<Op, R, T, N>)\
+            {\
+                if (!std::is_constant_evaluated())\
+                {\
+                    gdt_detail::simd_apply<Op, N>(\
+                        std::addressof(ret[0]), std::addressof(v[0]));\
+                    return ret;\
+                }\
+            }\
             for (std::size_t i = 0; i < N; ++i)\
             {\
                 ret[i] = op v[i];\
             }\
             return ret;\
         }
-        gdt(+)
-        gdt(-)
-        gdt(~)
-        gdt(!)
+        gdt(+, void)
+        gdt(-, std::negate<>)
+        gdt(~, std::bit_not<>)
+        gdt(!, void)
         #undef gdt
 
         // Vector-scalar and scalar-vector binary operators.
-        #define gdt(op)\
+        #define gdt(op, Op)\
         template<typename U> requires (!gdt_detail::is_vec_v<U>)\
         friend constexpr auto operator op(const vec& lhs, const U& rhs)\
         {\
-            vec<decltype(lhs[0] op rhs), N> ret;\
+            using R = decltype(lhs[0] op rhs);\
+            vec<R, N> ret;\
+            if constexpr (gdt_detail::simd_scalar<Op, R, T, U, N>)\
+            {\
+                if (!std::is_constant_evaluated())\
+                {\
+                    gdt_detail::simd_apply<Op, N>(\
+                        std::addressof(ret[0]), std::addressof(lhs[0]), T(rhs));\
+                    return ret;\
+                }\
+            }\
             for (std::size_t i = 0; i < N; ++i)\
             {\
                 ret[i] = lhs[i] op rhs;\
@@ -481,49 +594,73 @@ namespace gdt
         template<typename U> requires (!gdt_detail::is_vec_v<U>)\
         friend constexpr auto operator op(const U& lhs, const vec& rhs)\
         {\
-            vec<decltype(lhs op rhs[0]), N> ret;\
+            using R = decltype(lhs op rhs[0]);\
+            vec<R, N> ret;\
+            if constexpr (gdt_detail::simd_scalar<Op, R, T, U, N>)\
+            {\
+                if (!std::is_constant_evaluated())\
+                {\
+                    gdt_detail::simd_apply<Op, N>(\
+                        std::addressof(ret[0]), T(lhs), std::addressof(rhs[0]));\
+                    return ret;\
+                }\
+            }\
             for (std::size_t i = 0; i < N; ++i)\
             {\
                 ret[i] = lhs op rhs[i];\
             }\
             return ret;\
         }
-        gdt(+)
-        gdt(-)
-        gdt(*)
-        gdt(/)
-        gdt(%)
+        gdt(+, std::plus<>)
+        gdt(-, std::minus<>)
+        gdt(*, std::multiplies<>)
+        gdt(/, std::divides<>)
+        gdt(%, void)
         #undef gdt
 
         // Vector-vector binary operators.
-        #define gdt(op)\
+        #define gdt(op, Op)\
         template<typename U>\
         friend constexpr auto operator op(const vec& lhs, const vec<U, N>& rhs)\
         {\
-            vec<decltype(lhs[0] op rhs[0]), N> ret;\
+            using R = decltype(lhs[0] op rhs[0]);\
+            vec<R, N> ret;\
+            if constexpr (\
+                std::is_same_v<T, U> &&\
+                gdt_detail::simd_binary<Op, R, T, N>)\
+            {\
+                if (!std::is_constant_evaluated())\
+                {\
+                    gdt_detail::simd_apply<Op, N>(\
+                        std::addressof(ret[0]),\
+                        std::addressof(lhs[0]),\
+                        std::addressof(rhs[0]));\
+                    return ret;\
+                }\
+            }\
             for (std::size_t i = 0; i < N; ++i)\
             {\
                 ret[i] = lhs[i] op rhs[i];\
             }\
             return ret;\
         }
-        gdt(+)
-        gdt(-)
-        gdt(*)
-        gdt(/)
-        gdt(%)
-        gdt(&)
-        gdt(|)
-        gdt(^)
-        gdt(<<)
-        gdt(>>)
-        gdt(<)
-        gdt(>)
-        gdt(<=)
-        gdt(>=)
-        gdt(==)
-        gdt(!=)
-        gdt(<=>)
+        gdt(+, std::plus<>)
+        gdt(-, std::minus<>)
+        gdt(*, std::multiplies<>)
+        gdt(/, std::divides<>)
+        gdt(%, void)
+        gdt(&, std::bit_and<>)
+        gdt(|, std::bit_or<>)
+        gdt(^, std::bit_xor<>)
+        gdt(<<, gdt_detail::shift_left)
+        gdt(>>, gdt_detail::shift_right)
+        gdt(<, std::less<>)
+        gdt(>, std::greater<>)
+        gdt(<=, std::less_equal<>)
+        gdt(>=, std::greater_equal<>)
+        gdt(==, std::equal_to<>)
+        gdt(!=, std::not_equal_to<>)
+        gdt(<=>, void)
         #undef gdt
 
     private:
@@ -756,3 +893,250 @@ namespace gdt
     gdt(lerp)
     #undef gdt
 }
+
+namespace gdt_detail
+{
+    // c * c - m, exactly enough to compare candidate roots of `m`.
+    // Dekker's product; `c` must be near sqrt(m) in [1, 2].
+    template<typename T>
+    constexpr T sqrt_residual(const T& c, const T& m)
+    {
+        T split = T(1);
+        for (int i = 0; i < (std::numeric_limits<T>::digits + 1) / 2; ++i)
+        {
+            split *= T(2);
+        }
+        split += T(1);
+
+        T h = split * c;
+        T hi = h - (h - c);
+        T lo = c - hi;
+        T p = c * c;
+        T e = ((hi * hi - p) + T(2) * hi * lo) + lo * lo;
+        return (p - m) + e;
+    }
+
+    // Square root that also works in constant expressions.
+    // Those are correctly rounded, like std::sqrt.
+    template<typename T>
+    constexpr T constexpr_sqrt(const T& x)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            using std::sqrt;
+            return sqrt(x);
+        }
+
+        if (x < T(0))
+        {
+            return std::numeric_limits<T>::quiet_NaN();
+        }
+
+        // Zero, infinity, and NaN are their own square roots.
+        if (!(x > T(0)) || x == std::numeric_limits<T>::infinity())
+        {
+            return x;
+        }
+
+        // Scale into [1, 4) by powers of 4, which is exact.
+        T m = x;
+        T scale = T(1);
+        while (m >= T(4))
+        {
+            m /= T(4);
+            scale *= T(2);
+        }
+        while (m < T(1))
+        {
+            m *= T(4);
+            scale /= T(2);
+        }
+
+        // Newton's method from above gets within a unit in the last place.
+        T y = T(2);
+        while (true)
+        {
+            T next = (y + m / y) / T(2);
+            if (!(next < y))
+            {
+                break;
+            }
+            y = next;
+        }
+
+        // Pick whichever neighbor has the smallest residual.
+        auto eps = std::numeric_limits<T>::epsilon();
+        T candidates[2] = {y > T(1) ? y - eps : T(1) - eps / T(2), y + eps};
+        auto best = sqrt_residual(y, m);
+        best = best < T(0) ? -best : best;
+        for (auto c : candidates)
+        {
+            auto r = sqrt_residual(c, m);
+            r = r < T(0) ? -r : r;
+            if (r < best)
+            {
+                best = r;
+                y = c;
+            }
+        }
+
+        return y * scale;
+    }
+
+    // Estimate 1 / sqrt(x) for x > 0.
+    // Uses the SIMD estimate at runtime where there is one; otherwise a bit
+    // trick refined by three Newton steps. Either is within a few units in
+    // the last place.
+    constexpr float fast_rsqrt(float x)
+    {
+        if constexpr (has_simd_rsqrt)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                return simd_rsqrt(x);
+            }
+        }
+
+        auto bits = std::bit_cast<std::uint32_t>(x);
+        auto y = std::bit_cast<float>(std::uint32_t(0x5f375a86) - (bits >> 1));
+        auto hx = 0.5f * x;
+        for (int i = 0; i < 3; ++i)
+        {
+            y = y * (1.5f - hx * y * y);
+        }
+        return y;
+    }
+}
+
+namespace gdt
+{
+    // Dot product.
+    // Sums products in pairs, ((v0 + v1) + (v2 + v3)) for 4 components.
+    template<typename T, std::size_t N>
+    constexpr T dot(const vec<T, N>& v1, const vec<T, N>& v2)
+    {
+        if constexpr (gdt_detail::simd_dot<T, N>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                return gdt_detail::simd_geometric<T, N>::dot(
+                    std::addressof(v1[0]),
+                    std::addressof(v2[0]));
+            }
+        }
+
+        T ret = T(v1[0] * v2[0]);
+        std::size_t i = 1;
+        if constexpr (N >= 2)
+        {
+            ret = T(ret + v1[1] * v2[1]);
+            i = 2;
+        }
+        for (; i + 1 < N; i += 2)
+        {
+            ret = T(ret + (v1[i] * v2[i] + v1[i + 1] * v2[i + 1]));
+        }
+        if (i < N)
+        {
+            ret = T(ret + v1[i] * v2[i]);
+        }
+        return ret;
+    }
+
+    // Cross product.
+    template<typename T>
+    constexpr vec<T, 3> cross(const vec<T, 3>& v1, const vec<T, 3>& v2)
+    {
+        return vec<T, 3>(
+            T(v1[1] * v2[2] - v1[2] * v2[1]),
+            T(v1[2] * v2[0] - v1[0] * v2[2]),
+            T(v1[0] * v2[1] - v1[1] * v2[0]));
+    }
+
+    // Squared length.
+    template<typename T, std::size_t N>
+    constexpr T length_squared(const vec<T, N>& v)
+    {
+        return dot(v, v);
+    }
+
+    // Length.
+    template<typename T, std::size_t N>
+    requires (std::is_floating_point_v<T>)
+    constexpr T length(const vec<T, N>& v)
+    {
+        return gdt_detail::constexpr_sqrt(dot(v, v));
+    }
+
+    // Distance between points.
+    template<typename T, std::size_t N>
+    requires (std::is_floating_point_v<T>)
+    constexpr T distance(const vec<T, N>& p1, const vec<T, N>& p2)
+    {
+        return length(p1 - p2);
+    }
+
+    // Unit vector in the direction of `v`, which must not be zero.
+    template<typename T, std::size_t N>
+    requires (std::is_floating_point_v<T>)
+    constexpr vec<T, N> normalize(const vec<T, N>& v)
+    {
+        if constexpr (gdt_detail::simd_normalize<T, N>)
+        {
+            if (!std::is_constant_evaluated())
+            {
+                vec<T, N> ret;
+                gdt_detail::simd_geometric<T, N>::normalize(
+                    std::addressof(ret[0]),
+                    std::addressof(v[0]));
+                return ret;
+            }
+        }
+
+        return v / length(v);
+    }
+
+    // Approximately `normalize(v)`.
+    // For float, multiplies by an estimated 1 / length accurate to a few
+    // units in the last place. Other types use `normalize`.
+    template<typename T, std::size_t N>
+    requires (std::is_floating_point_v<T>)
+    constexpr vec<T, N> fast_normalize(const vec<T, N>& v)
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+            if constexpr (gdt_detail::simd_fast_normalize<T, N>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    vec<T, N> ret;
+                    gdt_detail::simd_geometric<T, N>::fast_normalize(
+                        std::addressof(ret[0]),
+                        std::addressof(v[0]));
+                    return ret;
+                }
+            }
+
+            return v * gdt_detail::fast_rsqrt(dot(v, v));
+        }
+        else
+        {
+            return normalize(v);
+        }
+    }
+
+    // Reflect incident vector `i` off a surface with unit normal `n`.
+    template<typename T, std::size_t N>
+    constexpr vec<T, N> reflect(const vec<T, N>& i, const vec<T, N>& n)
+    {
+        return vec<T, N>(i - T(2) * dot(n, i) * n);
+    }
+
+    // Projection of `v` onto `onto`, which must not be zero.
+    template<typename T, std::size_t N>
+    requires (std::is_floating_point_v<T>)
+    constexpr vec<T, N> project(const vec<T, N>& v, const vec<T, N>& onto)
+    {
+        return onto * (dot(v, onto) / dot(onto, onto));
+    }
+}
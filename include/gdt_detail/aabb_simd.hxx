@@ -0,0 +1,309 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "vec_simd.hxx"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace gdt_detail
+{
+    // SIMD kernels for `W` boxes in structure-of-arrays form.
+    // `lower` and `upper` point at N runs of W floats, one run per axis.
+    // Specializations set `enabled` and provide static `overlaps` and
+    // `intersect` functions whose results match the scalar code exactly.
+    template<typename T, std::size_t W>
+    struct simd_aabb
+    {
+        static constexpr bool enabled = false;
+    };
+
+#if defined(GDT_SIMD_SSE2)
+    // Overlap mask for the 4 boxes at `lane` of runs `Stride` floats long.
+    template<std::size_t N, std::size_t Stride>
+    inline std::uint32_t sse2_aabb_overlaps(
+        const float* lower,
+        const float* upper,
+        const float* box_lower,
+        const float* box_upper,
+        std::size_t lane) noexcept
+    {
+        auto mask = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (std::size_t a = 0; a < N; ++a)
+        {
+            auto lo = _mm_loadu_ps(lower + a * Stride + lane);
+            auto hi = _mm_loadu_ps(upper + a * Stride + lane);
+            auto bl = _mm_set1_ps(box_lower[a]);
+            auto bu = _mm_set1_ps(box_upper[a]);
+            mask = _mm_and_ps(mask, _mm_cmple_ps(lo, bu));
+            mask = _mm_and_ps(mask, _mm_cmple_ps(bl, hi));
+        }
+        return std::uint32_t(_mm_movemask_ps(mask));
+    }
+
+    // Hit mask for the 4 boxes at `lane` of runs `Stride` floats long.
+    template<std::size_t N, std::size_t Stride>
+    inline std::uint32_t sse2_aabb_intersect(
+        const float* lower,
+        const float* upper,
+        const float* origin,
+        const float* inv,
+        float t_max,
+        float* t,
+        std::size_t lane) noexcept
+    {
+        auto t_enter = _mm_setzero_ps();
+        auto t_exit = _mm_set1_ps(t_max);
+        for (std::size_t a = 0; a < N; ++a)
+        {
+            auto lo = lower + a * Stride + lane;
+            auto hi = upper + a * Stride + lane;
+            auto near = _mm_loadu_ps(!(inv[a] < 0.0f) ? lo : hi);
+            auto far = _mm_loadu_ps(!(inv[a] < 0.0f) ? hi : lo);
+            auto o = _mm_set1_ps(origin[a]);
+            auto i = _mm_set1_ps(inv[a]);
+
+            // max and min return their second operand for NaN, like the
+            // scalar code.
+            auto tn = _mm_mul_ps(_mm_sub_ps(near, o), i);
+            auto tf = _mm_mul_ps(_mm_sub_ps(far, o), i);
+            t_enter = _mm_max_ps(tn, t_enter);
+            t_exit = _mm_min_ps(tf, t_exit);
+        }
+
+        auto hit = _mm_cmple_ps(t_enter, t_exit);
+        if (t != nullptr)
+        {
+            auto inf = _mm_set1_ps(std::numeric_limits<float>::infinity());
+            _mm_storeu_ps(t + lane, _mm_or_ps(
+                _mm_and_ps(hit, t_enter),
+                _mm_andnot_ps(hit, inf)));
+        }
+        return std::uint32_t(_mm_movemask_ps(hit));
+    }
+
+    template<>
+    struct simd_aabb<float, 4>
+    {
+        static constexpr bool enabled = true;
+
+        template<std::size_t N>
+        static std::uint32_t overlaps(
+            const float* lower,
+            const float* upper,
+            const float* box_lower,
+            const float* box_upper) noexcept
+        {
+            return sse2_aabb_overlaps<N, 4>(
+                lower, upper, box_lower, box_upper, 0);
+        }
+
+        template<std::size_t N>
+        static std::uint32_t intersect(
+            const float* lower,
+            const float* upper,
+            const float* origin,
+            const float* inv,
+            float t_max,
+            float* t) noexcept
+        {
+            return sse2_aabb_intersect<N, 4>(
+                lower, upper, origin, inv, t_max, t, 0);
+        }
+    };
+
+    template<>
+    struct simd_aabb<float, 8>
+    {
+        static constexpr bool enabled = true;
+
+        template<std::size_t N>
+        static std::uint32_t overlaps(
+            const float* lower,
+            const float* upper,
+            const float* box_lower,
+            const float* box_upper) noexcept
+        {
+#if defined(GDT_SIMD_AVX)
+            auto mask = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (std::size_t a = 0; a < N; ++a)
+            {
+                auto lo = _mm256_loadu_ps(lower + a * 8);
+                auto hi = _mm256_loadu_ps(upper + a * 8);
+                auto bl = _mm256_set1_ps(box_lower[a]);
+                auto bu = _mm256_set1_ps(box_upper[a]);
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(lo, bu, _CMP_LE_OQ));
+                mask = _mm256_and_ps(mask, _mm256_cmp_ps(bl, hi, _CMP_LE_OQ));
+            }
+            return std::uint32_t(_mm256_movemask_ps(mask));
+#else
+            return
+                sse2_aabb_overlaps<N, 8>(
+                    lower, upper, box_lower, box_upper, 0) |
+                sse2_aabb_overlaps<N, 8>(
+                    lower, upper, box_lower, box_upper, 4) << 4;
+#endif
+        }
+
+        template<std::size_t N>
+        static std::uint32_t intersect(
+            const float* lower,
+            const float* upper,
+            const float* origin,
+            const float* inv,
+            float t_max,
+            float* t) noexcept
+        {
+#if defined(GDT_SIMD_AVX)
+            auto t_enter = _mm256_setzero_ps();
+            auto t_exit = _mm256_set1_ps(t_max);
+            for (std::size_t a = 0; a < N; ++a)
+            {
+                auto lo = lower + a * 8;
+                auto hi = upper + a * 8;
+                auto near = _mm256_loadu_ps(!(inv[a] < 0.0f) ? lo : hi);
+                auto far = _mm256_loadu_ps(!(inv[a] < 0.0f) ? hi : lo);
+                auto o = _mm256_set1_ps(origin[a]);
+                auto i = _mm256_set1_ps(inv[a]);
+
+                auto tn = _mm256_mul_ps(_mm256_sub_ps(near, o), i);
+                auto tf = _mm256_mul_ps(_mm256_sub_ps(far, o), i);
+                t_enter = _mm256_max_ps(tn, t_enter);
+                t_exit = _mm256_min_ps(tf, t_exit);
+            }
+
+            auto hit = _mm256_cmp_ps(t_enter, t_exit, _CMP_LE_OQ);
+            if (t != nullptr)
+            {
+                auto inf = std::numeric_limits<float>::infinity();
+                _mm256_storeu_ps(t, _mm256_blendv_ps(
+                    _mm256_set1_ps(inf),
+                    t_enter,
+                    hit));
+            }
+            return std::uint32_t(_mm256_movemask_ps(hit));
+#else
+            return
+                sse2_aabb_intersect<N, 8>(
+                    lower, upper, origin, inv, t_max, t, 0) |
+                sse2_aabb_intersect<N, 8>(
+                    lower, upper, origin, inv, t_max, t, 4) << 4;
+#endif
+        }
+    };
+#endif
+
+#if defined(GDT_SIMD_NEON)
+    // Bit `i` set for each all-ones lane `i` of `m`.
+    inline std::uint32_t neon_movemask(uint32x4_t m) noexcept
+    {
+        return
+            (vgetq_lane_u32(m, 0) & 1) |
+            (vgetq_lane_u32(m, 1) & 2) |
+            (vgetq_lane_u32(m, 2) & 4) |
+            (vgetq_lane_u32(m, 3) & 8);
+    }
+
+    // Overlap mask for the 4 boxes at `lane` of runs `Stride` floats long.
+    template<std::size_t N, std::size_t Stride>
+    inline std::uint32_t neon_aabb_overlaps(
+        const float* lower,
+        const float* upper,
+        const float* box_lower,
+        const float* box_upper,
+        std::size_t lane) noexcept
+    {
+        auto mask = vdupq_n_u32(0xffffffff);
+        for (std::size_t a = 0; a < N; ++a)
+        {
+            auto lo = vld1q_f32(lower + a * Stride + lane);
+            auto hi = vld1q_f32(upper + a * Stride + lane);
+            mask = vandq_u32(mask, vcleq_f32(lo, vdupq_n_f32(box_upper[a])));
+            mask = vandq_u32(mask, vcleq_f32(vdupq_n_f32(box_lower[a]), hi));
+        }
+        return neon_movemask(mask);
+    }
+
+    // Hit mask for the 4 boxes at `lane` of runs `Stride` floats long.
+    template<std::size_t N, std::size_t Stride>
+    inline std::uint32_t neon_aabb_intersect(
+        const float* lower,
+        const float* upper,
+        const float* origin,
+        const float* inv,
+        float t_max,
+        float* t,
+        std::size_t lane) noexcept
+    {
+        auto t_enter = vdupq_n_f32(0.0f);
+        auto t_exit = vdupq_n_f32(t_max);
+        for (std::size_t a = 0; a < N; ++a)
+        {
+            auto lo = lower + a * Stride + lane;
+            auto hi = upper + a * Stride + lane;
+            auto near = vld1q_f32(!(inv[a] < 0.0f) ? lo : hi);
+            auto far = vld1q_f32(!(inv[a] < 0.0f) ? hi : lo);
+            auto o = vdupq_n_f32(origin[a]);
+
+            // vmaxq and vminq propagate NaN, so select instead.
+            auto tn = vmulq_n_f32(vsubq_f32(near, o), inv[a]);
+            auto tf = vmulq_n_f32(vsubq_f32(far, o), inv[a]);
+            t_enter = vbslq_f32(vcgtq_f32(tn, t_enter), tn, t_enter);
+            t_exit = vbslq_f32(vcltq_f32(tf, t_exit), tf, t_exit);
+        }
+
+        auto hit = vcleq_f32(t_enter, t_exit);
+        if (t != nullptr)
+        {
+            auto inf = std::numeric_limits<float>::infinity();
+            vst1q_f32(t + lane, vbslq_f32(hit, t_enter, vdupq_n_f32(inf)));
+        }
+        return neon_movemask(hit);
+    }
+
+    template<std::size_t W>
+    requires (W == 4 || W == 8)
+    struct simd_aabb<float, W>
+    {
+        static constexpr bool enabled = true;
+
+        template<std::size_t N>
+        static std::uint32_t overlaps(
+            const float* lower,
+            const float* upper,
+            const float* box_lower,
+            const float* box_upper) noexcept
+        {
+            std::uint32_t ret = 0;
+            for (std::size_t lane = 0; lane < W; lane += 4)
+            {
+                ret |= neon_aabb_overlaps<N, W>(
+                    lower, upper, box_lower, box_upper, lane) << lane;
+            }
+            return ret;
+        }
+
+        template<std::size_t N>
+        static std::uint32_t intersect(
+            const float* lower,
+            const float* upper,
+            const float* origin,
+            const float* inv,
+            float t_max,
+            float* t) noexcept
+        {
+            std::uint32_t ret = 0;
+            for (std::size_t lane = 0; lane < W; lane += 4)
+            {
+                ret |= neon_aabb_intersect<N, W>(
+                    lower, upper, origin, inv, t_max, t, lane) << lane;
+            }
+            return ret;
+        }
+    };
+#endif
+}
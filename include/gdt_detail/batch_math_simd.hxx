@@ -0,0 +1,534 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "vec_simd.hxx"
+#include <cstddef>
+#include <cstdint>
+
+namespace gdt_detail
+{
+    // Constants for the float approximations in the Cephes library.
+    namespace cephes
+    {
+        // sin and cos.
+        constexpr float fopi = 1.27323954473516f;
+        constexpr float dp1 = 0.78515625f;
+        constexpr float dp2 = 2.4187564849853515625e-4f;
+        constexpr float dp3 = 3.77489497744594108e-8f;
+        constexpr float sin_p0 = -1.9515295891e-4f;
+        constexpr float sin_p1 = 8.3321608736e-3f;
+        constexpr float sin_p2 = -1.6666654611e-1f;
+        constexpr float cos_p0 = 2.443315711809948e-5f;
+        constexpr float cos_p1 = -1.388731625493765e-3f;
+        constexpr float cos_p2 = 4.166664568298827e-2f;
+
+        // exp.
+        constexpr float exp_hi = 88.3762626647949f;
+        constexpr float exp_lo = -88.3762626647949f;
+        constexpr float log2e = 1.44269504088896341f;
+        constexpr float exp_c1 = 0.693359375f;
+        constexpr float exp_c2 = -2.12194440e-4f;
+        constexpr float exp_p0 = 1.9875691500e-4f;
+        constexpr float exp_p1 = 1.3981999507e-3f;
+        constexpr float exp_p2 = 8.3334519073e-3f;
+        constexpr float exp_p3 = 4.1665795894e-2f;
+        constexpr float exp_p4 = 1.6666665459e-1f;
+        constexpr float exp_p5 = 5.0000001201e-1f;
+
+        // log.
+        constexpr float sqrthf = 0.707106781186547524f;
+        constexpr float log_p0 = 7.0376836292e-2f;
+        constexpr float log_p1 = -1.1514610310e-1f;
+        constexpr float log_p2 = 1.1676998740e-1f;
+        constexpr float log_p3 = -1.2420140846e-1f;
+        constexpr float log_p4 = 1.4249322787e-1f;
+        constexpr float log_p5 = -1.6668057665e-1f;
+        constexpr float log_p6 = 2.0000714765e-1f;
+        constexpr float log_p7 = -2.4999993993e-1f;
+        constexpr float log_p8 = 3.3333331174e-1f;
+        constexpr float log_q1 = -2.12194440e-4f;
+        constexpr float log_q2 = 0.693359375f;
+    }
+
+    // Batch math operations.
+    struct batch_sin {};
+    struct batch_cos {};
+    struct batch_exp {};
+    struct batch_log {};
+    struct batch_sqrt {};
+
+    // SIMD kernel for a batch math operation on 4 floats.
+    // Specializations provide a static `apply` function that performs the
+    // same float operations, in the same order, as the scalar kernel.
+    template<typename Op>
+    struct simd_batch_math {};
+
+#if defined(GDT_SIMD_SSE2)
+    // mask ? a : b.
+    inline __m128 sse2_select(__m128 mask, __m128 a, __m128 b) noexcept
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // Broadcast an int32.
+    inline __m128i sse2_set1(std::int32_t i) noexcept
+    {
+        return _mm_set1_epi32(i);
+    }
+
+    // sin(x) or cos(x) for `x` reduced to [-pi/4, pi/4].
+    inline __m128 sse2_sincos_poly(__m128 x, __m128 use_sin) noexcept
+    {
+        auto z = _mm_mul_ps(x, x);
+
+        auto c = _mm_mul_ps(_mm_set1_ps(cephes::cos_p0), z);
+        c = _mm_add_ps(c, _mm_set1_ps(cephes::cos_p1));
+        c = _mm_mul_ps(c, z);
+        c = _mm_add_ps(c, _mm_set1_ps(cephes::cos_p2));
+        c = _mm_mul_ps(c, z);
+        c = _mm_mul_ps(c, z);
+        c = _mm_sub_ps(c, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+        c = _mm_add_ps(c, _mm_set1_ps(1.0f));
+
+        auto s = _mm_mul_ps(_mm_set1_ps(cephes::sin_p0), z);
+        s = _mm_add_ps(s, _mm_set1_ps(cephes::sin_p1));
+        s = _mm_mul_ps(s, z);
+        s = _mm_add_ps(s, _mm_set1_ps(cephes::sin_p2));
+        s = _mm_mul_ps(s, z);
+        s = _mm_mul_ps(s, x);
+        s = _mm_add_ps(s, x);
+
+        return sse2_select(use_sin, s, c);
+    }
+
+    // Reduce |x| by the even octant `y` and evaluate.
+    // `j` is `y` as an integer.
+    inline __m128 sse2_sincos(__m128 x, __m128 y, __m128i j) noexcept
+    {
+        x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(cephes::dp1)));
+        x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(cephes::dp2)));
+        x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(cephes::dp3)));
+        auto use_sin = _mm_castsi128_ps(_mm_cmpeq_epi32(
+            _mm_and_si128(j, sse2_set1(2)),
+            _mm_setzero_si128()));
+        return sse2_sincos_poly(x, use_sin);
+    }
+
+    template<>
+    struct simd_batch_math<batch_sin>
+    {
+        static __m128 apply(__m128 x) noexcept
+        {
+            auto sign_bit = _mm_set1_ps(-0.0f);
+            auto sign = _mm_and_ps(x, sign_bit);
+            x = _mm_andnot_ps(sign_bit, x);
+
+            auto j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(cephes::fopi)));
+            j = _mm_and_si128(_mm_add_epi32(j, sse2_set1(1)), sse2_set1(~1));
+            auto y = _mm_cvtepi32_ps(j);
+
+            auto flip = _mm_slli_epi32(_mm_and_si128(j, sse2_set1(4)), 29);
+            sign = _mm_xor_ps(sign, _mm_castsi128_ps(flip));
+            return _mm_xor_ps(sse2_sincos(x, y, j), sign);
+        }
+    };
+
+    template<>
+    struct simd_batch_math<batch_cos>
+    {
+        static __m128 apply(__m128 x) noexcept
+        {
+            x = _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+
+            auto j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(cephes::fopi)));
+            j = _mm_and_si128(_mm_add_epi32(j, sse2_set1(1)), sse2_set1(~1));
+            auto y = _mm_cvtepi32_ps(j);
+            j = _mm_sub_epi32(j, sse2_set1(2));
+
+            auto sign = _mm_slli_epi32(_mm_andnot_si128(j, sse2_set1(4)), 29);
+            return _mm_xor_ps(sse2_sincos(x, y, j), _mm_castsi128_ps(sign));
+        }
+    };
+
+    template<>
+    struct simd_batch_math<batch_exp>
+    {
+        static __m128 apply(__m128 x) noexcept
+        {
+            auto v = _mm_min_ps(x, _mm_set1_ps(cephes::exp_hi));
+            v = _mm_max_ps(v, _mm_set1_ps(cephes::exp_lo));
+
+            // fx = floor(v * log2(e) + 0.5).
+            auto fx = _mm_mul_ps(v, _mm_set1_ps(cephes::log2e));
+            fx = _mm_add_ps(fx, _mm_set1_ps(0.5f));
+            auto t = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+            auto borrow = _mm_and_ps(_mm_cmpgt_ps(t, fx), _mm_set1_ps(1.0f));
+            fx = _mm_sub_ps(t, borrow);
+
+            v = _mm_sub_ps(v, _mm_mul_ps(fx, _mm_set1_ps(cephes::exp_c1)));
+            v = _mm_sub_ps(v, _mm_mul_ps(fx, _mm_set1_ps(cephes::exp_c2)));
+            auto z = _mm_mul_ps(v, v);
+
+            auto y = _mm_mul_ps(_mm_set1_ps(cephes::exp_p0), v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::exp_p1));
+            y = _mm_mul_ps(y, v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::exp_p2));
+            y = _mm_mul_ps(y, v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::exp_p3));
+            y = _mm_mul_ps(y, v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::exp_p4));
+            y = _mm_mul_ps(y, v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::exp_p5));
+            y = _mm_mul_ps(y, z);
+            y = _mm_add_ps(y, v);
+            y = _mm_add_ps(y, _mm_set1_ps(1.0f));
+
+            // Scale by 2^fx.
+            auto n = _mm_add_epi32(_mm_cvttps_epi32(fx), sse2_set1(127));
+            y = _mm_mul_ps(y, _mm_castsi128_ps(_mm_slli_epi32(n, 23)));
+
+            auto inf = _mm_castsi128_ps(sse2_set1(0x7f800000));
+            auto hi = _mm_set1_ps(cephes::exp_hi);
+            y = sse2_select(_mm_cmpgt_ps(x, hi), inf, y);
+            return sse2_select(_mm_cmpunord_ps(x, x), x, y);
+        }
+    };
+
+    template<>
+    struct simd_batch_math<batch_log>
+    {
+        static __m128 apply(__m128 x) noexcept
+        {
+            auto v = _mm_max_ps(x, _mm_castsi128_ps(sse2_set1(0x00800000)));
+            auto bits = _mm_castps_si128(v);
+
+            // v = m * 2^e with m in [0.5, 1).
+            auto exp = _mm_sub_epi32(_mm_srli_epi32(bits, 23), sse2_set1(127));
+            auto e = _mm_add_ps(_mm_cvtepi32_ps(exp), _mm_set1_ps(1.0f));
+            bits = _mm_and_si128(bits, sse2_set1(~0x7f800000));
+            bits = _mm_or_si128(bits, sse2_set1(0x3f000000));
+            v = _mm_castsi128_ps(bits);
+
+            // Shift m into [sqrt(1/2), sqrt(2)) and subtract 1.
+            auto small = _mm_cmplt_ps(v, _mm_set1_ps(cephes::sqrthf));
+            auto tmp = _mm_and_ps(small, v);
+            v = _mm_sub_ps(v, _mm_set1_ps(1.0f));
+            e = _mm_sub_ps(e, _mm_and_ps(small, _mm_set1_ps(1.0f)));
+            v = _mm_add_ps(v, tmp);
+            auto z = _mm_mul_ps(v, v);
+
+            auto y = _mm_mul_ps(_mm_set1_ps(cephes::log_p0), v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::log_p1));
+            y = _mm_mul_ps(y, v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::log_p2));
+            y = _mm_mul_ps(y, v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::log_p3));
+            y = _mm_mul_ps(y, v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::log_p4));
+            y = _mm_mul_ps(y, v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::log_p5));
+            y = _mm_mul_ps(y, v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::log_p6));
+            y = _mm_mul_ps(y, v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::log_p7));
+            y = _mm_mul_ps(y, v);
+            y = _mm_add_ps(y, _mm_set1_ps(cephes::log_p8));
+            y = _mm_mul_ps(y, v);
+            y = _mm_mul_ps(y, z);
+
+            y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(cephes::log_q1)));
+            y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+            v = _mm_add_ps(v, y);
+            v = _mm_add_ps(v, _mm_mul_ps(e, _mm_set1_ps(cephes::log_q2)));
+
+            // log(0) = -inf, log(inf) = inf, and log(x < 0) = NaN.
+            auto inf = _mm_castsi128_ps(sse2_set1(0x7f800000));
+            auto nan = _mm_castsi128_ps(sse2_set1(0x7fc00000));
+            auto zero = _mm_setzero_ps();
+            v = sse2_select(_mm_cmpeq_ps(x, inf), inf, v);
+            v = sse2_select(_mm_cmpeq_ps(x, zero), _mm_sub_ps(zero, inf), v);
+            return sse2_select(_mm_cmpnge_ps(x, zero), nan, v);
+        }
+    };
+
+    template<>
+    struct simd_batch_math<batch_sqrt>
+    {
+        static __m128 apply(__m128 x) noexcept
+        {
+            return _mm_sqrt_ps(x);
+        }
+    };
+
+    // Apply a batch math operation to `n` floats, 4 at a time.
+    // Returns how many it did; the caller does the rest.
+    template<typename Op>
+    inline std::size_t simd_batch_apply(
+        float* out,
+        const float* in,
+        std::size_t n)
+    noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            auto r = simd_batch_math<Op>::apply(_mm_loadu_ps(in + i));
+            _mm_storeu_ps(out + i, r);
+        }
+        return i;
+    }
+#endif
+
+#if defined(GDT_SIMD_NEON)
+    // mask ? a : b.
+    inline float32x4_t neon_select(
+        uint32x4_t mask,
+        float32x4_t a,
+        float32x4_t b)
+    noexcept
+    {
+        return vbslq_f32(mask, a, b);
+    }
+
+    // XOR float bits.
+    inline float32x4_t neon_xor(float32x4_t a, uint32x4_t b) noexcept
+    {
+        return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), b));
+    }
+
+    // sin(x) or cos(x) for `x` reduced to [-pi/4, pi/4].
+    inline float32x4_t neon_sincos_poly(float32x4_t x, uint32x4_t use_sin)
+    noexcept
+    {
+        auto z = vmulq_f32(x, x);
+
+        auto c = vmulq_f32(vdupq_n_f32(cephes::cos_p0), z);
+        c = vaddq_f32(c, vdupq_n_f32(cephes::cos_p1));
+        c = vmulq_f32(c, z);
+        c = vaddq_f32(c, vdupq_n_f32(cephes::cos_p2));
+        c = vmulq_f32(c, z);
+        c = vmulq_f32(c, z);
+        c = vsubq_f32(c, vmulq_f32(z, vdupq_n_f32(0.5f)));
+        c = vaddq_f32(c, vdupq_n_f32(1.0f));
+
+        auto s = vmulq_f32(vdupq_n_f32(cephes::sin_p0), z);
+        s = vaddq_f32(s, vdupq_n_f32(cephes::sin_p1));
+        s = vmulq_f32(s, z);
+        s = vaddq_f32(s, vdupq_n_f32(cephes::sin_p2));
+        s = vmulq_f32(s, z);
+        s = vmulq_f32(s, x);
+        s = vaddq_f32(s, x);
+
+        return neon_select(use_sin, s, c);
+    }
+
+    // Reduce |x| by the even octant `y` and evaluate.
+    // `j` is `y` as an integer.
+    inline float32x4_t neon_sincos(float32x4_t x, float32x4_t y, uint32x4_t j)
+    noexcept
+    {
+        x = vsubq_f32(x, vmulq_f32(y, vdupq_n_f32(cephes::dp1)));
+        x = vsubq_f32(x, vmulq_f32(y, vdupq_n_f32(cephes::dp2)));
+        x = vsubq_f32(x, vmulq_f32(y, vdupq_n_f32(cephes::dp3)));
+        auto use_sin = vceqq_u32(vandq_u32(j, vdupq_n_u32(2)), vdupq_n_u32(0));
+        return neon_sincos_poly(x, use_sin);
+    }
+
+    template<>
+    struct simd_batch_math<batch_sin>
+    {
+        static float32x4_t apply(float32x4_t x) noexcept
+        {
+            auto bits = vreinterpretq_u32_f32(x);
+            auto sign = vandq_u32(bits, vdupq_n_u32(0x80000000));
+            x = vabsq_f32(x);
+
+            auto j = vreinterpretq_u32_s32(
+                vcvtq_s32_f32(vmulq_f32(x, vdupq_n_f32(cephes::fopi))));
+            j = vandq_u32(vaddq_u32(j, vdupq_n_u32(1)), vdupq_n_u32(~1u));
+            auto y = vcvtq_f32_s32(vreinterpretq_s32_u32(j));
+
+            auto flip = vshlq_n_u32(vandq_u32(j, vdupq_n_u32(4)), 29);
+            sign = veorq_u32(sign, flip);
+            return neon_xor(neon_sincos(x, y, j), sign);
+        }
+    };
+
+    template<>
+    struct simd_batch_math<batch_cos>
+    {
+        static float32x4_t apply(float32x4_t x) noexcept
+        {
+            x = vabsq_f32(x);
+
+            auto j = vreinterpretq_u32_s32(
+                vcvtq_s32_f32(vmulq_f32(x, vdupq_n_f32(cephes::fopi))));
+            j = vandq_u32(vaddq_u32(j, vdupq_n_u32(1)), vdupq_n_u32(~1u));
+            auto y = vcvtq_f32_s32(vreinterpretq_s32_u32(j));
+            j = vsubq_u32(j, vdupq_n_u32(2));
+
+            auto sign = vshlq_n_u32(vbicq_u32(vdupq_n_u32(4), j), 29);
+            return neon_xor(neon_sincos(x, y, j), sign);
+        }
+    };
+
+    template<>
+    struct simd_batch_math<batch_exp>
+    {
+        static float32x4_t apply(float32x4_t x) noexcept
+        {
+            auto v = vminq_f32(x, vdupq_n_f32(cephes::exp_hi));
+            v = vmaxq_f32(v, vdupq_n_f32(cephes::exp_lo));
+
+            // fx = floor(v * log2(e) + 0.5).
+            auto fx = vmulq_f32(v, vdupq_n_f32(cephes::log2e));
+            fx = vaddq_f32(fx, vdupq_n_f32(0.5f));
+            auto t = vcvtq_f32_s32(vcvtq_s32_f32(fx));
+            auto borrow = vreinterpretq_f32_u32(vandq_u32(
+                vcgtq_f32(t, fx),
+                vreinterpretq_u32_f32(vdupq_n_f32(1.0f))));
+            fx = vsubq_f32(t, borrow);
+
+            v = vsubq_f32(v, vmulq_f32(fx, vdupq_n_f32(cephes::exp_c1)));
+            v = vsubq_f32(v, vmulq_f32(fx, vdupq_n_f32(cephes::exp_c2)));
+            auto z = vmulq_f32(v, v);
+
+            auto y = vmulq_f32(vdupq_n_f32(cephes::exp_p0), v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::exp_p1));
+            y = vmulq_f32(y, v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::exp_p2));
+            y = vmulq_f32(y, v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::exp_p3));
+            y = vmulq_f32(y, v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::exp_p4));
+            y = vmulq_f32(y, v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::exp_p5));
+            y = vmulq_f32(y, z);
+            y = vaddq_f32(y, v);
+            y = vaddq_f32(y, vdupq_n_f32(1.0f));
+
+            // Scale by 2^fx.
+            auto n = vaddq_s32(vcvtq_s32_f32(fx), vdupq_n_s32(127));
+            y = vmulq_f32(y, vreinterpretq_f32_s32(vshlq_n_s32(n, 23)));
+
+            auto inf = vreinterpretq_f32_u32(vdupq_n_u32(0x7f800000));
+            auto hi = vdupq_n_f32(cephes::exp_hi);
+            y = neon_select(vcgtq_f32(x, hi), inf, y);
+            return neon_select(vceqq_f32(x, x), y, x);
+        }
+    };
+
+    template<>
+    struct simd_batch_math<batch_log>
+    {
+        static float32x4_t apply(float32x4_t x) noexcept
+        {
+            auto min_normal = vreinterpretq_f32_u32(vdupq_n_u32(0x00800000));
+            auto v = vmaxq_f32(x, min_normal);
+            auto bits = vreinterpretq_u32_f32(v);
+
+            // v = m * 2^e with m in [0.5, 1).
+            auto exp = vsubq_s32(
+                vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)),
+                vdupq_n_s32(127));
+            auto e = vaddq_f32(vcvtq_f32_s32(exp), vdupq_n_f32(1.0f));
+            bits = vandq_u32(bits, vdupq_n_u32(~0x7f800000u));
+            bits = vorrq_u32(bits, vdupq_n_u32(0x3f000000));
+            v = vreinterpretq_f32_u32(bits);
+
+            // Shift m into [sqrt(1/2), sqrt(2)) and subtract 1.
+            auto small = vcltq_f32(v, vdupq_n_f32(cephes::sqrthf));
+            auto tmp = vreinterpretq_f32_u32(
+                vandq_u32(small, vreinterpretq_u32_f32(v)));
+            v = vsubq_f32(v, vdupq_n_f32(1.0f));
+            e = vsubq_f32(e, vreinterpretq_f32_u32(vandq_u32(
+                small,
+                vreinterpretq_u32_f32(vdupq_n_f32(1.0f)))));
+            v = vaddq_f32(v, tmp);
+            auto z = vmulq_f32(v, v);
+
+            auto y = vmulq_f32(vdupq_n_f32(cephes::log_p0), v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::log_p1));
+            y = vmulq_f32(y, v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::log_p2));
+            y = vmulq_f32(y, v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::log_p3));
+            y = vmulq_f32(y, v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::log_p4));
+            y = vmulq_f32(y, v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::log_p5));
+            y = vmulq_f32(y, v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::log_p6));
+            y = vmulq_f32(y, v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::log_p7));
+            y = vmulq_f32(y, v);
+            y = vaddq_f32(y, vdupq_n_f32(cephes::log_p8));
+            y = vmulq_f32(y, v);
+            y = vmulq_f32(y, z);
+
+            y = vaddq_f32(y, vmulq_f32(e, vdupq_n_f32(cephes::log_q1)));
+            y = vsubq_f32(y, vmulq_f32(z, vdupq_n_f32(0.5f)));
+            v = vaddq_f32(v, y);
+            v = vaddq_f32(v, vmulq_f32(e, vdupq_n_f32(cephes::log_q2)));
+
+            // log(0) = -inf, log(inf) = inf, and log(x < 0) = NaN.
+            auto inf = vreinterpretq_f32_u32(vdupq_n_u32(0x7f800000));
+            auto nan = vreinterpretq_f32_u32(vdupq_n_u32(0x7fc00000));
+            auto zero = vdupq_n_f32(0.0f);
+            v = neon_select(vceqq_f32(x, inf), inf, v);
+            v = neon_select(vceqq_f32(x, zero), vnegq_f32(inf), v);
+            return neon_select(vcgeq_f32(x, zero), v, nan);
+        }
+    };
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+    template<>
+    struct simd_batch_math<batch_sqrt>
+    {
+        static float32x4_t apply(float32x4_t x) noexcept
+        {
+            return vsqrtq_f32(x);
+        }
+    };
+#endif
+
+    // Apply a batch math operation to `n` floats, 4 at a time.
+    // Returns how many it did; the caller does the rest.
+    template<typename Op>
+    inline std::size_t simd_batch_apply(
+        float* out,
+        const float* in,
+        std::size_t n)
+    noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            auto r = simd_batch_math<Op>::apply(vld1q_f32(in + i));
+            vst1q_f32(out + i, r);
+        }
+        return i;
+    }
+#endif
+
+#if !defined(GDT_SIMD_SSE2) && !defined(GDT_SIMD_NEON)
+    // Declared but never defined or called; keeps the dispatch well-formed.
+    template<typename Op>
+    std::size_t simd_batch_apply(
+        float* out,
+        const float* in,
+        std::size_t n)
+    noexcept;
+#endif
+
+    // A batch math operation can use SIMD.
+    template<typename Op>
+    concept simd_batch = requires
+    {
+        &simd_batch_math<Op>::apply;
+    };
+}
@@ -0,0 +1,447 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "vec_simd.hxx"
+#include <cstddef>
+#include <cstdint>
+
+namespace gdt_detail
+{
+    // Bitwise operations on words.
+    struct bit_and
+    {
+        static constexpr std::uint64_t apply(std::uint64_t a, std::uint64_t b)
+        noexcept
+        {
+            return a & b;
+        }
+    };
+
+    struct bit_or
+    {
+        static constexpr std::uint64_t apply(std::uint64_t a, std::uint64_t b)
+        noexcept
+        {
+            return a | b;
+        }
+    };
+
+    struct bit_xor
+    {
+        static constexpr std::uint64_t apply(std::uint64_t a, std::uint64_t b)
+        noexcept
+        {
+            return a ^ b;
+        }
+    };
+
+    struct bit_and_not
+    {
+        static constexpr std::uint64_t apply(std::uint64_t a, std::uint64_t b)
+        noexcept
+        {
+            return a & ~b;
+        }
+    };
+
+    // SIMD kernels over arrays of 64-bit words.
+    // `simd_bitwise<Op>` provides a static `apply` function and
+    // `simd_bits` static `popcount` and `skip` functions. Each does whole
+    // blocks of words from the start of the array and returns how many
+    // words it did; the caller does the rest.
+#if defined(GDT_SIMD_AVX2)
+    template<typename Op>
+    inline __m256i avx2_bitwise(__m256i a, __m256i b) noexcept;
+
+    template<>
+    inline __m256i avx2_bitwise<bit_and>(__m256i a, __m256i b) noexcept
+    {
+        return _mm256_and_si256(a, b);
+    }
+
+    template<>
+    inline __m256i avx2_bitwise<bit_or>(__m256i a, __m256i b) noexcept
+    {
+        return _mm256_or_si256(a, b);
+    }
+
+    template<>
+    inline __m256i avx2_bitwise<bit_xor>(__m256i a, __m256i b) noexcept
+    {
+        return _mm256_xor_si256(a, b);
+    }
+
+    template<>
+    inline __m256i avx2_bitwise<bit_and_not>(__m256i a, __m256i b) noexcept
+    {
+        return _mm256_andnot_si256(b, a);
+    }
+
+    template<typename Op>
+    struct simd_bitwise
+    {
+        // dst[i] = Op(dst[i], src[i]), 8 words at a time.
+        static std::size_t apply(
+            std::uint64_t* dst,
+            const std::uint64_t* src,
+            std::size_t n) noexcept
+        {
+            auto d = reinterpret_cast<__m256i*>(dst);
+            auto s = reinterpret_cast<const __m256i*>(src);
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8, d += 2, s += 2)
+            {
+                auto a0 = _mm256_loadu_si256(d);
+                auto a1 = _mm256_loadu_si256(d + 1);
+                auto b0 = _mm256_loadu_si256(s);
+                auto b1 = _mm256_loadu_si256(s + 1);
+                _mm256_storeu_si256(d, avx2_bitwise<Op>(a0, b0));
+                _mm256_storeu_si256(d + 1, avx2_bitwise<Op>(a1, b1));
+            }
+            return i;
+        }
+    };
+
+    struct simd_bits
+    {
+        // Add the set bits in `n` words to `count`, 4 at a time.
+        // Looks up each nibble's popcount with a byte shuffle.
+        static std::size_t popcount(
+            const std::uint64_t* p,
+            std::size_t n,
+            std::uint64_t& count) noexcept
+        {
+            auto lookup = _mm256_setr_epi8(
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+            auto low = _mm256_set1_epi8(0x0f);
+            auto zero = _mm256_setzero_si256();
+            auto sum = zero;
+
+            auto s = reinterpret_cast<const __m256i*>(p);
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4, ++s)
+            {
+                auto v = _mm256_loadu_si256(s);
+                auto lo = _mm256_and_si256(v, low);
+                auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+                auto c = _mm256_add_epi8(
+                    _mm256_shuffle_epi8(lookup, lo),
+                    _mm256_shuffle_epi8(lookup, hi));
+                sum = _mm256_add_epi64(sum, _mm256_sad_epu8(c, zero));
+            }
+
+            alignas(32) std::uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sum);
+            count += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+            return i;
+        }
+
+        // Number of leading words equal to `value`, 8 at a time.
+        static std::size_t skip(
+            const std::uint64_t* p,
+            std::size_t n,
+            std::uint64_t value) noexcept
+        {
+            auto x = _mm256_set1_epi64x(std::int64_t(value));
+            auto s = reinterpret_cast<const __m256i*>(p);
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8, s += 2)
+            {
+                auto d = _mm256_or_si256(
+                    _mm256_xor_si256(_mm256_loadu_si256(s), x),
+                    _mm256_xor_si256(_mm256_loadu_si256(s + 1), x));
+                if (!_mm256_testz_si256(d, d))
+                {
+                    break;
+                }
+            }
+            return i;
+        }
+    };
+#elif defined(GDT_SIMD_SSE2)
+    template<typename Op>
+    inline __m128i sse2_bitwise(__m128i a, __m128i b) noexcept;
+
+    template<>
+    inline __m128i sse2_bitwise<bit_and>(__m128i a, __m128i b) noexcept
+    {
+        return _mm_and_si128(a, b);
+    }
+
+    template<>
+    inline __m128i sse2_bitwise<bit_or>(__m128i a, __m128i b) noexcept
+    {
+        return _mm_or_si128(a, b);
+    }
+
+    template<>
+    inline __m128i sse2_bitwise<bit_xor>(__m128i a, __m128i b) noexcept
+    {
+        return _mm_xor_si128(a, b);
+    }
+
+    template<>
+    inline __m128i sse2_bitwise<bit_and_not>(__m128i a, __m128i b) noexcept
+    {
+        return _mm_andnot_si128(b, a);
+    }
+
+    template<typename Op>
+    struct simd_bitwise
+    {
+        // dst[i] = Op(dst[i], src[i]), 4 words at a time.
+        static std::size_t apply(
+            std::uint64_t* dst,
+            const std::uint64_t* src,
+            std::size_t n) noexcept
+        {
+            auto d = reinterpret_cast<__m128i*>(dst);
+            auto s = reinterpret_cast<const __m128i*>(src);
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4, d += 2, s += 2)
+            {
+                auto a0 = _mm_loadu_si128(d);
+                auto a1 = _mm_loadu_si128(d + 1);
+                auto b0 = _mm_loadu_si128(s);
+                auto b1 = _mm_loadu_si128(s + 1);
+                _mm_storeu_si128(d, sse2_bitwise<Op>(a0, b0));
+                _mm_storeu_si128(d + 1, sse2_bitwise<Op>(a1, b1));
+            }
+            return i;
+        }
+    };
+
+    struct simd_bits
+    {
+#if defined(__POPCNT__)
+        // Leave popcounts to the caller's popcnt instructions.
+        static std::size_t popcount(
+            const std::uint64_t*,
+            std::size_t,
+            std::uint64_t&) noexcept
+        {
+            return 0;
+        }
+#else
+        // Add the set bits in `n` words to `count`, 2 at a time.
+        // Sums bits into bytes in-register, then bytes with `psadbw`.
+        static std::size_t popcount(
+            const std::uint64_t* p,
+            std::size_t n,
+            std::uint64_t& count) noexcept
+        {
+            auto m1 = _mm_set1_epi8(0x55);
+            auto m2 = _mm_set1_epi8(0x33);
+            auto m4 = _mm_set1_epi8(0x0f);
+            auto zero = _mm_setzero_si128();
+            auto sum = zero;
+
+            auto s = reinterpret_cast<const __m128i*>(p);
+            std::size_t i = 0;
+            for (; i + 2 <= n; i += 2, ++s)
+            {
+                auto v = _mm_loadu_si128(s);
+                v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi64(v, 1), m1));
+                v = _mm_add_epi8(
+                    _mm_and_si128(v, m2),
+                    _mm_and_si128(_mm_srli_epi64(v, 2), m2));
+                v = _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi64(v, 4)), m4);
+                sum = _mm_add_epi64(sum, _mm_sad_epu8(v, zero));
+            }
+
+            alignas(16) std::uint64_t lanes[2];
+            _mm_store_si128(reinterpret_cast<__m128i*>(lanes), sum);
+            count += lanes[0] + lanes[1];
+            return i;
+        }
+#endif
+
+        // Number of leading words equal to `value`, 4 at a time.
+        static std::size_t skip(
+            const std::uint64_t* p,
+            std::size_t n,
+            std::uint64_t value) noexcept
+        {
+            auto x = _mm_set1_epi64x(std::int64_t(value));
+            auto s = reinterpret_cast<const __m128i*>(p);
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4, s += 2)
+            {
+                auto eq = _mm_and_si128(
+                    _mm_cmpeq_epi32(_mm_loadu_si128(s), x),
+                    _mm_cmpeq_epi32(_mm_loadu_si128(s + 1), x));
+                if (_mm_movemask_epi8(eq) != 0xffff)
+                {
+                    break;
+                }
+            }
+            return i;
+        }
+    };
+#elif defined(GDT_SIMD_NEON)
+    template<typename Op>
+    inline uint64x2_t neon_bitwise(uint64x2_t a, uint64x2_t b) noexcept;
+
+    template<>
+    inline uint64x2_t neon_bitwise<bit_and>(uint64x2_t a, uint64x2_t b)
+    noexcept
+    {
+        return vandq_u64(a, b);
+    }
+
+    template<>
+    inline uint64x2_t neon_bitwise<bit_or>(uint64x2_t a, uint64x2_t b)
+    noexcept
+    {
+        return vorrq_u64(a, b);
+    }
+
+    template<>
+    inline uint64x2_t neon_bitwise<bit_xor>(uint64x2_t a, uint64x2_t b)
+    noexcept
+    {
+        return veorq_u64(a, b);
+    }
+
+    template<>
+    inline uint64x2_t neon_bitwise<bit_and_not>(uint64x2_t a, uint64x2_t b)
+    noexcept
+    {
+        return vbicq_u64(a, b);
+    }
+
+    template<typename Op>
+    struct simd_bitwise
+    {
+        // dst[i] = Op(dst[i], src[i]), 4 words at a time.
+        static std::size_t apply(
+            std::uint64_t* dst,
+            const std::uint64_t* src,
+            std::size_t n) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                auto a0 = vld1q_u64(dst + i);
+                auto a1 = vld1q_u64(dst + i + 2);
+                auto b0 = vld1q_u64(src + i);
+                auto b1 = vld1q_u64(src + i + 2);
+                vst1q_u64(dst + i, neon_bitwise<Op>(a0, b0));
+                vst1q_u64(dst + i + 2, neon_bitwise<Op>(a1, b1));
+            }
+            return i;
+        }
+    };
+
+    struct simd_bits
+    {
+        // Add the set bits in `n` words to `count`, 2 at a time.
+        static std::size_t popcount(
+            const std::uint64_t* p,
+            std::size_t n,
+            std::uint64_t& count) noexcept
+        {
+            auto sum = vdupq_n_u64(0);
+            std::size_t i = 0;
+            for (; i + 2 <= n; i += 2)
+            {
+                auto c = vcntq_u8(vreinterpretq_u8_u64(vld1q_u64(p + i)));
+                sum = vaddq_u64(sum, vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(c))));
+            }
+
+            count += vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1);
+            return i;
+        }
+
+        // Number of leading words equal to `value`, 4 at a time.
+        static std::size_t skip(
+            const std::uint64_t* p,
+            std::size_t n,
+            std::uint64_t value) noexcept
+        {
+            auto x = vdupq_n_u64(value);
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                auto d = vorrq_u64(
+                    veorq_u64(vld1q_u64(p + i), x),
+                    veorq_u64(vld1q_u64(p + i + 2), x));
+                if ((vgetq_lane_u64(d, 0) | vgetq_lane_u64(d, 1)) != 0)
+                {
+                    break;
+                }
+            }
+            return i;
+        }
+    };
+#else
+    template<typename Op>
+    struct simd_bitwise {};
+
+    struct simd_bits
+    {
+        static std::size_t popcount(
+            const std::uint64_t*,
+            std::size_t,
+            std::uint64_t&) noexcept
+        {
+            return 0;
+        }
+
+        static std::size_t skip(
+            const std::uint64_t*,
+            std::size_t,
+            std::uint64_t) noexcept
+        {
+            return 0;
+        }
+    };
+#endif
+
+    // A bitwise operation can use SIMD.
+    template<typename Op>
+    concept simd_bitwise_op = requires
+    {
+        &simd_bitwise<Op>::apply;
+    };
+
+    // Apply `Op` to the first of `n` words with SIMD, if any.
+    // Returns how many it did; the caller does the rest.
+    template<typename Op>
+    std::size_t simd_bitwise_some(
+        std::uint64_t* dst,
+        const std::uint64_t* src,
+        std::size_t n) noexcept
+    {
+        if constexpr (simd_bitwise_op<Op>)
+        {
+            return simd_bitwise<Op>::apply(dst, src, n);
+        }
+        return 0;
+    }
+
+    // Count the set bits in the first of `n` words with SIMD, if any.
+    // Returns how many words it did; the caller does the rest.
+    inline std::size_t simd_popcount_some(
+        const std::uint64_t* p,
+        std::size_t n,
+        std::uint64_t& count) noexcept
+    {
+        return simd_bits::popcount(p, n, count);
+    }
+
+    // Skip leading words equal to `value` with SIMD, if any.
+    // Returns how many words it skipped; the caller checks the rest.
+    inline std::size_t simd_skip_some(
+        const std::uint64_t* p,
+        std::size_t n,
+        std::uint64_t value) noexcept
+    {
+        return simd_bits::skip(p, n, value);
+    }
+}
@@ -0,0 +1,16 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include <cstddef>
+
+namespace gdt_detail
+{
+    // Cache line size to pad shared data to.
+    // `std::hardware_destructive_interference_size` can vary between
+    // compiler flags, which makes it unsafe to use in headers.
+    inline constexpr std::size_t cache_line_size = 64;
+}
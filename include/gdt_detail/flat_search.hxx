@@ -0,0 +1,105 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace gdt_detail
+{
+    // Index of the first of `n` sorted keys not less than `key`.
+    // Halves the range with a conditional move instead of a branch,
+    // so the loop runs the same log2(n) steps whatever the keys are
+    // and there are no mispredictions to pay for.
+    template<typename T, typename Key, typename Compare>
+    constexpr std::size_t flat_lower_bound(
+        const T* keys,
+        std::size_t n,
+        const Key& key,
+        const Compare& compare)
+    {
+        if (n == 0)
+        {
+            return 0;
+        }
+
+        auto base = keys;
+        while (n > 1)
+        {
+            auto half = n / 2;
+            base = compare(base[half - 1], key) ? base + half : base;
+            n -= half;
+        }
+
+        return std::size_t(base - keys) + compare(*base, key);
+    }
+
+    // Index of the first of `n` sorted keys greater than `key`.
+    template<typename T, typename Key, typename Compare>
+    constexpr std::size_t flat_upper_bound(
+        const T* keys,
+        std::size_t n,
+        const Key& key,
+        const Compare& compare)
+    {
+        if (n == 0)
+        {
+            return 0;
+        }
+
+        auto base = keys;
+        while (n > 1)
+        {
+            auto half = n / 2;
+            base = !compare(key, base[half - 1]) ? base + half : base;
+            n -= half;
+        }
+
+        return std::size_t(base - keys) + !compare(key, *base);
+    }
+
+    // Stable sort.
+    // `std::stable_sort` isn't constexpr, so constant
+    // evaluation falls back to insertion sort.
+    template<typename RandomIt, typename Compare>
+    constexpr void flat_stable_sort(
+        RandomIt first,
+        RandomIt last,
+        const Compare& compare)
+    {
+        if (!std::is_constant_evaluated())
+        {
+            std::stable_sort(first, last, compare);
+            return;
+        }
+
+        for (auto i = first; i != last; ++i)
+        {
+            for (auto j = i; j != first && compare(*j, *std::prev(j)); --j)
+            {
+                std::iter_swap(j, std::prev(j));
+            }
+        }
+    }
+
+    // Stable sort `first` to `last` and drop all but the first of
+    // every run of equivalent elements. Returns the new end.
+    template<typename RandomIt, typename Compare>
+    constexpr RandomIt flat_sort_unique(
+        RandomIt first,
+        RandomIt last,
+        const Compare& compare)
+    {
+        flat_stable_sort(first, last, compare);
+        return std::unique(first, last, [&](const auto& a, const auto& b)
+        {
+            return !compare(a, b);
+        });
+    }
+}
@@ -0,0 +1,1152 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "../gdt/assert.hxx"
+#include "../gdt/assume.hxx"
+#include "../gdt/dynarr.hxx"
+#include "hash_table_simd.hxx"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace gdt_detail
+{
+    // Hash table iterator.
+    template<typename V>
+    class hash_table_iterator;
+
+    // Spread the bits of a hash.
+    // Tables take the low 7 bits for control bytes and the rest for the
+    // probe start, so identity hashes (like most `std::hash<int>`s) would
+    // otherwise pile sequential keys into the same few groups.
+    constexpr std::uint64_t hash_mix(std::uint64_t h) noexcept
+    {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccd;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // Triangular probe sequence over groups of `Width` slots.
+    // Visits every group once when `mask + 1` is a power of 2.
+    template<typename SizeT, std::size_t Width>
+    class hash_probe
+    {
+    public:
+        // Constructor.
+        constexpr hash_probe(std::uint64_t h1, SizeT mask) noexcept
+        :
+            _mask{mask},
+            _offset{SizeT(h1 & mask)},
+            _index{0}
+        {}
+
+        // Start of the current group.
+        constexpr SizeT offset() const noexcept
+        {
+            return _offset;
+        }
+
+        // Slot of lane `i` in the current group.
+        constexpr SizeT offset(std::size_t i) const noexcept
+        {
+            return SizeT((_offset + i) & _mask);
+        }
+
+        // Move on to the next group.
+        constexpr void next() noexcept
+        {
+            _index = SizeT(_index + Width);
+            _offset = SizeT((_offset + _index) & _mask);
+        }
+
+    private:
+        // Member variables.
+        SizeT _mask;
+        SizeT _offset;
+        SizeT _index;
+    };
+
+    // Open-addressing hash table with SIMD group probing.
+    // `Policy` provides `key_type`, `value_type`, `constant_iterators`
+    // and a static `key` that gets the key of a value.
+    // Capacity is always 0 or a power of 2 minus 1. There are
+    // `capacity + hash_group_width` control bytes: one per slot, the
+    // sentinel, then clones of the first `hash_group_width - 1`.
+    template<
+        typename Policy,
+        typename Hash,
+        typename KeyEqual,
+        typename Allocator>
+    class hash_table
+    {
+        static_assert(std::is_same_v<
+            typename std::allocator_traits<Allocator>::pointer,
+            typename Policy::value_type*>);
+
+    public:
+        // Member types.
+        using key_type = typename Policy::key_type;
+        using value_type = typename Policy::value_type;
+        using size_type = typename std::allocator_traits<Allocator>::size_type;
+        using difference_type = typename std::allocator_traits<Allocator>::difference_type;
+        using hasher = Hash;
+        using key_equal = KeyEqual;
+        using allocator_type = Allocator;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = typename std::allocator_traits<Allocator>::pointer;
+        using const_pointer = typename std::allocator_traits<Allocator>::const_pointer;
+        using iterator = hash_table_iterator<std::conditional_t<
+            Policy::constant_iterators, const value_type, value_type>>;
+        using const_iterator = hash_table_iterator<const value_type>;
+
+    private:
+        // Member types.
+        using _ctrl_allocator_type = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<hash_ctrl>;
+
+        // Member variables.
+        [[no_unique_address]] Hash _hash;
+        [[no_unique_address]] KeyEqual _eq;
+        [[no_unique_address]] Allocator _allocator;
+        hash_ctrl* _ctrl;
+        value_type* _slots;
+        size_type _capacity;
+        size_type _size;
+        size_type _growth_left;
+
+    public:
+        // Constructor.
+        constexpr hash_table()
+        noexcept(noexcept(Hash()) && noexcept(KeyEqual()) &&
+            noexcept(Allocator()))
+        :
+            hash_table(Allocator())
+        {}
+
+        // Constructor.
+        explicit constexpr hash_table(const Allocator& allocator) noexcept
+        :
+            hash_table(0, Hash(), KeyEqual(), allocator)
+        {}
+
+        // Constructor.
+        // Reserves room for `count` elements.
+        explicit constexpr hash_table(
+            size_type count,
+            const Hash& hash = Hash(),
+            const KeyEqual& equal = KeyEqual(),
+            const Allocator& allocator = Allocator())
+        :
+            _hash{hash},
+            _eq{equal},
+            _allocator{allocator},
+            _ctrl{nullptr},
+            _slots{nullptr},
+            _capacity{0},
+            _size{0},
+            _growth_left{0}
+        {
+            reserve(count);
+        }
+
+        // Constructor.
+        template<
+            typename InputIterator>
+        requires std::is_base_of_v<
+            std::input_iterator_tag,
+            typename std::iterator_traits<InputIterator>::iterator_category>
+        constexpr hash_table(
+            InputIterator first,
+            InputIterator last,
+            size_type count = 0,
+            const Hash& hash = Hash(),
+            const KeyEqual& equal = KeyEqual(),
+            const Allocator& allocator = Allocator())
+        :
+            hash_table(count, hash, equal, allocator)
+        {
+            insert(first, last);
+        }
+
+        // Constructor.
+        constexpr hash_table(
+            std::initializer_list<value_type> il,
+            size_type count = 0,
+            const Hash& hash = Hash(),
+            const KeyEqual& equal = KeyEqual(),
+            const Allocator& allocator = Allocator())
+        :
+            hash_table(il.begin(), il.end(), count, hash, equal, allocator)
+        {}
+
+        // Constructor.
+        constexpr hash_table(const hash_table& other)
+        :
+            hash_table(0, other._hash, other._eq,
+                std::allocator_traits<Allocator>::
+                    select_on_container_copy_construction(other._allocator))
+        {
+            _copy_from(other);
+        }
+
+        // Constructor.
+        constexpr hash_table(hash_table&& other) noexcept
+        :
+            _hash{std::move(other._hash)},
+            _eq{std::move(other._eq)},
+            _allocator{std::move(other._allocator)},
+            _ctrl{std::exchange(other._ctrl, nullptr)},
+            _slots{std::exchange(other._slots, nullptr)},
+            _capacity{std::exchange(other._capacity, 0)},
+            _size{std::exchange(other._size, 0)},
+            _growth_left{std::exchange(other._growth_left, 0)}
+        {}
+
+        // Destructor.
+        constexpr ~hash_table()
+        {
+            _reset();
+        }
+
+        // Assignment.
+        constexpr hash_table& operator=(const hash_table& other)
+        {
+            if (&other == this)
+            {
+                return *this;
+            }
+
+            if constexpr (
+                std::allocator_traits<Allocator>::
+                    propagate_on_container_copy_assignment::value)
+            {
+                if constexpr (
+                    !std::allocator_traits<Allocator>::is_always_equal::value)
+                {
+                    if (_allocator != other._allocator)
+                    {
+                        // Free old memory since we have a different allocator.
+                        _reset();
+                    }
+                }
+                _allocator = other._allocator;
+            }
+
+            _hash = other._hash;
+            _eq = other._eq;
+            clear();
+            _copy_from(other);
+            return *this;
+        }
+
+        // Assignment.
+        constexpr hash_table& operator=(
+            hash_table&& other)
+        noexcept(
+            std::allocator_traits<Allocator>::
+                propagate_on_container_move_assignment::value ||
+            std::allocator_traits<Allocator>::
+                is_always_equal::value)
+        {
+            if (&other == this)
+            {
+                // No-op.
+            }
+            else if constexpr (
+                std::allocator_traits<Allocator>::
+                    propagate_on_container_move_assignment::value)
+            {
+                _reset();
+                _allocator = std::move(other._allocator);
+                _take_buffer(other);
+            }
+            else if constexpr (
+                std::allocator_traits<Allocator>::is_always_equal::value)
+            {
+                _reset();
+                _take_buffer(other);
+            }
+            else if (_allocator == other._allocator)
+            {
+                _reset();
+                _take_buffer(other);
+            }
+            else
+            {
+                // Element-wise move since we have a different allocator.
+                _hash = other._hash;
+                _eq = other._eq;
+                clear();
+                reserve(other._size);
+                for (auto& v : other)
+                {
+                    _emplace_unique(_hash_of(Policy::key(v)), std::move(v));
+                }
+                other.clear();
+            }
+
+            return *this;
+        }
+
+        // Assignment.
+        constexpr hash_table& operator=(std::initializer_list<value_type> il)
+        {
+            clear();
+            insert(il);
+            return *this;
+        }
+
+        // Get allocator.
+        constexpr allocator_type get_allocator() const noexcept
+        {
+            return _allocator;
+        }
+
+        // Hash function.
+        constexpr hasher hash_function() const
+        {
+            return _hash;
+        }
+
+        // Key equality.
+        constexpr key_equal key_eq() const
+        {
+            return _eq;
+        }
+
+        // Begin.
+        constexpr iterator begin() noexcept
+        {
+            return _begin<iterator>(*this);
+        }
+
+        // Begin.
+        constexpr const_iterator begin() const noexcept
+        {
+            return _begin<const_iterator>(*this);
+        }
+
+        // End.
+        constexpr iterator end() noexcept
+        {
+            return _iterator_at(_capacity);
+        }
+
+        // End.
+        constexpr const_iterator end() const noexcept
+        {
+            return _iterator_at(_capacity);
+        }
+
+        // Const begin.
+        constexpr const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        // Const end.
+        constexpr const_iterator cend() const noexcept
+        {
+            return end();
+        }
+
+        // Empty.
+        [[nodiscard]] constexpr bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        // Size.
+        constexpr size_type size() const noexcept
+        {
+            return _size;
+        }
+
+        // Max size.
+        constexpr size_type max_size() const noexcept
+        {
+            auto slots = std::allocator_traits<Allocator>::max_size(
+                _allocator);
+            auto ctrl = std::allocator_traits<_ctrl_allocator_type>::max_size(
+                _ctrl_allocator_type(_allocator));
+            return size_type((std::min)(
+                std::size_t(slots),
+                std::size_t(ctrl) - hash_group_width));
+        }
+
+        // Capacity.
+        // Number of slots. At most 7/8 of them get filled before growing.
+        constexpr size_type capacity() const noexcept
+        {
+            return _capacity;
+        }
+
+        // Reserve.
+        // Makes room for `count` elements without growing.
+        constexpr void reserve(size_type count)
+        {
+            if (count > _size + _growth_left)
+            {
+                _resize(_capacity_for(count));
+            }
+        }
+
+        // Rehash.
+        // Rebuilds with at least `count` slots, dropping deleted ones.
+        constexpr void rehash(size_type count)
+        {
+            auto new_capacity = (std::max)(
+                _normalize_capacity(count),
+                _capacity_for(_size));
+
+            if (new_capacity != 0 || _capacity != 0)
+            {
+                _resize(new_capacity);
+            }
+        }
+
+        // Clear.
+        // Keeps the capacity.
+        constexpr void clear() noexcept
+        {
+            if (_capacity == 0)
+            {
+                return;
+            }
+
+            _destroy_all();
+            _reset_ctrl();
+            _size = 0;
+            _growth_left = _growth(_capacity);
+        }
+
+        // Insert.
+        constexpr std::pair<iterator, bool> insert(const value_type& value)
+        {
+            return _insert(value);
+        }
+
+        // Insert.
+        constexpr std::pair<iterator, bool> insert(value_type&& value)
+        {
+            return _insert(std::move(value));
+        }
+
+        // Insert.
+        template<
+            typename InputIterator>
+        requires std::is_base_of_v<
+            std::input_iterator_tag,
+            typename std::iterator_traits<InputIterator>::iterator_category>
+        constexpr void insert(InputIterator first, InputIterator last)
+        {
+            if constexpr (std::is_base_of_v<
+                std::forward_iterator_tag,
+                typename std::iterator_traits<InputIterator>::
+                    iterator_category>)
+            {
+                auto d = std::distance(first, last);
+                auto u = std::make_unsigned_t<decltype(d)>(d);
+                gdt_assert(u <= max_size() - _size);
+                reserve(size_type(_size + u));
+            }
+
+            for (; first != last; ++first)
+            {
+                _insert(*first);
+            }
+        }
+
+        // Insert.
+        constexpr void insert(std::initializer_list<value_type> il)
+        {
+            insert(il.begin(), il.end());
+        }
+
+        // Emplace.
+        // Constructs the value up front to get its key.
+        template<typename... Args>
+        constexpr std::pair<iterator, bool> emplace(Args&&... args)
+        {
+            value_type value(std::forward<Args>(args)...);
+            return _insert(std::move(value));
+        }
+
+        // Erase.
+        // Returns an iterator to the next element.
+        constexpr iterator erase(const_iterator position)
+        {
+            gdt_assume(position != cend());
+
+            auto i = size_type(position._ctrl - _ctrl);
+            _erase_at(i);
+
+            auto ret = _iterator_at(i);
+            ret._skip_empty_or_deleted();
+            return ret;
+        }
+
+        // Erase.
+        // Returns the number of elements erased.
+        constexpr size_type erase(const key_type& key)
+        {
+            auto i = _find(key, _hash_of(key));
+            if (i == _capacity)
+            {
+                return 0;
+            }
+
+            _erase_at(i);
+            return 1;
+        }
+
+        // Swap.
+        constexpr void swap(hash_table& other)
+        noexcept(
+            std::allocator_traits<Allocator>::
+                propagate_on_container_swap::value ||
+            std::allocator_traits<Allocator>::
+                is_always_equal::value)
+        {
+            using std::swap;
+
+            if constexpr (
+                std::allocator_traits<Allocator>::
+                    propagate_on_container_swap::value)
+            {
+                swap(_allocator, other._allocator);
+            }
+            else
+            {
+                gdt_assume(_allocator == other._allocator);
+            }
+
+            swap(_hash, other._hash);
+            swap(_eq, other._eq);
+            swap(_ctrl, other._ctrl);
+            swap(_slots, other._slots);
+            swap(_capacity, other._capacity);
+            swap(_size, other._size);
+            swap(_growth_left, other._growth_left);
+        }
+
+        // Swap.
+        friend constexpr void swap(hash_table& lhs, hash_table& rhs)
+        noexcept(noexcept(lhs.swap(rhs)))
+        {
+            lhs.swap(rhs);
+        }
+
+        // Find.
+        constexpr iterator find(const key_type& key)
+        {
+            return _iterator_at(_find(key, _hash_of(key)));
+        }
+
+        // Find.
+        constexpr const_iterator find(const key_type& key) const
+        {
+            return _iterator_at(_find(key, _hash_of(key)));
+        }
+
+        // Contains.
+        constexpr bool contains(const key_type& key) const
+        {
+            return _find(key, _hash_of(key)) != _capacity;
+        }
+
+        // Count.
+        constexpr size_type count(const key_type& key) const
+        {
+            return size_type(contains(key));
+        }
+
+        // Equality.
+        // Same elements, regardless of order.
+        friend constexpr bool operator==(
+            const hash_table& lhs,
+            const hash_table& rhs)
+        {
+            if (lhs._size != rhs._size)
+            {
+                return false;
+            }
+
+            for (auto& v : lhs)
+            {
+                auto it = rhs.find(Policy::key(v));
+                if (it == rhs.end() || !(*it == v))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+    protected:
+        // Where to find or insert a key.
+        struct _slot_for
+        {
+            size_type index;
+            std::uint64_t hash;
+            bool found;
+        };
+
+        // Find `key`, or make room for it.
+        constexpr _slot_for _find_or_prepare_insert(const key_type& key)
+        {
+            auto h = _hash_of(key);
+            auto i = _find(key, h);
+            if (i != _capacity)
+            {
+                return {i, h, true};
+            }
+
+            return {_prepare_insert(h), h, false};
+        }
+
+        // Construct a value in a slot from `_find_or_prepare_insert`.
+        template<typename... Args>
+        constexpr iterator _construct_at(const _slot_for& slot, Args&&... args)
+        {
+            gdt_assume(!slot.found);
+            _construct(_slots + slot.index, std::forward<Args>(args)...);
+            _commit_insert(slot.index, slot.hash);
+            return _iterator_at(slot.index);
+        }
+
+        // Iterator at slot `i`.
+        constexpr iterator _iterator_at(size_type i) noexcept
+        {
+            return iterator(_ctrl + i, _slots + i);
+        }
+
+        // Iterator at slot `i`.
+        constexpr const_iterator _iterator_at(size_type i) const noexcept
+        {
+            return const_iterator(_ctrl + i, _slots + i);
+        }
+
+    private:
+        // Friends.
+        template<typename> friend class hash_table_iterator;
+
+        // Begin.
+        template<typename Iterator, typename Self>
+        static constexpr Iterator _begin(Self& self) noexcept
+        {
+            if (self._capacity == 0)
+            {
+                return self.end();
+            }
+
+            Iterator ret = self._iterator_at(0);
+            ret._skip_empty_or_deleted();
+            return ret;
+        }
+
+        // Hash of a key.
+        constexpr std::uint64_t _hash_of(const key_type& key) const
+        {
+            return hash_mix(std::uint64_t(_hash(key)));
+        }
+
+        // Control byte for a full slot with hash `h`.
+        static constexpr hash_ctrl _h2(std::uint64_t h) noexcept
+        {
+            return hash_ctrl(h & 0x7f);
+        }
+
+        // Most elements that fit in `capacity` slots.
+        // Leaves at least one empty slot per 8 so probes stop. A full table
+        // of 7 would have no empty control bytes in an 8-wide group.
+        static constexpr size_type _growth(size_type capacity) noexcept
+        {
+            return capacity == 7 ? 6 : size_type(capacity - capacity / 8);
+        }
+
+        // Smallest valid capacity >= `count`.
+        constexpr size_type _normalize_capacity(size_type count) const
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+
+            gdt_assert(count <= max_size() / 2);
+            return size_type(std::bit_ceil(std::size_t(count) + 1) - 1);
+        }
+
+        // Smallest valid capacity that fits `count` elements.
+        constexpr size_type _capacity_for(size_type count) const
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+
+            gdt_assert(count <= max_size() / 2);
+            auto capacity = _normalize_capacity(
+                size_type(count + (count - 1) / 7));
+            if (_growth(capacity) < count)
+            {
+                capacity = size_type(capacity * 2 + 1);
+            }
+            return capacity;
+        }
+
+        // Find `key`. Returns `_capacity` if it's not there.
+        constexpr size_type _find(const key_type& key, std::uint64_t h) const
+        {
+            if (std::is_constant_evaluated())
+            {
+                return _find<hash_group_portable>(key, h);
+            }
+            else
+            {
+                return _find<hash_group>(key, h);
+            }
+        }
+
+        // Find `key` one `Group` at a time.
+        template<typename Group>
+        constexpr size_type _find(const key_type& key, std::uint64_t h) const
+        {
+            if (_capacity == 0)
+            {
+                return 0;
+            }
+
+            hash_probe<size_type, Group::width> seq(h >> 7, _capacity);
+            while (true)
+            {
+                Group g(_ctrl + seq.offset());
+                for (auto m = g.match(_h2(h)); m; m.pop())
+                {
+                    auto i = seq.offset(m.lowest());
+                    if (_eq(Policy::key(_slots[i]), key))
+                    {
+                        return i;
+                    }
+                }
+
+                if (g.match_empty())
+                {
+                    return _capacity;
+                }
+
+                seq.next();
+            }
+        }
+
+        // First empty or deleted slot on the probe sequence for `h`.
+        constexpr size_type _find_first_non_full(std::uint64_t h) const
+        {
+            if (std::is_constant_evaluated())
+            {
+                return _find_first_non_full<hash_group_portable>(h);
+            }
+            else
+            {
+                return _find_first_non_full<hash_group>(h);
+            }
+        }
+
+        // First empty or deleted slot, one `Group` at a time.
+        template<typename Group>
+        constexpr size_type _find_first_non_full(std::uint64_t h) const
+        {
+            hash_probe<size_type, Group::width> seq(h >> 7, _capacity);
+            while (true)
+            {
+                auto m = Group(_ctrl + seq.offset()).match_empty_or_deleted();
+                if (m)
+                {
+                    return seq.offset(m.lowest());
+                }
+
+                seq.next();
+            }
+        }
+
+        // Slot to insert a new element with hash `h` into.
+        // Grows first if that would take the last empty slot.
+        constexpr size_type _prepare_insert(std::uint64_t h)
+        {
+            if (_capacity != 0)
+            {
+                auto i = _find_first_non_full(h);
+                if (_growth_left != 0 || _ctrl[i] == hash_ctrl_deleted)
+                {
+                    return i;
+                }
+            }
+
+            _grow();
+            return _find_first_non_full(h);
+        }
+
+        // Mark slot `i` full after constructing its element.
+        constexpr void _commit_insert(size_type i, std::uint64_t h) noexcept
+        {
+            _growth_left = size_type(
+                _growth_left - (_ctrl[i] == hash_ctrl_empty));
+            _set_ctrl(i, _h2(h));
+            _size += 1;
+        }
+
+        // Insert a value unless its key is already there.
+        template<typename Value>
+        constexpr std::pair<iterator, bool> _insert(Value&& value)
+        {
+            auto slot = _find_or_prepare_insert(Policy::key(value));
+            if (slot.found)
+            {
+                return {_iterator_at(slot.index), false};
+            }
+
+            return {_construct_at(slot, std::forward<Value>(value)), true};
+        }
+
+        // Insert a value whose key isn't already there.
+        template<typename... Args>
+        constexpr void _emplace_unique(std::uint64_t h, Args&&... args)
+        {
+            auto i = _prepare_insert(h);
+            _construct(_slots + i, std::forward<Args>(args)...);
+            _commit_insert(i, h);
+        }
+
+        // Copy another table's elements into this empty one.
+        constexpr void _copy_from(const hash_table& other)
+        {
+            gdt_assume(_size == 0);
+            reserve(other._size);
+            for (auto& v : other)
+            {
+                _emplace_unique(_hash_of(Policy::key(v)), v);
+            }
+        }
+
+        // Destroy the element in slot `i` and free the slot.
+        constexpr void _erase_at(size_type i)
+        {
+            _destroy(_slots + i);
+            if (std::is_constant_evaluated())
+            {
+                _erase_ctrl<hash_group_portable>(i);
+            }
+            else
+            {
+                _erase_ctrl<hash_group>(i);
+            }
+            _size -= 1;
+        }
+
+        // Free slot `i`. It can go back to empty instead of deleted if no
+        // probe could have passed over it, i.e. there's no run of a whole
+        // `Group` of non-empty slots through it.
+        template<typename Group>
+        constexpr void _erase_ctrl(size_type i) noexcept
+        {
+            auto before = size_type((i - Group::width) & _capacity);
+            auto empty_after = Group(_ctrl + i).match_empty();
+            auto empty_before = Group(_ctrl + before).match_empty();
+
+            bool was_never_full =
+                empty_before && empty_after &&
+                empty_after.lowest() + empty_before.lanes_after_highest() <
+                    Group::width;
+
+            _set_ctrl(i, was_never_full ? hash_ctrl_empty : hash_ctrl_deleted);
+            _growth_left = size_type(_growth_left + was_never_full);
+        }
+
+        // Set the control byte of slot `i` and its clone.
+        // Tables smaller than a group write their clone back over `i`.
+        constexpr void _set_ctrl(size_type i, hash_ctrl c) noexcept
+        {
+            constexpr std::size_t cloned = hash_group_width - 1;
+            _ctrl[i] = c;
+            _ctrl[((std::size_t(i) - cloned) & _capacity) +
+                (cloned & _capacity)] = c;
+        }
+
+        // Mark every slot empty.
+        constexpr void _reset_ctrl() noexcept
+        {
+            std::fill_n(
+                _ctrl,
+                std::size_t(_capacity) + hash_group_width,
+                hash_ctrl_empty);
+            _ctrl[_capacity] = hash_ctrl_sentinel;
+        }
+
+        // Grow to make room for another element.
+        // Rebuilds at the same capacity instead if the table is
+        // under 25/32 full and deleted slots are taking up the rest.
+        constexpr void _grow()
+        {
+            if (_capacity == 0)
+            {
+                _resize(1);
+            }
+            else if (
+                std::uint64_t(_size) * 32 <= std::uint64_t(_capacity) * 25)
+            {
+                _resize(_capacity);
+            }
+            else
+            {
+                gdt_assert(_capacity <= max_size() / 2);
+                _resize(size_type(_capacity * 2 + 1));
+            }
+        }
+
+        // Move every element to a table with `new_capacity` slots.
+        constexpr void _resize(size_type new_capacity)
+        {
+            gdt_assume(_growth(new_capacity) >= _size);
+
+            auto old_ctrl = _ctrl;
+            auto old_slots = _slots;
+            auto old_capacity = _capacity;
+
+            _allocate(new_capacity);
+            _growth_left = size_type(_growth(new_capacity) - _size);
+
+            for (size_type i = 0; i < old_capacity; ++i)
+            {
+                if (old_ctrl[i] >= 0)
+                {
+                    auto h = _hash_of(Policy::key(old_slots[i]));
+                    auto j = _find_first_non_full(h);
+                    _set_ctrl(j, _h2(h));
+                    _relocate(old_slots + i, _slots + j);
+                }
+            }
+
+            _deallocate(old_ctrl, old_slots, old_capacity);
+        }
+
+        // Allocate control bytes and slots for `capacity` elements.
+        constexpr void _allocate(size_type capacity)
+        {
+            if (capacity == 0)
+            {
+                _ctrl = nullptr;
+                _slots = nullptr;
+                _capacity = 0;
+                return;
+            }
+
+            _ctrl_allocator_type ctrl_allocator(_allocator);
+            _ctrl = std::allocator_traits<_ctrl_allocator_type>::allocate(
+                ctrl_allocator,
+                size_type(capacity + hash_group_width));
+            _slots = std::allocator_traits<Allocator>::allocate(
+                _allocator, capacity);
+            _capacity = capacity;
+            _reset_ctrl();
+        }
+
+        // Deallocate control bytes and slots.
+        constexpr void _deallocate(
+            hash_ctrl* ctrl,
+            value_type* slots,
+            size_type capacity) noexcept
+        {
+            if (capacity == 0)
+            {
+                return;
+            }
+
+            _ctrl_allocator_type ctrl_allocator(_allocator);
+            std::allocator_traits<_ctrl_allocator_type>::deallocate(
+                ctrl_allocator,
+                ctrl,
+                size_type(capacity + hash_group_width));
+            std::allocator_traits<Allocator>::deallocate(
+                _allocator, slots, capacity);
+        }
+
+        // Destroy every element and free the buffers.
+        constexpr void _reset() noexcept
+        {
+            _destroy_all();
+            _deallocate(_ctrl, _slots, _capacity);
+            _ctrl = nullptr;
+            _slots = nullptr;
+            _capacity = 0;
+            _size = 0;
+            _growth_left = 0;
+        }
+
+        // Take ownership of another table's buffers.
+        constexpr void _take_buffer(hash_table& other) noexcept
+        {
+            _hash = other._hash;
+            _eq = other._eq;
+            _ctrl = std::exchange(other._ctrl, nullptr);
+            _slots = std::exchange(other._slots, nullptr);
+            _capacity = std::exchange(other._capacity, 0);
+            _size = std::exchange(other._size, 0);
+            _growth_left = std::exchange(other._growth_left, 0);
+        }
+
+        // Construct using allocator.
+        template<typename... Args>
+        constexpr void _construct(value_type* p, Args&&... args)
+        {
+            std::allocator_traits<Allocator>::construct(
+                _allocator, p, std::forward<Args>(args)...);
+        }
+
+        // Destroy using allocator.
+        constexpr void _destroy(value_type* p) noexcept
+        {
+            std::allocator_traits<Allocator>::destroy(_allocator, p);
+        }
+
+        // Destroy every element.
+        constexpr void _destroy_all() noexcept
+        {
+            if constexpr (!is_trivially_destroyable<Allocator, value_type>)
+            {
+                for (size_type i = 0; i < _capacity; ++i)
+                {
+                    if (_ctrl[i] >= 0)
+                    {
+                        _destroy(_slots + i);
+                    }
+                }
+            }
+        }
+
+        // Move an element to an unconstructed slot.
+        constexpr void _relocate(value_type* src, value_type* dst)
+        {
+            if constexpr (is_memcpy_relocatable<Allocator, value_type>)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    std::memcpy(
+                        static_cast<void*>(dst),
+                        static_cast<const void*>(src),
+                        sizeof(value_type));
+                    return;
+                }
+            }
+
+            _construct(dst, std::move(*src));
+            _destroy(src);
+        }
+    };
+
+    // Hash table iterator.
+    // `V` is a possibly const value type.
+    template<typename V>
+    class hash_table_iterator
+    {
+    public:
+        // Member types.
+        using value_type = std::remove_const_t<V>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = V*;
+        using reference = V&;
+        using iterator_category = std::forward_iterator_tag;
+
+        // Constructor.
+        constexpr hash_table_iterator() = default;
+
+        // Constructor.
+        template<typename U>
+        requires (std::is_const_v<V> && std::is_same_v<const U, V>)
+        constexpr hash_table_iterator(const hash_table_iterator<U>& other)
+        noexcept
+        :
+            _ctrl{other._ctrl},
+            _slot{other._slot}
+        {}
+
+        // Dereference.
+        constexpr reference operator*() const
+        {
+            gdt_assume(*_ctrl >= 0);
+            return *_slot;
+        }
+
+        // Member access.
+        constexpr pointer operator->() const
+        {
+            gdt_assume(*_ctrl >= 0);
+            return _slot;
+        }
+
+        // Pre-increment.
+        constexpr hash_table_iterator& operator++()
+        {
+            ++_ctrl;
+            ++_slot;
+            _skip_empty_or_deleted();
+            return *this;
+        }
+
+        // Post-increment.
+        constexpr hash_table_iterator operator++(int)
+        {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        // Equality.
+        friend constexpr bool operator==(
+            const hash_table_iterator& lhs,
+            const hash_table_iterator& rhs)
+        {
+            return lhs._ctrl == rhs._ctrl;
+        }
+
+    private:
+        // Friends.
+        template<typename, typename, typename, typename>
+        friend class hash_table;
+        template<typename> friend class hash_table_iterator;
+
+        // Member variables.
+        const hash_ctrl* _ctrl = nullptr;
+        V* _slot = nullptr;
+
+        // Constructor.
+        constexpr hash_table_iterator(const hash_ctrl* ctrl, V* slot) noexcept
+        :
+            _ctrl{ctrl},
+            _slot{slot}
+        {}
+
+        // Move forward to a full slot or the sentinel.
+        constexpr void _skip_empty_or_deleted() noexcept
+        {
+            while (*_ctrl < hash_ctrl_sentinel)
+            {
+                ++_ctrl;
+                ++_slot;
+            }
+        }
+    };
+}
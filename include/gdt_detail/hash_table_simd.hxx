@@ -0,0 +1,224 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "vec_simd.hxx"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace gdt_detail
+{
+    // Control byte of a hash table slot.
+    // Full slots hold the low 7 bits of their hash, so they're never
+    // negative. The sentinel marks the end of the slots for iterators.
+    using hash_ctrl = std::int8_t;
+    inline constexpr hash_ctrl hash_ctrl_empty = -128;
+    inline constexpr hash_ctrl hash_ctrl_deleted = -2;
+    inline constexpr hash_ctrl hash_ctrl_sentinel = -1;
+
+    // Matching control bytes in a group, lowest first.
+    // Each lane is `1 << Shift` bits wide with at most one of them set.
+    template<typename T, int Shift>
+    class hash_bitmask
+    {
+    public:
+        // Constructor.
+        explicit constexpr hash_bitmask(T mask) noexcept
+        :
+            _mask{mask}
+        {}
+
+        // Any matches?
+        explicit constexpr operator bool() const noexcept
+        {
+            return _mask != 0;
+        }
+
+        // Lowest match.
+        constexpr std::size_t lowest() const noexcept
+        {
+            return std::size_t(std::countr_zero(_mask) >> Shift);
+        }
+
+        // Drop the lowest match.
+        constexpr void pop() noexcept
+        {
+            _mask &= T(_mask - 1);
+        }
+
+        // Lanes after the highest match.
+        // The whole group if there are none, like `lowest()`.
+        constexpr std::size_t lanes_after_highest() const noexcept
+        {
+            return std::size_t(std::countl_zero(_mask) >> Shift);
+        }
+
+    private:
+        // Member variables.
+        T _mask;
+    };
+
+    // Group of 8 control bytes in a 64-bit word.
+    // Works everywhere, including constant evaluation.
+    class hash_group_portable
+    {
+    public:
+        // Member types.
+        using mask = hash_bitmask<std::uint64_t, 3>;
+
+        // Width.
+        static constexpr std::size_t width = 8;
+
+        // Constructor.
+        explicit constexpr hash_group_portable(const hash_ctrl* ctrl) noexcept
+        :
+            _ctrl{0}
+        {
+            for (std::size_t i = 0; i < width; ++i)
+            {
+                _ctrl |= std::uint64_t(std::uint8_t(ctrl[i])) << (i * 8);
+            }
+        }
+
+        // Full slots with the given hash bits.
+        // May have false positives past a true match, which the key
+        // comparison weeds out.
+        constexpr mask match(hash_ctrl h2) const noexcept
+        {
+            auto x = _ctrl ^ (_lsbs * std::uint8_t(h2));
+            return mask((x - _lsbs) & ~x & _msbs);
+        }
+
+        // Empty slots.
+        constexpr mask match_empty() const noexcept
+        {
+            return mask(_ctrl & ~(_ctrl << 6) & _msbs);
+        }
+
+        // Empty or deleted slots.
+        constexpr mask match_empty_or_deleted() const noexcept
+        {
+            return mask(_ctrl & ~(_ctrl << 7) & _msbs);
+        }
+
+    private:
+        // Constants.
+        static constexpr std::uint64_t _lsbs = 0x0101010101010101;
+        static constexpr std::uint64_t _msbs = 0x8080808080808080;
+
+        // Member variables.
+        std::uint64_t _ctrl;
+    };
+
+#if defined(GDT_SIMD_SSE2)
+    // Group of 16 control bytes in an SSE2 register.
+    class hash_group_sse2
+    {
+    public:
+        // Member types.
+        using mask = hash_bitmask<std::uint16_t, 0>;
+
+        // Width.
+        static constexpr std::size_t width = 16;
+
+        // Constructor.
+        explicit hash_group_sse2(const hash_ctrl* ctrl) noexcept
+        :
+            _ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))}
+        {}
+
+        // Full slots with the given hash bits.
+        mask match(hash_ctrl h2) const noexcept
+        {
+            return _movemask(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl));
+        }
+
+        // Empty slots.
+        mask match_empty() const noexcept
+        {
+            auto empty = _mm_set1_epi8(hash_ctrl_empty);
+            return _movemask(_mm_cmpeq_epi8(empty, _ctrl));
+        }
+
+        // Empty or deleted slots.
+        mask match_empty_or_deleted() const noexcept
+        {
+            auto sentinel = _mm_set1_epi8(hash_ctrl_sentinel);
+            return _movemask(_mm_cmpgt_epi8(sentinel, _ctrl));
+        }
+
+    private:
+        // Mask from the top bit of each byte.
+        static mask _movemask(__m128i m) noexcept
+        {
+            return mask(std::uint16_t(_mm_movemask_epi8(m)));
+        }
+
+        // Member variables.
+        __m128i _ctrl;
+    };
+
+    using hash_group = hash_group_sse2;
+#elif defined(GDT_SIMD_NEON)
+    // Group of 8 control bytes in a NEON register.
+    // NEON has no movemask, but a 64-bit lane of byte masks does as well.
+    class hash_group_neon
+    {
+    public:
+        // Member types.
+        using mask = hash_bitmask<std::uint64_t, 3>;
+
+        // Width.
+        static constexpr std::size_t width = 8;
+
+        // Constructor.
+        explicit hash_group_neon(const hash_ctrl* ctrl) noexcept
+        :
+            _ctrl{vld1_s8(ctrl)}
+        {}
+
+        // Full slots with the given hash bits.
+        mask match(hash_ctrl h2) const noexcept
+        {
+            return _movemask(vceq_s8(vdup_n_s8(h2), _ctrl));
+        }
+
+        // Empty slots.
+        mask match_empty() const noexcept
+        {
+            return _movemask(vceq_s8(vdup_n_s8(hash_ctrl_empty), _ctrl));
+        }
+
+        // Empty or deleted slots.
+        mask match_empty_or_deleted() const noexcept
+        {
+            return _movemask(vcgt_s8(vdup_n_s8(hash_ctrl_sentinel), _ctrl));
+        }
+
+    private:
+        // Mask from the top bit of each byte.
+        static mask _movemask(uint8x8_t m) noexcept
+        {
+            auto bits = vget_lane_u64(vreinterpret_u64_u8(m), 0);
+            return mask(bits & 0x8080808080808080);
+        }
+
+        // Member variables.
+        int8x8_t _ctrl;
+    };
+
+    using hash_group = hash_group_neon;
+#else
+    using hash_group = hash_group_portable;
+#endif
+
+    // Widest group. Tables clone their first `hash_group_width - 1`
+    // control bytes after the sentinel so groups can be loaded at any slot.
+    inline constexpr std::size_t hash_group_width =
+        hash_group::width > hash_group_portable::width ?
+        hash_group::width : hash_group_portable::width;
+}
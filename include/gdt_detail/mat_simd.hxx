@@ -0,0 +1,276 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "vec_simd.hxx"
+#include <cstddef>
+
+namespace gdt_detail
+{
+    // 4x4 float matrix kernels are available.
+    // Matrices are 16 contiguous floats in column-major order.
+#if defined(GDT_SIMD_SSE2) || defined(GDT_SIMD_NEON)
+    constexpr bool has_simd_mat4 = true;
+#else
+    constexpr bool has_simd_mat4 = false;
+#endif
+
+#if defined(GDT_SIMD_SSE2)
+    // m * v for the columns of `m` and a vector in a register.
+    inline __m128 sse2_mat4_mul_vec(const __m128 (&m)[4], __m128 v) noexcept
+    {
+        // Accumulate in column order to match the scalar code exactly.
+        auto x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+        auto y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+        auto z = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+        auto w = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+        auto ret = _mm_mul_ps(m[0], x);
+        ret = _mm_add_ps(ret, _mm_mul_ps(m[1], y));
+        ret = _mm_add_ps(ret, _mm_mul_ps(m[2], z));
+        return _mm_add_ps(ret, _mm_mul_ps(m[3], w));
+    }
+
+    // Load the columns of `m`.
+    inline void sse2_mat4_load(__m128 (&ret)[4], const float* m) noexcept
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            ret[c] = _mm_loadu_ps(m + 4 * c);
+        }
+    }
+
+    // out = a * b.
+    inline void simd_mat4_mul(float* out, const float* a, const float* b)
+    noexcept
+    {
+        __m128 ma[4];
+        sse2_mat4_load(ma, a);
+
+        __m128 ret[4];
+        for (int c = 0; c < 4; ++c)
+        {
+            ret[c] = sse2_mat4_mul_vec(ma, _mm_loadu_ps(b + 4 * c));
+        }
+
+        for (int c = 0; c < 4; ++c)
+        {
+            _mm_storeu_ps(out + 4 * c, ret[c]);
+        }
+    }
+
+    // out = m * v.
+    inline void simd_mat4_mul_vec(float* out, const float* m, const float* v)
+    noexcept
+    {
+        __m128 mm[4];
+        sse2_mat4_load(mm, m);
+        _mm_storeu_ps(out, sse2_mat4_mul_vec(mm, _mm_loadu_ps(v)));
+    }
+
+    // out[i] = m * in[i] for `n` vec4s.
+    inline void simd_mat4_transform4(
+        float* out,
+        const float* m,
+        const float* in,
+        std::size_t n)
+    noexcept
+    {
+        __m128 mm[4];
+        sse2_mat4_load(mm, m);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto v = _mm_loadu_ps(in + 4 * i);
+            _mm_storeu_ps(out + 4 * i, sse2_mat4_mul_vec(mm, v));
+        }
+    }
+
+    // out[i] = (m * vec4(in[i], W)).xyz for `n` vec3s.
+    // Transforms 4 at a time, transposed so each register holds one
+    // component. Returns how many it transformed; the caller does the rest.
+    template<bool W>
+    inline std::size_t simd_mat4_transform3(
+        float* out,
+        const float* m,
+        const float* in,
+        std::size_t n)
+    noexcept
+    {
+        __m128 e[4][3];
+        for (int c = 0; c < 4; ++c)
+        {
+            for (int r = 0; r < 3; ++r)
+            {
+                e[c][r] = _mm_set1_ps(m[4 * c + r]);
+            }
+        }
+
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            // [x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3] -> x, y, z.
+            auto a = _mm_loadu_ps(in + 3 * i);
+            auto b = _mm_loadu_ps(in + 3 * i + 4);
+            auto c = _mm_loadu_ps(in + 3 * i + 8);
+            auto t = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+            auto u = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+            auto v = _mm_shuffle_ps(b, c, _MM_SHUFFLE(3, 0, 1, 1));
+            auto x = _mm_shuffle_ps(a, t, _MM_SHUFFLE(2, 0, 3, 0));
+            auto y = _mm_shuffle_ps(u, t, _MM_SHUFFLE(3, 1, 2, 0));
+            auto z = _mm_shuffle_ps(u, v, _MM_SHUFFLE(3, 2, 3, 1));
+
+            __m128 ret[3];
+            for (int r = 0; r < 3; ++r)
+            {
+                ret[r] = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(e[0][r], x), _mm_mul_ps(e[1][r], y)),
+                    _mm_mul_ps(e[2][r], z));
+                if constexpr (W)
+                {
+                    ret[r] = _mm_add_ps(ret[r], e[3][r]);
+                }
+            }
+
+            // x, y, z -> [x0 y0 z0 x1] [y1 z1 x2 y2] [z2 x3 y3 z3].
+            auto xy_lo = _mm_unpacklo_ps(ret[0], ret[1]);
+            auto xy_hi = _mm_unpackhi_ps(ret[0], ret[1]);
+            auto s1 = _mm_shuffle_ps(ret[2], xy_lo, _MM_SHUFFLE(3, 2, 1, 0));
+            auto s2 = _mm_shuffle_ps(ret[2], xy_hi, _MM_SHUFFLE(3, 2, 3, 2));
+            _mm_storeu_ps(
+                out + 3 * i,
+                _mm_shuffle_ps(xy_lo, s1, _MM_SHUFFLE(2, 0, 1, 0)));
+            _mm_storeu_ps(
+                out + 3 * i + 4,
+                _mm_shuffle_ps(s1, xy_hi, _MM_SHUFFLE(1, 0, 1, 3)));
+            _mm_storeu_ps(
+                out + 3 * i + 8,
+                _mm_shuffle_ps(s2, s2, _MM_SHUFFLE(1, 3, 2, 0)));
+        }
+
+        return i;
+    }
+#endif
+
+#if defined(GDT_SIMD_NEON)
+    // m * v for the columns of `m` and a vector in a register.
+    inline float32x4_t neon_mat4_mul_vec(
+        const float32x4_t (&m)[4],
+        float32x4_t v)
+    noexcept
+    {
+        auto ret = vmulq_n_f32(m[0], vgetq_lane_f32(v, 0));
+        ret = vmlaq_n_f32(ret, m[1], vgetq_lane_f32(v, 1));
+        ret = vmlaq_n_f32(ret, m[2], vgetq_lane_f32(v, 2));
+        return vmlaq_n_f32(ret, m[3], vgetq_lane_f32(v, 3));
+    }
+
+    // Load the columns of `m`.
+    inline void neon_mat4_load(float32x4_t (&ret)[4], const float* m) noexcept
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            ret[c] = vld1q_f32(m + 4 * c);
+        }
+    }
+
+    // out = a * b.
+    inline void simd_mat4_mul(float* out, const float* a, const float* b)
+    noexcept
+    {
+        float32x4_t ma[4];
+        neon_mat4_load(ma, a);
+
+        float32x4_t ret[4];
+        for (int c = 0; c < 4; ++c)
+        {
+            ret[c] = neon_mat4_mul_vec(ma, vld1q_f32(b + 4 * c));
+        }
+
+        for (int c = 0; c < 4; ++c)
+        {
+            vst1q_f32(out + 4 * c, ret[c]);
+        }
+    }
+
+    // out = m * v.
+    inline void simd_mat4_mul_vec(float* out, const float* m, const float* v)
+    noexcept
+    {
+        float32x4_t mm[4];
+        neon_mat4_load(mm, m);
+        vst1q_f32(out, neon_mat4_mul_vec(mm, vld1q_f32(v)));
+    }
+
+    // out[i] = m * in[i] for `n` vec4s.
+    inline void simd_mat4_transform4(
+        float* out,
+        const float* m,
+        const float* in,
+        std::size_t n)
+    noexcept
+    {
+        float32x4_t mm[4];
+        neon_mat4_load(mm, m);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            auto v = vld1q_f32(in + 4 * i);
+            vst1q_f32(out + 4 * i, neon_mat4_mul_vec(mm, v));
+        }
+    }
+
+    // out[i] = (m * vec4(in[i], W)).xyz for `n` vec3s.
+    // Transforms 4 at a time, deinterleaved so each register holds one
+    // component. Returns how many it transformed; the caller does the rest.
+    template<bool W>
+    inline std::size_t simd_mat4_transform3(
+        float* out,
+        const float* m,
+        const float* in,
+        std::size_t n)
+    noexcept
+    {
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            auto v = vld3q_f32(in + 3 * i);
+            float32x4x3_t ret;
+            for (int r = 0; r < 3; ++r)
+            {
+                auto acc = vmulq_n_f32(v.val[0], m[r]);
+                acc = vmlaq_n_f32(acc, v.val[1], m[4 + r]);
+                acc = vmlaq_n_f32(acc, v.val[2], m[8 + r]);
+                if constexpr (W)
+                {
+                    acc = vaddq_f32(acc, vdupq_n_f32(m[12 + r]));
+                }
+                ret.val[r] = acc;
+            }
+            vst3q_f32(out + 3 * i, ret);
+        }
+
+        return i;
+    }
+#endif
+
+#if !defined(GDT_SIMD_SSE2) && !defined(GDT_SIMD_NEON)
+    // Declared but never defined or called; keeps the dispatch well-formed.
+    void simd_mat4_mul(float* out, const float* a, const float* b) noexcept;
+    void simd_mat4_mul_vec(float* out, const float* m, const float* v)
+    noexcept;
+    void simd_mat4_transform4(
+        float* out,
+        const float* m,
+        const float* in,
+        std::size_t n)
+    noexcept;
+    template<bool W>
+    std::size_t simd_mat4_transform3(
+        float* out,
+        const float* m,
+        const float* in,
+        std::size_t n)
+    noexcept;
+#endif
+}
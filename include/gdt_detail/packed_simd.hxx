@@ -0,0 +1,534 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include "vec_simd.hxx"
+#include <cstddef>
+#include <cstdint>
+
+namespace gdt_detail
+{
+    // Packed formats.
+    struct packed_half {};
+    struct packed_unorm8 {};
+    struct packed_snorm16 {};
+    struct packed_unorm10_10_10_2 {};
+
+    // SIMD kernels for a packed format.
+    // Specializations provide static `pack` and `unpack` functions that
+    // convert up to `n` floats, several at a time, and return how many they
+    // did; the caller does the rest. Their results match the scalar
+    // conversions exactly, except for NaN payloads.
+    template<typename Format>
+    struct simd_packed {};
+
+#if defined(GDT_SIMD_SSE2)
+    // mask ? a : b.
+    inline __m128i sse2_select(__m128i mask, __m128i a, __m128i b) noexcept
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    // Round to int32, ties to even, after replacing NaN with 0 and clamping
+    // to [lo, hi].
+    inline __m128i sse2_to_norm(__m128 x, float lo, float hi, float scale)
+    noexcept
+    {
+        x = _mm_and_ps(x, _mm_cmpord_ps(x, x));
+        x = _mm_max_ps(x, _mm_set1_ps(lo));
+        x = _mm_min_ps(x, _mm_set1_ps(hi));
+        return _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(scale)));
+    }
+
+    // int32 to float, divided by `scale`.
+    inline __m128 sse2_from_norm(__m128i i, float scale) noexcept
+    {
+        return _mm_div_ps(_mm_cvtepi32_ps(i), _mm_set1_ps(scale));
+    }
+
+#if !defined(GDT_SIMD_F16C)
+    // 4 floats to halves in the low 16 bits of each int32, sign-extended.
+    inline __m128i sse2_float_to_half(__m128 f) noexcept
+    {
+        auto u = _mm_castps_si128(f);
+        auto sign = _mm_and_si128(u, _mm_set1_epi32(INT32_MIN));
+        u = _mm_xor_si128(u, sign);
+
+        // 65536 and up overflow to infinity; NaN becomes a quiet NaN.
+        auto big = _mm_cmpgt_epi32(u, _mm_set1_epi32(0x477fffff));
+        auto nan = _mm_cmpgt_epi32(u, _mm_set1_epi32(0x7f800000));
+        auto special = _mm_or_si128(
+            _mm_set1_epi32(0x7c00),
+            _mm_and_si128(nan, _mm_set1_epi32(0x0200)));
+
+        // Below the smallest normal half, adding 0.5 rounds the mantissa
+        // into place.
+        auto small = _mm_cmplt_epi32(u, _mm_set1_epi32(0x38800000));
+        auto sub = _mm_add_ps(_mm_castsi128_ps(u), _mm_set1_ps(0.5f));
+        auto subnormal = _mm_sub_epi32(
+            _mm_castps_si128(sub),
+            _mm_set1_epi32(0x3f000000));
+
+        // Rebias the exponent and round the mantissa to nearest even.
+        auto odd = _mm_and_si128(_mm_srli_epi32(u, 13), _mm_set1_epi32(1));
+        auto bias = _mm_set1_epi32(std::int32_t(0xc8000fff));
+        auto normal = _mm_add_epi32(_mm_add_epi32(u, bias), odd);
+        normal = _mm_srli_epi32(normal, 13);
+
+        auto h = sse2_select(small, subnormal, normal);
+        h = sse2_select(big, special, h);
+        h = _mm_or_si128(h, _mm_srli_epi32(sign, 16));
+        return _mm_srai_epi32(_mm_slli_epi32(h, 16), 16);
+    }
+
+    // Halves in the low 16 bits of each int32, zero-extended, to 4 floats.
+    inline __m128 sse2_half_to_float(__m128i h) noexcept
+    {
+        // Multiplying by 2^112 rebiases the exponent, subnormals included.
+        auto u = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7fff)), 13);
+        auto f = _mm_mul_ps(_mm_castsi128_ps(u), _mm_set1_ps(0x1p112f));
+
+        // Infinity and NaN.
+        auto special = _mm_cmpge_ps(f, _mm_set1_ps(65536.0f));
+        auto inf = _mm_and_ps(special, _mm_castsi128_ps(
+            _mm_set1_epi32(0x7f800000)));
+        u = _mm_castps_si128(_mm_or_ps(f, inf));
+
+        auto sign = _mm_and_si128(h, _mm_set1_epi32(0x8000));
+        return _mm_castsi128_ps(_mm_or_si128(u, _mm_slli_epi32(sign, 16)));
+    }
+#endif
+
+    template<>
+    struct simd_packed<packed_half>
+    {
+        static std::size_t pack(void* out, const float* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<char*>(out);
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                auto a = _mm_loadu_ps(in + i);
+                auto b = _mm_loadu_ps(in + i + 4);
+#if defined(GDT_SIMD_F16C)
+                auto h = _mm_unpacklo_epi64(
+                    _mm_cvtps_ph(a, _MM_FROUND_TO_NEAREST_INT),
+                    _mm_cvtps_ph(b, _MM_FROUND_TO_NEAREST_INT));
+#else
+                auto h = _mm_packs_epi32(
+                    sse2_float_to_half(a),
+                    sse2_float_to_half(b));
+#endif
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p + i * 2), h);
+            }
+            return i;
+        }
+
+        static std::size_t unpack(float* out, const void* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<const char*>(in);
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                auto h = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(p + i * 2));
+#if defined(GDT_SIMD_F16C)
+                auto a = _mm_cvtph_ps(h);
+                auto b = _mm_cvtph_ps(_mm_unpackhi_epi64(h, h));
+                _mm_storeu_ps(out + i, a);
+                _mm_storeu_ps(out + i + 4, b);
+#else
+                auto zero = _mm_setzero_si128();
+                auto a = sse2_half_to_float(_mm_unpacklo_epi16(h, zero));
+                auto b = sse2_half_to_float(_mm_unpackhi_epi16(h, zero));
+                _mm_storeu_ps(out + i, a);
+                _mm_storeu_ps(out + i + 4, b);
+#endif
+            }
+            return i;
+        }
+    };
+
+    template<>
+    struct simd_packed<packed_unorm8>
+    {
+        static std::size_t pack(void* out, const float* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<char*>(out);
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                __m128i r[4];
+                for (int j = 0; j < 4; ++j)
+                {
+                    auto x = _mm_loadu_ps(in + i + j * 4);
+                    r[j] = sse2_to_norm(x, 0.0f, 1.0f, 255.0f);
+                }
+
+                auto lo = _mm_packs_epi32(r[0], r[1]);
+                auto hi = _mm_packs_epi32(r[2], r[3]);
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(p + i),
+                    _mm_packus_epi16(lo, hi));
+            }
+            return i;
+        }
+
+        static std::size_t unpack(float* out, const void* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<const char*>(in);
+            auto zero = _mm_setzero_si128();
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                auto b = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(p + i));
+                auto lo = _mm_unpacklo_epi8(b, zero);
+                auto hi = _mm_unpackhi_epi8(b, zero);
+                __m128i r[4] = {
+                    _mm_unpacklo_epi16(lo, zero),
+                    _mm_unpackhi_epi16(lo, zero),
+                    _mm_unpacklo_epi16(hi, zero),
+                    _mm_unpackhi_epi16(hi, zero),
+                };
+                for (int j = 0; j < 4; ++j)
+                {
+                    auto f = sse2_from_norm(r[j], 255.0f);
+                    _mm_storeu_ps(out + i + j * 4, f);
+                }
+            }
+            return i;
+        }
+    };
+
+    template<>
+    struct simd_packed<packed_snorm16>
+    {
+        static std::size_t pack(void* out, const float* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<char*>(out);
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                auto a = _mm_loadu_ps(in + i);
+                auto b = _mm_loadu_ps(in + i + 4);
+                auto sa = sse2_to_norm(a, -1.0f, 1.0f, 32767.0f);
+                auto sb = sse2_to_norm(b, -1.0f, 1.0f, 32767.0f);
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(p + i * 2),
+                    _mm_packs_epi32(sa, sb));
+            }
+            return i;
+        }
+
+        static std::size_t unpack(float* out, const void* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<const char*>(in);
+            auto neg1 = _mm_set1_ps(-1.0f);
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                auto s = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(p + i * 2));
+                auto a = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+                auto b = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+                auto fa = _mm_max_ps(sse2_from_norm(a, 32767.0f), neg1);
+                auto fb = _mm_max_ps(sse2_from_norm(b, 32767.0f), neg1);
+                _mm_storeu_ps(out + i, fa);
+                _mm_storeu_ps(out + i + 4, fb);
+            }
+            return i;
+        }
+    };
+
+    // Four vec4s at a time, transposed so each register holds one component.
+    template<>
+    struct simd_packed<packed_unorm10_10_10_2>
+    {
+        static std::size_t pack(void* out, const float* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<char*>(out);
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                auto x = _mm_loadu_ps(in + i);
+                auto y = _mm_loadu_ps(in + i + 4);
+                auto z = _mm_loadu_ps(in + i + 8);
+                auto w = _mm_loadu_ps(in + i + 12);
+                _MM_TRANSPOSE4_PS(x, y, z, w);
+
+                auto r = sse2_to_norm(x, 0.0f, 1.0f, 1023.0f);
+                r = _mm_or_si128(r, _mm_slli_epi32(
+                    sse2_to_norm(y, 0.0f, 1.0f, 1023.0f), 10));
+                r = _mm_or_si128(r, _mm_slli_epi32(
+                    sse2_to_norm(z, 0.0f, 1.0f, 1023.0f), 20));
+                r = _mm_or_si128(r, _mm_slli_epi32(
+                    sse2_to_norm(w, 0.0f, 1.0f, 3.0f), 30));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(p + i), r);
+            }
+            return i;
+        }
+
+        static std::size_t unpack(float* out, const void* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<const char*>(in);
+            auto mask = _mm_set1_epi32(0x3ff);
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                auto r = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(p + i));
+                auto x = sse2_from_norm(_mm_and_si128(r, mask), 1023.0f);
+                auto y = sse2_from_norm(
+                    _mm_and_si128(_mm_srli_epi32(r, 10), mask), 1023.0f);
+                auto z = sse2_from_norm(
+                    _mm_and_si128(_mm_srli_epi32(r, 20), mask), 1023.0f);
+                auto w = sse2_from_norm(_mm_srli_epi32(r, 30), 3.0f);
+                _MM_TRANSPOSE4_PS(x, y, z, w);
+
+                _mm_storeu_ps(out + i, x);
+                _mm_storeu_ps(out + i + 4, y);
+                _mm_storeu_ps(out + i + 8, z);
+                _mm_storeu_ps(out + i + 12, w);
+            }
+            return i;
+        }
+    };
+#endif
+
+#if defined(GDT_SIMD_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+    // Round to int32, ties to even, after replacing NaN with 0 and clamping
+    // to [lo, hi].
+    inline int32x4_t neon_to_norm(
+        float32x4_t x,
+        float lo,
+        float hi,
+        float scale)
+    noexcept
+    {
+        x = vbslq_f32(vceqq_f32(x, x), x, vdupq_n_f32(0.0f));
+        x = vmaxq_f32(x, vdupq_n_f32(lo));
+        x = vminq_f32(x, vdupq_n_f32(hi));
+        return vcvtnq_s32_f32(vmulq_f32(x, vdupq_n_f32(scale)));
+    }
+
+    // int32 to float, divided by `scale`.
+    inline float32x4_t neon_from_norm(int32x4_t i, float scale) noexcept
+    {
+        return vdivq_f32(vcvtq_f32_s32(i), vdupq_n_f32(scale));
+    }
+
+    template<>
+    struct simd_packed<packed_half>
+    {
+        static std::size_t pack(void* out, const float* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<std::uint16_t*>(out);
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                auto h = vcvt_f16_f32(vld1q_f32(in + i));
+                vst1_u16(p + i, vreinterpret_u16_f16(h));
+            }
+            return i;
+        }
+
+        static std::size_t unpack(float* out, const void* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<const std::uint16_t*>(in);
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                auto h = vreinterpret_f16_u16(vld1_u16(p + i));
+                vst1q_f32(out + i, vcvt_f32_f16(h));
+            }
+            return i;
+        }
+    };
+
+    template<>
+    struct simd_packed<packed_unorm8>
+    {
+        static std::size_t pack(void* out, const float* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<std::uint8_t*>(out);
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                int32x4_t r[4];
+                for (int j = 0; j < 4; ++j)
+                {
+                    auto x = vld1q_f32(in + i + j * 4);
+                    r[j] = neon_to_norm(x, 0.0f, 1.0f, 255.0f);
+                }
+
+                auto lo = vcombine_s16(vqmovn_s32(r[0]), vqmovn_s32(r[1]));
+                auto hi = vcombine_s16(vqmovn_s32(r[2]), vqmovn_s32(r[3]));
+                vst1q_u8(p + i, vcombine_u8(vqmovun_s16(lo), vqmovun_s16(hi)));
+            }
+            return i;
+        }
+
+        static std::size_t unpack(float* out, const void* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<const std::uint8_t*>(in);
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                auto b = vld1q_u8(p + i);
+                auto lo = vmovl_u8(vget_low_u8(b));
+                auto hi = vmovl_u8(vget_high_u8(b));
+                uint32x4_t r[4] = {
+                    vmovl_u16(vget_low_u16(lo)),
+                    vmovl_u16(vget_high_u16(lo)),
+                    vmovl_u16(vget_low_u16(hi)),
+                    vmovl_u16(vget_high_u16(hi)),
+                };
+                for (int j = 0; j < 4; ++j)
+                {
+                    auto s = vreinterpretq_s32_u32(r[j]);
+                    auto f = neon_from_norm(s, 255.0f);
+                    vst1q_f32(out + i + j * 4, f);
+                }
+            }
+            return i;
+        }
+    };
+
+    template<>
+    struct simd_packed<packed_snorm16>
+    {
+        static std::size_t pack(void* out, const float* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<std::int16_t*>(out);
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                auto a = vld1q_f32(in + i);
+                auto b = vld1q_f32(in + i + 4);
+                auto sa = neon_to_norm(a, -1.0f, 1.0f, 32767.0f);
+                auto sb = neon_to_norm(b, -1.0f, 1.0f, 32767.0f);
+                vst1q_s16(p + i, vcombine_s16(vqmovn_s32(sa), vqmovn_s32(sb)));
+            }
+            return i;
+        }
+
+        static std::size_t unpack(float* out, const void* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<const std::int16_t*>(in);
+            auto neg1 = vdupq_n_f32(-1.0f);
+            std::size_t i = 0;
+            for (; i + 8 <= n; i += 8)
+            {
+                auto s = vld1q_s16(p + i);
+                auto a = neon_from_norm(vmovl_s16(vget_low_s16(s)), 32767.0f);
+                auto b = neon_from_norm(vmovl_s16(vget_high_s16(s)), 32767.0f);
+                vst1q_f32(out + i, vmaxq_f32(a, neg1));
+                vst1q_f32(out + i + 4, vmaxq_f32(b, neg1));
+            }
+            return i;
+        }
+    };
+
+    // Four vec4s at a time, deinterleaved so each register holds one
+    // component.
+    template<>
+    struct simd_packed<packed_unorm10_10_10_2>
+    {
+        static std::size_t pack(void* out, const float* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<std::uint32_t*>(out);
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                auto v = vld4q_f32(in + i);
+                auto x = neon_to_norm(v.val[0], 0.0f, 1.0f, 1023.0f);
+                auto y = neon_to_norm(v.val[1], 0.0f, 1.0f, 1023.0f);
+                auto z = neon_to_norm(v.val[2], 0.0f, 1.0f, 1023.0f);
+                auto w = neon_to_norm(v.val[3], 0.0f, 1.0f, 3.0f);
+
+                auto r = vreinterpretq_u32_s32(x);
+                r = vorrq_u32(r, vshlq_n_u32(vreinterpretq_u32_s32(y), 10));
+                r = vorrq_u32(r, vshlq_n_u32(vreinterpretq_u32_s32(z), 20));
+                r = vorrq_u32(r, vshlq_n_u32(vreinterpretq_u32_s32(w), 30));
+                vst1q_u32(p + i / 4, r);
+            }
+            return i;
+        }
+
+        static std::size_t unpack(float* out, const void* in, std::size_t n)
+        noexcept
+        {
+            auto p = static_cast<const std::uint32_t*>(in);
+            auto mask = vdupq_n_u32(0x3ff);
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16)
+            {
+                auto r = vld1q_u32(p + i / 4);
+                float32x4x4_t v;
+                v.val[0] = neon_from_norm(
+                    vreinterpretq_s32_u32(vandq_u32(r, mask)), 1023.0f);
+                v.val[1] = neon_from_norm(
+                    vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(r, 10), mask)),
+                    1023.0f);
+                v.val[2] = neon_from_norm(
+                    vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(r, 20), mask)),
+                    1023.0f);
+                v.val[3] = neon_from_norm(
+                    vreinterpretq_s32_u32(vshrq_n_u32(r, 30)), 3.0f);
+                vst4q_f32(out + i, v);
+            }
+            return i;
+        }
+    };
+#endif
+
+    // A packed format can use SIMD.
+    template<typename Format>
+    concept simd_pack = requires
+    {
+        &simd_packed<Format>::pack;
+    };
+
+    // Pack the first of `n` floats with SIMD, if any.
+    // Returns how many it did; the caller does the rest.
+    template<typename Format>
+    std::size_t simd_pack_some(void* out, const float* in, std::size_t n)
+    {
+        if constexpr (simd_pack<Format>)
+        {
+            return simd_packed<Format>::pack(out, in, n);
+        }
+        return 0;
+    }
+
+    // Unpack the first of `n` floats with SIMD, if any.
+    // Returns how many it did; the caller does the rest.
+    template<typename Format>
+    std::size_t simd_unpack_some(float* out, const void* in, std::size_t n)
+    {
+        if constexpr (simd_pack<Format>)
+        {
+            return simd_packed<Format>::unpack(out, in, n);
+        }
+        return 0;
+    }
+}
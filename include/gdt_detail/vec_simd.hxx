@@ -0,0 +1,816 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+// Pick an instruction set. Define GDT_NO_SIMD to use scalar code everywhere.
+#if defined(GDT_NO_SIMD)
+#elif defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GDT_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define GDT_SIMD_SSE4_1 1
+#include <smmintrin.h>
+#endif
+#if defined(__AVX__)
+#define GDT_SIMD_AVX 1
+#include <immintrin.h>
+#endif
+#if defined(__AVX2__)
+#define GDT_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(__F16C__)
+#define GDT_SIMD_F16C 1
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define GDT_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace gdt_detail
+{
+    // Shift left.
+    struct shift_left {};
+
+    // Shift right.
+    struct shift_right {};
+
+    // SIMD register for `N` components of `T`.
+    // Specializations provide `reg` and `mask` types, loads and stores.
+    // There's none for vec3: without padding, its partial loads and stores
+    // cost more than they save.
+    template<typename T, std::size_t N>
+    struct simd_vec
+    {
+        static constexpr bool enabled = false;
+    };
+
+    // SIMD operation on registers of `T`.
+    // Specializations provide a static `apply` function.
+    template<typename Op, typename T>
+    struct simd_op;
+
+    // Geometric kernels on `N` components of `T`.
+    // Specializations provide static `dot`, `normalize`, and `fast_normalize`
+    // functions, each only where the instruction set makes it cheap.
+    template<typename T, std::size_t N>
+    struct simd_geometric {};
+
+    // SIMD permutation of the 4 components of a register of `T`.
+    // Specializations provide a static `apply<I0, I1, I2, I3>` function
+    // returning components `I0`, `I1`, `I2`, and `I3` of its argument.
+    template<typename T>
+    struct simd_shuffle {};
+
+#if defined(GDT_SIMD_SSE2)
+    // Store an all-ones/all-zeros mask as 4 bools.
+    inline void sse2_store_mask(bool* p, __m128i m) noexcept
+    {
+        auto m16 = _mm_packs_epi32(m, m);
+        auto m8 = _mm_packs_epi16(m16, m16);
+        auto bits = _mm_cvtsi128_si32(_mm_and_si128(m8, _mm_set1_epi8(1)));
+        std::memcpy(p, &bits, 4);
+    }
+
+    template<>
+    struct simd_vec<float, 4>
+    {
+        static constexpr bool enabled = true;
+        using reg = __m128;
+        using mask = __m128;
+
+        static reg load(const float* p) noexcept
+        {
+            return _mm_loadu_ps(p);
+        }
+
+        static void store(float* p, reg r) noexcept
+        {
+            _mm_storeu_ps(p, r);
+        }
+
+        static void store_mask(bool* p, mask m) noexcept
+        {
+            sse2_store_mask(p, _mm_castps_si128(m));
+        }
+
+        static reg broadcast(float s) noexcept
+        {
+            return _mm_set1_ps(s);
+        }
+    };
+
+    template<>
+    struct simd_vec<std::int32_t, 4>
+    {
+        static constexpr bool enabled = true;
+        using reg = __m128i;
+        using mask = __m128i;
+
+        static reg load(const std::int32_t* p) noexcept
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        static void store(std::int32_t* p, reg r) noexcept
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p), r);
+        }
+
+        static void store_mask(bool* p, mask m) noexcept
+        {
+            sse2_store_mask(p, m);
+        }
+
+        static reg broadcast(std::int32_t s) noexcept
+        {
+            return _mm_set1_epi32(s);
+        }
+    };
+
+    // Float arithmetic.
+    template<>
+    struct simd_op<std::plus<>, float>
+    {
+        static __m128 apply(__m128 a, __m128 b) noexcept
+        {
+            return _mm_add_ps(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::minus<>, float>
+    {
+        static __m128 apply(__m128 a, __m128 b) noexcept
+        {
+            return _mm_sub_ps(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::multiplies<>, float>
+    {
+        static __m128 apply(__m128 a, __m128 b) noexcept
+        {
+            return _mm_mul_ps(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::divides<>, float>
+    {
+        static __m128 apply(__m128 a, __m128 b) noexcept
+        {
+            return _mm_div_ps(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::negate<>, float>
+    {
+        static __m128 apply(__m128 a) noexcept
+        {
+            return _mm_xor_ps(a, _mm_set1_ps(-0.0f));
+        }
+    };
+
+    // Float comparisons.
+    template<>
+    struct simd_op<std::less<>, float>
+    {
+        static __m128 apply(__m128 a, __m128 b) noexcept
+        {
+            return _mm_cmplt_ps(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::greater<>, float>
+    {
+        static __m128 apply(__m128 a, __m128 b) noexcept
+        {
+            return _mm_cmpgt_ps(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::less_equal<>, float>
+    {
+        static __m128 apply(__m128 a, __m128 b) noexcept
+        {
+            return _mm_cmple_ps(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::greater_equal<>, float>
+    {
+        static __m128 apply(__m128 a, __m128 b) noexcept
+        {
+            return _mm_cmpge_ps(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::equal_to<>, float>
+    {
+        static __m128 apply(__m128 a, __m128 b) noexcept
+        {
+            return _mm_cmpeq_ps(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::not_equal_to<>, float>
+    {
+        static __m128 apply(__m128 a, __m128 b) noexcept
+        {
+            return _mm_cmpneq_ps(a, b);
+        }
+    };
+
+    // Integer arithmetic.
+    template<>
+    struct simd_op<std::plus<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_add_epi32(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::minus<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_sub_epi32(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::multiplies<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+#if defined(GDT_SIMD_SSE4_1)
+            return _mm_mullo_epi32(a, b);
+#else
+            // Multiply even and odd lanes separately, keeping the low bits.
+            auto even = _mm_mul_epu32(a, b);
+            auto odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+            return _mm_unpacklo_epi32(
+                _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+        }
+    };
+
+    template<>
+    struct simd_op<std::negate<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a) noexcept
+        {
+            return _mm_sub_epi32(_mm_setzero_si128(), a);
+        }
+    };
+
+    // Integer bitwise operations.
+    template<>
+    struct simd_op<std::bit_and<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_and_si128(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::bit_or<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_or_si128(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::bit_xor<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_xor_si128(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::bit_not<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a) noexcept
+        {
+            return _mm_xor_si128(a, _mm_set1_epi32(-1));
+        }
+    };
+
+#if defined(GDT_SIMD_AVX2)
+    template<>
+    struct simd_op<shift_left, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_sllv_epi32(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<shift_right, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_srav_epi32(a, b);
+        }
+    };
+#endif
+
+    // Integer comparisons.
+    template<>
+    struct simd_op<std::less<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_cmplt_epi32(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::greater<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_cmpgt_epi32(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::less_equal<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_xor_si128(_mm_cmpgt_epi32(a, b), _mm_set1_epi32(-1));
+        }
+    };
+
+    template<>
+    struct simd_op<std::greater_equal<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_xor_si128(_mm_cmplt_epi32(a, b), _mm_set1_epi32(-1));
+        }
+    };
+
+    template<>
+    struct simd_op<std::equal_to<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_cmpeq_epi32(a, b);
+        }
+    };
+
+    template<>
+    struct simd_op<std::not_equal_to<>, std::int32_t>
+    {
+        static __m128i apply(__m128i a, __m128i b) noexcept
+        {
+            return _mm_xor_si128(_mm_cmpeq_epi32(a, b), _mm_set1_epi32(-1));
+        }
+    };
+
+    // Sum of the components of `r` in every component.
+    // Adds in pairs: (r0 + r1) + (r2 + r3).
+    inline __m128 sse2_hsum(__m128 r) noexcept
+    {
+        auto s = _mm_add_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+
+    // Estimate 1 / sqrt(x), refined by one Newton step.
+    inline __m128 sse2_rsqrt(__m128 x) noexcept
+    {
+        auto y = _mm_rsqrt_ps(x);
+        auto hxy = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), x), y);
+        return _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(hxy, y)));
+    }
+
+    // Estimate 1 / sqrt(x), refined by one Newton step.
+    inline float simd_rsqrt(float x) noexcept
+    {
+        return _mm_cvtss_f32(sse2_rsqrt(_mm_set1_ps(x)));
+    }
+
+    template<>
+    struct simd_geometric<float, 4>
+    {
+        static float dot(const float* a, const float* b) noexcept
+        {
+            auto m = _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b));
+            return _mm_cvtss_f32(sse2_hsum(m));
+        }
+
+        static void normalize(float* ret, const float* v) noexcept
+        {
+            auto r = _mm_loadu_ps(v);
+            auto d = sse2_hsum(_mm_mul_ps(r, r));
+            _mm_storeu_ps(ret, _mm_div_ps(r, _mm_sqrt_ps(d)));
+        }
+
+        static void fast_normalize(float* ret, const float* v) noexcept
+        {
+            auto r = _mm_loadu_ps(v);
+            auto d = sse2_hsum(_mm_mul_ps(r, r));
+            _mm_storeu_ps(ret, _mm_mul_ps(r, sse2_rsqrt(d)));
+        }
+    };
+
+    template<>
+    struct simd_shuffle<float>
+    {
+        template<std::size_t I0, std::size_t I1, std::size_t I2, std::size_t I3>
+        static __m128 apply(__m128 a) noexcept
+        {
+            return _mm_shuffle_ps(a, a, _MM_SHUFFLE(I3, I2, I1, I0));
+        }
+    };
+
+    template<>
+    struct simd_shuffle<std::int32_t>
+    {
+        template<std::size_t I0, std::size_t I1, std::size_t I2, std::size_t I3>
+        static __m128i apply(__m128i a) noexcept
+        {
+            return _mm_shuffle_epi32(a, _MM_SHUFFLE(I3, I2, I1, I0));
+        }
+    };
+#endif
+
+#if defined(GDT_SIMD_NEON)
+    // Store an all-ones/all-zeros mask as 4 bools.
+    inline void neon_store_mask(bool* p, uint32x4_t m) noexcept
+    {
+        auto m16 = vmovn_u32(m);
+        auto m8 = vmovn_u16(vcombine_u16(m16, m16));
+        auto bits = vget_lane_u32(
+            vreinterpret_u32_u8(vand_u8(m8, vdup_n_u8(1))), 0);
+        std::memcpy(p, &bits, 4);
+    }
+
+    template<>
+    struct simd_vec<float, 4>
+    {
+        static constexpr bool enabled = true;
+        using reg = float32x4_t;
+        using mask = uint32x4_t;
+
+        static reg load(const float* p) noexcept
+        {
+            return vld1q_f32(p);
+        }
+
+        static void store(float* p, reg r) noexcept
+        {
+            vst1q_f32(p, r);
+        }
+
+        static void store_mask(bool* p, mask m) noexcept
+        {
+            neon_store_mask(p, m);
+        }
+
+        static reg broadcast(float s) noexcept
+        {
+            return vdupq_n_f32(s);
+        }
+    };
+
+    template<>
+    struct simd_vec<std::int32_t, 4>
+    {
+        static constexpr bool enabled = true;
+        using reg = int32x4_t;
+        using mask = uint32x4_t;
+
+        static reg load(const std::int32_t* p) noexcept
+        {
+            return vld1q_s32(p);
+        }
+
+        static void store(std::int32_t* p, reg r) noexcept
+        {
+            vst1q_s32(p, r);
+        }
+
+        static void store_mask(bool* p, mask m) noexcept
+        {
+            neon_store_mask(p, m);
+        }
+
+        static reg broadcast(std::int32_t s) noexcept
+        {
+            return vdupq_n_s32(s);
+        }
+    };
+
+    // Define a NEON `simd_op` specialization.
+    #define gdt(Op, T, Reg, Ret, expr)\
+    template<>\
+    struct simd_op<Op, T>\
+    {\
+        static Ret apply(Reg a, Reg b) noexcept\
+        {\
+            return expr;\
+        }\
+    };
+    gdt(std::plus<>, float, float32x4_t, float32x4_t, vaddq_f32(a, b))
+    gdt(std::minus<>, float, float32x4_t, float32x4_t, vsubq_f32(a, b))
+    gdt(std::multiplies<>, float, float32x4_t, float32x4_t, vmulq_f32(a, b))
+#if defined(__aarch64__) || defined(_M_ARM64)
+    gdt(std::divides<>, float, float32x4_t, float32x4_t, vdivq_f32(a, b))
+#endif
+    gdt(std::less<>, float, float32x4_t, uint32x4_t, vcltq_f32(a, b))
+    gdt(std::greater<>, float, float32x4_t, uint32x4_t, vcgtq_f32(a, b))
+    gdt(std::less_equal<>, float, float32x4_t, uint32x4_t, vcleq_f32(a, b))
+    gdt(std::greater_equal<>, float, float32x4_t, uint32x4_t, vcgeq_f32(a, b))
+    gdt(std::equal_to<>, float, float32x4_t, uint32x4_t, vceqq_f32(a, b))
+    gdt(std::not_equal_to<>, float, float32x4_t, uint32x4_t,
+        vmvnq_u32(vceqq_f32(a, b)))
+    gdt(std::plus<>, std::int32_t, int32x4_t, int32x4_t, vaddq_s32(a, b))
+    gdt(std::minus<>, std::int32_t, int32x4_t, int32x4_t, vsubq_s32(a, b))
+    gdt(std::multiplies<>, std::int32_t, int32x4_t, int32x4_t, vmulq_s32(a, b))
+    gdt(std::bit_and<>, std::int32_t, int32x4_t, int32x4_t, vandq_s32(a, b))
+    gdt(std::bit_or<>, std::int32_t, int32x4_t, int32x4_t, vorrq_s32(a, b))
+    gdt(std::bit_xor<>, std::int32_t, int32x4_t, int32x4_t, veorq_s32(a, b))
+    gdt(shift_left, std::int32_t, int32x4_t, int32x4_t, vshlq_s32(a, b))
+    gdt(shift_right, std::int32_t, int32x4_t, int32x4_t,
+        vshlq_s32(a, vnegq_s32(b)))
+    gdt(std::less<>, std::int32_t, int32x4_t, uint32x4_t, vcltq_s32(a, b))
+    gdt(std::greater<>, std::int32_t, int32x4_t, uint32x4_t, vcgtq_s32(a, b))
+    gdt(std::less_equal<>, std::int32_t, int32x4_t, uint32x4_t, vcleq_s32(a, b))
+    gdt(std::greater_equal<>, std::int32_t, int32x4_t, uint32x4_t,
+        vcgeq_s32(a, b))
+    gdt(std::equal_to<>, std::int32_t, int32x4_t, uint32x4_t, vceqq_s32(a, b))
+    gdt(std::not_equal_to<>, std::int32_t, int32x4_t, uint32x4_t,
+        vmvnq_u32(vceqq_s32(a, b)))
+    #undef gdt
+
+    template<>
+    struct simd_op<std::negate<>, float>
+    {
+        static float32x4_t apply(float32x4_t a) noexcept
+        {
+            return vnegq_f32(a);
+        }
+    };
+
+    template<>
+    struct simd_op<std::negate<>, std::int32_t>
+    {
+        static int32x4_t apply(int32x4_t a) noexcept
+        {
+            return vnegq_s32(a);
+        }
+    };
+
+    template<>
+    struct simd_op<std::bit_not<>, std::int32_t>
+    {
+        static int32x4_t apply(int32x4_t a) noexcept
+        {
+            return vmvnq_s32(a);
+        }
+    };
+
+    // Sum of the components of `r` in every component.
+    // Adds in pairs: (r0 + r1) + (r2 + r3).
+    inline float32x4_t neon_hsum(float32x4_t r) noexcept
+    {
+        auto s = vpadd_f32(vget_low_f32(r), vget_high_f32(r));
+        s = vpadd_f32(s, s);
+        return vcombine_f32(s, s);
+    }
+
+    // Estimate 1 / sqrt(x), refined by two Newton steps.
+    // The NEON estimate has half the bits of SSE's, so it needs both.
+    inline float32x4_t neon_rsqrt(float32x4_t x) noexcept
+    {
+        auto y = vrsqrteq_f32(x);
+        y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(x, y), y));
+        return vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(x, y), y));
+    }
+
+    // Estimate 1 / sqrt(x), refined by two Newton steps.
+    inline float simd_rsqrt(float x) noexcept
+    {
+        return vgetq_lane_f32(neon_rsqrt(vdupq_n_f32(x)), 0);
+    }
+
+    template<>
+    struct simd_geometric<float, 4>
+    {
+        static float dot(const float* a, const float* b) noexcept
+        {
+            auto m = vmulq_f32(vld1q_f32(a), vld1q_f32(b));
+            return vgetq_lane_f32(neon_hsum(m), 0);
+        }
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+        static void normalize(float* ret, const float* v) noexcept
+        {
+            auto r = vld1q_f32(v);
+            auto d = neon_hsum(vmulq_f32(r, r));
+            vst1q_f32(ret, vdivq_f32(r, vsqrtq_f32(d)));
+        }
+#endif
+
+        static void fast_normalize(float* ret, const float* v) noexcept
+        {
+            auto r = vld1q_f32(v);
+            auto d = neon_hsum(vmulq_f32(r, r));
+            vst1q_f32(ret, vmulq_f32(r, neon_rsqrt(d)));
+        }
+    };
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+    // Byte table selecting 32-bit lanes `I0`, `I1`, `I2`, and `I3`.
+    template<std::size_t I0, std::size_t I1, std::size_t I2, std::size_t I3>
+    inline uint8x16_t neon_shuffle_table() noexcept
+    {
+        static constexpr std::uint8_t table[16] = {
+            I0 * 4, I0 * 4 + 1, I0 * 4 + 2, I0 * 4 + 3,
+            I1 * 4, I1 * 4 + 1, I1 * 4 + 2, I1 * 4 + 3,
+            I2 * 4, I2 * 4 + 1, I2 * 4 + 2, I2 * 4 + 3,
+            I3 * 4, I3 * 4 + 1, I3 * 4 + 2, I3 * 4 + 3};
+        return vld1q_u8(table);
+    }
+
+    template<>
+    struct simd_shuffle<float>
+    {
+        template<std::size_t I0, std::size_t I1, std::size_t I2, std::size_t I3>
+        static float32x4_t apply(float32x4_t a) noexcept
+        {
+            auto table = neon_shuffle_table<I0, I1, I2, I3>();
+            return vreinterpretq_f32_u8(
+                vqtbl1q_u8(vreinterpretq_u8_f32(a), table));
+        }
+    };
+
+    template<>
+    struct simd_shuffle<std::int32_t>
+    {
+        template<std::size_t I0, std::size_t I1, std::size_t I2, std::size_t I3>
+        static int32x4_t apply(int32x4_t a) noexcept
+        {
+            auto table = neon_shuffle_table<I0, I1, I2, I3>();
+            return vreinterpretq_s32_u8(
+                vqtbl1q_u8(vreinterpretq_u8_s32(a), table));
+        }
+    };
+#endif
+#endif
+
+    // `R ret = a op b` for `N` components of `T` can use SIMD.
+    template<typename Op, typename R, typename T, std::size_t N>
+    concept simd_binary =
+        simd_vec<T, N>::enabled &&
+        (std::is_same_v<R, T> || std::is_same_v<R, bool>) &&
+        requires (typename simd_vec<T, N>::reg r)
+        {
+            simd_op<Op, T>::apply(r, r);
+        };
+
+    // `R ret = a op s` for scalar `s` can use SIMD.
+    // `s` must convert to `T` without changing the result.
+    template<typename Op, typename R, typename T, typename U, std::size_t N>
+    concept simd_scalar =
+        std::is_arithmetic_v<U> &&
+        std::is_same_v<std::common_type_t<T, U>, T> &&
+        simd_binary<Op, R, T, N>;
+
+    // `R ret = op a` for `N` components of `T` can use SIMD.
+    template<typename Op, typename R, typename T, std::size_t N>
+    concept simd_unary =
+        simd_vec<T, N>::enabled &&
+        std::is_same_v<R, T> &&
+        requires (typename simd_vec<T, N>::reg r)
+        {
+            simd_op<Op, T>::apply(r);
+        };
+
+    // Store the result of a SIMD operation.
+    template<typename R, typename T, std::size_t N, typename Reg>
+    inline void simd_store(R* ret, Reg r) noexcept
+    {
+        if constexpr (std::is_same_v<R, bool>)
+        {
+            simd_vec<T, N>::store_mask(ret, r);
+        }
+        else
+        {
+            simd_vec<T, N>::store(ret, r);
+        }
+    }
+
+    // Vector-vector binary operation.
+    template<typename Op, std::size_t N, typename R, typename T>
+    inline void simd_apply(R* ret, const T* lhs, const T* rhs) noexcept
+    {
+        using v = simd_vec<T, N>;
+        simd_store<R, T, N>(ret, simd_op<Op, T>::apply(
+            v::load(lhs), v::load(rhs)));
+    }
+
+    // Vector-scalar binary operation.
+    template<typename Op, std::size_t N, typename R, typename T>
+    inline void simd_apply(R* ret, const T* lhs, T rhs) noexcept
+    {
+        using v = simd_vec<T, N>;
+        simd_store<R, T, N>(ret, simd_op<Op, T>::apply(
+            v::load(lhs), v::broadcast(rhs)));
+    }
+
+    // Scalar-vector binary operation.
+    template<typename Op, std::size_t N, typename R, typename T>
+    inline void simd_apply(R* ret, T lhs, const T* rhs) noexcept
+    {
+        using v = simd_vec<T, N>;
+        simd_store<R, T, N>(ret, simd_op<Op, T>::apply(
+            v::broadcast(lhs), v::load(rhs)));
+    }
+
+    // Unary operation.
+    template<typename Op, std::size_t N, typename T>
+    inline void simd_apply(T* ret, const T* v) noexcept
+    {
+        simd_vec<T, N>::store(
+            ret, simd_op<Op, T>::apply(simd_vec<T, N>::load(v)));
+    }
+
+    // Swizzle of `N` components of `T` to components `I...` can use SIMD.
+    template<typename T, std::size_t N, std::size_t... I>
+    concept simd_swizzle =
+        simd_vec<T, N>::enabled &&
+        sizeof...(I) == N &&
+        requires (typename simd_vec<T, N>::reg r)
+        {
+            simd_shuffle<T>::template apply<I...>(r);
+        };
+
+    // Swizzle.
+    template<std::size_t... I, typename T>
+    inline void simd_apply_swizzle(T* ret, const T* v) noexcept
+    {
+        using s = simd_vec<T, sizeof...(I)>;
+        s::store(ret, simd_shuffle<T>::template apply<I...>(s::load(v)));
+    }
+
+    // SIMD estimate of 1 / sqrt(x) for a float is available.
+#if defined(GDT_SIMD_SSE2) || defined(GDT_SIMD_NEON)
+    constexpr bool has_simd_rsqrt = true;
+#else
+    constexpr bool has_simd_rsqrt = false;
+    float simd_rsqrt(float x) noexcept;
+#endif
+
+    // Dot product of `N` components of `T` can use SIMD.
+    template<typename T, std::size_t N>
+    concept simd_dot = requires (const T* p)
+    {
+        simd_geometric<T, N>::dot(p, p);
+    };
+
+    // Normalization of `N` components of `T` can use SIMD.
+    template<typename T, std::size_t N>
+    concept simd_normalize = requires (T* ret, const T* p)
+    {
+        simd_geometric<T, N>::normalize(ret, p);
+    };
+
+    // Fast normalization of `N` components of `T` can use SIMD.
+    template<typename T, std::size_t N>
+    concept simd_fast_normalize = requires (T* ret, const T* p)
+    {
+        simd_geometric<T, N>::fast_normalize(ret, p);
+    };
+}
@@ -0,0 +1,150 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/aabb.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/vec.hxx>
+#include <cstddef>
+#include <cstdint>
+
+using gdt::aabb;
+using gdt::aabb_soa;
+using gdt::all;
+using gdt::contains;
+using gdt::intersect;
+using gdt::merge;
+using gdt::overlaps;
+using gdt::vec;
+using gdt::vec3;
+
+using box3 = aabb<float, 3>;
+
+// Box `i` of a spread of boxes, some overlapping the unit cube.
+box3 sample_box(std::size_t i)
+{
+    auto x = float(i % 7) * 0.5f - 1.5f;
+    auto y = float(i % 5) * 0.5f - 1.0f;
+    auto z = float(i % 3) * 0.75f - 0.75f;
+    auto s = float(i % 4) * 0.25f;
+    return {vec(x, y, z), vec(x + s, y + s * 2.0f, z + s)};
+}
+
+// batch::overlaps matches overlaps.
+template<std::size_t W>
+void test_batch_overlaps()
+{
+    box3 unit{vec3<float>(0.0f), vec3<float>(1.0f)};
+    for (std::size_t first = 0; first < 256; first += W - 1)
+    {
+        auto boxes = aabb_soa<float, 3, W>::empty();
+        for (std::size_t i = 0; i + 1 < W; ++i)
+        {
+            boxes.set(i, sample_box(first + i));
+        }
+
+        std::uint32_t expected = 0;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            if (overlaps(unit, boxes.get(i)))
+            {
+                expected |= std::uint32_t(1) << i;
+            }
+        }
+        gdt_assert(gdt::batch::overlaps(unit, boxes) == expected);
+    }
+}
+
+consteval int test_consteval()
+{
+    box3 a{vec(0.0f, 0.0f, 0.0f), vec(2.0f, 2.0f, 2.0f)};
+    box3 b{vec(1.0f, -1.0f, 1.0f), vec(3.0f, 1.0f, 1.5f)};
+    box3 c{vec(5.0f, 5.0f, 5.0f), vec(6.0f, 6.0f, 6.0f)};
+
+    // Accessors.
+    {
+        gdt_assert(all(a.center() == vec(1.0f, 1.0f, 1.0f)));
+        gdt_assert(all(b.size() == vec(2.0f, 2.0f, 0.5f)));
+        gdt_assert(!a.is_empty());
+        gdt_assert(box3::empty().is_empty());
+        gdt_assert(!box3(vec(1.0f, 2.0f, 3.0f)).is_empty());
+    }
+
+    // Merge.
+    {
+        gdt_assert(merge(a, b) == box3(vec(0.0f, -1.0f, 0.0f), vec(3.0f, 2.0f, 2.0f)));
+        gdt_assert(merge(box3::empty(), a) == a);
+        gdt_assert(merge(a, box3::empty()) == a);
+        gdt_assert(merge(a, vec(-1.0f, 1.0f, 4.0f)) == box3(vec(-1.0f, 0.0f, 0.0f), vec(2.0f, 2.0f, 4.0f)));
+    }
+
+    // Intersect.
+    {
+        gdt_assert(intersect(a, b) == box3(vec(1.0f, 0.0f, 1.0f), vec(2.0f, 1.0f, 1.5f)));
+        gdt_assert(intersect(a, c).is_empty());
+        gdt_assert(intersect(a, box3::empty()).is_empty());
+    }
+
+    // Overlaps.
+    {
+        gdt_assert(overlaps(a, b));
+        gdt_assert(overlaps(b, a));
+        gdt_assert(!overlaps(a, c));
+        gdt_assert(!overlaps(a, box3::empty()));
+
+        // Touching counts.
+        box3 d{vec(2.0f, 0.0f, 0.0f), vec(3.0f, 1.0f, 1.0f)};
+        gdt_assert(overlaps(a, d));
+    }
+
+    // Contains.
+    {
+        gdt_assert(contains(a, vec(2.0f, 0.0f, 1.0f)));
+        gdt_assert(!contains(a, vec(2.5f, 0.0f, 1.0f)));
+        gdt_assert(contains(a, intersect(a, b)));
+        gdt_assert(!contains(a, b));
+        gdt_assert(contains(merge(a, b), b));
+    }
+
+    // Structure of arrays.
+    {
+        auto boxes = aabb_soa<float, 3, 4>::empty();
+        boxes.set(0, a);
+        boxes.set(2, c);
+        gdt_assert(boxes.get(0) == a);
+        gdt_assert(boxes.get(1) == box3::empty());
+        gdt_assert(boxes.get(2) == c);
+        gdt_assert(all(boxes.lower(0) == vec(0.0f, 3.4028235e38f, 5.0f, 3.4028235e38f)));
+        gdt_assert(gdt::batch::overlaps(b, boxes) == 0b0001);
+        gdt_assert(gdt::batch::overlaps(merge(a, c), boxes) == 0b0101);
+    }
+
+    // Integers.
+    {
+        aabb<int, 2> p{vec(0, 0), vec(4, 4)};
+        aabb<int, 2> q{vec(4, 1), vec(6, 2)};
+        gdt_assert(overlaps(p, q));
+        gdt_assert((intersect(p, q) == aabb<int, 2>(vec(4, 1), vec(4, 2))));
+        gdt_assert((aabb<int, 2>::empty().is_empty()));
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_aabb(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Batch overlaps matches the scalar test.
+    {
+        test_batch_overlaps<4>();
+        test_batch_overlaps<8>();
+    }
+
+    // Success.
+    return 0;
+}
@@ -37,5 +37,23 @@ int test_allocator(int, char** const)
     struct alignas(128) foo_t { char _[128]; };
     [[maybe_unused]] std::vector<foo_t, allocator<foo_t>> v2(123);
 
+    // Reallocate.
+    {
+        int* p = allocator<int>().allocate(3);
+        p[0] = 1;
+        p[1] = 2;
+        p[2] = 3;
+
+        p = allocator<int>().reallocate(p, 3, 12345);
+        gdt_assert(p[0] == 1);
+        gdt_assert(p[1] == 2);
+        gdt_assert(p[2] == 3);
+
+        p = allocator<int>().reallocate(p, 12345, 2);
+        gdt_assert(p[0] == 1);
+        gdt_assert(p[1] == 2);
+        allocator<int>().deallocate(p, 2);
+    }
+
     return 0;
 }
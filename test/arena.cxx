@@ -0,0 +1,152 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/arena.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <cstdint>
+
+using gdt::arena;
+using gdt::arena_allocator;
+
+namespace
+{
+    bool is_aligned(const void* p, std::size_t align)
+    {
+        return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+    }
+}
+
+int test_arena(int, char** const)
+{
+    // Allocations are aligned and don't overlap.
+    {
+        arena a(256);
+        auto p1 = static_cast<char*>(a.allocate(3, 1));
+        auto p2 = static_cast<char*>(a.allocate(8, 8));
+        auto p3 = static_cast<char*>(a.allocate(16, 16));
+        gdt_assert(is_aligned(p2, 8));
+        gdt_assert(is_aligned(p3, 16));
+        gdt_assert(p2 >= p1 + 3);
+        gdt_assert(p3 >= p2 + 8);
+    }
+
+    // Allocations bigger than a block get their own.
+    {
+        arena a(64);
+        auto p1 = static_cast<char*>(a.allocate(16, 1));
+        auto p2 = static_cast<char*>(a.allocate(1000, 1));
+        p2[999] = 1;
+        p1[15] = 1;
+        auto p3 = static_cast<char*>(a.allocate(16, 1));
+        gdt_assert(p3 != p1);
+        gdt_assert(p3 < p2 || p3 >= p2 + 1000);
+    }
+
+    // Mark and rewind.
+    {
+        arena a(64);
+        auto p1 = a.allocate(16, 1);
+        auto m = a.mark();
+        auto p2 = a.allocate(16, 1);
+        static_cast<void>(a.allocate(1000, 1));
+        a.rewind(m);
+        gdt_assert(a.allocate(16, 1) == p2);
+        static_cast<void>(p1);
+    }
+
+    // Reset reuses blocks.
+    {
+        arena a(64);
+        auto p1 = a.allocate(48, 1);
+        auto p2 = a.allocate(48, 1);
+        a.reset();
+        gdt_assert(a.allocate(48, 1) == p1);
+        gdt_assert(a.allocate(48, 1) == p2);
+    }
+
+    // Caller-supplied buffer.
+    {
+        alignas(16) unsigned char buffer[64];
+        arena a(buffer, sizeof(buffer), 128);
+        auto p1 = a.allocate(32, 16);
+        gdt_assert(p1 == buffer);
+        auto p2 = static_cast<unsigned char*>(a.allocate(64, 1));
+        gdt_assert(p2 < buffer || p2 >= buffer + sizeof(buffer));
+        a.reset();
+        gdt_assert(a.allocate(32, 16) == buffer);
+    }
+
+    // Alignment padding that runs past the end of the buffer.
+    {
+        alignas(16) unsigned char buffer[100];
+        arena a(buffer, sizeof(buffer), 128);
+        gdt_assert(a.allocate(97, 1) == buffer);
+        auto p = static_cast<unsigned char*>(a.allocate(1, 16));
+        gdt_assert(p < buffer || p >= buffer + sizeof(buffer));
+        gdt_assert(a.available() <= 128);
+    }
+
+    // Deallocating the most recent allocation gives it back.
+    {
+        arena a(256);
+        auto p1 = a.allocate(32, 1);
+        auto p2 = a.allocate(32, 1);
+        a.deallocate(p1, 32);
+        a.deallocate(p2, 32);
+        gdt_assert(a.allocate(32, 1) == p2);
+    }
+
+    // Try expand.
+    {
+        arena a(256);
+        auto p1 = a.allocate(32, 1);
+        gdt_assert(a.try_expand(p1, 32, 64));
+        auto p2 = a.allocate(32, 1);
+        gdt_assert(p2 == static_cast<char*>(p1) + 64);
+        gdt_assert(!a.try_expand(p1, 64, 128));
+        gdt_assert(!a.try_expand(p2, 32, 1000));
+    }
+
+    // Dynarr grows in place at the top of the arena.
+    {
+        arena a(4096);
+        gdt::dynarr<int, arena_allocator<int>> d(a);
+        d.push_back(0);
+        auto p = d.data();
+        for (int i = 1; i < 512; ++i)
+        {
+            d.push_back(i);
+        }
+
+        gdt_assert(d.data() == p);
+        for (int i = 0; i < 512; ++i)
+        {
+            gdt_assert(d[i] == i);
+        }
+    }
+
+    // Dynarr with a 32-bit size type.
+    {
+        arena a;
+        using allocator_type = arena_allocator<int, std::uint32_t, std::int32_t>;
+        gdt::dynarr<int, allocator_type> d({1, 2, 3}, allocator_type(a));
+        gdt_assert(sizeof(d) == sizeof(void*) * 2 + 8);
+        gdt_assert(d.size() == 3);
+        gdt_assert(&d.get_allocator().get_arena() == &a);
+    }
+
+    // Allocators compare by arena.
+    {
+        arena a1;
+        arena a2;
+        gdt_assert(arena_allocator<int>(a1) == arena_allocator<float>(a1));
+        gdt_assert(arena_allocator<int>(a1) != arena_allocator<int>(a2));
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,203 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/batch_math.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <gdt/vec.hxx>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+using gdt::batch::accuracy;
+using gdt::dynarr;
+using gdt::vec;
+using gdt::vec3;
+using gdt::vec4;
+
+namespace
+{
+    // Error of `actual` in units of the last place of `expected`.
+    double ulp_error(float actual, double expected)
+    {
+        auto e = float(expected);
+        if (actual == e)
+        {
+            return 0.0;
+        }
+        auto ulp = std::ldexp(1.0, std::ilogb(e) - 23);
+        return std::fabs(double(actual) - expected) / ulp;
+    }
+
+    // `n` evenly spaced floats from `lo` to `hi`.
+    dynarr<float> linspace(float lo, float hi, std::size_t n)
+    {
+        dynarr<float> ret(n);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            ret[i] = lo + (hi - lo) * float(i) / float(n - 1);
+        }
+        return ret;
+    }
+
+    // Batch results match the scalar kernel bit for bit, and stay within
+    // `max_ulp` of the double-precision function.
+    template<typename Op, typename F>
+    bool within_ulp(const dynarr<float>& in, F f, double max_ulp)
+    {
+        dynarr<float> out(in.size());
+        gdt_detail::batch_apply<Op>(
+            out.data(), in.data(), in.size(), accuracy::fast);
+
+        for (std::size_t i = 0; i < in.size(); ++i)
+        {
+            auto scalar = gdt_detail::batch_math<Op>::fast(in[i]);
+            if (std::bit_cast<std::uint32_t>(scalar) !=
+                std::bit_cast<std::uint32_t>(out[i]))
+            {
+                return false;
+            }
+
+            if (ulp_error(out[i], f(double(in[i]))) > max_ulp)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Batch results stay within `max_abs` of the double-precision function.
+    template<typename Op, typename F>
+    bool within_abs(const dynarr<float>& in, F f, double max_abs)
+    {
+        dynarr<float> out(in.size());
+        gdt_detail::batch_apply<Op>(
+            out.data(), in.data(), in.size(), accuracy::fast);
+
+        for (std::size_t i = 0; i < in.size(); ++i)
+        {
+            if (std::fabs(double(out[i]) - f(double(in[i]))) > max_abs)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+int test_batch_math(int, char** const)
+{
+    using namespace gdt_detail;
+    constexpr double pi = 3.14159265358979323846;
+
+    // Documented error bounds.
+    {
+        auto sin = [](double x) { return std::sin(x); };
+        auto cos = [](double x) { return std::cos(x); };
+        auto exp = [](double x) { return std::exp(x); };
+        auto log = [](double x) { return std::log(x); };
+
+        auto small = linspace(-float(pi), float(pi), 100'003);
+        auto large = linspace(-8192.0f, 8192.0f, 100'003);
+        gdt_assert(within_ulp<batch_sin>(small, sin, 2.0));
+        gdt_assert(within_ulp<batch_cos>(small, cos, 2.0));
+        gdt_assert(within_abs<batch_sin>(large, sin, 1e-7));
+        gdt_assert(within_abs<batch_cos>(large, cos, 1e-7));
+
+        auto normal = linspace(-87.0f, 88.0f, 100'003);
+        gdt_assert(within_ulp<batch_exp>(normal, exp, 2.0));
+
+        auto tiny = linspace(1e-30f, 4.0f, 100'003);
+        auto huge = linspace(1.0f, 3e38f, 100'003);
+        gdt_assert(within_ulp<batch_log>(tiny, log, 2.0));
+        gdt_assert(within_ulp<batch_log>(huge, log, 2.0));
+    }
+
+    // Special values.
+    {
+        constexpr auto inf = std::numeric_limits<float>::infinity();
+        constexpr auto nan = std::numeric_limits<float>::quiet_NaN();
+        float in[] = {0.0f, -0.0f, -1.0f, inf, -inf, nan, 1.0f, -100.0f};
+        float out[8];
+
+        gdt::batch::log(in, out);
+        gdt_assert(out[0] == -inf);
+        gdt_assert(out[1] == -inf);
+        gdt_assert(out[2] != out[2]);
+        gdt_assert(out[3] == inf);
+        gdt_assert(out[4] != out[4]);
+        gdt_assert(out[5] != out[5]);
+        gdt_assert(out[6] == 0.0f);
+
+        gdt::batch::exp(in, out);
+        gdt_assert(out[0] == 1.0f);
+        gdt_assert(out[3] == inf);
+        gdt_assert(out[4] == 0.0f);
+        gdt_assert(out[5] != out[5]);
+        gdt_assert(out[7] == 0.0f);
+
+        gdt::batch::sin(in, out);
+        gdt_assert(out[0] == 0.0f);
+        gdt_assert(std::signbit(out[1]));
+        gdt_assert(out[3] != out[3]);
+        gdt_assert(out[5] != out[5]);
+
+        gdt::batch::cos(in, out);
+        gdt_assert(out[0] == 1.0f);
+        gdt_assert(out[3] != out[3]);
+    }
+
+    // Spans of vectors, including tails and in place.
+    {
+        dynarr<vec3<float>> v;
+        for (int i = 0; i < 7; ++i)
+        {
+            auto f = float(i);
+            v.push_back(vec(f, f + 0.25f, f + 0.5f));
+        }
+
+        dynarr<vec3<float>> fast(v.size());
+        dynarr<vec3<float>> precise(v.size());
+        gdt::batch::sin(v, fast);
+        gdt::batch::sin(v, precise, accuracy::precise);
+        for (std::size_t i = 0; i < v.size(); ++i)
+        {
+            for (std::size_t k = 0; k < 3; ++k)
+            {
+                gdt_assert(fast[i][k] == batch_math<batch_sin>::fast(v[i][k]));
+                gdt_assert(precise[i][k] == std::sin(v[i][k]));
+            }
+        }
+
+        gdt::batch::sqrt(v, v);
+        gdt_assert(v[4][0] == 2.0f);
+        gdt_assert(v[6][1] == 2.5f);
+    }
+
+    // Precise mode uses <cmath>.
+    {
+        vec4<float> in[3] = {
+            vec(0.1f, 0.2f, 0.3f, 0.4f),
+            vec(1.5f, 2.5f, 3.5f, 4.5f),
+            vec(10.0f, 20.0f, 30.0f, 40.0f),
+        };
+        vec4<float> out[3];
+
+        gdt::batch::exp(in, out, accuracy::precise);
+        gdt_assert(out[1][2] == std::exp(3.5f));
+        gdt::batch::log(in, out, accuracy::precise);
+        gdt_assert(out[2][3] == std::log(40.0f));
+        gdt::batch::cos(in, out, accuracy::precise);
+        gdt_assert(out[0][0] == std::cos(0.1f));
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,265 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/bitset_dynarr.hxx>
+
+#include <gdt/allocator.hxx>
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <cstddef>
+#include <cstdint>
+
+using gdt::bitset_dynarr;
+
+consteval int test_consteval()
+{
+    // Default constructor.
+    {
+        bitset_dynarr<> b;
+        gdt_assert(b.empty());
+        gdt_assert(b.count() == 0);
+        gdt_assert(b.none());
+        gdt_assert(b.all());
+        gdt_assert(b.find_first() == b.npos);
+    }
+
+    // Size constructor.
+    {
+        bitset_dynarr<> b(70, true);
+        gdt_assert(b.size() == 70);
+        gdt_assert(b.words().size() == 2);
+        gdt_assert(b.words()[1] == 0x3f);
+        gdt_assert(b.count() == 70);
+        gdt_assert(b.all());
+    }
+
+    // Set, reset, flip and test.
+    {
+        bitset_dynarr<> b(100);
+        b.set(3).set(64).set(99);
+        gdt_assert(b[3]);
+        gdt_assert(b.test(64));
+        gdt_assert(!b[4]);
+        gdt_assert(b.count() == 3);
+
+        b.reset(64);
+        b.flip(4);
+        b.set(5, false);
+        gdt_assert(!b[64]);
+        gdt_assert(b[4]);
+        gdt_assert(b.count() == 3);
+        gdt_assert(b.any());
+        gdt_assert(!b.all());
+    }
+
+    // Whole-array set, reset and flip keep the tail clear.
+    {
+        bitset_dynarr<> b(65);
+        b.set();
+        gdt_assert(b.all());
+        gdt_assert(b.count() == 65);
+        b.flip();
+        gdt_assert(b.none());
+        gdt_assert(b.words()[1] == 0);
+        b.flip(0).reset();
+        gdt_assert(b.none());
+    }
+
+    // Find first and next.
+    {
+        bitset_dynarr<> b(300);
+        b.set(0).set(63).set(64).set(200).set(299);
+
+        std::size_t found[8] = {};
+        std::size_t n = 0;
+        for (auto i = b.find_first(); i != b.npos; i = b.find_next(i))
+        {
+            found[n++] = i;
+        }
+
+        gdt_assert(n == 5);
+        gdt_assert(found[1] == 63);
+        gdt_assert(found[2] == 64);
+        gdt_assert(found[3] == 200);
+        gdt_assert(found[4] == 299);
+        gdt_assert(b.find_next(299) == b.npos);
+    }
+
+    // Push back, pop back and resize.
+    {
+        bitset_dynarr<> b;
+        for (int i = 0; i < 130; ++i)
+        {
+            b.push_back(i % 3 == 0);
+        }
+        gdt_assert(b.size() == 130);
+        gdt_assert(b.count() == 44);
+        gdt_assert(b[129]);
+
+        b.pop_back();
+        b.pop_back();
+        gdt_assert(b.size() == 128);
+        gdt_assert(b.words().size() == 2);
+        gdt_assert(b.count() == 43);
+
+        b.resize(10);
+        gdt_assert(b.count() == 4);
+        b.resize(70, true);
+        gdt_assert(b.count() == 64);
+        gdt_assert(b[10]);
+        gdt_assert(!b[8]);
+    }
+
+    // Bitwise operations.
+    {
+        bitset_dynarr<> a(8);
+        bitset_dynarr<> b(8);
+        a.set(0).set(1);
+        b.set(1).set(2);
+
+        gdt_assert((a & b).count() == 1);
+        gdt_assert((a | b).count() == 3);
+        gdt_assert((a ^ b).count() == 2);
+
+        a.and_not(b);
+        gdt_assert(a[0]);
+        gdt_assert(!a[1]);
+        gdt_assert(a.count() == 1);
+    }
+
+    // Equality and swap.
+    {
+        bitset_dynarr<> a(10);
+        bitset_dynarr<> b(10);
+        gdt_assert(a == b);
+        b.set(9);
+        gdt_assert(a != b);
+        swap(a, b);
+        gdt_assert(a[9]);
+        gdt_assert(b.none());
+    }
+
+    // Success.
+    return 0;
+}
+
+namespace
+{
+    // Check every query against a dynarr<bool> with the same bits.
+    template<typename Bitset>
+    void check(const Bitset& b, const gdt::dynarr<bool>& ref)
+    {
+        gdt_assert(b.size() == ref.size());
+
+        std::size_t count = 0;
+        std::size_t first = b.npos;
+        for (std::size_t i = 0; i < ref.size(); ++i)
+        {
+            gdt_assert(b[i] == ref[i]);
+            if (ref[i])
+            {
+                count += 1;
+                if (first == b.npos)
+                {
+                    first = i;
+                }
+            }
+        }
+
+        gdt_assert(b.count() == count);
+        gdt_assert(b.any() == (count > 0));
+        gdt_assert(b.none() == (count == 0));
+        gdt_assert(b.all() == (count == ref.size()));
+        gdt_assert(b.find_first() == first);
+
+        std::size_t seen = 0;
+        for (auto i = b.find_first(); i != b.npos; i = b.find_next(i))
+        {
+            gdt_assert(ref[i]);
+            seen += 1;
+        }
+        gdt_assert(seen == count);
+    }
+}
+
+int test_bitset_dynarr(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Sizes around SIMD block boundaries.
+    for (std::size_t n : {0, 1, 63, 64, 65, 255, 256, 257, 511, 513, 1000, 4099})
+    {
+        gdt::dynarr<bool> ra(n, false);
+        gdt::dynarr<bool> rb(n, false);
+        bitset_dynarr<> a(n);
+        bitset_dynarr<> b(n);
+
+        // Sparse bits near the end, so SIMD scans skip most words.
+        std::uint64_t x = n + 1;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            x = x * 6364136223846793005 + 1442695040888963407;
+            if (i + 40 > n && (x >> 60) < 4)
+            {
+                ra[i] = true;
+                a.set(i);
+            }
+            if ((x >> 33) % 3 == 0)
+            {
+                rb[i] = true;
+                b.set(i);
+            }
+        }
+        check(a, ra);
+        check(b, rb);
+
+        auto r = ra;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            r[i] = ra[i] & rb[i];
+        }
+        check(a & b, r);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            r[i] = ra[i] | rb[i];
+        }
+        check(a | b, r);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            r[i] = ra[i] ^ rb[i];
+        }
+        check(a ^ b, r);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            r[i] = ra[i] && !rb[i];
+        }
+        check(bitset_dynarr<>(a).and_not(b), r);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            r[i] = true;
+        }
+        check(bitset_dynarr<>(a).set(), r);
+        check(bitset_dynarr<>(n, true), r);
+    }
+
+    // Compact 32-bit sizes.
+    {
+        using allocator_type = gdt::allocator<
+            std::uint64_t, std::uint32_t, std::int32_t>;
+        bitset_dynarr<allocator_type> b(1000);
+        b.set(999);
+        gdt_assert(b.find_first() == 999);
+        gdt_assert(b.find_next(999) == b.npos);
+        gdt_assert(b.npos == UINT32_MAX);
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,299 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/bvh.hxx>
+
+#include <gdt/aabb.hxx>
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <gdt/frustum.hxx>
+#include <gdt/mat.hxx>
+#include <gdt/ray.hxx>
+#include <gdt/vec.hxx>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+using gdt::aabb;
+using gdt::bvh;
+using gdt::bvh_build_options;
+using gdt::bvh_node;
+using gdt::dynarr;
+using gdt::frustum;
+using gdt::mat4;
+using gdt::ray;
+using gdt::vec;
+
+using box3 = aabb<float, 3>;
+using ray3 = ray<float, 3>;
+
+constexpr auto inf = std::numeric_limits<float>::infinity();
+constexpr auto none = bvh_node<float>::none;
+
+// Small boxes scattered through [-50, 50] with a little clumping.
+constexpr dynarr<box3> sample_boxes(std::size_t n, std::uint32_t seed)
+{
+    dynarr<box3> ret;
+    auto next = [&]
+    {
+        seed = seed * 1664525 + 1013904223;
+        return float(seed >> 8) / float(1 << 24);
+    };
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        auto c = vec(next(), next(), next()) * 100.0f - 50.0f;
+        if (i % 5 == 0)
+        {
+            c = c * 0.1f;
+        }
+        auto s = vec(next(), next(), next()) * 2.0f;
+        ret.push_back(box3(c - s, c + s));
+    }
+    return ret;
+}
+
+// Every primitive appears in exactly one leaf and every box contains its
+// children.
+template<typename T>
+constexpr bool is_valid(const bvh<T>& b, std::size_t n)
+{
+    dynarr<int> seen(n, 0);
+    for (auto& index : b.indices())
+    {
+        ++seen[index];
+    }
+    for (auto count : seen)
+    {
+        if (count != 1)
+        {
+            return false;
+        }
+    }
+
+    for (std::size_t i = 0; i < b.nodes().size(); ++i)
+    {
+        auto& node = b.nodes()[i];
+        for (std::size_t lane = 0; lane < 4; ++lane)
+        {
+            if (node.first[lane] == none || node.count[lane] != 0)
+            {
+                continue;
+            }
+            auto child = node.first[lane];
+            if (child <= i || child >= b.nodes().size())
+            {
+                return false;
+            }
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                auto box = b.nodes()[child].bounds.get(j);
+                if (!box.is_empty() && !contains(node.bounds.get(lane), box))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Nearest box along `r`, brute force.
+gdt::bvh_hit<float> nearest(const dynarr<box3>& boxes, const ray3& r)
+{
+    gdt::bvh_hit<float> ret{none, inf};
+    for (std::size_t i = 0; i < boxes.size(); ++i)
+    {
+        auto t = intersect(r, boxes[i]);
+        if (t < ret.t)
+        {
+            ret = {std::uint32_t(i), t};
+        }
+    }
+    return ret;
+}
+
+// Queries match brute force.
+void test_queries(const bvh<float>& b, const dynarr<box3>& boxes)
+{
+    gdt_assert(is_valid(b, boxes.size()));
+
+    // Rays.
+    for (int i = 0; i < 100; ++i)
+    {
+        auto a = float(i) * 0.37f;
+        auto o = vec(float(i % 13) - 80.0f, float(i % 7) * 3.0f - 10.0f, a);
+        auto d = vec(1.0f, float(i % 9) * 0.05f - 0.2f, -a * 0.01f);
+        if (i % 10 == 0)
+        {
+            d = vec(1.0f, 0.0f, 0.0f);
+        }
+        ray3 r(o, d);
+        auto expected = nearest(boxes, r);
+        auto hit = b.intersect(r, [&](std::uint32_t j)
+        {
+            return intersect(r, boxes[j]);
+        });
+        gdt_assert(hit.t == expected.t);
+        gdt_assert(hit.index == none || intersect(r, boxes[hit.index]) == hit.t);
+    }
+
+    // Boxes.
+    for (int i = 0; i < 50; ++i)
+    {
+        auto c = vec(float(i % 10) * 10.0f - 45.0f, float(i % 3) * 5.0f, 0.0f);
+        box3 query(c - 4.0f, c + 4.0f);
+        dynarr<int> seen(boxes.size(), 0);
+        b.query(query, [&](std::uint32_t j) { ++seen[j]; });
+        for (std::size_t j = 0; j < boxes.size(); ++j)
+        {
+            gdt_assert(seen[j] <= 1);
+            gdt_assert(!overlaps(query, boxes[j]) || seen[j] == 1);
+        }
+    }
+
+    // Frustums.
+    {
+        mat4<float> m(
+            vec(0.1f, 0.0f, 0.0f, 0.0f),
+            vec(0.0f, 0.2f, 0.0f, 0.0f),
+            vec(0.1f, 0.0f, 0.05f, 0.0f),
+            vec(0.0f, 0.5f, 0.5f, 1.0f));
+        frustum<float> f(m);
+        dynarr<int> seen(boxes.size(), 0);
+        b.query(f, [&](std::uint32_t j) { ++seen[j]; });
+        for (std::size_t j = 0; j < boxes.size(); ++j)
+        {
+            gdt_assert(seen[j] <= 1);
+            gdt_assert(!overlaps(f, boxes[j]) || seen[j] == 1);
+        }
+    }
+}
+
+consteval int test_consteval()
+{
+    // Empty.
+    {
+        bvh<float> b;
+        gdt_assert(b.empty());
+        gdt_assert(b.bounds().is_empty());
+        ray3 r(vec(0.0f, 0.0f, 0.0f), vec(1.0f, 0.0f, 0.0f));
+        auto hit = b.intersect(r, [](std::uint32_t) { return 0.0f; });
+        gdt_assert(hit.index == none && hit.t == inf);
+    }
+
+    // One primitive.
+    {
+        box3 boxes[] = {box3(vec(1.0f, -1.0f, -1.0f), vec(2.0f, 1.0f, 1.0f))};
+        bvh<float> b(boxes);
+        gdt_assert(b.nodes().size() == 1);
+        gdt_assert(b.bounds() == boxes[0]);
+
+        ray3 r(vec(0.0f, 0.0f, 0.0f), vec(1.0f, 0.0f, 0.0f));
+        auto hit = b.intersect(r, [&](std::uint32_t i)
+        {
+            return intersect(r, boxes[i]);
+        });
+        gdt_assert(hit.index == 0 && hit.t == 1.0f);
+        hit = b.intersect(r, [&](std::uint32_t) { return inf; });
+        gdt_assert(hit.index == none);
+    }
+
+    // Build and refit.
+    {
+        auto boxes = sample_boxes(40, 1);
+        bvh<float> b(boxes);
+        gdt_assert(is_valid(b, boxes.size()));
+        gdt_assert(b.nodes().size() > 1);
+
+        for (auto& box : boxes)
+        {
+            box = box3(box.lower() + 10.0f, box.upper() + 10.0f);
+        }
+        b.refit(boxes);
+        gdt_assert(is_valid(b, boxes.size()));
+
+        auto expected = box3::empty();
+        for (auto& box : boxes)
+        {
+            expected = merge(expected, box);
+        }
+        gdt_assert(b.bounds() == expected);
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_bvh(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Queries.
+    {
+        auto boxes = sample_boxes(2000, 2);
+        bvh<float> b(boxes);
+        test_queries(b, boxes);
+
+        bvh_build_options options;
+        options.max_leaf_size = 1;
+        options.bins = 4;
+        b.build(boxes, options);
+        test_queries(b, boxes);
+    }
+
+    // Refit.
+    {
+        auto boxes = sample_boxes(2000, 3);
+        bvh<float> b(boxes);
+        for (std::size_t i = 0; i < boxes.size(); ++i)
+        {
+            auto d = vec(float(i % 3), float(i % 5), -float(i % 7)) * 2.0f;
+            boxes[i] = box3(boxes[i].lower() + d, boxes[i].upper() + d);
+        }
+        b.refit(boxes);
+        test_queries(b, boxes);
+    }
+
+    // Identical boxes.
+    {
+        dynarr<box3> boxes(100, box3(vec(1.0f, 1.0f, 1.0f), vec(2.0f, 2.0f, 2.0f)));
+        bvh<float> b(boxes);
+        test_queries(b, boxes);
+    }
+
+    // Parallel.
+    {
+        auto boxes = sample_boxes(20'000, 4);
+        bvh_build_options options;
+        options.parallel = true;
+        options.parallel_size = 1000;
+        bvh<float> serial(boxes);
+        bvh<float> parallel(boxes, options);
+        gdt_assert(is_valid(parallel, boxes.size()));
+        gdt_assert(parallel.nodes().size() == serial.nodes().size());
+        gdt_assert(parallel.bounds() == serial.bounds());
+        for (int i = 0; i < 100; ++i)
+        {
+            auto f = float(i);
+            ray3 r(vec(-60.0f, f - 50.0f, 0.0f), vec(1.0f, 0.0f, f * 0.01f));
+            auto hit = [&](std::uint32_t j) { return intersect(r, boxes[j]); };
+            gdt_assert(parallel.intersect(r, hit).t == serial.intersect(r, hit).t);
+        }
+
+        // Same tree however few threads it gets.
+        for (std::uint32_t max_threads = 1; max_threads <= 3; ++max_threads)
+        {
+            options.max_threads = max_threads;
+            bvh<float> capped(boxes, options);
+            gdt_assert(is_valid(capped, boxes.size()));
+            gdt_assert(capped.nodes().size() == serial.nodes().size());
+            gdt_assert(capped.bounds() == serial.bounds());
+        }
+    }
+
+    // Success.
+    return 0;
+}
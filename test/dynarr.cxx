@@ -13,12 +13,24 @@ using gdt::dynarr;
 
 namespace
 {
-    struct not_always_equal : gdt::allocator<int>
+    struct not_always_equal
     {
         int id;
 
+        using value_type = int;
         using is_always_equal = std::false_type;
         using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+
+        [[nodiscard]] constexpr int* allocate(std::size_t n) const
+        {
+            return gdt::allocator<int>().allocate(n);
+        }
+
+        constexpr void deallocate(int* p, std::size_t n) const
+        {
+            gdt::allocator<int>().deallocate(p, n);
+        }
 
         constexpr not_always_equal select_on_container_copy_construction()
         const
@@ -42,6 +54,77 @@ namespace
     };
 }
 
+namespace
+{
+    struct relocatable
+    {
+        static inline int moves = 0;
+
+        int value;
+
+        explicit relocatable(int v) : value{v} {}
+        relocatable(relocatable&& other) : value{other.value} { ++moves; }
+        relocatable& operator=(relocatable&&) = default;
+        ~relocatable() {}
+    };
+}
+
+template<>
+struct gdt::is_trivially_relocatable<relocatable> : std::true_type {};
+
+namespace
+{
+    // Allocator that hands out 64-element blocks and can grow in place.
+    struct expanding_allocator
+    {
+        using value_type = int;
+
+        static constexpr std::size_t block_size = 64;
+
+        int* allocate(std::size_t n)
+        {
+            return gdt::allocator<int>().allocate(std::max(n, block_size));
+        }
+
+        void deallocate(int* p, std::size_t n)
+        {
+            gdt::allocator<int>().deallocate(p, std::max(n, block_size));
+        }
+
+        bool try_expand(int*, std::size_t, std::size_t new_n)
+        {
+            return new_n <= block_size;
+        }
+
+        friend bool operator==(
+            const expanding_allocator&,
+            const expanding_allocator&) = default;
+    };
+
+    // Allocator that counts calls to `reallocate`.
+    struct reallocating_allocator : gdt::allocator<int>
+    {
+        static inline int reallocations = 0;
+
+        int* reallocate(int* p, std::size_t old_n, std::size_t new_n)
+        {
+            ++reallocations;
+            return gdt::allocator<int>::reallocate(p, old_n, new_n);
+        }
+    };
+
+    struct counted
+    {
+        static inline int constructions = 0;
+        static inline int destructions = 0;
+
+        counted() { ++constructions; }
+        counted(const counted&) { ++constructions; }
+        counted& operator=(const counted&) = default;
+        ~counted() { ++destructions; }
+    };
+}
+
 consteval int test_consteval()
 {
     // Default constructor.
@@ -521,6 +604,71 @@ consteval int test_consteval()
         gdt_assert(a[1] == 2);
     }
 
+    // Resize from empty.
+    {
+        dynarr<int> a;
+        a.resize(3);
+        gdt_assert(a.capacity() == 3);
+        gdt_assert((a == dynarr{0, 0, 0}));
+
+        a.resize(5, 4);
+        gdt_assert(a.capacity() == 6);
+        gdt_assert((a == dynarr{0, 0, 0, 4, 4}));
+
+        a.resize(0);
+        gdt_assert(a.capacity() == 6);
+        gdt_assert(a.empty());
+    }
+
+    // Resize with non-trivial elements.
+    {
+        dynarr<dynarr<int>> a = {{1}, {2, 3}};
+        a.resize(4);
+        gdt_assert(a.size() == 4);
+        gdt_assert((a[1] == dynarr{2, 3}));
+        gdt_assert(a[2].empty());
+        gdt_assert(a[3].empty());
+
+        a.resize(6, dynarr{4, 5});
+        gdt_assert((a[4] == dynarr{4, 5}));
+        gdt_assert((a[5] == dynarr{4, 5}));
+
+        a.resize(1);
+        gdt_assert(a.size() == 1);
+        gdt_assert((a[0] == dynarr{1}));
+    }
+
+    // Resize for overwrite.
+    {
+        dynarr a = {1, 2};
+        a.resize_for_overwrite(3);
+        gdt_assert(a.capacity() == 4);
+        gdt_assert(a.size() == 3);
+        gdt_assert(a[0] == 1);
+        gdt_assert(a[1] == 2);
+
+        a.resize_for_overwrite(1);
+        gdt_assert(a.capacity() == 4);
+        gdt_assert((a == dynarr{1}));
+    }
+
+    // Append uninitialized.
+    {
+        dynarr a = {1, 2};
+        int* p = a.append_uninitialized(3);
+        gdt_assert(p == a.data() + 2);
+        gdt_assert(a.capacity() == 5);
+        gdt_assert(a.size() == 5);
+        p[0] = 3;
+        p[1] = 4;
+        p[2] = 5;
+        gdt_assert((a == dynarr{1, 2, 3, 4, 5}));
+
+        p = a.append_uninitialized(0);
+        gdt_assert(p == a.data() + 5);
+        gdt_assert(a.size() == 5);
+    }
+
     // Reserve.
     {
         dynarr a = {1, 2, 3};
@@ -569,6 +717,11 @@ consteval int test_consteval()
         gdt_assert(a[0] == 1);
         gdt_assert(a[1] == 2);
         gdt_assert(a[2] == 3);
+
+        a.clear();
+        a.shrink_to_fit();
+        gdt_assert(a.capacity() == 0);
+        gdt_assert(a.data() == nullptr);
     }
 
     // At.
@@ -653,6 +806,66 @@ consteval int test_consteval()
         gdt_assert((a2[1].data() == data));
     }
 
+    // Insert in the middle.
+    {
+        dynarr a = {1, 2, 3};
+        a.reserve(5);
+        auto data = a.data();
+        auto itr = a.insert(a.begin() + 1, 4);
+        gdt_assert(a.data() == data);
+        gdt_assert(itr == a.begin() + 1);
+        gdt_assert((a == dynarr{1, 4, 2, 3}));
+    }
+
+    // Insert range in the middle.
+    {
+        dynarr a = {1, 2, 3};
+        a.reserve(5);
+        auto il = {4, 5};
+        auto itr = a.insert(a.begin() + 1, il.begin(), il.end());
+        gdt_assert(itr == a.begin() + 1);
+        gdt_assert((a == dynarr{1, 4, 5, 2, 3}));
+    }
+
+    // Insert range in the middle with reallocation.
+    {
+        dynarr a = {1, 2, 3};
+        auto il = {4, 5};
+        auto itr = a.insert(a.begin() + 2, il.begin(), il.end());
+        gdt_assert(a.capacity() == 6);
+        gdt_assert(itr == a.begin() + 2);
+        gdt_assert((a == dynarr{1, 2, 4, 5, 3}));
+    }
+
+    // Erase.
+    {
+        dynarr a = {1, 2, 3, 4};
+        auto itr = a.erase(a.begin() + 1);
+        gdt_assert(itr == a.begin() + 1);
+        gdt_assert(a.capacity() == 4);
+        gdt_assert((a == dynarr{1, 3, 4}));
+    }
+
+    // Erase range.
+    {
+        dynarr a = {1, 2, 3, 4};
+        auto itr = a.erase(a.begin() + 1, a.begin() + 3);
+        gdt_assert(itr == a.begin() + 1);
+        gdt_assert((a == dynarr{1, 4}));
+    }
+
+    // Swap remove.
+    {
+        dynarr a = {1, 2, 3, 4};
+        auto itr = a.swap_remove(a.begin() + 1);
+        gdt_assert(itr == a.begin() + 1);
+        gdt_assert((a == dynarr{1, 4, 3}));
+
+        itr = a.swap_remove(a.end() - 1);
+        gdt_assert(itr == a.end());
+        gdt_assert((a == dynarr{1, 4}));
+    }
+
     // TODO: More.
 
     // Success.
@@ -664,6 +877,161 @@ int test_dynarr(int, char** const)
     // Consteval.
     gdt_assert(test_consteval() == 0);
 
+    // Trivially relocatable elements skip move construction.
+    {
+        dynarr<relocatable> a;
+        for (int i = 0; i < 100; ++i)
+        {
+            a.emplace_back(i);
+        }
+
+        a.insert(a.begin() + 10, relocatable(-1));
+        a.erase(a.begin() + 20, a.begin() + 30);
+        a.swap_remove(a.begin());
+        a.shrink_to_fit();
+
+        gdt_assert(relocatable::moves == 1);
+        gdt_assert(a.size() == 90);
+        gdt_assert(a[0].value == 99);
+        gdt_assert(a[10].value == -1);
+        gdt_assert(a[11].value == 10);
+        gdt_assert(a[20].value == 29);
+        gdt_assert(a[89].value == 98);
+    }
+
+    // Bulk resize with trivial elements.
+    {
+        struct pod { int i; float f; };
+        dynarr<pod> a(2, pod{1, 2.0f});
+        a.resize(1000);
+        gdt_assert(a.size() == 1000);
+        gdt_assert(a[1].i == 1);
+        gdt_assert(a[1].f == 2.0f);
+        for (auto itr = a.begin() + 2; itr != a.end(); ++itr)
+        {
+            gdt_assert(itr->i == 0);
+            gdt_assert(itr->f == 0.0f);
+        }
+
+        a.resize(2000, pod{3, 4.0f});
+        gdt_assert(a.size() == 2000);
+        gdt_assert(a[999].i == 0);
+        gdt_assert(a[1000].i == 3);
+        gdt_assert(a[1999].f == 4.0f);
+    }
+
+    // Bulk resize value-initializes classes holding member pointers.
+    {
+        struct member_ptr { int x; int member_ptr::*p; };
+        dynarr<member_ptr> a(4);
+        a.resize(8);
+        for (auto& e : a)
+        {
+            gdt_assert(e.x == 0);
+            gdt_assert(e.p == nullptr);
+        }
+
+        dynarr<int member_ptr::*> b(4);
+        b.resize(8);
+        for (auto p : b)
+        {
+            gdt_assert(p == nullptr);
+        }
+    }
+
+    // Bulk resize constructs and destroys each element once.
+    {
+        counted::constructions = 0;
+        counted::destructions = 0;
+        {
+            dynarr<counted> a;
+            a.resize(100);
+            gdt_assert(counted::constructions == 100);
+            a.resize(10);
+            gdt_assert(counted::destructions == 90);
+            a.assign(50, counted());
+            gdt_assert(counted::constructions == 141);
+            gdt_assert(counted::destructions == 91);
+        }
+        gdt_assert(counted::constructions == counted::destructions);
+    }
+
+    // Default-initializing growth.
+    {
+        dynarr<float> a;
+        float* p = a.append_uninitialized(1000);
+        gdt_assert(p == a.data());
+        gdt_assert(a.size() == 1000);
+        for (int i = 0; i < 1000; ++i)
+        {
+            p[i] = float(i);
+        }
+
+        a.resize_for_overwrite(2000);
+        gdt_assert(a.size() == 2000);
+        gdt_assert(a[999] == 999.0f);
+
+        dynarr<dynarr<int>> b = {{1}};
+        b.resize_for_overwrite(3);
+        gdt_assert((b[0] == dynarr{1}));
+        gdt_assert(b[1].empty());
+        gdt_assert(b[2].empty());
+    }
+
+    // Grow in place with try_expand.
+    {
+        dynarr<int, expanding_allocator> a;
+        a.push_back(1);
+        auto data = a.data();
+        for (int i = 2; i <= 64; ++i)
+        {
+            a.push_back(i);
+        }
+        a.insert(a.begin(), 0);
+        gdt_assert(a.data() != data);
+        gdt_assert(a.size() == 65);
+
+        a.resize(1);
+        a.shrink_to_fit();
+        data = a.data();
+        a.insert(a.begin(), -1);
+        a.insert(a.begin() + 1, {-2, -3});
+        gdt_assert(a.data() == data);
+        gdt_assert((a == dynarr<int, expanding_allocator>{-1, -2, -3, 0}));
+    }
+
+    // Grow and shrink with reallocate.
+    {
+        dynarr<int, reallocating_allocator> a;
+        for (int i = 0; i < 1000; ++i)
+        {
+            a.push_back(i);
+        }
+        a.resize(10);
+        a.shrink_to_fit();
+
+        // Every reallocation but the first (from null) uses reallocate.
+        gdt_assert(reallocating_allocator::reallocations == 11);
+        gdt_assert(a.capacity() == 10);
+        for (int i = 0; i < 10; ++i)
+        {
+            gdt_assert(a[dynarr<int>::size_type(i)] == i);
+        }
+    }
+
+    // Dynarrs themselves are trivially relocatable.
+    {
+        dynarr<dynarr<int>> a;
+        a.emplace_back(3, 45);
+        auto data = a[0].data();
+        for (int i = 0; i < 10; ++i)
+        {
+            a.emplace_back();
+        }
+        gdt_assert(a[0].data() == data);
+        gdt_assert((a[0] == dynarr{45, 45, 45}));
+    }
+
     // Success.
     return 0;
 }
@@ -0,0 +1,182 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/flat_map.hxx>
+
+#include <gdt/allocator.hxx>
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
+using gdt::flat_map;
+
+consteval int test_consteval()
+{
+    // Default constructor.
+    {
+        flat_map<int, int> m;
+        gdt_assert(m.empty());
+        gdt_assert(m.begin() == m.end());
+        gdt_assert(m.find(0) == m.end());
+        gdt_assert(!m.contains(0));
+    }
+
+    // Initializer list constructor sorts and keeps the first duplicate.
+    {
+        flat_map<int, int> m{{3, 30}, {1, 10}, {3, 31}, {2, 20}};
+        gdt_assert(m.size() == 3);
+        gdt_assert(m.keys()[0] == 1);
+        gdt_assert(m.keys()[2] == 3);
+        gdt_assert(m.values()[2] == 30);
+        gdt_assert(m.at(2) == 20);
+    }
+
+    // Keys and values walk together.
+    {
+        flat_map<int, int> m{{2, 20}, {1, 10}};
+        auto it = m.begin();
+        gdt_assert((*it).first == 1);
+        gdt_assert(it->second == 10);
+        it->second = 11;
+        ++it;
+        auto [k, v] = *it;
+        gdt_assert(k == 2);
+        gdt_assert(v == 20);
+        gdt_assert(++it == m.end());
+        gdt_assert(m.end() - m.begin() == 2);
+        gdt_assert(m.begin()[0].second == 11);
+
+        flat_map<int, int>::const_iterator cit = m.begin();
+        gdt_assert(cit == m.cbegin());
+    }
+
+    // Try emplace, insert or assign and subscript.
+    {
+        flat_map<int, int> m;
+        gdt_assert(m.try_emplace(5, 50).second);
+        gdt_assert(!m.try_emplace(5, 51).second);
+        gdt_assert(m[5] == 50);
+
+        gdt_assert(m.insert({1, 10}).second);
+        gdt_assert(!m.insert_or_assign(1, 11).second);
+        gdt_assert(m.insert_or_assign(9, 90).second);
+        gdt_assert(m[1] == 11);
+
+        gdt_assert(m[3] == 0);
+        gdt_assert(m.size() == 4);
+        gdt_assert(m.keys()[1] == 3);
+        gdt_assert(m.values()[3] == 90);
+    }
+
+    // Bounds.
+    {
+        flat_map<int, int> m{{10, 1}, {20, 2}, {30, 3}};
+        gdt_assert(m.lower_bound(20)->second == 2);
+        gdt_assert(m.upper_bound(20)->second == 3);
+        gdt_assert(m.lower_bound(5) == m.begin());
+        gdt_assert(m.upper_bound(30) == m.end());
+    }
+
+    // Insert range merges into existing pairs.
+    {
+        flat_map<int, int> m{{2, 20}, {4, 40}};
+        std::pair<int, int> more[] = {{5, 50}, {1, 10}, {4, 41}, {1, 11}};
+        m.insert_range(more);
+        gdt_assert(m.size() == 4);
+        gdt_assert(m.keys()[0] == 1);
+        gdt_assert(m.values()[0] == 10);
+        gdt_assert(m.at(4) == 40);
+        gdt_assert(m.keys()[3] == 5);
+    }
+
+    // Erase.
+    {
+        flat_map<int, int> m{{1, 10}, {2, 20}, {3, 30}};
+        gdt_assert(m.erase(2) == 1);
+        gdt_assert(m.erase(2) == 0);
+        auto it = m.erase(m.begin());
+        gdt_assert(it->first == 3);
+        gdt_assert(m.values()[0] == 30);
+        m.clear();
+        gdt_assert(m.empty());
+    }
+
+    // Equality.
+    {
+        flat_map<int, int> m1{{1, 10}, {2, 20}};
+        flat_map<int, int> m2{{2, 20}, {1, 10}};
+        gdt_assert(m1 == m2);
+        m2[2] = 21;
+        gdt_assert(m1 != m2);
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_flat_map(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Bulk insert matches one-at-a-time insert.
+    {
+        gdt::dynarr<std::pair<std::uint32_t, std::uint32_t>> pairs;
+        for (std::uint32_t i = 0; i < 10000; ++i)
+        {
+            pairs.push_back({(i * 7919) % 5003, i});
+        }
+
+        flat_map<std::uint32_t, std::uint32_t> bulk;
+        bulk.insert(pairs.begin(), pairs.begin() + 5000);
+        bulk.insert_range(pairs);
+
+        flat_map<std::uint32_t, std::uint32_t> single;
+        for (auto& p : pairs)
+        {
+            single.insert(p);
+        }
+
+        gdt_assert(bulk == single);
+        gdt_assert(bulk.size() == 5003);
+        gdt_assert(std::is_sorted(bulk.keys().begin(), bulk.keys().end()));
+        for (auto [k, v] : bulk)
+        {
+            gdt_assert((v * 7919) % 5003 == k);
+        }
+    }
+
+    // Non-trivial values and 32-bit sizes.
+    {
+        using allocator_type = gdt::allocator<
+            std::pair<std::string, std::unique_ptr<int>>,
+            std::uint32_t,
+            std::int32_t>;
+        flat_map<
+            std::string,
+            std::unique_ptr<int>,
+            std::less<std::string>,
+            allocator_type> m;
+
+        m.try_emplace("b", std::make_unique<int>(2));
+        m.try_emplace("a", std::make_unique<int>(1));
+        m["c"] = std::make_unique<int>(3);
+        gdt_assert(*m.at("a") == 1);
+        gdt_assert(*m.values()[2] == 3);
+
+        auto it = m.find("b");
+        gdt_assert(it != m.end());
+        gdt_assert(*it->second == 2);
+        gdt_assert(std::distance(m.begin(), m.end()) == 3);
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,150 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/flat_set.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+using gdt::flat_set;
+
+consteval int test_consteval()
+{
+    // Default constructor.
+    {
+        flat_set<int> s;
+        gdt_assert(s.empty());
+        gdt_assert(s.begin() == s.end());
+        gdt_assert(!s.contains(0));
+        gdt_assert(s.lower_bound(0) == s.end());
+    }
+
+    // Initializer list constructor sorts and drops duplicates.
+    {
+        flat_set<int> s{5, 3, 9, 3, 1};
+        gdt_assert(s.size() == 4);
+        gdt_assert(s.keys()[0] == 1);
+        gdt_assert(s.keys()[1] == 3);
+        gdt_assert(s.keys()[2] == 5);
+        gdt_assert(s.keys()[3] == 9);
+    }
+
+    // Insert keeps keys sorted.
+    {
+        flat_set<int> s;
+        gdt_assert(s.insert(2).second);
+        gdt_assert(s.insert(0).second);
+        gdt_assert(*s.insert(1).first == 1);
+        gdt_assert(!s.insert(2).second);
+        gdt_assert(s.emplace(3).second);
+        gdt_assert(s == flat_set<int>({0, 1, 2, 3}));
+    }
+
+    // Find and bounds.
+    {
+        flat_set<int> s{10, 20, 30};
+        gdt_assert(*s.find(20) == 20);
+        gdt_assert(s.find(25) == s.end());
+        gdt_assert(s.count(30) == 1);
+        gdt_assert(s.count(5) == 0);
+        gdt_assert(*s.lower_bound(20) == 20);
+        gdt_assert(*s.upper_bound(20) == 30);
+        gdt_assert(*s.lower_bound(15) == 20);
+        gdt_assert(s.lower_bound(35) == s.end());
+        gdt_assert(s.upper_bound(30) == s.end());
+        gdt_assert(s.upper_bound(0) == s.begin());
+    }
+
+    // Insert range merges into existing keys.
+    {
+        flat_set<int> s{2, 4, 6};
+        int more[] = {7, 1, 4, 5, 1};
+        s.insert_range(more);
+        gdt_assert(s == flat_set<int>({1, 2, 4, 5, 6, 7}));
+
+        // Appends past the back.
+        s.insert({9, 8, 9});
+        gdt_assert(s.size() == 8);
+        gdt_assert(s.keys()[7] == 9);
+    }
+
+    // Erase.
+    {
+        flat_set<int> s{1, 2, 3, 4};
+        gdt_assert(s.erase(2) == 1);
+        gdt_assert(s.erase(2) == 0);
+        auto it = s.erase(s.begin());
+        gdt_assert(*it == 3);
+        s.erase(s.begin(), s.end());
+        gdt_assert(s.empty());
+    }
+
+    // Custom comparison.
+    {
+        flat_set<int, std::greater<int>> s{1, 3, 2};
+        gdt_assert(s.keys()[0] == 3);
+        gdt_assert(s.keys()[2] == 1);
+        gdt_assert(*s.lower_bound(2) == 2);
+    }
+
+    // Swap.
+    {
+        flat_set<int> s1{1};
+        flat_set<int> s2{2, 3};
+        swap(s1, s2);
+        gdt_assert(s1.size() == 2);
+        gdt_assert(s2.contains(1));
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_flat_set(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Bulk insert matches one-at-a-time insert.
+    {
+        gdt::dynarr<std::uint32_t> keys;
+        for (std::uint32_t i = 0; i < 10000; ++i)
+        {
+            keys.push_back((i * 7919) % 5003);
+        }
+
+        flat_set<std::uint32_t> bulk;
+        bulk.insert(keys.begin(), keys.begin() + 5000);
+        bulk.insert_range(keys);
+
+        flat_set<std::uint32_t> single;
+        for (auto k : keys)
+        {
+            single.insert(k);
+        }
+
+        gdt_assert(bulk == single);
+        gdt_assert(bulk.size() == 5003);
+        for (std::uint32_t i = 0; i < 5003; ++i)
+        {
+            gdt_assert(bulk.keys()[i] == i);
+        }
+    }
+
+    // Non-trivial keys.
+    {
+        flat_set<std::string> s{"pear", "apple", "fig"};
+        s.insert_range(flat_set<std::string>{"kiwi", "apple"});
+        gdt_assert(s.size() == 4);
+        gdt_assert(*s.begin() == "apple");
+        gdt_assert(s.contains("kiwi"));
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,109 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/frustum.hxx>
+
+#include <gdt/aabb.hxx>
+#include <gdt/assert.hxx>
+#include <gdt/mat.hxx>
+#include <gdt/vec.hxx>
+#include <cstddef>
+#include <cstdint>
+
+using gdt::aabb;
+using gdt::aabb_soa;
+using gdt::all;
+using gdt::frustum;
+using gdt::mat4;
+using gdt::overlaps;
+using gdt::vec;
+
+using box3 = aabb<float, 3>;
+
+// Box that x from [-2, 2], y from [-1, 1], and z from [1, 3] map to clip
+// space.
+constexpr frustum<float> sample_frustum()
+{
+    mat4<float> m(
+        vec(0.5f, 0.0f, 0.0f, 0.0f),
+        vec(0.0f, 1.0f, 0.0f, 0.0f),
+        vec(0.0f, 0.0f, 0.5f, 0.0f),
+        vec(0.0f, 0.0f, -0.5f, 1.0f));
+    return frustum<float>(m);
+}
+
+consteval int test_consteval()
+{
+    auto f = sample_frustum();
+
+    // Planes.
+    {
+        gdt_assert(all(f.plane(0) == vec(0.5f, 0.0f, 0.0f, 1.0f)));
+        gdt_assert(all(f.plane(1) == vec(-0.5f, 0.0f, 0.0f, 1.0f)));
+        gdt_assert(all(f.plane(4) == vec(0.0f, 0.0f, 0.5f, -0.5f)));
+        gdt_assert(all(f.plane(5) == vec(0.0f, 0.0f, -0.5f, 1.5f)));
+    }
+
+    // Overlaps.
+    {
+        gdt_assert(overlaps(f, box3(vec(-1.0f, -0.5f, 1.5f), vec(1.0f, 0.5f, 2.5f))));
+        gdt_assert(overlaps(f, box3(vec(-9.0f, -9.0f, -9.0f), vec(9.0f, 9.0f, 9.0f))));
+        gdt_assert(overlaps(f, box3(vec(1.5f, 0.5f, 2.5f), vec(5.0f, 5.0f, 5.0f))));
+        gdt_assert(overlaps(f, box3(vec(2.0f, 0.0f, 2.0f), vec(3.0f, 1.0f, 3.0f))));
+        gdt_assert(!overlaps(f, box3(vec(2.5f, 0.0f, 2.0f), vec(3.0f, 1.0f, 3.0f))));
+        gdt_assert(!overlaps(f, box3(vec(0.0f, 0.0f, 0.0f), vec(0.5f, 0.5f, 0.5f))));
+        gdt_assert(!overlaps(f, box3(vec(0.0f, 0.0f, 3.5f), vec(0.5f, 0.5f, 4.0f))));
+        gdt_assert(!overlaps(f, box3::empty()));
+    }
+
+    // Batches.
+    {
+        auto boxes = aabb_soa<float, 3, 4>::empty();
+        boxes.set(0, box3(vec(-1.0f, -0.5f, 1.5f), vec(1.0f, 0.5f, 2.5f)));
+        boxes.set(1, box3(vec(2.5f, 0.0f, 2.0f), vec(3.0f, 1.0f, 3.0f)));
+        boxes.set(2, box3(vec(1.5f, 0.5f, 2.5f), vec(5.0f, 5.0f, 5.0f)));
+        gdt_assert(gdt::batch::overlaps(f, boxes) == 0b0101);
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_frustum(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Batch overlaps matches the scalar test.
+    {
+        auto f = sample_frustum();
+        for (std::size_t first = 0; first < 512; first += 8)
+        {
+            auto boxes = aabb_soa<float, 3, 8>::empty();
+            for (std::size_t i = 0; i < 7; ++i)
+            {
+                auto j = first + i;
+                auto x = float(j % 11) * 0.5f - 3.0f;
+                auto y = float(j % 7) * 0.5f - 2.0f;
+                auto z = float(j % 9) * 0.5f - 0.5f;
+                auto s = float(j % 3) * 0.5f;
+                boxes.set(i, box3(vec(x, y, z), vec(x + s, y + s, z + s)));
+            }
+
+            std::uint32_t expected = 0;
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                if (overlaps(f, boxes.get(i)))
+                {
+                    expected |= std::uint32_t(1) << i;
+                }
+            }
+            gdt_assert(gdt::batch::overlaps(f, boxes) == expected);
+        }
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/growth_policy.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <cstdint>
+
+using gdt::capped_growth;
+using gdt::default_growth;
+using gdt::dynarr;
+using gdt::geometric_growth;
+using gdt::rounded_growth;
+
+consteval int test_consteval()
+{
+    // Default growth doubles.
+    {
+        using g = default_growth;
+        gdt_assert(g::next_capacity<std::size_t>(0, 1, 100, 4) == 1);
+        gdt_assert(g::next_capacity<std::size_t>(1, 2, 100, 4) == 2);
+        gdt_assert(g::next_capacity<std::size_t>(8, 9, 100, 4) == 16);
+        gdt_assert(g::next_capacity<std::size_t>(8, 20, 100, 4) == 20);
+        gdt_assert(g::next_capacity<std::size_t>(60, 61, 100, 4) == 100);
+        gdt_assert(g::next_capacity<std::uint8_t>(200, 201, 255, 4) == 255);
+    }
+
+    // Geometric growth by 1.5x.
+    {
+        using g = geometric_growth<3, 2>;
+        gdt_assert(g::next_capacity<std::size_t>(1, 2, 100, 4) == 2);
+        gdt_assert(g::next_capacity<std::size_t>(2, 3, 100, 4) == 3);
+        gdt_assert(g::next_capacity<std::size_t>(10, 11, 100, 4) == 15);
+        gdt_assert(g::next_capacity<std::size_t>(40, 41, 100, 4) == 60);
+        gdt_assert(g::next_capacity<std::size_t>(80, 81, 100, 4) == 100);
+    }
+
+    // Minimum capacity.
+    {
+        using g = geometric_growth<2, 1, 16>;
+        gdt_assert(g::next_capacity<std::size_t>(0, 1, 100, 4) == 16);
+        gdt_assert(g::next_capacity<std::size_t>(16, 17, 100, 4) == 32);
+        gdt_assert(g::next_capacity<std::size_t>(0, 1, 10, 4) == 10);
+    }
+
+    // Rounded growth.
+    {
+        using g = rounded_growth<default_growth, 4096>;
+        gdt_assert(g::next_capacity<std::size_t>(8, 9, 1 << 20, 4) == 16);
+        gdt_assert(g::next_capacity<std::size_t>(1000, 1001, 1 << 20, 4) == 2048);
+        gdt_assert(g::next_capacity<std::size_t>(1100, 1101, 1 << 20, 12) == 2389);
+        gdt_assert(g::next_capacity<std::size_t>(1000, 1001, 2040, 12) == 2000);
+    }
+
+    // Capped growth.
+    {
+        using g = capped_growth<default_growth, 4096, 1024>;
+        gdt_assert(g::next_capacity<std::size_t>(512, 513, 1 << 20, 4) == 1024);
+        gdt_assert(g::next_capacity<std::size_t>(1024, 1025, 1 << 20, 4) == 1280);
+        gdt_assert(g::next_capacity<std::size_t>(1024, 2000, 1 << 20, 4) == 2000);
+        gdt_assert(g::next_capacity<std::size_t>(1024, 1025, 1100, 4) == 1100);
+    }
+
+    // Dynarr with a growth policy.
+    {
+        dynarr<int, gdt::allocator<int>, geometric_growth<2, 1, 8>> a;
+        a.push_back(1);
+        gdt_assert(a.capacity() == 8);
+        a.resize(9);
+        gdt_assert(a.capacity() == 16);
+        gdt_assert(erase(a, 0) == 8);
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_growth_policy(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Growth policies don't affect relocatability.
+    {
+        using a = dynarr<int, gdt::allocator<int>, geometric_growth<3, 2>>;
+        gdt_assert(gdt::is_trivially_relocatable_v<a>);
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,177 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/half.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <gdt/vec.hxx>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+using gdt::all;
+using gdt::dynarr;
+using gdt::half;
+using gdt::vec;
+using gdt::vec3;
+using gdt::vec4;
+
+// Binary16 bits is a NaN.
+constexpr bool is_nan(std::uint16_t bits)
+{
+    return (bits & 0x7c00) == 0x7c00 && (bits & 0x03ff) != 0;
+}
+
+consteval int test_consteval()
+{
+    // Float to half.
+    {
+        auto inf = std::numeric_limits<float>::infinity();
+        gdt_assert(half(0.0f).bits() == 0x0000);
+        gdt_assert(half(-0.0f).bits() == 0x8000);
+        gdt_assert(half(1.0f).bits() == 0x3c00);
+        gdt_assert(half(-2.0f).bits() == 0xc000);
+        gdt_assert(half(0.1f).bits() == 0x2e66);
+        gdt_assert(half(65504.0f).bits() == 0x7bff);
+        gdt_assert(half(65519.0f).bits() == 0x7bff);
+        gdt_assert(half(65520.0f).bits() == 0x7c00);
+        gdt_assert(half(1e10f).bits() == 0x7c00);
+        gdt_assert(half(inf).bits() == 0x7c00);
+        gdt_assert(half(-inf).bits() == 0xfc00);
+        gdt_assert(is_nan(half(std::numeric_limits<float>::quiet_NaN()).bits()));
+    }
+
+    // Rounding to nearest even.
+    {
+        // 1 + 2^-11 is halfway between 1 and the next half.
+        gdt_assert(half(1.00048828125f).bits() == 0x3c00);
+        gdt_assert(half(1.00146484375f).bits() == 0x3c02);
+        gdt_assert(half(1.0005f).bits() == 0x3c01);
+    }
+
+    // Subnormals.
+    {
+        auto tiny = 0x1p-24f;
+        gdt_assert(half(tiny).bits() == 0x0001);
+        gdt_assert(half(tiny * 0.5f).bits() == 0x0000);
+        gdt_assert(half(tiny * 1.5f).bits() == 0x0002);
+        gdt_assert(half(tiny * 1023.0f).bits() == 0x03ff);
+        gdt_assert(half(0x1p-14f).bits() == 0x0400);
+        gdt_assert(half(0x1p-14f - tiny * 0.25f).bits() == 0x0400);
+    }
+
+    // Half to float.
+    {
+        gdt_assert(float(half::from_bits(0x3c00)) == 1.0f);
+        gdt_assert(float(half::from_bits(0xc000)) == -2.0f);
+        gdt_assert(float(half::from_bits(0x7bff)) == 65504.0f);
+        gdt_assert(float(half::from_bits(0x0001)) == 0x1p-24f);
+        gdt_assert(float(half::from_bits(0x03ff)) == 0x1p-24f * 1023.0f);
+        gdt_assert(float(half::from_bits(0x7c00)) == std::numeric_limits<float>::infinity());
+        gdt_assert(float(half::from_bits(0xfc00)) == -std::numeric_limits<float>::infinity());
+        auto nan = float(half::from_bits(0x7e00));
+        gdt_assert(nan != nan);
+        gdt_assert(std::bit_cast<std::uint32_t>(float(half::from_bits(0x8000))) == 0x80000000);
+    }
+
+    // Vectors.
+    {
+        auto v = vec(1.0f, 0.5f, -2.0f, 0.25f);
+        vec4<half> h(v);
+        gdt_assert(h[1].bits() == 0x3800);
+        gdt_assert(all(vec4<float>(h) == v));
+        gdt_assert(all(vec3<float>(h) == v.xyz()));
+        gdt_assert(h[0] + h[1] == 1.5f);
+        gdt_assert(all(h + h == v * 2.0f));
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_half(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Every half round-trips through float, one at a time and in bulk.
+    {
+        dynarr<half> h;
+        for (std::uint32_t bits = 0; bits <= 0xffff; ++bits)
+        {
+            h.push_back(half::from_bits(std::uint16_t(bits)));
+        }
+
+        dynarr<float> f(h.size());
+        dynarr<half> back(h.size());
+        gdt::batch::convert(h, f);
+        gdt::batch::convert(f, back);
+        for (std::size_t i = 0; i < h.size(); ++i)
+        {
+            auto bits = h[i].bits();
+            auto scalar = float(h[i]);
+            if (is_nan(bits))
+            {
+                gdt_assert(f[i] != f[i]);
+                gdt_assert(is_nan(back[i].bits()));
+                continue;
+            }
+
+            gdt_assert(std::bit_cast<std::uint32_t>(f[i]) == std::bit_cast<std::uint32_t>(scalar));
+            gdt_assert(half(scalar).bits() == bits);
+            gdt_assert(back[i].bits() == bits);
+        }
+    }
+
+    // Bulk conversion from float matches the scalar conversion.
+    {
+        dynarr<float> f;
+        for (std::uint64_t bits = 0; bits <= 0xffffffff; bits += 0x1001)
+        {
+            f.push_back(std::bit_cast<float>(std::uint32_t(bits)));
+        }
+
+        dynarr<half> h(f.size());
+        gdt::batch::convert(f, h);
+        for (std::size_t i = 0; i < f.size(); ++i)
+        {
+            auto scalar = half(f[i]).bits();
+            if (is_nan(scalar))
+            {
+                gdt_assert(is_nan(h[i].bits()));
+                gdt_assert((h[i].bits() & 0x8000) == (scalar & 0x8000));
+            }
+            else
+            {
+                gdt_assert(h[i].bits() == scalar);
+            }
+        }
+    }
+
+    // Vector spans, with a length that leaves a scalar tail.
+    {
+        dynarr<vec3<float>> v;
+        for (int i = 0; i < 11; ++i)
+        {
+            auto f = float(i);
+            v.push_back(vec(f, f * 0.25f, -f * 1024.0f));
+        }
+
+        dynarr<vec3<half>> h(v.size());
+        dynarr<vec3<float>> back(v.size());
+        gdt::batch::convert(v, h);
+        gdt::batch::convert(h, back);
+        for (std::size_t i = 0; i < v.size(); ++i)
+        {
+            gdt_assert(all(vec3<float>(h[i]) == v[i]));
+            gdt_assert(all(back[i] == v[i]));
+        }
+    }
+
+    // Success.
+    return 0;
+}
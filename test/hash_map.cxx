@@ -0,0 +1,298 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/hash_map.hxx>
+
+#include <gdt/allocator.hxx>
+#include <gdt/assert.hxx>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+
+using gdt::hash_map;
+
+namespace
+{
+    // Hash usable in constant expressions.
+    struct int_hash
+    {
+        constexpr std::size_t operator()(int i) const noexcept
+        {
+            return std::size_t(i);
+        }
+    };
+
+    // Hash that sends every key to the same probe sequence.
+    struct collide_hash
+    {
+        constexpr std::size_t operator()(int) const noexcept
+        {
+            return 0;
+        }
+    };
+
+    using int_map = hash_map<int, int, int_hash>;
+}
+
+consteval int test_consteval()
+{
+    // Default constructor.
+    {
+        int_map m;
+        gdt_assert(m.empty());
+        gdt_assert(m.size() == 0);
+        gdt_assert(m.capacity() == 0);
+        gdt_assert(m.begin() == m.end());
+        gdt_assert(m.find(1) == m.end());
+        gdt_assert(!m.contains(1));
+    }
+
+    // Initializer list constructor.
+    {
+        int_map m{{1, 10}, {2, 20}, {1, 30}};
+        gdt_assert(m.size() == 2);
+        gdt_assert(m.at(1) == 10);
+        gdt_assert(m.at(2) == 20);
+    }
+
+    // Insert.
+    {
+        int_map m;
+        auto [it, inserted] = m.insert({1, 10});
+        gdt_assert(inserted);
+        gdt_assert(it->first == 1);
+        gdt_assert(it->second == 10);
+
+        auto [it2, inserted2] = m.insert({1, 20});
+        gdt_assert(!inserted2);
+        gdt_assert(it2 == it);
+        gdt_assert(it2->second == 10);
+    }
+
+    // Try emplace, insert or assign and subscript.
+    {
+        int_map m;
+        gdt_assert(m.try_emplace(1, 10).second);
+        gdt_assert(!m.try_emplace(1, 20).second);
+        gdt_assert(m[1] == 10);
+
+        gdt_assert(!m.insert_or_assign(1, 30).second);
+        gdt_assert(m[1] == 30);
+        gdt_assert(m.insert_or_assign(2, 40).second);
+
+        m[3] += 5;
+        gdt_assert(m[3] == 5);
+        gdt_assert(m.size() == 3);
+    }
+
+    // Growth.
+    {
+        int_map m;
+        for (int i = 0; i < 100; ++i)
+        {
+            m[i] = i * 2;
+        }
+
+        gdt_assert(m.size() == 100);
+        gdt_assert(m.capacity() >= 100);
+        for (int i = 0; i < 100; ++i)
+        {
+            gdt_assert(m.at(i) == i * 2);
+        }
+        gdt_assert(!m.contains(100));
+        gdt_assert(std::distance(m.begin(), m.end()) == 100);
+    }
+
+    // Erase.
+    {
+        int_map m;
+        for (int i = 0; i < 50; ++i)
+        {
+            m[i] = i;
+        }
+
+        gdt_assert(m.erase(10) == 1);
+        gdt_assert(m.erase(10) == 0);
+        gdt_assert(!m.contains(10));
+        gdt_assert(m.size() == 49);
+
+        for (auto it = m.begin(); it != m.end();)
+        {
+            if (it->first % 2 == 0)
+            {
+                it = m.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        gdt_assert(m.size() == 25);
+        for (int i = 0; i < 50; ++i)
+        {
+            gdt_assert(m.contains(i) == (i % 2 == 1));
+        }
+    }
+
+    // Collisions.
+    {
+        hash_map<int, int, collide_hash> m;
+        for (int i = 0; i < 40; ++i)
+        {
+            m[i] = i;
+        }
+        for (int i = 0; i < 40; i += 3)
+        {
+            m.erase(i);
+        }
+        for (int i = 0; i < 40; ++i)
+        {
+            gdt_assert(m.contains(i) == (i % 3 != 0));
+        }
+    }
+
+    // Copy and move.
+    {
+        int_map m1{{1, 10}, {2, 20}};
+        int_map m2 = m1;
+        gdt_assert(m2 == m1);
+
+        m2[3] = 30;
+        gdt_assert(m2 != m1);
+
+        int_map m3 = std::move(m2);
+        gdt_assert(m3.size() == 3);
+
+        m1 = m3;
+        gdt_assert(m1 == m3);
+
+        m1 = {{4, 40}};
+        gdt_assert(m1.size() == 1);
+        gdt_assert(m1.at(4) == 40);
+    }
+
+    // Clear and reserve.
+    {
+        int_map m{{1, 10}, {2, 20}};
+        auto capacity = m.capacity();
+        m.clear();
+        gdt_assert(m.empty());
+        gdt_assert(m.capacity() == capacity);
+        gdt_assert(m.begin() == m.end());
+
+        m.reserve(100);
+        auto reserved = m.capacity();
+        for (int i = 0; i < 100; ++i)
+        {
+            m[i] = i;
+        }
+        gdt_assert(m.capacity() == reserved);
+    }
+
+    // Non-trivial elements.
+    {
+        hash_map<int, std::string, int_hash> m;
+        for (int i = 0; i < 20; ++i)
+        {
+            m[i] = std::string(std::size_t(i), 'x');
+        }
+        m.erase(5);
+        gdt_assert(m.at(19).size() == 19);
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_hash_map(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Runtime.
+    {
+        hash_map<std::uint64_t, std::uint64_t> m;
+        for (std::uint64_t i = 0; i < 100000; ++i)
+        {
+            m[i * 7919] = i;
+        }
+
+        gdt_assert(m.size() == 100000);
+        for (std::uint64_t i = 0; i < 100000; ++i)
+        {
+            gdt_assert(m.at(i * 7919) == i);
+        }
+
+        for (std::uint64_t i = 0; i < 100000; i += 2)
+        {
+            gdt_assert(m.erase(i * 7919) == 1);
+        }
+
+        gdt_assert(m.size() == 50000);
+        for (std::uint64_t i = 0; i < 100000; ++i)
+        {
+            gdt_assert(m.contains(i * 7919) == (i % 2 == 1));
+        }
+    }
+
+    // Churn reuses deleted slots instead of growing forever.
+    {
+        hash_map<int, int> m;
+        for (int i = 0; i < 1000; ++i)
+        {
+            m[i] = i;
+        }
+
+        auto capacity = m.capacity();
+        for (int i = 1000; i < 100000; ++i)
+        {
+            m.erase(i - 1000);
+            m[i] = i;
+        }
+
+        gdt_assert(m.size() == 1000);
+        gdt_assert(m.capacity() == capacity);
+        gdt_assert(m.at(99999) == 99999);
+    }
+
+    // Compact 32-bit indexing.
+    {
+        using allocator_type = gdt::allocator<
+            std::pair<const int, int>, std::uint32_t, std::int32_t>;
+        using map = hash_map<
+            int, int, std::hash<int>, std::equal_to<int>, allocator_type>;
+
+        gdt_assert((std::is_same_v<map::size_type, std::uint32_t>));
+        gdt_assert((std::is_same_v<map::difference_type, std::int32_t>));
+
+        map m;
+        for (int i = 0; i < 1000; ++i)
+        {
+            m[i] = -i;
+        }
+        gdt_assert(m.size() == 1000u);
+        gdt_assert(m.at(999) == -999);
+    }
+
+    // Iterators are forward iterators.
+    {
+        gdt_assert(std::forward_iterator<int_map::iterator>);
+        gdt_assert(std::forward_iterator<int_map::const_iterator>);
+        gdt_assert((std::is_same_v<decltype(*int_map::iterator()),
+            std::pair<const int, int>&>));
+    }
+
+    // Relocatability follows the functors and allocator.
+    {
+        gdt_assert(gdt::is_trivially_relocatable_v<int_map>);
+    }
+
+    // Success.
+    return 0;
+}
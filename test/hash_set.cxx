@@ -0,0 +1,151 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/hash_set.hxx>
+
+#include <gdt/assert.hxx>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+using gdt::hash_set;
+
+namespace
+{
+    // Hash usable in constant expressions.
+    struct int_hash
+    {
+        constexpr std::size_t operator()(int i) const noexcept
+        {
+            return std::size_t(i);
+        }
+    };
+
+    using int_set = hash_set<int, int_hash>;
+}
+
+consteval int test_consteval()
+{
+    // Default constructor.
+    {
+        int_set s;
+        gdt_assert(s.empty());
+        gdt_assert(s.begin() == s.end());
+        gdt_assert(!s.contains(0));
+    }
+
+    // Initializer list constructor.
+    {
+        int_set s{3, 1, 2, 1};
+        gdt_assert(s.size() == 3);
+        gdt_assert(s.contains(1));
+        gdt_assert(s.contains(2));
+        gdt_assert(s.contains(3));
+        gdt_assert(s.count(4) == 0);
+    }
+
+    // Insert, emplace and erase.
+    {
+        int_set s;
+        gdt_assert(s.insert(1).second);
+        gdt_assert(!s.insert(1).second);
+        gdt_assert(s.emplace(2).second);
+        gdt_assert(*s.find(2) == 2);
+
+        gdt_assert(s.erase(1) == 1);
+        gdt_assert(!s.contains(1));
+        gdt_assert(s.size() == 1);
+    }
+
+    // Growth and iteration.
+    {
+        int_set s;
+        for (int i = 0; i < 200; ++i)
+        {
+            s.insert(i);
+        }
+
+        int sum = 0;
+        for (auto i : s)
+        {
+            sum += i;
+        }
+        gdt_assert(sum == 199 * 200 / 2);
+    }
+
+    // Equality ignores order.
+    {
+        int_set s1{1, 2, 3};
+        int_set s2{3, 2, 1};
+        gdt_assert(s1 == s2);
+
+        s2.erase(2);
+        gdt_assert(s1 != s2);
+    }
+
+    // Rehash drops deleted slots.
+    {
+        int_set s;
+        for (int i = 0; i < 100; ++i)
+        {
+            s.insert(i);
+        }
+        for (int i = 0; i < 90; ++i)
+        {
+            s.erase(i);
+        }
+
+        s.rehash(0);
+        gdt_assert(s.capacity() < 100);
+        for (int i = 90; i < 100; ++i)
+        {
+            gdt_assert(s.contains(i));
+        }
+    }
+
+    // Swap.
+    {
+        int_set s1{1};
+        int_set s2{2, 3};
+        swap(s1, s2);
+        gdt_assert(s1.size() == 2);
+        gdt_assert(s2.contains(1));
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_hash_set(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Runtime.
+    {
+        hash_set<std::uint32_t> s;
+        for (std::uint32_t i = 0; i < 100000; ++i)
+        {
+            s.insert(i * 2654435761u);
+        }
+
+        gdt_assert(s.size() == 100000);
+        for (std::uint32_t i = 0; i < 100000; ++i)
+        {
+            gdt_assert(s.contains(i * 2654435761u));
+            gdt_assert(!s.contains(i * 2654435761u + 1));
+        }
+    }
+
+    // Iterators are constant.
+    {
+        gdt_assert((std::is_same_v<int_set::iterator, int_set::const_iterator>));
+        gdt_assert((std::is_same_v<decltype(*int_set::iterator()), const int&>));
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,215 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/mat.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <gdt/vec.hxx>
+#include <cmath>
+#include <cstddef>
+
+using gdt::all;
+using gdt::determinant;
+using gdt::dynarr;
+using gdt::inverse;
+using gdt::mat;
+using gdt::mat2;
+using gdt::mat3;
+using gdt::mat4;
+using gdt::transpose;
+using gdt::vec;
+using gdt::vec3;
+using gdt::vec4;
+
+// Components within `eps` of each other.
+template<typename T, std::size_t R, std::size_t C>
+constexpr bool near(const mat<T, R, C>& a, const mat<T, R, C>& b, T eps)
+{
+    for (std::size_t c = 0; c < C; ++c)
+    {
+        for (std::size_t r = 0; r < R; ++r)
+        {
+            auto d = a[c][r] - b[c][r];
+            if (d > eps || d < -eps)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// A well-conditioned 4x4 matrix.
+constexpr mat4<float> sample_mat4()
+{
+    return {
+        vec(2.0f, 0.5f, 0.0f, 0.25f),
+        vec(-1.0f, 3.0f, 1.0f, 0.0f),
+        vec(0.0f, 1.0f, 4.0f, -0.5f),
+        vec(1.0f, -2.0f, 0.5f, 1.0f),
+    };
+}
+
+consteval int test_consteval()
+{
+    // Diagonal and identity.
+    {
+        mat3<int> m(2);
+        gdt_assert(all(m[0] == vec(2, 0, 0)));
+        gdt_assert(all(m[1] == vec(0, 2, 0)));
+        gdt_assert(all(m[2] == vec(0, 0, 2)));
+        gdt_assert(mat3<int>::identity() == mat3<int>(1));
+    }
+
+    // Column constructor and rows.
+    {
+        mat<int, 2, 3> m(vec(1, 2), vec(3, 4), vec(5, 6));
+        gdt_assert(all(m[1] == vec(3, 4)));
+        gdt_assert(all(m.row(0) == vec(1, 3, 5)));
+        gdt_assert(all(m.row(1) == vec(2, 4, 6)));
+    }
+
+    // Truncation.
+    {
+        mat4<int> m(vec(1, 2, 3, 4), vec(5, 6, 7, 8), vec4<int>(0), vec4<int>(0));
+        mat2<int> t(m);
+        gdt_assert(t == mat2<int>(vec(1, 2), vec(5, 6)));
+    }
+
+    // Component-wise operators.
+    {
+        mat2<int> a(vec(1, 2), vec(3, 4));
+        mat2<int> b(vec(4, 3), vec(2, 1));
+        gdt_assert(a + b == mat2<int>(vec(5, 5), vec(5, 5)));
+        gdt_assert(a - b == mat2<int>(vec(-3, -1), vec(1, 3)));
+        gdt_assert(-a == mat2<int>(vec(-1, -2), vec(-3, -4)));
+        gdt_assert(a * 2 == mat2<int>(vec(2, 4), vec(6, 8)));
+        gdt_assert(2 * a == a * 2);
+        gdt_assert(a * 2 / 2 == a);
+        gdt_assert(a != b);
+    }
+
+    // Multiplication.
+    {
+        mat<int, 2, 3> a(vec(1, 4), vec(2, 5), vec(3, 6));
+        mat<int, 3, 2> b(vec(7, 9, 11), vec(8, 10, 12));
+        auto ab = a * b;
+        gdt_assert(ab == mat2<int>(vec(58, 139), vec(64, 154)));
+        gdt_assert(all(a * vec(1, 1, 1) == vec(6, 15)));
+        gdt_assert(all(vec(1, 1) * a == vec(5, 7, 9)));
+    }
+
+    // Transpose.
+    {
+        mat<int, 2, 3> a(vec(1, 4), vec(2, 5), vec(3, 6));
+        auto t = transpose(a);
+        gdt_assert((t == mat<int, 3, 2>(vec(1, 2, 3), vec(4, 5, 6))));
+        gdt_assert(transpose(t) == a);
+    }
+
+    // Determinant.
+    {
+        gdt_assert(determinant(mat2<int>(vec(1, 2), vec(3, 4))) == -2);
+        gdt_assert(determinant(mat3<int>(2)) == 8);
+        mat3<int> swap_yz(vec(1, 0, 0), vec(0, 0, 1), vec(0, 1, 0));
+        gdt_assert(determinant(swap_yz) == -1);
+        gdt_assert(determinant(mat4<int>(3)) == 81);
+        mat4<int> m(
+            vec(1, 0, 2, -1),
+            vec(3, 0, 0, 5),
+            vec(2, 1, 4, -3),
+            vec(1, 0, 5, 0));
+        gdt_assert(determinant(m) == 30);
+    }
+
+    // Inverse.
+    {
+        mat2<double> m2(vec(4.0, 2.0), vec(7.0, 6.0));
+        gdt_assert(near(m2 * inverse(m2), mat2<double>(1.0), 1e-12));
+
+        mat3<double> m3(vec(1.0, 0.0, 5.0), vec(2.0, 1.0, 6.0), vec(3.0, 4.0, 0.0));
+        gdt_assert(near(m3 * inverse(m3), mat3<double>(1.0), 1e-12));
+        gdt_assert(near(inverse(m3) * m3, mat3<double>(1.0), 1e-12));
+
+        auto m4 = sample_mat4();
+        gdt_assert(near(m4 * inverse(m4), mat4<float>(1.0f), 1e-5f));
+        gdt_assert(near(inverse(m4) * m4, mat4<float>(1.0f), 1e-5f));
+    }
+
+    // Batch transform.
+    {
+        auto m = sample_mat4();
+        vec4<float> in[2] = {vec(1.0f, 2.0f, 3.0f, 1.0f), vec(0.0f, 1.0f, 0.0f, 0.0f)};
+        vec4<float> out[2];
+        gdt::batch::transform(m, in, out);
+        gdt_assert(all(out[0] == m * in[0]));
+        gdt_assert(all(out[1] == m * in[1]));
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_mat(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // SIMD kernels match the scalar code.
+    {
+        static constexpr auto a = sample_mat4();
+        static constexpr auto b = inverse(sample_mat4()) * 3.0f;
+        static constexpr auto v = vec(1.5f, -2.0f, 0.25f, 1.0f);
+
+        constexpr auto ab = a * b;
+        constexpr auto av = a * v;
+        auto ab_rt = a * b;
+        auto av_rt = a * v;
+        gdt_assert(ab_rt == ab);
+        gdt_assert(all(av_rt == av));
+    }
+
+    // Batch transforms match per-element transforms.
+    {
+        auto m = sample_mat4();
+        dynarr<vec4<float>> v4;
+        dynarr<vec3<float>> v3;
+        for (int i = 0; i < 11; ++i)
+        {
+            auto f = float(i);
+            v4.push_back(vec(f, 1.0f - f, f * 0.5f, 1.0f));
+            v3.push_back(vec(f, 1.0f - f, f * 0.5f));
+        }
+
+        dynarr<vec4<float>> o4(v4.size());
+        gdt::batch::transform(m, v4, o4);
+        for (std::size_t i = 0; i < v4.size(); ++i)
+        {
+            gdt_assert(all(o4[i] == m * v4[i]));
+        }
+
+        dynarr<vec3<float>> points(v3.size());
+        dynarr<vec3<float>> vectors(v3.size());
+        gdt::batch::transform_points(m, v3, points);
+        gdt::batch::transform_vectors(m, v3, vectors);
+        for (std::size_t i = 0; i < v3.size(); ++i)
+        {
+            auto p = m[0].xyz() * v3[i][0] + m[1].xyz() * v3[i][1] + m[2].xyz() * v3[i][2];
+            gdt_assert(all(vectors[i] == p));
+            gdt_assert(all(points[i] == p + m[3].xyz()));
+        }
+
+        // In place.
+        gdt::batch::transform_points(m, v3, v3);
+        for (std::size_t i = 0; i < v3.size(); ++i)
+        {
+            gdt_assert(all(v3[i] == points[i]));
+        }
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,163 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/mpmc_queue.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+
+using gdt::mpmc_queue;
+
+int test_mpmc_queue(int, char** const)
+{
+    // Capacity rounds up to a power of 2, and at least 2.
+    {
+        mpmc_queue<int> q1(5);
+        gdt_assert(q1.capacity() == 8);
+
+        mpmc_queue<int> q2(1);
+        gdt_assert(q2.capacity() == 2);
+    }
+
+    // Push and pop in order until full.
+    {
+        mpmc_queue<int> q(4);
+        for (int i = 0; i < 4; ++i)
+        {
+            gdt_assert(q.try_push(i));
+        }
+        gdt_assert(!q.try_push(4));
+        gdt_assert(q.size() == 4);
+
+        int v;
+        for (int i = 0; i < 4; ++i)
+        {
+            gdt_assert(q.try_pop(v));
+            gdt_assert(v == i);
+        }
+        gdt_assert(!q.try_pop(v));
+        gdt_assert(q.empty());
+    }
+
+    // Batches wrap around the end of the buffer.
+    {
+        mpmc_queue<int> q(8);
+        int in[6] = {0, 1, 2, 3, 4, 5};
+        int out[6] = {};
+
+        gdt_assert(q.try_push_batch(in) == 6);
+        gdt_assert(q.try_pop_batch(std::span(out, 4)) == 4);
+        gdt_assert(q.try_push_batch(in) == 6);
+        gdt_assert(q.try_push_batch(in) == 0);
+
+        gdt_assert(q.try_pop_batch(out) == 6);
+        gdt_assert(out[0] == 4);
+        gdt_assert(out[2] == 0);
+        gdt_assert(out[5] == 3);
+        gdt_assert(q.try_pop_batch(out) == 2);
+        gdt_assert(q.try_pop_batch(out) == 0);
+    }
+
+    // Leftover values are destroyed.
+    {
+        auto shared = std::make_shared<int>(1);
+        {
+            mpmc_queue<std::shared_ptr<int>> q(4);
+            q.try_push(shared);
+            q.try_emplace(shared);
+            gdt_assert(shared.use_count() == 3);
+        }
+        gdt_assert(shared.use_count() == 1);
+    }
+
+    // Several producers and consumers.
+    // Every value comes out exactly once.
+    {
+        constexpr int threads = 4;
+        constexpr std::uint32_t per_thread = 100'000;
+        constexpr auto total = per_thread * threads;
+
+        mpmc_queue<std::uint32_t> q(256);
+        auto seen = std::make_unique<std::atomic<std::uint8_t>[]>(total);
+        std::atomic<std::uint32_t> popped{0};
+
+        gdt::dynarr<std::thread> pool;
+        for (int t = 0; t < threads; ++t)
+        {
+            pool.emplace_back([&, t]
+            {
+                auto first = per_thread * std::uint32_t(t);
+                auto last = first + per_thread;
+                std::uint32_t batch[8];
+
+                for (auto next = first; next < last;)
+                {
+                    std::uint32_t pushed;
+                    if (t % 2 == 0)
+                    {
+                        pushed = std::uint32_t(q.try_push(next));
+                    }
+                    else
+                    {
+                        std::size_t count = 0;
+                        for (; count < 8 && next + count < last; ++count)
+                        {
+                            batch[count] = next + std::uint32_t(count);
+                        }
+                        pushed = std::uint32_t(
+                            q.try_push_batch(std::span(batch, count)));
+                    }
+
+                    if (pushed == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+                    next += pushed;
+                }
+            });
+
+            pool.emplace_back([&, t]
+            {
+                std::uint32_t batch[8];
+                while (popped.load(std::memory_order_relaxed) < total)
+                {
+                    auto n = t % 2 == 0 ?
+                        std::uint32_t(q.try_pop(batch[0])) :
+                        std::uint32_t(q.try_pop_batch(batch));
+
+                    if (n == 0)
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    for (std::uint32_t i = 0; i < n; ++i)
+                    {
+                        seen[batch[i]].fetch_add(1, std::memory_order_relaxed);
+                    }
+                    popped.fetch_add(n, std::memory_order_relaxed);
+                }
+            });
+        }
+
+        for (auto& t : pool)
+        {
+            t.join();
+        }
+
+        gdt_assert(q.empty());
+        for (std::uint32_t i = 0; i < total; ++i)
+        {
+            gdt_assert(seen[i].load() == 1);
+        }
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,185 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/packed.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <gdt/vec.hxx>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+using gdt::all;
+using gdt::dynarr;
+using gdt::snorm16;
+using gdt::snorm16x2;
+using gdt::snorm8;
+using gdt::unorm10_10_10_2;
+using gdt::unorm16;
+using gdt::unorm8;
+using gdt::unorm8x4;
+using gdt::vec;
+using gdt::vec2;
+using gdt::vec4;
+
+// Floats that exercise clamping, rounding, and NaN.
+dynarr<float> sample_floats()
+{
+    dynarr<float> ret;
+    for (int i = -300; i <= 1300; ++i)
+    {
+        ret.push_back(float(i) / 1000.0f);
+    }
+    for (int i = 0; i <= 255; ++i)
+    {
+        ret.push_back((float(i) + 0.5f) / 255.0f);
+    }
+    ret.push_back(std::numeric_limits<float>::infinity());
+    ret.push_back(-std::numeric_limits<float>::infinity());
+    ret.push_back(std::numeric_limits<float>::quiet_NaN());
+    ret.push_back(-std::numeric_limits<float>::quiet_NaN());
+    ret.push_back(-0.0f);
+    return ret;
+}
+
+consteval int test_consteval()
+{
+    // Unsigned normalized integers.
+    {
+        gdt_assert(unorm8(0.0f).bits() == 0);
+        gdt_assert(unorm8(1.0f).bits() == 255);
+        gdt_assert(unorm8(0.5f).bits() == 128);
+        gdt_assert(unorm8(-1.0f).bits() == 0);
+        gdt_assert(unorm8(2.0f).bits() == 255);
+        gdt_assert(unorm8(std::numeric_limits<float>::quiet_NaN()).bits() == 0);
+        gdt_assert(float(unorm8::from_bits(255)) == 1.0f);
+        gdt_assert(float(unorm8::from_bits(51)) == 0.2f);
+        gdt_assert(unorm16(1.0f).bits() == 65535);
+        gdt_assert(float(unorm16::from_bits(0)) == 0.0f);
+    }
+
+    // Signed normalized integers.
+    {
+        gdt_assert(snorm16(1.0f).bits() == 32767);
+        gdt_assert(snorm16(-1.0f).bits() == -32767);
+        gdt_assert(snorm16(-2.0f).bits() == -32767);
+        gdt_assert(snorm16(0.5f).bits() == 16384);
+        gdt_assert(snorm16(-0.5f).bits() == -16384);
+        gdt_assert(float(snorm16::from_bits(-32768)) == -1.0f);
+        gdt_assert(float(snorm16::from_bits(-32767)) == -1.0f);
+        gdt_assert(snorm8(0.25f).bits() == 32);
+        gdt_assert(float(snorm8::from_bits(127)) == 1.0f);
+    }
+
+    // Ties round to even.
+    {
+        gdt_assert(gdt_detail::round_even(0.5f) == 0);
+        gdt_assert(gdt_detail::round_even(1.5f) == 2);
+        gdt_assert(gdt_detail::round_even(2.5f) == 2);
+        gdt_assert(gdt_detail::round_even(-0.5f) == 0);
+        gdt_assert(gdt_detail::round_even(-1.5f) == -2);
+        gdt_assert(gdt_detail::round_even(-2.4f) == -2);
+        gdt_assert(gdt_detail::round_even(2.6f) == 3);
+    }
+
+    // Packed vectors.
+    {
+        auto v = vec(0.0f, 0.2f, 1.0f, 0.4f);
+        unorm8x4 p(v);
+        gdt_assert(sizeof(p) == 4);
+        gdt_assert(p[1].bits() == 51 && p[3].bits() == 102);
+        gdt_assert(all(vec4<float>(p) == v));
+
+        snorm16x2 s(vec(-1.0f, 0.5f));
+        gdt_assert(sizeof(s) == 4);
+        gdt_assert(all(vec2<float>(s) == vec(-1.0f, 16384.0f / 32767.0f)));
+    }
+
+    // 10-10-10-2.
+    {
+        unorm10_10_10_2 p(vec(1.0f, 0.0f, 0.5f, 1.0f));
+        gdt_assert(p.bits() == (0x3ffu | 512u << 20 | 3u << 30));
+        gdt_assert(all(vec4<float>(p) == vec(1.0f, 0.0f, 512.0f / 1023.0f, 1.0f)));
+
+        auto q = unorm10_10_10_2::from_bits(0x5a5a5a5a);
+        gdt_assert(unorm10_10_10_2(vec4<float>(q)).bits() == 0x5a5a5a5a);
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_packed(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Every integer round-trips through float.
+    {
+        for (int i = 0; i <= 255; ++i)
+        {
+            auto bits = std::uint8_t(i);
+            gdt_assert(unorm8(float(unorm8::from_bits(bits))).bits() == bits);
+        }
+        for (int i = -32767; i <= 32767; ++i)
+        {
+            auto bits = std::int16_t(i);
+            gdt_assert(snorm16(float(snorm16::from_bits(bits))).bits() == bits);
+        }
+        for (std::uint32_t i = 0; i < 1024; ++i)
+        {
+            auto bits = i | (1023 - i) << 10 | (i ^ 0x155) << 20 | (i & 3) << 30;
+            auto p = unorm10_10_10_2::from_bits(bits);
+            gdt_assert(unorm10_10_10_2(vec4<float>(p)).bits() == bits);
+        }
+    }
+
+    // Bulk conversion matches the scalar conversion.
+    {
+        auto f = sample_floats();
+        dynarr<vec4<float>> v4;
+        dynarr<vec2<float>> v2;
+        for (std::size_t i = 0; i < f.size(); ++i)
+        {
+            auto g = f[(i * 7) % f.size()];
+            auto h = f[(i * 13) % f.size()];
+            v4.push_back(vec(f[i], g, h, f[f.size() - 1 - i]));
+            v2.push_back(vec(f[i], g));
+        }
+
+        dynarr<unorm8x4> u8(v4.size());
+        dynarr<unorm10_10_10_2> u10(v4.size());
+        dynarr<snorm16x2> s16(v2.size());
+        gdt::batch::convert(v4, u8);
+        gdt::batch::convert(v4, u10);
+        gdt::batch::convert(v2, s16);
+
+        dynarr<vec4<float>> u8_back(v4.size());
+        dynarr<vec4<float>> u10_back(v4.size());
+        dynarr<vec2<float>> s16_back(v2.size());
+        gdt::batch::convert(u8, u8_back);
+        gdt::batch::convert(u10, u10_back);
+        gdt::batch::convert(s16, s16_back);
+
+        for (std::size_t i = 0; i < v4.size(); ++i)
+        {
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                gdt_assert(u8[i][k].bits() == unorm8(v4[i][k]).bits());
+            }
+            gdt_assert(u10[i].bits() == unorm10_10_10_2(v4[i]).bits());
+            gdt_assert(s16[i][0].bits() == snorm16(v2[i][0]).bits());
+            gdt_assert(s16[i][1].bits() == snorm16(v2[i][1]).bits());
+
+            gdt_assert(all(u8_back[i] == vec4<float>(u8[i])));
+            gdt_assert(all(u10_back[i] == vec4<float>(u10[i])));
+            gdt_assert(all(s16_back[i] == vec2<float>(s16[i])));
+        }
+    }
+
+    // Success.
+    return 0;
+}
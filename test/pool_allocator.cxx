@@ -0,0 +1,208 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/pool_allocator.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <cstdint>
+#include <thread>
+
+using gdt::pool_allocator;
+
+namespace
+{
+    struct node
+    {
+        node* next;
+        int value;
+    };
+
+    struct alignas(64) over_aligned
+    {
+        char data[64];
+    };
+}
+
+consteval int test_consteval()
+{
+    // Allocate and deallocate.
+    {
+        pool_allocator<int> a;
+        auto p = a.allocate(3);
+        p[0] = 1;
+        a.deallocate(p, 3);
+    }
+
+    // Dynarr.
+    {
+        gdt::dynarr<int, pool_allocator<int>> a{1, 2, 3};
+        a.push_back(4);
+        gdt_assert(a.size() == 4);
+        gdt_assert(a[3] == 4);
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_pool_allocator(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Freed slots are reused.
+    {
+        pool_allocator<node> a;
+        auto p1 = a.allocate(1);
+        a.deallocate(p1, 1);
+        auto p2 = a.allocate(1);
+        gdt_assert(p1 == p2);
+        a.deallocate(p2, 1);
+    }
+
+    // Allocations round up to the whole slot.
+    {
+        pool_allocator<int> a;
+        auto r = a.allocate_at_least(5);
+        gdt_assert(r.count == 8);
+        for (int i = 0; i < 8; ++i)
+        {
+            r.ptr[i] = i;
+        }
+
+        a.deallocate(r.ptr, r.count);
+    }
+
+    // Big and over-aligned allocations fall back to the heap.
+    {
+        pool_allocator<int> a;
+        auto r = a.allocate_at_least(1000);
+        gdt_assert(r.count == 1000);
+        a.deallocate(r.ptr, r.count);
+
+        pool_allocator<over_aligned> b;
+        auto p = b.allocate(1);
+        gdt_assert(reinterpret_cast<std::uintptr_t>(p) % 64 == 0);
+        b.deallocate(p, 1);
+    }
+
+    // Many live allocations don't overlap.
+    {
+        pool_allocator<node> a;
+        node* head = nullptr;
+        for (int i = 0; i < 10'000; ++i)
+        {
+            auto p = a.allocate(1);
+            p->next = head;
+            p->value = i;
+            head = p;
+        }
+
+        for (int i = 10'000; i-- > 0;)
+        {
+            gdt_assert(head->value == i);
+            auto next = head->next;
+            a.deallocate(head, 1);
+            head = next;
+        }
+    }
+
+    // Dynarr buffers.
+    {
+        gdt::dynarr<int, pool_allocator<int>> a;
+        for (int i = 0; i < 1000; ++i)
+        {
+            a.push_back(i);
+        }
+
+        gdt_assert(a.capacity() >= 1000);
+        for (int i = 0; i < 1000; ++i)
+        {
+            gdt_assert(a[i] == i);
+        }
+    }
+
+    // Freeing on another thread.
+    {
+        constexpr int n = 100'000;
+        pool_allocator<node> a;
+        auto nodes = new node*[n];
+        for (int i = 0; i < n; ++i)
+        {
+            nodes[i] = a.allocate(1);
+            nodes[i]->value = i;
+        }
+
+        std::thread t([&]
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                gdt_assert(nodes[i]->value == i);
+                a.deallocate(nodes[i], 1);
+            }
+        });
+        t.join();
+
+        for (int i = 0; i < n; ++i)
+        {
+            nodes[i] = a.allocate(1);
+            nodes[i]->value = -i;
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            gdt_assert(nodes[i]->value == -i);
+            a.deallocate(nodes[i], 1);
+        }
+
+        delete[] nodes;
+    }
+
+    // Churning one slot at a time after a big cross-thread free only
+    // takes a batch off the global free list, not all of it.
+    {
+        constexpr int n = 200'000;
+        pool_allocator<node> a;
+        auto nodes = new node*[n];
+        for (int i = 0; i < n; ++i)
+        {
+            nodes[i] = a.allocate(1);
+        }
+
+        std::thread t([&]
+        {
+            for (int i = 0; i < n; ++i)
+            {
+                a.deallocate(nodes[i], 1);
+            }
+        });
+        t.join();
+
+        for (int i = 0; i < 100'000; ++i)
+        {
+            auto p = a.allocate(1);
+            p->value = i;
+            a.deallocate(p, 1);
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            nodes[i] = a.allocate(1);
+            nodes[i]->value = i;
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            gdt_assert(nodes[i]->value == i);
+            a.deallocate(nodes[i], 1);
+        }
+
+        delete[] nodes;
+    }
+
+    // Success.
+    return 0;
+}
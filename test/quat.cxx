@@ -0,0 +1,266 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/quat.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <gdt/mat.hxx>
+#include <gdt/vec.hxx>
+#include <cmath>
+#include <cstddef>
+#include <numbers>
+
+using gdt::all;
+using gdt::conjugate;
+using gdt::dynarr;
+using gdt::fast_slerp;
+using gdt::inverse;
+using gdt::nlerp;
+using gdt::quat;
+using gdt::rotate;
+using gdt::slerp;
+using gdt::to_mat3;
+using gdt::vec;
+using gdt::vec3;
+
+// Components within `eps` of each other.
+template<typename T, std::size_t N>
+constexpr bool near(const vec<T, N>& a, const vec<T, N>& b, T eps)
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        auto d = a[i] - b[i];
+        if (d > eps || d < -eps)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+constexpr bool near(const quat<T>& a, const quat<T>& b, T eps)
+{
+    return near(a.xyzw(), b.xyzw(), eps);
+}
+
+// Rotation by 90 degrees about +z.
+constexpr quat<float> quarter_turn_z()
+{
+    auto s = gdt_detail::constexpr_sqrt(0.5f);
+    return {0.0f, 0.0f, s, s};
+}
+
+// A rotation about an oblique axis.
+constexpr quat<float> sample_quat()
+{
+    return normalize(quat<float>(0.3f, -0.5f, 0.2f, 0.8f));
+}
+
+consteval int test_consteval()
+{
+    // Identity.
+    {
+        auto i = quat<double>::identity();
+        auto q = quat<double>(1.0, 2.0, 3.0, 4.0);
+        gdt_assert(i * q == q);
+        gdt_assert(q * i == q);
+        gdt_assert(all(rotate(i, vec(1.0, 2.0, 3.0)) == vec(1.0, 2.0, 3.0)));
+    }
+
+    // Components.
+    {
+        quat<double> q(vec(1.0, 2.0, 3.0), 4.0);
+        gdt_assert(q.x() == 1.0 && q.y() == 2.0 && q.z() == 3.0);
+        gdt_assert(q.w() == 4.0);
+        gdt_assert(all(q.xyz() == vec(1.0, 2.0, 3.0)));
+        q.w() = 5.0;
+        gdt_assert(all(q.xyzw() == vec(1.0, 2.0, 3.0, 5.0)));
+    }
+
+    // Multiplication.
+    {
+        quat<double> i(1.0, 0.0, 0.0, 0.0);
+        quat<double> j(0.0, 1.0, 0.0, 0.0);
+        quat<double> k(0.0, 0.0, 1.0, 0.0);
+        auto neg1 = -quat<double>::identity();
+        gdt_assert(i * j == k);
+        gdt_assert(j * k == i);
+        gdt_assert(k * i == j);
+        gdt_assert(j * i == -k);
+        gdt_assert(i * i == neg1);
+        gdt_assert(i * j * k == neg1);
+    }
+
+    // Scalar and component-wise operators.
+    {
+        quat<double> a(1.0, 2.0, 3.0, 4.0);
+        quat<double> b(4.0, 3.0, 2.0, 1.0);
+        gdt_assert(a + b == quat<double>(5.0, 5.0, 5.0, 5.0));
+        gdt_assert(a - b == quat<double>(-3.0, -1.0, 1.0, 3.0));
+        gdt_assert(a * 2.0 == 2.0 * a);
+        gdt_assert(a * 2.0 / 2.0 == a);
+        gdt_assert(dot(a, b) == 20.0);
+    }
+
+    // Conjugate and inverse.
+    {
+        quat<double> q(1.0, 2.0, 3.0, 4.0);
+        gdt_assert(conjugate(q) == quat<double>(-1.0, -2.0, -3.0, 4.0));
+        gdt_assert(near(q * inverse(q), quat<double>::identity(), 1e-15));
+        gdt_assert(near(inverse(q) * q, quat<double>::identity(), 1e-15));
+
+        auto u = sample_quat();
+        gdt_assert(near(u * conjugate(u), quat<float>::identity(), 1e-6f));
+    }
+
+    // Rotation.
+    {
+        auto q = quarter_turn_z();
+        auto x = vec(1.0f, 0.0f, 0.0f);
+        auto y = vec(0.0f, 1.0f, 0.0f);
+        gdt_assert(near(rotate(q, x), y, 1e-6f));
+        gdt_assert(near(rotate(q * q, x), -x, 1e-6f));
+        gdt_assert(near(rotate(-q, x), y, 1e-6f));
+        gdt_assert(near(rotate(conjugate(q), y), x, 1e-6f));
+
+        // Composition rotates by the right-hand side first.
+        auto p = sample_quat();
+        auto v = vec(0.5f, -1.0f, 2.0f);
+        gdt_assert(near(rotate(q * p, v), rotate(q, rotate(p, v)), 1e-5f));
+    }
+
+    // Rotation matrices.
+    {
+        auto q = sample_quat();
+        auto m = to_mat3(q);
+        auto v = vec(0.5f, -1.0f, 2.0f);
+        gdt_assert(near(m * v, rotate(q, v), 1e-5f));
+        gdt_assert(near(to_mat3(quarter_turn_z())[0], vec(0.0f, 1.0f, 0.0f), 1e-6f));
+        gdt_assert(near(quat<float>::from_mat3(m), q, 1e-6f));
+
+        // Each branch of from_mat3: positive trace, then a dominant x, y,
+        // or z.
+        auto s = gdt_detail::constexpr_sqrt(0.5);
+        quat<double> qs[] = {
+            {s, 0.0, 0.0, s},
+            {1.0, 0.0, 0.0, 0.0},
+            {0.0, 1.0, 0.0, 0.0},
+            {0.0, 0.0, 1.0, 0.0},
+            {0.5, 0.5, 0.5, 0.5},
+        };
+        for (auto& qd : qs)
+        {
+            auto r = quat<double>::from_mat3(to_mat3(qd));
+            gdt_assert(near(r, qd, 1e-15) || near(r, -qd, 1e-15));
+        }
+    }
+
+    // Interpolation.
+    {
+        auto a = quat<float>::identity();
+        auto b = quarter_turn_z();
+        gdt_assert(near(nlerp(a, b, 0.0f), a, 1e-6f));
+        gdt_assert(near(nlerp(a, b, 1.0f), b, 1e-6f));
+        gdt_assert(near(fast_slerp(a, b, 0.0f), a, 1e-6f));
+        gdt_assert(near(fast_slerp(a, b, 1.0f), b, 1e-6f));
+
+        // Halfway is 45 degrees, and the same either way.
+        auto h = fast_slerp(a, b, 0.5f);
+        gdt_assert(near(rotate(h, vec(1.0f, 0.0f, 0.0f)),
+            vec(1.0f, 1.0f, 0.0f) * gdt_detail::constexpr_sqrt(0.5f), 1e-6f));
+        gdt_assert(near(fast_slerp(b, a, 0.5f), h, 1e-6f));
+
+        // Shortest path: -b is the same rotation as b.
+        gdt_assert(near(nlerp(a, -b, 0.5f), nlerp(a, b, 0.5f), 1e-6f));
+        gdt_assert(near(fast_slerp(a, -b, 0.25f), fast_slerp(a, b, 0.25f), 1e-6f));
+    }
+
+    // Batch rotation.
+    {
+        auto q = quarter_turn_z();
+        vec3<float> in[2] = {vec(1.0f, 0.0f, 0.0f), vec(0.0f, 2.0f, 3.0f)};
+        vec3<float> out[2];
+        gdt::batch::rotate(q, in, out);
+        gdt_assert(near(out[0], vec(0.0f, 1.0f, 0.0f), 1e-6f));
+        gdt_assert(near(out[1], vec(-2.0f, 0.0f, 3.0f), 1e-6f));
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_quat(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Axis and angle.
+    {
+        auto axis = normalize(vec(1.0f, 2.0f, -2.0f));
+        auto q = quat<float>::from_axis_angle(axis, 1.25f);
+        gdt_assert(std::abs(length(q) - 1.0f) < 1e-6f);
+        gdt_assert(std::abs(gdt::angle(q) - 1.25f) < 1e-6f);
+        gdt_assert(near(gdt::axis(q), axis, 1e-6f));
+        gdt_assert(near(q, quat<float>::from_mat3(to_mat3(q)), 1e-6f));
+
+        auto z = quat<float>::from_axis_angle(vec(0.0f, 0.0f, 1.0f),
+            std::numbers::pi_v<float> / 2.0f);
+        gdt_assert(near(z, quarter_turn_z(), 1e-6f));
+        gdt_assert(all(gdt::axis(quat<float>::identity()) == vec(1.0f, 0.0f, 0.0f)));
+        gdt_assert(gdt::angle(quat<float>::identity()) == 0.0f);
+    }
+
+    // slerp and fast_slerp agree.
+    {
+        auto axis = normalize(vec(0.0f, 1.0f, 1.0f));
+        auto a = sample_quat();
+        for (int i = 1; i <= 8; ++i)
+        {
+            auto b = a * quat<float>::from_axis_angle(axis, float(i) * 0.4f);
+            for (int j = 0; j <= 10; ++j)
+            {
+                auto t = float(j) / 10.0f;
+                auto exact = slerp(a, b, t);
+                auto fast = fast_slerp(a, b, t);
+                gdt_assert(std::abs(length(exact) - 1.0f) < 1e-5f);
+                gdt_assert(near(fast, exact, 1e-3f));
+            }
+        }
+
+        // Nearly parallel.
+        auto b = a * quat<float>::from_axis_angle(axis, 1e-4f);
+        gdt_assert(near(slerp(a, b, 0.5f), fast_slerp(a, b, 0.5f), 1e-6f));
+    }
+
+    // Batch rotation matches per-vector rotation.
+    {
+        auto q = sample_quat();
+        dynarr<vec3<float>> in;
+        for (int i = 0; i < 11; ++i)
+        {
+            auto f = float(i);
+            in.push_back(vec(f, 1.0f - f, f * 0.5f));
+        }
+
+        dynarr<vec3<float>> out(in.size());
+        gdt::batch::rotate(q, in, out);
+        for (std::size_t i = 0; i < in.size(); ++i)
+        {
+            gdt_assert(near(out[i], rotate(q, in[i]), 1e-5f));
+        }
+
+        // In place.
+        gdt::batch::rotate(q, in, in);
+        for (std::size_t i = 0; i < in.size(); ++i)
+        {
+            gdt_assert(all(in[i] == out[i]));
+        }
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/ray.hxx>
+
+#include <gdt/aabb.hxx>
+#include <gdt/assert.hxx>
+#include <gdt/vec.hxx>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+using gdt::aabb;
+using gdt::aabb_soa;
+using gdt::all;
+using gdt::intersect;
+using gdt::ray;
+using gdt::vec;
+using gdt::vec3;
+
+using box3 = aabb<float, 3>;
+using ray3 = ray<float, 3>;
+
+constexpr auto inf = std::numeric_limits<float>::infinity();
+
+// batch::intersect matches intersect, bit for bit.
+template<std::size_t W>
+void test_batch_intersect(const ray3& r, float t_max)
+{
+    for (std::size_t first = 0; first < 210; first += W - 1)
+    {
+        auto boxes = aabb_soa<float, 3, W>::empty();
+        for (std::size_t i = 0; i + 1 < W; ++i)
+        {
+            auto j = first + i;
+            auto x = float(j % 7) - 3.0f;
+            auto y = float(j % 5) - 2.0f;
+            auto z = float(j % 6) - 2.5f;
+            auto s = float(j % 3) * 0.5f;
+            boxes.set(i, box3(vec(x, y, z), vec(x + s, y + 1.0f, z + s)));
+        }
+
+        vec<float, W> t;
+        auto mask = gdt::batch::intersect(r, boxes, t_max, &t);
+        gdt_assert(gdt::batch::intersect(r, boxes, t_max) == mask);
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            auto ti = intersect(r, boxes.get(i), t_max);
+            gdt_assert(ti == t[i]);
+            gdt_assert(((mask >> i) & 1) == (ti != inf));
+        }
+    }
+}
+
+consteval int test_consteval()
+{
+    box3 unit{vec3<float>(0.0f), vec3<float>(1.0f)};
+
+    // Accessors.
+    {
+        ray3 r{vec(1.0f, 2.0f, 3.0f), vec(2.0f, -4.0f, 0.5f)};
+        gdt_assert(all(r.inv_direction() == vec(0.5f, -0.25f, 2.0f)));
+        gdt_assert(all(r.at(2.0f) == vec(5.0f, -6.0f, 4.0f)));
+    }
+
+    // Hits and misses.
+    {
+        ray3 r{vec(-1.0f, 0.5f, 0.5f), vec(1.0f, 0.0f, 0.0f)};
+        gdt_assert(intersect(r, unit) == 1.0f);
+        gdt_assert(intersect(r, unit, 0.5f) == inf);
+        gdt_assert(intersect(r, unit, 1.0f) == 1.0f);
+
+        ray3 back{vec(-1.0f, 0.5f, 0.5f), vec(-1.0f, 0.0f, 0.0f)};
+        gdt_assert(intersect(back, unit) == inf);
+
+        ray3 diag{vec(2.0f, 2.0f, 2.0f), vec(-1.0f, -1.0f, -1.0f)};
+        gdt_assert(intersect(diag, unit) == 1.0f);
+
+        ray3 beside{vec(-1.0f, 1.5f, 0.5f), vec(1.0f, 0.0f, 0.0f)};
+        gdt_assert(intersect(beside, unit) == inf);
+    }
+
+    // Starting inside.
+    {
+        ray3 r{vec(0.5f, 0.5f, 0.5f), vec(0.0f, -1.0f, 0.0f)};
+        gdt_assert(intersect(r, unit) == 0.0f);
+    }
+
+    // Empty boxes never hit.
+    {
+        ray3 r{vec(0.5f, 0.5f, 0.5f), vec(1.0f, 1.0f, 1.0f)};
+        gdt_assert(intersect(r, box3::empty()) == inf);
+    }
+
+    // Batches.
+    {
+        auto boxes = aabb_soa<float, 3, 4>::empty();
+        boxes.set(0, unit);
+        boxes.set(1, box3(vec(3.0f, 0.0f, 0.0f), vec(4.0f, 1.0f, 1.0f)));
+        boxes.set(2, box3(vec(0.0f, 3.0f, 0.0f), vec(1.0f, 4.0f, 1.0f)));
+
+        ray3 r{vec(-1.0f, 0.5f, 0.5f), vec(1.0f, 0.0f, 0.0f)};
+        vec<float, 4> t;
+        gdt_assert(gdt::batch::intersect(r, boxes, inf, &t) == 0b0011);
+        gdt_assert(all(t == vec(1.0f, 4.0f, inf, inf)));
+        gdt_assert(gdt::batch::intersect(r, boxes, 2.0f) == 0b0001);
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_ray(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Batch intersection matches the scalar test, including for rays
+    // parallel to an axis and rays in the plane of a face.
+    {
+        ray3 rays[] = {
+            {vec(-5.0f, 0.25f, 0.1f), vec(1.0f, 0.1f, 0.05f)},
+            {vec(4.0f, 3.0f, -4.0f), vec(-1.0f, -0.75f, 1.0f)},
+            {vec(0.5f, -4.0f, 0.25f), vec(0.0f, 1.0f, 0.0f)},
+            {vec(-4.0f, 0.0f, -0.5f), vec(1.0f, 0.0f, -0.0f)},
+            {vec(0.0f, 0.0f, 0.0f), vec(-0.3f, 0.2f, -0.1f)},
+        };
+        for (auto& r : rays)
+        {
+            test_batch_intersect<4>(r, inf);
+            test_batch_intersect<4>(r, 3.0f);
+            test_batch_intersect<8>(r, inf);
+            test_batch_intersect<8>(r, 3.0f);
+        }
+    }
+
+    // Success.
+    return 0;
+}
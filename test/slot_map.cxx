@@ -0,0 +1,255 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/slot_map.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <utility>
+
+using gdt::slot_map;
+using gdt::slot_map_handle;
+
+consteval int test_consteval()
+{
+    // Default constructor.
+    {
+        slot_map<int> m;
+        gdt_assert(m.empty());
+        gdt_assert(m.size() == 0);
+        gdt_assert(!m.contains(slot_map_handle()));
+        gdt_assert(m.find(slot_map_handle()) == nullptr);
+    }
+
+    // Insert and look up.
+    {
+        slot_map<int> m;
+        auto h1 = m.insert(10);
+        auto h2 = m.emplace(20);
+        gdt_assert(h1 != h2);
+        gdt_assert(m.size() == 2);
+        gdt_assert(m[h1] == 10);
+        gdt_assert(m.at(h2) == 20);
+        gdt_assert(*m.find(h1) == 10);
+
+        m[h1] = 11;
+        gdt_assert(m.values()[0] == 11);
+    }
+
+    // Erase swaps the last value into the gap.
+    {
+        slot_map<int> m;
+        auto h1 = m.insert(1);
+        auto h2 = m.insert(2);
+        auto h3 = m.insert(3);
+
+        gdt_assert(m.erase(h1));
+        gdt_assert(!m.erase(h1));
+        gdt_assert(!m.contains(h1));
+        gdt_assert(m.size() == 2);
+        gdt_assert(m.values()[0] == 3);
+        gdt_assert(m.values()[1] == 2);
+        gdt_assert(m[h2] == 2);
+        gdt_assert(m[h3] == 3);
+    }
+
+    // Reused slots get a new generation.
+    {
+        slot_map<int> m;
+        auto h1 = m.insert(1);
+        m.erase(h1);
+
+        auto h2 = m.insert(2);
+        gdt_assert(h2.index() == h1.index());
+        gdt_assert(h2.generation() != h1.generation());
+        gdt_assert(!m.contains(h1));
+        gdt_assert(m[h2] == 2);
+    }
+
+    // Handles pack the index and generation into 32 bits.
+    {
+        static_assert(sizeof(slot_map_handle<>) == 4);
+        static_assert(slot_map_handle<>::max_slots == 0xFFFFF);
+        static_assert(slot_map_handle<>::max_generation == 0xFFF);
+
+        slot_map_handle<> h(5, 7);
+        gdt_assert(h.index() == 5);
+        gdt_assert(h.generation() == 7);
+        gdt_assert(h != slot_map_handle<>());
+    }
+
+    // Slots are retired when their generations run out.
+    {
+        slot_map<int, gdt::allocator<int>, gdt::default_growth, 30> m;
+        auto h = m.insert(0);
+        for (int i = 1; i < 4; ++i)
+        {
+            m.erase(h);
+            auto next = m.insert(i);
+            gdt_assert(next.index() == h.index());
+            gdt_assert(next.generation() == h.generation() + 1);
+            h = next;
+        }
+
+        m.erase(h);
+        auto fresh = m.insert(4);
+        gdt_assert(fresh.index() != h.index());
+        gdt_assert(!m.contains(h));
+        gdt_assert(!m.contains({h.index(), 0}));
+        gdt_assert(m[fresh] == 4);
+    }
+
+    // Erase by iterator and handle_of.
+    {
+        slot_map<int> m;
+        for (int i = 0; i < 10; ++i)
+        {
+            m.insert(i);
+        }
+
+        for (auto it = m.begin(); it != m.end();)
+        {
+            if (*it % 2 == 0)
+            {
+                it = m.erase(it);
+            }
+            else
+            {
+                gdt_assert(m[m.handle_of(it)] == *it);
+                ++it;
+            }
+        }
+
+        gdt_assert(m.size() == 5);
+        for (auto v : m)
+        {
+            gdt_assert(v % 2 == 1);
+        }
+    }
+
+    // Clear invalidates every handle.
+    {
+        slot_map<int> m;
+        auto h1 = m.insert(1);
+        auto h2 = m.insert(2);
+        m.clear();
+        gdt_assert(m.empty());
+        gdt_assert(!m.contains(h1));
+        gdt_assert(!m.contains(h2));
+
+        auto h3 = m.insert(3);
+        gdt_assert(m[h3] == 3);
+        gdt_assert(!m.contains(h1));
+        gdt_assert(!m.contains(h2));
+    }
+
+    // Copy and move.
+    {
+        slot_map<int> m1;
+        auto h = m1.insert(1);
+
+        auto m2 = m1;
+        gdt_assert(m2[h] == 1);
+
+        auto m3 = std::move(m2);
+        gdt_assert(m3[h] == 1);
+
+        swap(m1, m3);
+        gdt_assert(m1[h] == 1);
+    }
+
+    // Moved-from maps have no free slots left to reuse.
+    {
+        slot_map<int> m1;
+        auto h1 = m1.insert(1);
+        m1.insert(2);
+        m1.erase(h1);
+
+        auto m2 = std::move(m1);
+        auto h2 = m1.insert(3);
+        gdt_assert(m1.size() == 1);
+        gdt_assert(m1[h2] == 3);
+        gdt_assert(m2.size() == 1);
+
+        slot_map<int> m3;
+        m3 = std::move(m2);
+        auto h3 = m2.insert(4);
+        gdt_assert(m2.size() == 1);
+        gdt_assert(m2[h3] == 4);
+        gdt_assert(m3.values()[0] == 2);
+    }
+
+    // Non-trivial values.
+    {
+        slot_map<std::string> m;
+        auto h1 = m.insert(std::string(20, 'a'));
+        auto h2 = m.insert(std::string(20, 'b'));
+        m.erase(h1);
+        gdt_assert(m[h2] == std::string(20, 'b'));
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_slot_map(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Runtime churn.
+    {
+        slot_map<std::uint64_t> m;
+        gdt::dynarr<slot_map_handle<>> handles;
+        for (std::uint64_t i = 0; i < 1000; ++i)
+        {
+            handles.push_back(m.insert(i));
+        }
+
+        for (std::uint64_t i = 1000; i < 100000; ++i)
+        {
+            auto j = std::size_t(i * 7919 % 1000);
+            auto old = handles[j];
+            gdt_assert(m.erase(old));
+            handles[j] = m.insert(i);
+            gdt_assert(!m.contains(old));
+        }
+
+        gdt_assert(m.size() == 1000);
+        for (auto h : handles)
+        {
+            gdt_assert(m.contains(h));
+        }
+
+        std::uint64_t sum = 0;
+        for (auto h : handles)
+        {
+            sum += m[h];
+        }
+
+        std::uint64_t dense_sum = 0;
+        for (auto v : m.values())
+        {
+            dense_sum += v;
+        }
+        gdt_assert(sum == dense_sum);
+    }
+
+    // Iterators are random access.
+    {
+        gdt_assert(std::random_access_iterator<slot_map<int>::iterator>);
+    }
+
+    // Relocatability follows the dynarrs.
+    {
+        gdt_assert(gdt::is_trivially_relocatable_v<slot_map<int>>);
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,265 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/small_dynarr.hxx>
+
+#include <gdt/assert.hxx>
+#include <memory>
+#include <string>
+
+using gdt::small_dynarr;
+
+consteval int test_consteval()
+{
+    // Default constructor.
+    {
+        small_dynarr<int, 4> a;
+        gdt_assert(a.size() == 0);
+        gdt_assert(!a.is_inline());
+    }
+
+    // Size constructor.
+    {
+        small_dynarr<int, 4> a(3);
+        gdt_assert(a.size() == 3);
+        for (int i : a)
+        {
+            gdt_assert(i == 0);
+        }
+    }
+
+    // Initializer list constructor.
+    {
+        small_dynarr<int, 4> a{1, 2, 3};
+        gdt_assert(a.size() == 3);
+        gdt_assert(a[0] == 1);
+        gdt_assert(a[1] == 2);
+        gdt_assert(a[2] == 3);
+    }
+
+    // Copy and move.
+    {
+        small_dynarr<int, 2> a1{1, 2, 3};
+        auto a2 = a1;
+        auto a3 = std::move(a1);
+        gdt_assert(a2 == a3);
+        gdt_assert(a3.size() == 3);
+        a1 = a3;
+        gdt_assert(a1 == a3);
+    }
+
+    // Push back, insert, erase.
+    {
+        small_dynarr<int, 2> a;
+        for (int i = 0; i < 10; ++i)
+        {
+            a.push_back(i);
+        }
+
+        a.insert(a.begin(), -1);
+        a.erase(a.begin() + 1, a.begin() + 3);
+        a.swap_remove(a.begin());
+        gdt_assert(a.size() == 8);
+        gdt_assert(a[0] == 9);
+        gdt_assert(a[1] == 2);
+        gdt_assert(a.back() == 8);
+    }
+
+    // Swap.
+    {
+        small_dynarr<int, 2> a1{1};
+        small_dynarr<int, 2> a2{2, 3, 4};
+        swap(a1, a2);
+        gdt_assert((a1 == small_dynarr<int, 2>{2, 3, 4}));
+        gdt_assert((a2 == small_dynarr<int, 2>{1}));
+    }
+
+    // Comparison.
+    {
+        small_dynarr<int, 2> a1{1, 2};
+        small_dynarr<int, 2> a2{1, 3};
+        gdt_assert(a1 < a2);
+        gdt_assert(a1 != a2);
+    }
+
+    // Erase if.
+    {
+        small_dynarr<int, 4> a{1, 2, 3, 4, 5};
+        gdt_assert(erase_if(a, [](int i) { return i % 2 == 0; }) == 2);
+        gdt_assert((a == small_dynarr<int, 4>{1, 3, 5}));
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_small_dynarr(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Small arrays live inline.
+    {
+        small_dynarr<int, 4> a;
+        for (int i = 0; i < 4; ++i)
+        {
+            a.push_back(i);
+            gdt_assert(a.is_inline());
+        }
+
+        gdt_assert(a.capacity() == 4);
+        auto p = static_cast<const void*>(a.data());
+        gdt_assert(p >= static_cast<const void*>(&a));
+        gdt_assert(p < static_cast<const void*>(&a + 1));
+
+        a.push_back(4);
+        gdt_assert(!a.is_inline());
+        gdt_assert(a.size() == 5);
+        for (int i = 0; i < 5; ++i)
+        {
+            gdt_assert(a[i] == i);
+        }
+    }
+
+    // Reserve within the inline capacity.
+    {
+        small_dynarr<std::string, 3> a;
+        a.reserve(2);
+        gdt_assert(a.is_inline());
+        gdt_assert(a.capacity() == 3);
+        a.emplace_back("one");
+        a.emplace_back("two");
+        a.emplace_back("three");
+        gdt_assert(a.is_inline());
+        a.emplace_back("four");
+        gdt_assert(!a.is_inline());
+        gdt_assert(a[0] == "one");
+        gdt_assert(a[3] == "four");
+    }
+
+    // Moving inline arrays moves elements.
+    {
+        small_dynarr<std::string, 2> a1{"a", "b"};
+        auto a2 = std::move(a1);
+        gdt_assert(a2.is_inline());
+        gdt_assert(a2.data() != a1.data());
+        gdt_assert(a2[0] == "a");
+        gdt_assert(a2[1] == "b");
+    }
+
+    // Moving heap arrays steals the buffer.
+    {
+        small_dynarr<std::string, 2> a1{"a", "b", "c"};
+        auto p = a1.data();
+        auto a2 = std::move(a1);
+        gdt_assert(a2.data() == p);
+        gdt_assert(a1.empty());
+
+        small_dynarr<std::string, 2> a3;
+        a3 = std::move(a2);
+        gdt_assert(a3.data() == p);
+        gdt_assert(a3.size() == 3);
+    }
+
+    // Copies get their own inline buffer.
+    {
+        small_dynarr<int, 4> a1{1, 2};
+        auto a2 = a1;
+        gdt_assert(a2.is_inline());
+        gdt_assert(a2.data() != a1.data());
+        gdt_assert(a1 == a2);
+    }
+
+    // Swapping inline with heap.
+    {
+        small_dynarr<std::string, 2> a1{"x"};
+        small_dynarr<std::string, 2> a2{"a", "b", "c"};
+        a1.swap(a2);
+        gdt_assert(a1.size() == 3);
+        gdt_assert(!a1.is_inline());
+        gdt_assert(a2.size() == 1);
+        gdt_assert(a2.is_inline());
+        gdt_assert(a2[0] == "x");
+
+        a1.swap(a2);
+        gdt_assert(a1.is_inline());
+        gdt_assert(!a2.is_inline());
+        gdt_assert(a1[0] == "x");
+        gdt_assert(a2[2] == "c");
+    }
+
+    // Swapping inline arrays keeps them inline.
+    {
+        small_dynarr<std::string, 4> a1{"a", "b", "c"};
+        small_dynarr<std::string, 4> a2{"x"};
+        a1.swap(a2);
+        gdt_assert(a1.is_inline());
+        gdt_assert(a2.is_inline());
+        gdt_assert(a1.size() == 1);
+        gdt_assert(a1[0] == "x");
+        gdt_assert(a2.size() == 3);
+        gdt_assert(a2[2] == "c");
+
+        swap(a1, a2);
+        gdt_assert(a1.size() == 3);
+        gdt_assert(a2[0] == "x");
+    }
+
+    // Swapping heap arrays swaps their buffers.
+    {
+        small_dynarr<int, 2> a1{1, 2, 3};
+        small_dynarr<int, 2> a2{4, 5, 6, 7};
+        auto p1 = a1.data();
+        auto p2 = a2.data();
+        a1.swap(a2);
+        gdt_assert(a1.data() == p2);
+        gdt_assert(a2.data() == p1);
+        gdt_assert(a1.size() == 4);
+        gdt_assert(a2[2] == 3);
+        static_assert(noexcept(a1.swap(a2)));
+    }
+
+    // Shrink back into the inline buffer.
+    {
+        small_dynarr<int, 2> a{1, 2, 3, 4};
+        a.resize(1);
+        a.shrink_to_fit();
+        gdt_assert(a.is_inline());
+        gdt_assert(a.size() == 1);
+        gdt_assert(a[0] == 1);
+
+        small_dynarr<std::string, 2> s{"a", "b", "c"};
+        s.pop_back();
+        s.shrink_to_fit();
+        gdt_assert(s.is_inline());
+        gdt_assert(s[1] == "b");
+    }
+
+    // Shrinking inline arrays leaves them inline.
+    {
+        small_dynarr<int, 8> a{1, 2, 3};
+        a.shrink_to_fit();
+        gdt_assert(a.is_inline());
+        gdt_assert(a.capacity() == 8);
+
+        a.clear();
+        a.shrink_to_fit();
+        a.push_back(1);
+        gdt_assert(a.is_inline());
+    }
+
+    // Shrink into a smaller heap buffer.
+    {
+        small_dynarr<int, 2> a{1, 2, 3, 4, 5};
+        a.pop_back();
+        a.shrink_to_fit();
+        gdt_assert(!a.is_inline());
+        gdt_assert(a.capacity() == 4);
+        gdt_assert(a[3] == 4);
+    }
+
+    // Success.
+    return 0;
+}
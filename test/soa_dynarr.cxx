@@ -0,0 +1,247 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/soa_dynarr.hxx>
+
+#include <gdt/assert.hxx>
+#include <gdt/vec.hxx>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+using gdt::all;
+using gdt::soa_dynarr;
+using gdt::vec;
+using gdt::vec3;
+using gdt::vec4;
+
+consteval int test_consteval()
+{
+    // Default constructor.
+    {
+        soa_dynarr<vec3<float>> a;
+        gdt_assert(a.empty());
+        gdt_assert(a.size() == 0);
+    }
+
+    // Size constructors.
+    {
+        soa_dynarr<vec3<int>> a1(3);
+        gdt_assert(a1.size() == 3);
+        gdt_assert(all(a1[2] == vec3<int>(0)));
+
+        soa_dynarr<vec3<int>> a2(2, vec(1, 2, 3));
+        gdt_assert(a2.size() == 2);
+        gdt_assert(all(a2[1] == vec(1, 2, 3)));
+    }
+
+    // Initializer list constructor.
+    {
+        soa_dynarr<vec3<int>> a{vec(1, 2, 3), vec(4, 5, 6)};
+        gdt_assert(a.size() == 2);
+        gdt_assert(all(a[0] == vec(1, 2, 3)));
+        gdt_assert(all(a[1] == vec(4, 5, 6)));
+    }
+
+    // Lanes.
+    {
+        soa_dynarr<vec3<int>> a{vec(1, 2, 3), vec(4, 5, 6)};
+        gdt_assert(a.lane(0).size() == 2);
+        gdt_assert(a.lane(0)[1] == 4);
+        gdt_assert(a.lane(1)[0] == 2);
+        gdt_assert(a.lane(2)[1] == 6);
+
+        a.lane(1)[1] = 50;
+        gdt_assert(all(a[1] == vec(4, 50, 6)));
+    }
+
+    // Reference.
+    {
+        soa_dynarr<vec3<int>> a{vec(1, 2, 3), vec(4, 5, 6)};
+        auto r = a[0];
+        gdt_assert(r.x() == 1);
+        gdt_assert(r.y() == 2);
+        gdt_assert(r.b() == 3);
+
+        r.y() = 20;
+        gdt_assert(a.lane(1)[0] == 20);
+
+        r = vec(7, 8, 9);
+        gdt_assert(all(a[0] == vec(7, 8, 9)));
+
+        a[1] = a[0];
+        gdt_assert(all(a[1] == vec(7, 8, 9)));
+
+        vec3<int> v = a[0];
+        gdt_assert(all(v == vec(7, 8, 9)));
+    }
+
+    // Reference operators.
+    {
+        soa_dynarr<vec3<int>> a{vec(1, 2, 3), vec(4, 5, 6)};
+        gdt_assert(all(a[0] + a[1] == vec(5, 7, 9)));
+        gdt_assert(all(a[1] - vec(1, 1, 1) == vec(3, 4, 5)));
+        gdt_assert(all(vec(1, 1, 1) * a[1] == vec(4, 5, 6)));
+        gdt_assert(all(a[0] * 2 == vec(2, 4, 6)));
+        gdt_assert(all(12 / a[0] == vec(12, 6, 4)));
+        gdt_assert(all(-a[0] == vec(-1, -2, -3)));
+        gdt_assert(any(a[0] != a[1]));
+
+        a[0] += a[1];
+        gdt_assert(all(a[0] == vec(5, 7, 9)));
+        a[0] -= vec(1, 1, 1);
+        gdt_assert(all(a[0] == vec(4, 6, 8)));
+        a[0] *= 2;
+        gdt_assert(all(a[0] == vec(8, 12, 16)));
+        a[0] /= 4;
+        gdt_assert(all(a[0] == vec(2, 3, 4)));
+    }
+
+    // Const reference.
+    {
+        const soa_dynarr<vec3<int>> a{vec(1, 2, 3)};
+        auto r = a[0];
+        gdt_assert(r.z() == 3);
+        gdt_assert(all(r + a.front() == vec(2, 4, 6)));
+    }
+
+    // Iteration.
+    {
+        soa_dynarr<vec3<int>> a{vec(1, 2, 3), vec(4, 5, 6), vec(7, 8, 9)};
+        for (auto r : a)
+        {
+            r += 1;
+        }
+
+        int sum = 0;
+        for (auto r : std::as_const(a))
+        {
+            sum += r.x();
+        }
+        gdt_assert(sum == 15);
+
+        auto it = a.begin() + 2;
+        gdt_assert(it - a.begin() == 2);
+        gdt_assert(all(*it == vec(8, 9, 10)));
+        gdt_assert(all(it[-1] == vec(5, 6, 7)));
+        gdt_assert(a.cend() - it == 1);
+    }
+
+    // Push back, pop back, erase.
+    {
+        soa_dynarr<vec4<int>> a;
+        for (int i = 0; i < 10; ++i)
+        {
+            a.push_back(vec4<int>(i));
+        }
+
+        gdt_assert(a.size() == 10);
+        gdt_assert(a.capacity() >= 10);
+        a.pop_back();
+        a.erase(a.begin() + 1);
+        a.swap_remove(a.begin());
+        gdt_assert(a.size() == 7);
+        gdt_assert(all(a[0] == vec4<int>(8)));
+        gdt_assert(all(a[1] == vec4<int>(2)));
+        gdt_assert(all(a.back() == vec4<int>(7)));
+    }
+
+    // Resize, reserve, shrink, clear.
+    {
+        soa_dynarr<vec3<int>> a;
+        a.reserve(8);
+        gdt_assert(a.capacity() >= 8);
+        a.resize(2, vec(1, 2, 3));
+        a.resize(3);
+        gdt_assert(all(a[1] == vec(1, 2, 3)));
+        gdt_assert(all(a[2] == vec3<int>(0)));
+        a.shrink_to_fit();
+        gdt_assert(a.capacity() == 3);
+        a.clear();
+        gdt_assert(a.empty());
+    }
+
+    // Copy, move, swap, equality.
+    {
+        soa_dynarr<vec3<int>> a1{vec(1, 2, 3)};
+        auto a2 = a1;
+        gdt_assert(a1 == a2);
+        auto a3 = std::move(a1);
+        gdt_assert(a3 == a2);
+
+        soa_dynarr<vec3<int>> a4{vec(4, 5, 6), vec(7, 8, 9)};
+        swap(a3, a4);
+        gdt_assert(a3.size() == 2);
+        gdt_assert(a4 == a2);
+        gdt_assert(a3 != a2);
+    }
+
+    // Swap references.
+    {
+        soa_dynarr<vec3<int>> a{vec(1, 2, 3), vec(4, 5, 6)};
+        swap(a[0], a[1]);
+        gdt_assert(all(a[0] == vec(4, 5, 6)));
+        gdt_assert(all(a[1] == vec(1, 2, 3)));
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_soa_dynarr(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Runtime.
+    {
+        soa_dynarr<vec3<float>> a;
+        for (int i = 0; i < 100; ++i)
+        {
+            a.push_back(vec3<float>(float(i)));
+        }
+
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            for (auto& c : a.lane(k))
+            {
+                c *= 2.0f;
+            }
+        }
+
+        gdt_assert(all(a[99] == vec3<float>(198.0f)));
+    }
+
+    // Iterators are random access.
+    {
+        using a = soa_dynarr<vec3<float>>;
+        gdt_assert(std::random_access_iterator<a::iterator>);
+        gdt_assert(std::random_access_iterator<a::const_iterator>);
+    }
+
+    // Relocatability follows the lanes.
+    {
+        gdt_assert(gdt::is_trivially_relocatable_v<soa_dynarr<vec3<float>>>);
+    }
+
+    // Sort through references.
+    {
+        soa_dynarr<vec<std::int32_t, 2>> a{vec(3, 0), vec(1, 1), vec(2, 2)};
+        for (std::size_t i = 1; i < a.size(); ++i)
+        {
+            for (auto j = i; j > 0 && a[j].x() < a[j - 1].x(); --j)
+            {
+                swap(a[j], a[j - 1]);
+            }
+        }
+
+        gdt_assert(all(a[0] == vec(1, 1)));
+        gdt_assert(all(a[1] == vec(2, 2)));
+        gdt_assert(all(a[2] == vec(3, 0)));
+    }
+
+    // Success.
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/spsc_queue.hxx>
+
+#include <gdt/allocator.hxx>
+#include <gdt/assert.hxx>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+
+using gdt::spsc_queue;
+
+int test_spsc_queue(int, char** const)
+{
+    // Capacity rounds up to a power of 2.
+    {
+        spsc_queue<int> q(5);
+        gdt_assert(q.capacity() == 8);
+        gdt_assert(q.empty());
+    }
+
+    // Push and pop in order until full.
+    {
+        spsc_queue<int> q(4);
+        for (int i = 0; i < 4; ++i)
+        {
+            gdt_assert(q.try_push(i));
+        }
+        gdt_assert(!q.try_push(4));
+        gdt_assert(q.size() == 4);
+
+        int v;
+        for (int i = 0; i < 4; ++i)
+        {
+            gdt_assert(q.try_pop(v));
+            gdt_assert(v == i);
+        }
+        gdt_assert(!q.try_pop(v));
+    }
+
+    // Batches wrap around the end of the buffer.
+    {
+        spsc_queue<int> q(8);
+        int in[6] = {0, 1, 2, 3, 4, 5};
+        int out[6] = {};
+
+        gdt_assert(q.try_push_batch(in) == 6);
+        gdt_assert(q.try_pop_batch(std::span(out, 4)) == 4);
+        gdt_assert(q.try_push_batch(in) == 6);
+        gdt_assert(q.try_push_batch(in) == 0);
+        gdt_assert(q.size() == 8);
+
+        gdt_assert(q.try_pop_batch(out) == 6);
+        gdt_assert(out[0] == 4);
+        gdt_assert(out[1] == 5);
+        gdt_assert(out[2] == 0);
+        gdt_assert(out[5] == 3);
+    }
+
+    // Leftover values are destroyed.
+    {
+        auto shared = std::make_shared<int>(1);
+        {
+            spsc_queue<std::shared_ptr<int>> q(4);
+            q.try_push(shared);
+            q.try_emplace(shared);
+            gdt_assert(shared.use_count() == 3);
+        }
+        gdt_assert(shared.use_count() == 1);
+    }
+
+    // Compact 32-bit indices wrap.
+    {
+        using allocator_type = gdt::allocator<
+            std::string, std::uint32_t, std::int32_t>;
+        spsc_queue<std::string, allocator_type> q(2);
+
+        std::string s;
+        for (int i = 0; i < 1000; ++i)
+        {
+            gdt_assert(q.try_emplace(std::to_string(i)));
+            gdt_assert(q.try_pop(s));
+            gdt_assert(s == std::to_string(i));
+        }
+    }
+
+    // One producer, one consumer.
+    {
+        constexpr std::uint64_t n = 1'000'000;
+        spsc_queue<std::uint64_t> q(1024);
+
+        std::thread producer([&]
+        {
+            std::uint64_t batch[16];
+            std::uint64_t next = 0;
+            while (next < n)
+            {
+                std::size_t count = 0;
+                for (; count < 16 && next + count < n; ++count)
+                {
+                    batch[count] = next + count;
+                }
+
+                auto pushed = q.try_push_batch(std::span(batch, count));
+                if (pushed == 0)
+                {
+                    std::this_thread::yield();
+                }
+                next += pushed;
+            }
+        });
+
+        std::uint64_t expected = 0;
+        std::uint64_t v;
+        while (expected < n)
+        {
+            if (q.try_pop(v))
+            {
+                gdt_assert(v == expected);
+                expected += 1;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        producer.join();
+        gdt_assert(q.empty());
+    }
+
+    // Success.
+    return 0;
+}
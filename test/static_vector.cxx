@@ -0,0 +1,247 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/static_vector.hxx>
+
+#include <gdt/assert.hxx>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+using gdt::static_vector;
+
+// Size types.
+static_assert(std::is_same_v<static_vector<int, 1>::size_type, std::uint8_t>);
+static_assert(std::is_same_v<static_vector<int, 255>::size_type, std::uint8_t>);
+static_assert(std::is_same_v<static_vector<int, 256>::size_type, std::uint16_t>);
+static_assert(std::is_same_v<static_vector<char, 65536>::size_type, std::uint32_t>);
+static_assert(sizeof(static_vector<std::uint8_t, 7>) == 8);
+
+// Trivially copyable when T is.
+static_assert(std::is_trivially_copyable_v<static_vector<int, 4>>);
+static_assert(!std::is_trivially_copyable_v<static_vector<std::string, 4>>);
+static_assert(gdt::is_trivially_relocatable_v<static_vector<int, 4>>);
+
+namespace
+{
+    // Make the oversized request named `name`, which should panic.
+    // Returns false if there's no such request.
+    bool request_oversized(std::string_view name)
+    {
+        // Sizes that wrap to 1 and 4 in a `std::uint8_t`.
+        constexpr std::size_t wraps_to_1 = 257;
+        constexpr std::size_t wraps_to_4 = 260;
+
+        static_vector<int, 16> a{1, 2};
+        if (name == "size_constructor")
+        {
+            static_vector<int, 16> b(wraps_to_1);
+        }
+        else if (name == "fill_constructor")
+        {
+            static_vector<int, 16> b(wraps_to_1, 0);
+        }
+        else if (name == "assign")
+        {
+            a.assign(wraps_to_4, 0);
+        }
+        else if (name == "resize")
+        {
+            a.resize(wraps_to_1);
+        }
+        else if (name == "resize_fill")
+        {
+            a.resize(wraps_to_1, 0);
+        }
+        else if (name == "resize_for_overwrite")
+        {
+            a.resize_for_overwrite(wraps_to_4);
+        }
+        else if (name == "append_uninitialized")
+        {
+            a.append_uninitialized(wraps_to_4);
+        }
+        else if (name == "reserve")
+        {
+            a.reserve(wraps_to_4);
+        }
+        else if (name == "insert")
+        {
+            a.insert(a.begin(), wraps_to_1, 0);
+        }
+        else if (name == "at")
+        {
+            a.at(wraps_to_1);
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+}
+
+consteval int test_consteval()
+{
+    // Default constructor.
+    {
+        static_vector<int, 4> a;
+        gdt_assert(a.size() == 0);
+        gdt_assert(a.capacity() == 4);
+    }
+
+    // Size constructor.
+    {
+        static_vector<int, 4> a(3);
+        gdt_assert(a.size() == 3);
+        for (int i : a)
+        {
+            gdt_assert(i == 0);
+        }
+    }
+
+    // Fill constructor.
+    {
+        static_vector<int, 4> a(3, 45);
+        gdt_assert(a.size() == 3);
+        for (int i : a)
+        {
+            gdt_assert(i == 45);
+        }
+    }
+
+    // Copy and move.
+    {
+        static_vector<int, 4> a1{1, 2, 3};
+        auto a2 = a1;
+        auto a3 = std::move(a1);
+        gdt_assert(a2 == a3);
+        a1 = a2;
+        a1.push_back(4);
+        gdt_assert(a1.full());
+        gdt_assert(a2.size() == 3);
+    }
+
+    // Non-trivial elements.
+    {
+        static_vector<std::string, 3> a{"a", "b"};
+        auto a2 = a;
+        a2.emplace_back("c");
+        a = a2;
+        gdt_assert(a.size() == 3);
+        gdt_assert(a[2] == "c");
+        a.erase(a.begin());
+        gdt_assert(a[0] == "b");
+        gdt_assert(a.size() == 2);
+    }
+
+    // Assign.
+    {
+        static_vector<int, 4> a{1, 2, 3};
+        a.assign(2, 7);
+        gdt_assert((a == static_vector<int, 4>{7, 7}));
+        a.assign({4, 5, 6, 7});
+        gdt_assert((a == static_vector<int, 4>{4, 5, 6, 7}));
+    }
+
+    // Resize.
+    {
+        static_vector<int, 8> a{1, 2};
+        a.resize(4);
+        gdt_assert((a == static_vector<int, 8>{1, 2, 0, 0}));
+        a.resize(1);
+        gdt_assert((a == static_vector<int, 8>{1}));
+        a.resize_for_overwrite(3);
+        gdt_assert(a.size() == 3);
+        auto p = a.append_uninitialized(2);
+        gdt_assert(p == a.begin() + 3);
+        gdt_assert(a.size() == 5);
+    }
+
+    // Insert.
+    {
+        static_vector<int, 8> a{1, 5};
+        a.insert(a.begin() + 1, 4);
+        a.insert(a.begin() + 1, {2, 3});
+        a.insert(a.end(), 2, 6);
+        a.emplace(a.begin(), 0);
+        gdt_assert((a == static_vector<int, 8>{0, 1, 2, 3, 4, 5, 6, 6}));
+    }
+
+    // Erase.
+    {
+        static_vector<int, 8> a{0, 1, 2, 3, 4, 5};
+        auto itr = a.erase(a.begin() + 1, a.begin() + 3);
+        gdt_assert(*itr == 3);
+        itr = a.swap_remove(a.begin());
+        gdt_assert(*itr == 5);
+        gdt_assert((a == static_vector<int, 8>{5, 3, 4}));
+        gdt_assert(erase(a, 3) == 1);
+        gdt_assert(erase_if(a, [](int i) { return i > 4; }) == 1);
+        gdt_assert((a == static_vector<int, 8>{4}));
+    }
+
+    // Swap.
+    {
+        static_vector<std::string, 4> a1{"a"};
+        static_vector<std::string, 4> a2{"b", "c", "d"};
+        swap(a1, a2);
+        gdt_assert(a1.size() == 3);
+        gdt_assert(a1[2] == "d");
+        gdt_assert(a2.size() == 1);
+        gdt_assert(a2[0] == "a");
+    }
+
+    // Comparison.
+    {
+        static_vector<int, 4> a1{1, 2};
+        static_vector<int, 4> a2{1, 2, 0};
+        gdt_assert(a1 < a2);
+        gdt_assert(a1 != a2);
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_static_vector(int argc, char** const argv)
+{
+    // Oversized requests, one per run since they panic.
+    if (argc > 1 && request_oversized(argv[1]))
+    {
+        return 0;
+    }
+
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Storage lives inside the object.
+    {
+        static_vector<float, 16> a;
+        a.resize_for_overwrite(16);
+        auto p = static_cast<const void*>(a.data());
+        gdt_assert(p == static_cast<const void*>(&a));
+        gdt_assert(a.full());
+    }
+
+    // Runtime insert and erase with non-trivial elements.
+    {
+        static_vector<std::string, 8> a{"0", "1", "4"};
+        a.insert(a.begin() + 2, {"2", "3"});
+        a.emplace(a.begin(), "-1");
+        a.erase(a.begin());
+        gdt_assert(a.size() == 5);
+        for (int i = 0; i < 5; ++i)
+        {
+            gdt_assert(a[i] == std::to_string(i));
+        }
+    }
+
+    // Success.
+    return 0;
+}
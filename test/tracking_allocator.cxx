@@ -0,0 +1,156 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/tracking_allocator.hxx>
+
+#include <gdt/arena.hxx>
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+using gdt::allocation_stats;
+using gdt::allocation_stats_for;
+using gdt::tracking_allocator;
+
+namespace
+{
+    struct growth_tag;
+    struct expand_tag;
+    struct realloc_tag;
+    struct string_tag;
+}
+
+// Traits are preserved.
+static_assert(std::allocator_traits<
+    tracking_allocator<gdt::allocator<int>>>::is_always_equal::value);
+static_assert(!std::allocator_traits<
+    tracking_allocator<gdt::arena_allocator<int>>>::is_always_equal::value);
+static_assert(std::allocator_traits<
+    tracking_allocator<gdt::arena_allocator<int>>>::
+        propagate_on_container_swap::value);
+static_assert(std::is_same_v<
+    std::allocator_traits<tracking_allocator<gdt::allocator<int>>>::
+        rebind_alloc<float>,
+    tracking_allocator<gdt::allocator<float>>>);
+static_assert(std::is_same_v<
+    tracking_allocator<gdt::allocator<int, std::uint32_t>>::size_type,
+    std::uint32_t>);
+static_assert(gdt::is_trivially_relocatable_v<
+    gdt::dynarr<std::string, tracking_allocator<gdt::allocator<std::string>>>>);
+
+consteval int test_consteval()
+{
+    // Dynarr.
+    {
+        gdt::dynarr<int, tracking_allocator<gdt::allocator<int>>> a{1, 2, 3};
+        a.push_back(4);
+        gdt_assert(a.size() == 4);
+    }
+
+    // Success.
+    return 0;
+}
+
+int test_tracking_allocator(int, char** const)
+{
+    // Consteval.
+    gdt_assert(test_consteval() == 0);
+
+    // Bucket for.
+    {
+        gdt_assert(allocation_stats::bucket_for(0) == 0);
+        gdt_assert(allocation_stats::bucket_for(1) == 1);
+        gdt_assert(allocation_stats::bucket_for(2) == 2);
+        gdt_assert(allocation_stats::bucket_for(3) == 2);
+        gdt_assert(allocation_stats::bucket_for(4) == 3);
+    }
+
+    // Dynarr growth.
+    {
+        using allocator_type = tracking_allocator<
+            gdt::allocator<std::string>, growth_tag>;
+        auto& stats = allocator_type::stats();
+        gdt_assert(&stats == &allocation_stats_for<growth_tag>());
+
+        {
+            gdt::dynarr<std::string, allocator_type> a;
+            for (int i = 0; i < 8; ++i)
+            {
+                a.emplace_back("x");
+            }
+
+            gdt_assert(stats.allocations() == 4);
+            gdt_assert(stats.deallocations() == 3);
+            gdt_assert(stats.live_bytes() == 8 * sizeof(std::string));
+            gdt_assert(stats.peak_bytes() == 12 * sizeof(std::string));
+
+            auto bucket = allocation_stats::bucket_for(sizeof(std::string));
+            gdt_assert(stats.histogram(bucket) == 1);
+        }
+
+        gdt_assert(stats.live_bytes() == 0);
+        gdt_assert(stats.deallocations() == 4);
+
+        stats.reset();
+        gdt_assert(stats.allocations() == 0);
+        gdt_assert(stats.peak_bytes() == 0);
+    }
+
+    // In-place expansion.
+    {
+        using allocator_type = tracking_allocator<
+            gdt::arena_allocator<int>, expand_tag>;
+        auto& stats = allocator_type::stats();
+
+        gdt::arena ar;
+        gdt::dynarr<int, allocator_type> a{allocator_type(ar)};
+        for (int i = 0; i < 64; ++i)
+        {
+            a.push_back(i);
+        }
+
+        gdt_assert(stats.allocations() == 1);
+        gdt_assert(stats.expansions() == 6);
+        gdt_assert(stats.live_bytes() == 64 * sizeof(int));
+    }
+
+    // Reallocation.
+    {
+        using allocator_type = tracking_allocator<
+            gdt::allocator<int>, realloc_tag>;
+        auto& stats = allocator_type::stats();
+
+        gdt::dynarr<int, allocator_type> a;
+        for (int i = 0; i < 64; ++i)
+        {
+            a.push_back(i);
+        }
+
+        gdt_assert(stats.allocations() == 1);
+        gdt_assert(stats.reallocations() == 6);
+        gdt_assert(stats.live_bytes() == 64 * sizeof(int));
+        a.shrink_to_fit();
+        a.clear();
+        a.shrink_to_fit();
+        gdt_assert(stats.live_bytes() == 0);
+    }
+
+    // Tags are separate.
+    {
+        using allocator_type = tracking_allocator<
+            std::allocator<char>, string_tag>;
+        auto& stats = allocator_type::stats();
+
+        std::basic_string<char, std::char_traits<char>, allocator_type> s(
+            1000, 'x');
+        gdt_assert(stats.live_bytes() >= 1000);
+        gdt_assert(allocation_stats_for<growth_tag>().allocations() == 0);
+    }
+
+    // Success.
+    return 0;
+}
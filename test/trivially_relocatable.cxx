@@ -0,0 +1,56 @@
+// Copyright Jo Bates 2021.
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE_1_0.txt or copy at:
+// https://www.boost.org/LICENSE_1_0.txt
+
+#include <gdt/trivially_relocatable.hxx>
+
+#include <gdt/allocator.hxx>
+#include <gdt/assert.hxx>
+#include <gdt/dynarr.hxx>
+
+using gdt::is_trivially_relocatable_v;
+
+namespace
+{
+    struct pod { int x, y; };
+
+    struct not_trivial
+    {
+        not_trivial(const not_trivial&) {}
+    };
+
+    struct specialized
+    {
+        specialized(const specialized&) {}
+    };
+
+    struct not_relocatable_allocator : gdt::allocator<int>
+    {
+        using pointer = not_trivial;
+    };
+}
+
+template<>
+struct gdt::is_trivially_relocatable<specialized> : std::true_type {};
+
+int test_trivially_relocatable(int, char** const)
+{
+    // Trivially copyable types.
+    gdt_assert(is_trivially_relocatable_v<int>);
+    gdt_assert(is_trivially_relocatable_v<int*>);
+    gdt_assert(is_trivially_relocatable_v<pod>);
+
+    // Non-trivially copyable types.
+    gdt_assert(!is_trivially_relocatable_v<not_trivial>);
+
+    // User specializations.
+    gdt_assert(is_trivially_relocatable_v<specialized>);
+
+    // Library types.
+    gdt_assert(is_trivially_relocatable_v<gdt::allocator<not_trivial>>);
+    gdt_assert(is_trivially_relocatable_v<gdt::dynarr<not_trivial>>);
+
+    // Success.
+    return 0;
+}
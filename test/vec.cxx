@@ -6,6 +6,9 @@
 #include <gdt/vec.hxx>
 
 #include <gdt/assert.hxx>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 
 using gdt::all;
 using gdt::vec;
@@ -13,6 +16,40 @@ using gdt::vec2;
 using gdt::vec3;
 using gdt::vec4;
 
+// Components equal, compared one at a time.
+template<typename T, std::size_t N>
+bool same(const vec<T, N>& a, const vec<T, N>& b)
+{
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        if (a[i] != b[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Runtime (SIMD) result matches the constant-evaluated (scalar) result.
+template<typename F>
+bool simd_matches_scalar(F f)
+{
+    constexpr auto expected = f();
+    auto actual = f();
+    return same(actual, expected);
+}
+
+// Runtime result is within `tolerance` (squared distance) of the
+// constant-evaluated one. For expressions the compiler is allowed to
+// contract into FMAs at runtime but not during constant evaluation.
+template<typename F>
+bool simd_near_scalar(F f, float tolerance)
+{
+    constexpr auto expected = f();
+    auto e = f() - expected;
+    return dot(e, e) < tolerance;
+}
+
 consteval int test_consteval()
 {
     // Scalar constructor.
@@ -72,6 +109,23 @@ consteval int test_consteval()
         gdt_assert(v.x() == 5);
     }
 
+    // Indexed swizzling.
+    {
+        vec v = {1, 2, 3, 4};
+        gdt_assert(all(v.swizzle<2, 0, 1>() == vec(3, 1, 2)));
+        gdt_assert(all(v.swizzle<3, 3>() == v.ww()));
+        gdt_assert(v.swizzle<1>()[0] == 2);
+
+        v.set_swizzle<3, 1>(vec(5, 6));
+        gdt_assert(all(v == vec(1, 6, 3, 5)));
+
+        // Permutations can set from the vector itself.
+        v.set_wzyx(v);
+        gdt_assert(all(v == vec(5, 3, 6, 1)));
+        v.set_swizzle<1, 2, 0>(v.xyz());
+        gdt_assert(all(v == vec(6, 5, 3, 1)));
+    }
+
     // Operators.
     {
         gdt_assert(all(-vec(1, 2, 3) == vec(-1, -2, -3)));
@@ -85,6 +139,35 @@ consteval int test_consteval()
         gdt_assert(all(vec(1, 2) == vec(1, 2)));
     }
 
+    // Geometric functions.
+    {
+        gdt_assert(dot(vec(1, 2, 3), vec(4, 5, 6)) == 32);
+        gdt_assert(dot(vec(1, 2, 3, 4), vec(5, 6, 7, 8)) == 70);
+        gdt_assert(all(cross(vec(1, 0, 0), vec(0, 1, 0)) == vec(0, 0, 1)));
+        gdt_assert(all(cross(vec(2, 3, 4), vec(5, 6, 7)) == vec(-3, 6, -3)));
+        gdt_assert(length_squared(vec(1, 2, 2)) == 9);
+        gdt_assert(length(vec(3.0f, 4.0f)) == 5.0f);
+        gdt_assert(length(vec(2.0, 3.0, 6.0)) == 7.0);
+        gdt_assert(distance(vec(1.0, 1.0), vec(4.0, 5.0)) == 5.0);
+        gdt_assert(all(normalize(vec(0.0f, 3.0f, 4.0f)) == vec(0.0f, 0.6f, 0.8f)));
+        gdt_assert(all(reflect(vec(1, -1), vec(0, 1)) == vec(1, 1)));
+        gdt_assert(all(project(vec(2.0, 3.0), vec(4.0, 0.0)) == vec(2.0, 0.0)));
+
+        auto n = fast_normalize(vec(1.0f, 2.0f, 2.0f));
+        auto e = n - vec(1.0f, 2.0f, 2.0f) / 3.0f;
+        gdt_assert(dot(e, e) < 1e-12f);
+        gdt_assert(all(fast_normalize(vec(0.0, 2.0)) == vec(0.0, 1.0)));
+    }
+
+    // Square root.
+    {
+        using gdt_detail::constexpr_sqrt;
+        gdt_assert(constexpr_sqrt(0.0) == 0.0);
+        gdt_assert(constexpr_sqrt(2.25f) == 1.5f);
+        gdt_assert(constexpr_sqrt(1e30) == 1e15);
+        gdt_assert(constexpr_sqrt(-1.0) != constexpr_sqrt(-1.0));
+    }
+
     // Success.
     return 0;
 }
@@ -111,6 +194,118 @@ int test_vec(int, char** const)
         gdt_assert(all(f == vec(0.25f, 0.5f)));
     }
 
+    // SIMD float operators.
+    {
+        static constexpr vec4<float> a(1.5f, -2.0f, 3.25f, 0.0f);
+        static constexpr vec4<float> b(0.5f, 4.0f, 3.25f, -8.0f);
+        gdt_assert(simd_matches_scalar([] { return a + b; }));
+        gdt_assert(simd_matches_scalar([] { return a - b; }));
+        gdt_assert(simd_matches_scalar([] { return a * b; }));
+        gdt_assert(simd_matches_scalar([] { return a / b; }));
+        gdt_assert(simd_matches_scalar([] { return a * 2.0f; }));
+        gdt_assert(simd_matches_scalar([] { return 2 - a; }));
+        gdt_assert(simd_matches_scalar([] { return a / 4; }));
+        gdt_assert(simd_matches_scalar([] { return -a; }));
+        gdt_assert(simd_matches_scalar([] { return a < b; }));
+        gdt_assert(simd_matches_scalar([] { return a > b; }));
+        gdt_assert(simd_matches_scalar([] { return a <= b; }));
+        gdt_assert(simd_matches_scalar([] { return a >= b; }));
+        gdt_assert(simd_matches_scalar([] { return a == b; }));
+        gdt_assert(simd_matches_scalar([] { return a != b; }));
+        gdt_assert(simd_matches_scalar([] { return a * 0.5; }));
+        gdt_assert(simd_matches_scalar([] { return a.zyxw() + b.wzyx(); }));
+        gdt_assert(simd_matches_scalar([] { return a.swizzle<3, 3, 0, 1>(); }));
+        gdt_assert(simd_matches_scalar([] { return a.xxxx() * b.yzxw(); }));
+        gdt_assert(simd_matches_scalar([]
+        {
+            auto v = a;
+            v.set_yzwx(v);
+            return v;
+        }));
+    }
+
+    // vec3<float> operators (scalar).
+    {
+        static constexpr vec3<float> a(1.5f, -2.0f, 3.25f);
+        static constexpr vec3<float> b(0.5f, 4.0f, 3.25f);
+        gdt_assert(simd_matches_scalar([] { return a + b; }));
+        gdt_assert(simd_matches_scalar([] { return a - b; }));
+        gdt_assert(simd_matches_scalar([] { return a * b; }));
+        gdt_assert(simd_matches_scalar([] { return a / b; }));
+        gdt_assert(simd_matches_scalar([] { return a * 3.0f; }));
+        gdt_assert(simd_matches_scalar([] { return -a; }));
+        gdt_assert(simd_matches_scalar([] { return a == b; }));
+        gdt_assert(simd_matches_scalar([] { return a >= b; }));
+    }
+
+    // Constant-evaluated square roots are correctly rounded.
+    {
+        static constexpr double x[] = {2.0, 3.0, 1e-300, 5e-324, 7.5e300};
+        constexpr auto s0 = gdt_detail::constexpr_sqrt(x[0]);
+        constexpr auto s1 = gdt_detail::constexpr_sqrt(x[1]);
+        constexpr auto s2 = gdt_detail::constexpr_sqrt(x[2]);
+        constexpr auto s3 = gdt_detail::constexpr_sqrt(x[3]);
+        constexpr auto s4 = gdt_detail::constexpr_sqrt(x[4]);
+        constexpr auto f = gdt_detail::constexpr_sqrt(0.1f);
+        gdt_assert(s0 == std::sqrt(x[0]));
+        gdt_assert(s1 == std::sqrt(x[1]));
+        gdt_assert(s2 == std::sqrt(x[2]));
+        gdt_assert(s3 == std::sqrt(x[3]));
+        gdt_assert(s4 == std::sqrt(x[4]));
+        gdt_assert(f == std::sqrt(0.1f));
+    }
+
+    // SIMD geometric functions.
+    {
+        static constexpr auto a = vec(1.5f, -2.25f, 3.0f, 0.125f);
+        static constexpr auto b = vec(-0.5f, 4.0f, 1.75f, 8.0f);
+        constexpr auto ab = dot(a, b);
+        auto ab_rt = dot(a, b);
+        gdt_assert(ab_rt == ab);
+        gdt_assert(simd_matches_scalar([] { return normalize(a); }));
+        gdt_assert(simd_near_scalar(
+            [] { return reflect(a, normalize(b)); }, 1e-10f));
+        gdt_assert(simd_near_scalar([] { return project(a, b); }, 1e-10f));
+        gdt_assert(simd_matches_scalar([] { return cross(a.xyz(), b.xyz()); }));
+
+        // Within a few units in the last place of normalize.
+        for (auto v : {a, b, a.wzyx(), vec(1e-3f, 0.0f, 0.0f, 0.0f)})
+        {
+            auto e = fast_normalize(v) - normalize(v);
+            gdt_assert(dot(e, e) < 1e-12f);
+            auto e3 = fast_normalize(v.xyz()) - normalize(v.xyz());
+            gdt_assert(dot(e3, e3) < 1e-12f);
+        }
+    }
+
+    // SIMD int32 operators.
+    {
+        static constexpr vec4<std::int32_t> a(7, -3, 0x12345, -100);
+        static constexpr vec4<std::int32_t> b(2, 5, 3, -100);
+        static constexpr vec4<std::int32_t> s(1, 4, 0, 3);
+        gdt_assert(simd_matches_scalar([] { return a + b; }));
+        gdt_assert(simd_matches_scalar([] { return a - b; }));
+        gdt_assert(simd_matches_scalar([] { return a * b; }));
+        gdt_assert(simd_matches_scalar([] { return a / b; }));
+        gdt_assert(simd_matches_scalar([] { return a % b; }));
+        gdt_assert(simd_matches_scalar([] { return a & b; }));
+        gdt_assert(simd_matches_scalar([] { return a | b; }));
+        gdt_assert(simd_matches_scalar([] { return a ^ b; }));
+        gdt_assert(simd_matches_scalar([] { return b << s; }));
+        gdt_assert(simd_matches_scalar([] { return a >> s; }));
+        gdt_assert(simd_matches_scalar([] { return -b; }));
+        gdt_assert(simd_matches_scalar([] { return ~a; }));
+        gdt_assert(simd_matches_scalar([] { return a * 3; }));
+        gdt_assert(simd_matches_scalar([] { return 1 - a; }));
+        gdt_assert(simd_matches_scalar([] { return a < b; }));
+        gdt_assert(simd_matches_scalar([] { return a > b; }));
+        gdt_assert(simd_matches_scalar([] { return a <= b; }));
+        gdt_assert(simd_matches_scalar([] { return a >= b; }));
+        gdt_assert(simd_matches_scalar([] { return a == b; }));
+        gdt_assert(simd_matches_scalar([] { return a != b; }));
+        gdt_assert(simd_matches_scalar([] { return a.wzyx() + b.xxyy(); }));
+    }
+
     // Success.
     return 0;
 }